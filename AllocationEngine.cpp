@@ -3,20 +3,83 @@
 AllocationEngine::AllocationEngine() {
     zones = nullptr;
     zoneCount = 0;
+    zoneIndex = nullptr;
+    spilloverPolicy = SPILLOVER_NEAREST;
 }
 
 AllocationEngine::AllocationEngine(Zone* zones, int zoneCount) {
     this->zones = zones;
     this->zoneCount = zoneCount;
+    this->zoneIndex = nullptr;
+    this->spilloverPolicy = SPILLOVER_NEAREST;
+}
+
+AllocationEngine::AllocationEngine(Zone* zones, int zoneCount, const ZoneIndex* zoneIndex) {
+    this->zones = zones;
+    this->zoneCount = zoneCount;
+    this->zoneIndex = zoneIndex;
+    this->spilloverPolicy = SPILLOVER_NEAREST;
+}
+
+void AllocationEngine::setSpilloverPolicy(SpilloverPolicy policy) {
+    spilloverPolicy = policy;
+}
+
+SpilloverPolicy AllocationEngine::getSpilloverPolicy() const {
+    return spilloverPolicy;
+}
+
+// The two neighbours are picked by hashing the request ID rather than
+// drawing from a random generator, so replaying the log (or a snapshot
+// plus log) makes the same choices without any generator state to save
+ParkingSlot* AllocationEngine::claimInSampledNeighbour(Zone* requestedZone, int requestID, int stayStart, int stayEnd,
+                                                      int& zonesProbed) {
+    int count = requestedZone->getAdjacentZoneCount();
+    if (count == 0) {
+        return nullptr;
+    }
+    unsigned int hash = (unsigned int)requestID * 2654435761u;
+    hash ^= hash >> 16;
+    int first = (int)(hash % (unsigned int)count);
+    int second = first;
+    if (count > 1) {
+        second = (int)((hash >> 8) % (unsigned int)(count - 1));
+        if (second >= first) {
+            second++;
+        }
+    }
+    
+    // Free-slot counts are kept per zone, so comparing costs O(1); on a
+    // tie the closer neighbour wins
+    Zone* best = nullptr;
+    int bestIndex = count;
+    int bestFree = 0;
+    int candidates[2] = { first, second };
+    for (int c = 0; c < ((count > 1) ? 2 : 1); c++) {
+        zonesProbed++;
+        Zone* zone = getZone(requestedZone->getAdjacentZone(candidates[c]));
+        int free = (zone != nullptr) ? zone->getTotalAvailableSlots() : 0;
+        if (free > bestFree || (free == bestFree && free > 0 && candidates[c] < bestIndex)) {
+            best = zone;
+            bestIndex = candidates[c];
+            bestFree = free;
+        }
+    }
+    return (best != nullptr) ? best->claimAvailableSlot(stayStart, stayEnd) : nullptr;
 }
 
 AllocationResult AllocationEngine::allocateSlot(ParkingRequest& request) {
+    return allocateSlot(request, request.getRequestTime(), INT_MAX);
+}
+
+AllocationResult AllocationEngine::allocateSlot(ParkingRequest& request, int stayStart, int stayEnd) {
     AllocationResult result;
     
-    ParkingSlot* slot = findSlotInZone(request.getRequestedZone());
+    Zone* requestedZone = getZone(request.getRequestedZone());
+    ParkingSlot* slot = (requestedZone != nullptr) ? requestedZone->claimAvailableSlot(stayStart, stayEnd) : nullptr;
+    result.zonesProbed = 1;
     
     if (slot != nullptr) {
-        slot->occupySlot();
         result.success = true;
         result.allocatedSlotID = slot->getSlotID();
         result.allocatedZoneID = slot->getZoneID();
@@ -24,15 +87,29 @@ AllocationResult AllocationEngine::allocateSlot(ParkingRequest& request) {
         return result;
     }
     
-    slot = findSlotInAdjacentZones(request.getRequestedZone());
+    if (spilloverPolicy == SPILLOVER_TWO_CHOICES && requestedZone != nullptr) {
+        slot = claimInSampledNeighbour(requestedZone, request.getRequestID(), stayStart, stayEnd, result.zonesProbed);
+        if (slot != nullptr) {
+            result.success = true;
+            result.allocatedSlotID = slot->getSlotID();
+            result.allocatedZoneID = slot->getZoneID();
+            result.isCrossZone = true;
+            return result;
+        }
+    }
     
-    if (slot != nullptr) {
-        slot->occupySlot();
-        result.success = true;
-        result.allocatedSlotID = slot->getSlotID();
-        result.allocatedZoneID = slot->getZoneID();
-        result.isCrossZone = true;
-        return result;
+    // Neighbours are stored closest first, so the first hit is the nearest
+    for (int i = 0; requestedZone != nullptr && i < requestedZone->getAdjacentZoneCount(); i++) {
+        result.zonesProbed++;
+        Zone* zone = getZone(requestedZone->getAdjacentZone(i));
+        slot = (zone != nullptr) ? zone->claimAvailableSlot(stayStart, stayEnd) : nullptr;
+        if (slot != nullptr) {
+            result.success = true;
+            result.allocatedSlotID = slot->getSlotID();
+            result.allocatedZoneID = slot->getZoneID();
+            result.isCrossZone = true;
+            return result;
+        }
     }
     
     result.success = false;
@@ -40,37 +117,79 @@ AllocationResult AllocationEngine::allocateSlot(ParkingRequest& request) {
 }
 
 bool AllocationEngine::freeSlot(int slotID, int zoneID) {
-    ParkingSlot* slot = findSlotByID(slotID, zoneID);
-    if (slot != nullptr) {
-        slot->freeSlot();
-        return true;
+    Zone* zone = getZone(zoneID);
+    return zone != nullptr && zone->freeSlot(slotID);
+}
+
+// Books a slot for a future window without touching its current
+// availability; same-zone first, then adjacent zones, as for allocateSlot
+AllocationResult AllocationEngine::reserveSlot(ParkingRequest& request, int startTime, int endTime) {
+    AllocationResult result;
+    
+    Zone* requestedZone = getZone(request.getRequestedZone());
+    if (requestedZone == nullptr) {
+        return result;
     }
-    return false;
+    
+    int slotID = -1;
+    if (requestedZone->reserveSlotDuring(startTime, endTime, request.getRequestID(), slotID)) {
+        result.success = true;
+        result.allocatedSlotID = slotID;
+        result.allocatedZoneID = requestedZone->getZoneID();
+        result.isCrossZone = false;
+        return result;
+    }
+    
+    for (int i = 0; i < requestedZone->getAdjacentZoneCount(); i++) {
+        Zone* zone = getZone(requestedZone->getAdjacentZone(i));
+        if (zone != nullptr && zone->reserveSlotDuring(startTime, endTime, request.getRequestID(), slotID)) {
+            result.success = true;
+            result.allocatedSlotID = slotID;
+            result.allocatedZoneID = zone->getZoneID();
+            result.isCrossZone = true;
+            return result;
+        }
+    }
+    
+    return result;
+}
+
+bool AllocationEngine::cancelReservation(int slotID, int zoneID, int startTime, int requestID) {
+    Zone* zone = getZone(zoneID);
+    if (zone == nullptr) {
+        return false;
+    }
+    return zone->cancelReservation(slotID, startTime, requestID);
+}
+
+bool AllocationEngine::allocateReservedSlot(int slotID, int zoneID) {
+    Zone* zone = getZone(zoneID);
+    return zone != nullptr && zone->occupySlot(slotID);
 }
 
 ParkingSlot* AllocationEngine::findSlotInZone(int zoneID) {
-    for (int i = 0; i < zoneCount; i++) {
-        if (zones[i].getZoneID() == zoneID) {
-            return zones[i].findAvailableSlot();
-        }
+    Zone* zone = getZone(zoneID);
+    if (zone == nullptr) {
+        return nullptr;
     }
-    return nullptr;
+    return zone->findAvailableSlot();
 }
 
 ParkingSlot* AllocationEngine::findSlotInAdjacentZones(int requestedZoneID) {
-    Zone* requestedZone = nullptr;
-    for (int i = 0; i < zoneCount; i++) {
-        if (zones[i].getZoneID() == requestedZoneID) {
-            requestedZone = &zones[i];
-            break;
-        }
-    }
-    
+    int zonesProbed = 0;
+    return findSlotInAdjacentZones(requestedZoneID, zonesProbed);
+}
+
+// Neighbours are stored closest first, so the first hit is the nearest
+ParkingSlot* AllocationEngine::findSlotInAdjacentZones(int requestedZoneID, int& zonesProbedOut) {
+    zonesProbedOut = 0;
+    Zone* requestedZone = getZone(requestedZoneID);
     if (requestedZone == nullptr) {
         return nullptr;
     }
     
     for (int i = 0; i < requestedZone->getAdjacentZoneCount(); i++) {
+        zonesProbedOut++;
         int adjacentZoneID = requestedZone->getAdjacentZone(i);
         ParkingSlot* slot = findSlotInZone(adjacentZoneID);
         if (slot != nullptr) {
@@ -81,26 +200,27 @@ ParkingSlot* AllocationEngine::findSlotInAdjacentZones(int requestedZoneID) {
     return nullptr;
 }
 
+// Slot IDs encode their area, so only the owning area is searched
 ParkingSlot* AllocationEngine::findSlotByID(int slotID, int zoneID) {
-    for (int i = 0; i < zoneCount; i++) {
-        if (zones[i].getZoneID() == zoneID) {
-            for (int j = 0; j < zones[i].getAreaCount(); j++) {
-                ParkingArea* area = zones[i].getArea(j);
-                if (area != nullptr) {
-                    for (int k = 0; k < area->getCapacity(); k++) {
-                        ParkingSlot* slot = area->getSlot(k);
-                        if (slot != nullptr && slot->getSlotID() == slotID) {
-                            return slot;
-                        }
-                    }
-                }
-            }
+    Zone* zone = getZone(zoneID);
+    if (zone == nullptr) {
+        return nullptr;
+    }
+    for (int j = 0; j < zone->getAreaCount(); j++) {
+        ParkingArea* area = zone->getArea(j);
+        int index = area->getSlotIndex(slotID);
+        if (index != -1) {
+            return area->getSlot(index);
         }
     }
     return nullptr;
 }
 
 Zone* AllocationEngine::getZone(int zoneID) {
+    if (zoneIndex != nullptr) {
+        int index = zoneIndex->find(zoneID);
+        return (index != -1) ? &zones[index] : nullptr;
+    }
     for (int i = 0; i < zoneCount; i++) {
         if (zones[i].getZoneID() == zoneID) {
             return &zones[i];
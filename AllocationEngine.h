@@ -3,36 +3,67 @@
 // Allocation logic updated for cross-zone support(.h)
 
 #include "Zone.h"
+#include "ZoneIndex.h"
 #include "ParkingRequest.h"
+#include <climits>
 
 struct AllocationResult {
     bool success;
     int allocatedSlotID;
     int allocatedZoneID;
     bool isCrossZone;
+    int zonesProbed;
     
     AllocationResult() {
         success = false;
         allocatedSlotID = -1;
         allocatedZoneID = -1;
         isCrossZone = false;
+        zonesProbed = 0;
     }
 };
 
+// How a request overflowing its own zone picks a neighbour.
+// NEAREST tries neighbours closest first, so the first-linked neighbour
+// takes all the overflow until it is full. TWO_CHOICES samples two
+// neighbours and takes the one with more free slots (power of two
+// choices), falling back to the nearest-first scan when both are full.
+enum SpilloverPolicy {
+    SPILLOVER_NEAREST,
+    SPILLOVER_TWO_CHOICES
+};
+
 class AllocationEngine {
 private:
     Zone* zones;
     int zoneCount;
+    const ZoneIndex* zoneIndex;
+    SpilloverPolicy spilloverPolicy;
+    
+    ParkingSlot* claimInSampledNeighbour(Zone* requestedZone, int requestID, int stayStart, int stayEnd,
+                                         int& zonesProbed);
 
 public:
     AllocationEngine();
     AllocationEngine(Zone* zones, int zoneCount);
+    AllocationEngine(Zone* zones, int zoneCount, const ZoneIndex* zoneIndex);
     
+    void setSpilloverPolicy(SpilloverPolicy policy);
+    SpilloverPolicy getSpilloverPolicy() const;
+    
+    // Never takes a slot booked during [stayStart, stayEnd); the one-argument
+    // form assumes an open-ended stay from the request time
     AllocationResult allocateSlot(ParkingRequest& request);
+    AllocationResult allocateSlot(ParkingRequest& request, int stayStart, int stayEnd);
     bool freeSlot(int slotID, int zoneID);
     
+    AllocationResult reserveSlot(ParkingRequest& request, int startTime, int endTime);
+    bool cancelReservation(int slotID, int zoneID, int startTime, int requestID);
+    bool allocateReservedSlot(int slotID, int zoneID);
+    
     ParkingSlot* findSlotInZone(int zoneID);
     ParkingSlot* findSlotInAdjacentZones(int requestedZoneID);
+    ParkingSlot* findSlotInAdjacentZones(int requestedZoneID, int& zonesProbedOut);
     ParkingSlot* findSlotByID(int slotID, int zoneID);
     
     Zone* getZone(int zoneID);
@@ -0,0 +1,102 @@
+#include "AtomicHistogram.h"
+
+AtomicHistogram::AtomicHistogram() : AtomicHistogram(4) {
+}
+
+AtomicHistogram::AtomicHistogram(int subBucketBits) {
+    this->subBucketBits = (subBucketBits >= 0 && subBucketBits <= 8) ? subBucketBits : 4;
+    bucketCount = (64 - this->subBucketBits) << this->subBucketBits;
+    counts = new atomic<long long>[bucketCount];
+    clear();
+}
+
+AtomicHistogram::~AtomicHistogram() {
+    delete[] counts;
+}
+
+void AtomicHistogram::clear() {
+    for (int i = 0; i < bucketCount; i++) {
+        counts[i].store(0, memory_order_relaxed);
+    }
+    totalCount.store(0, memory_order_relaxed);
+    sum.store(0, memory_order_relaxed);
+    maxValue.store(0, memory_order_relaxed);
+}
+
+int AtomicHistogram::bucketFor(long long value) const {
+    int subBuckets = 1 << subBucketBits;
+    if (value < subBuckets) {
+        return (value < 0) ? 0 : (int)value;
+    }
+    // Binary search for the highest set bit: six steps instead of a
+    // shift per bit on the recording path
+    int highestBit = 0;
+    for (int step = 32; step > 0; step >>= 1) {
+        if ((value >> (highestBit + step)) != 0) {
+            highestBit += step;
+        }
+    }
+    int shift = highestBit - subBucketBits;
+    int sub = (int)((value >> shift) & (subBuckets - 1));
+    return (shift + 1) * subBuckets + sub;
+}
+
+long long AtomicHistogram::bucketUpperBound(int bucket) const {
+    int subBuckets = 1 << subBucketBits;
+    if (bucket < subBuckets) {
+        return bucket;
+    }
+    int shift = bucket / subBuckets - 1;
+    unsigned long long sub = bucket % subBuckets;
+    unsigned long long bound = ((subBuckets + sub + 1) << shift) - 1;
+    return (bound > 0x7FFFFFFFFFFFFFFFULL) ? 0x7FFFFFFFFFFFFFFFLL : (long long)bound;
+}
+
+void AtomicHistogram::record(long long value) {
+    counts[bucketFor(value)].fetch_add(1, memory_order_relaxed);
+    totalCount.fetch_add(1, memory_order_relaxed);
+    sum.fetch_add(value, memory_order_relaxed);
+    long long seen = maxValue.load(memory_order_relaxed);
+    while (value > seen && !maxValue.compare_exchange_weak(seen, value, memory_order_relaxed)) {
+    }
+}
+
+long long AtomicHistogram::getCount() const {
+    return totalCount.load(memory_order_relaxed);
+}
+
+long long AtomicHistogram::getMax() const {
+    return maxValue.load(memory_order_relaxed);
+}
+
+double AtomicHistogram::getMean() const {
+    long long count = getCount();
+    return (count > 0) ? (double)sum.load(memory_order_relaxed) / count : 0.0;
+}
+
+// Upper edge of the bucket holding the given percentile (0-100), capped at
+// the largest value recorded
+long long AtomicHistogram::getPercentile(double percentile) const {
+    long long count = getCount();
+    if (count == 0) {
+        return 0;
+    }
+    long long target = (long long)(percentile / 100.0 * count + 0.5);
+    if (target < 1) {
+        target = 1;
+    }
+    if (target > count) {
+        target = count;
+    }
+
+    long long maximum = getMax();
+    long long seen = 0;
+    for (int i = 0; i < bucketCount; i++) {
+        seen += counts[i].load(memory_order_relaxed);
+        if (seen >= target) {
+            long long bound = bucketUpperBound(i);
+            return (bound < maximum) ? bound : maximum;
+        }
+    }
+    return maximum;
+}
\ No newline at end of file
@@ -0,0 +1,43 @@
+#ifndef ATOMICHISTOGRAM_H
+#define ATOMICHISTOGRAM_H
+
+#include <atomic>
+using namespace std;
+
+// Log-linear histogram with lock-free recording, for metrics updated on
+// hot paths. Values below 2^subBucketBits get their own bucket; above that
+// each power of two is split into 2^subBucketBits buckets. With 4 bits it
+// matches LatencyHistogram (~6% precision, 960 buckets); 0 bits gives
+// plain power-of-two buckets (64 counters) where memory matters more.
+// Counters use relaxed atomics, so readers see each counter exactly but
+// not necessarily a consistent cut across them.
+class AtomicHistogram {
+private:
+    int subBucketBits;
+    int bucketCount;
+    atomic<long long>* counts;
+    atomic<long long> totalCount;
+    atomic<long long> sum;
+    atomic<long long> maxValue;
+
+    int bucketFor(long long value) const;
+    long long bucketUpperBound(int bucket) const;
+
+    AtomicHistogram(const AtomicHistogram&);
+    AtomicHistogram& operator=(const AtomicHistogram&);
+
+public:
+    AtomicHistogram();
+    AtomicHistogram(int subBucketBits);
+    ~AtomicHistogram();
+
+    void record(long long value);
+    void clear();
+
+    long long getCount() const;
+    long long getMax() const;
+    double getMean() const;
+    long long getPercentile(double percentile) const;
+};
+
+#endif
\ No newline at end of file
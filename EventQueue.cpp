@@ -0,0 +1,127 @@
+#include "EventQueue.h"
+
+EventQueue::EventQueue() {
+    heap = nullptr;
+    size = 0;
+    capacity = 0;
+    nextSequence = 0;
+}
+
+EventQueue::~EventQueue() {
+    delete[] heap;
+}
+
+EventQueue::EventQueue(const EventQueue& other) {
+    size = other.size;
+    capacity = other.capacity;
+    nextSequence = other.nextSequence;
+    heap = (capacity > 0) ? new ScheduledEvent[capacity] : nullptr;
+    for (int i = 0; i < size; i++) {
+        heap[i] = other.heap[i];
+    }
+}
+
+EventQueue& EventQueue::operator=(const EventQueue& other) {
+    if (this != &other) {
+        delete[] heap;
+        size = other.size;
+        capacity = other.capacity;
+        nextSequence = other.nextSequence;
+        heap = (capacity > 0) ? new ScheduledEvent[capacity] : nullptr;
+        for (int i = 0; i < size; i++) {
+            heap[i] = other.heap[i];
+        }
+    }
+    return *this;
+}
+
+bool EventQueue::comesBefore(const ScheduledEvent& a, const ScheduledEvent& b) const {
+    if (a.time != b.time) {
+        return a.time < b.time;
+    }
+    return a.sequence < b.sequence;
+}
+
+void EventQueue::grow() {
+    int newCapacity = (capacity == 0) ? 64 : capacity * 2;
+    ScheduledEvent* newHeap = new ScheduledEvent[newCapacity];
+    for (int i = 0; i < size; i++) {
+        newHeap[i] = heap[i];
+    }
+    delete[] heap;
+    heap = newHeap;
+    capacity = newCapacity;
+}
+
+void EventQueue::siftUp(int i) {
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (!comesBefore(heap[i], heap[parent])) {
+            break;
+        }
+        ScheduledEvent temp = heap[i];
+        heap[i] = heap[parent];
+        heap[parent] = temp;
+        i = parent;
+    }
+}
+
+void EventQueue::siftDown(int i) {
+    while (true) {
+        int best = i;
+        int left = 2 * i + 1;
+        int right = 2 * i + 2;
+        if (left < size && comesBefore(heap[left], heap[best])) {
+            best = left;
+        }
+        if (right < size && comesBefore(heap[right], heap[best])) {
+            best = right;
+        }
+        if (best == i) {
+            return;
+        }
+        ScheduledEvent temp = heap[i];
+        heap[i] = heap[best];
+        heap[best] = temp;
+        i = best;
+    }
+}
+
+void EventQueue::push(const ScheduledEvent& event) {
+    if (size >= capacity) {
+        grow();
+    }
+    heap[size] = event;
+    heap[size].sequence = nextSequence++;
+    siftUp(size);
+    size++;
+}
+
+bool EventQueue::pop(ScheduledEvent& event) {
+    if (size == 0) {
+        return false;
+    }
+    event = heap[0];
+    size--;
+    if (size > 0) {
+        heap[0] = heap[size];
+        siftDown(0);
+    }
+    return true;
+}
+
+bool EventQueue::peek(ScheduledEvent& event) const {
+    if (size == 0) {
+        return false;
+    }
+    event = heap[0];
+    return true;
+}
+
+int EventQueue::getSize() const {
+    return size;
+}
+
+bool EventQueue::isEmpty() const {
+    return size == 0;
+}
\ No newline at end of file
@@ -0,0 +1,59 @@
+#ifndef EVENTQUEUE_H
+#define EVENTQUEUE_H
+
+// A future event of a simulated workload. `kind` and the payload fields
+// are interpreted by whoever schedules the event.
+struct ScheduledEvent {
+    double time;
+    long long sequence;
+    int kind;
+    int key;
+    int requestID;
+
+    ScheduledEvent() {
+        time = 0.0;
+        sequence = 0;
+        kind = 0;
+        key = -1;
+        requestID = -1;
+    }
+
+    ScheduledEvent(double eventTime, int eventKind, int eventKey, int reqID) {
+        time = eventTime;
+        sequence = 0;
+        kind = eventKind;
+        key = eventKey;
+        requestID = reqID;
+    }
+};
+
+// Binary min-heap of events by time. Events at the same time come out in
+// the order they were pushed, so a simulation is deterministic.
+class EventQueue {
+private:
+    ScheduledEvent* heap;
+    int size;
+    int capacity;
+    long long nextSequence;
+
+    bool comesBefore(const ScheduledEvent& a, const ScheduledEvent& b) const;
+    void grow();
+    void siftUp(int i);
+    void siftDown(int i);
+
+public:
+    EventQueue();
+    ~EventQueue();
+
+    EventQueue(const EventQueue& other);
+    EventQueue& operator=(const EventQueue& other);
+
+    void push(const ScheduledEvent& event);
+    bool pop(ScheduledEvent& event);
+    bool peek(ScheduledEvent& event) const;
+
+    int getSize() const;
+    bool isEmpty() const;
+};
+
+#endif
\ No newline at end of file
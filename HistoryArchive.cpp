@@ -0,0 +1,347 @@
+#include "HistoryArchive.h"
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+static const unsigned char ARCHIVE_MAGIC[4] = { 'P', 'K', 'H', 'A' };
+static const int ARCHIVE_VERSION = 3;
+static const int ARCHIVE_HEADER_SIZE = 8;
+
+static void putI32(unsigned char* out, int value) {
+    unsigned int bits = (unsigned int)value;
+    for (int i = 0; i < 4; i++) {
+        out[i] = (unsigned char)((bits >> (8 * i)) & 0xFF);
+    }
+}
+
+static int getI32(const unsigned char* in) {
+    return (int)((unsigned int)in[0] | ((unsigned int)in[1] << 8)
+               | ((unsigned int)in[2] << 16) | ((unsigned int)in[3] << 24));
+}
+
+HistoryArchive::HistoryArchive() {
+    file = nullptr;
+    path = "";
+    mappedRecords = 0;
+    recordCount = 0;
+    indexFile = nullptr;
+    indexWriteEnd = -1;
+    totals = HistoryTotals();
+}
+
+HistoryArchive::~HistoryArchive() {
+    close();
+}
+
+// Starts a new, empty archive at `path`
+bool HistoryArchive::open(const string& path) {
+    close();
+    
+    file = fopen(path.c_str(), "w+b");
+    if (file == nullptr || !openIndex()) {
+        close();
+        return false;
+    }
+    this->path = path;
+    
+    unsigned char header[ARCHIVE_HEADER_SIZE];
+    for (int i = 0; i < 4; i++) {
+        header[i] = ARCHIVE_MAGIC[i];
+    }
+    putI32(header + 4, ARCHIVE_VERSION);
+    if (fwrite(header, 1, ARCHIVE_HEADER_SIZE, file) != ARCHIVE_HEADER_SIZE || fflush(file) != 0) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+// Re-attaches to an existing archive, keeping its first keepRecords records
+// (the ones a snapshot knows about) and discarding anything after them.
+// A file shorter than that lost records the snapshot counts, and is refused
+// rather than zero-extended into blank entries
+bool HistoryArchive::reopen(const string& path, int keepRecords) {
+    close();
+    
+    file = fopen(path.c_str(), "r+b");
+    if (file == nullptr || keepRecords < 0 || !openIndex()) {
+        close();
+        return false;
+    }
+    this->path = path;
+    
+    long long keepBytes = ARCHIVE_HEADER_SIZE + (long long)keepRecords * RECORD_SIZE;
+    fseek(file, 0, SEEK_END);
+    if (ftell(file) < keepBytes) {
+        close();
+        return false;
+    }
+    fflush(file);
+#ifdef _WIN32
+    bool truncated = _chsize_s(_fileno(file), keepBytes) == 0;
+#else
+    bool truncated = ftruncate(fileno(file), (off_t)keepBytes) == 0;
+#endif
+    if (!truncated || !mapping.open(path) || mapping.getSize() != keepBytes) {
+        close();
+        return false;
+    }
+    
+    const unsigned char* data = mapping.getData();
+    for (int i = 0; i < 4; i++) {
+        if (data[i] != ARCHIVE_MAGIC[i]) {
+            close();
+            return false;
+        }
+    }
+    if (getI32(data + 4) != ARCHIVE_VERSION) {
+        close();
+        return false;
+    }
+    
+    // One pass to rebuild the request-ID index and the analytics totals
+    mappedRecords = keepRecords;
+    HistoryNode node;
+    for (int r = 0; r < keepRecords; r++) {
+        decodeRecord(data + ARCHIVE_HEADER_SIZE + (long long)r * RECORD_SIZE, node);
+        indexRecord(node.request.getRequestID(), r);
+        totals.add(node, 1);
+    }
+    recordCount = keepRecords;
+    
+    fseek(file, 0, SEEK_END);
+    return true;
+}
+
+void HistoryArchive::close() {
+    mapping.close();
+    if (file != nullptr) {
+        fclose(file);
+        file = nullptr;
+    }
+    if (indexFile != nullptr) {
+        fclose(indexFile);
+        indexFile = nullptr;
+    }
+    mappedRecords = 0;
+    recordCount = 0;
+    totals = HistoryTotals();
+}
+
+bool HistoryArchive::isOpen() const {
+    return file != nullptr;
+}
+
+// An unnamed file, deleted when closed or when the process ends
+bool HistoryArchive::openIndex() {
+    indexFile = tmpfile();
+    indexWriteEnd = -1;
+    return indexFile != nullptr;
+}
+
+// A record number of -1 clears the request's entry
+void HistoryArchive::indexRecord(int requestID, int recordNumber) {
+    if (indexFile == nullptr || requestID < 0) {
+        return;
+    }
+    long long offset = (long long)requestID * 4;
+    if (offset != indexWriteEnd && fseek(indexFile, (long)offset, SEEK_SET) != 0) {
+        indexWriteEnd = -1;
+        return;
+    }
+    unsigned char entry[4];
+    putI32(entry, recordNumber + 1);
+    indexWriteEnd = (fwrite(entry, 1, 4, indexFile) == 4) ? offset + 4 : -1;
+}
+
+int HistoryArchive::lookupRecord(int requestID) {
+    if (indexFile == nullptr || requestID < 0) {
+        return -1;
+    }
+    indexWriteEnd = -1;
+    unsigned char entry[4];
+    if (fseek(indexFile, (long)((long long)requestID * 4), SEEK_SET) != 0 || fread(entry, 1, 4, indexFile) != 4) {
+        return -1;
+    }
+    return getI32(entry) - 1;
+}
+
+void HistoryTotals::add(const HistoryNode& node, int direction) {
+    entries += direction;
+    if (node.request.getState() == RELEASED && node.releaseTime != -1) {
+        completed += direction;
+        totalDuration += direction * (node.releaseTime - node.allocatedTime);
+    }
+    if (node.request.getState() == CANCELLED) {
+        cancelled += direction;
+    }
+    if (node.isCrossZone) {
+        crossZone += direction;
+    }
+}
+
+void HistoryTotals::add(const HistoryTotals& other, int direction) {
+    entries += direction * other.entries;
+    completed += direction * other.completed;
+    cancelled += direction * other.cancelled;
+    crossZone += direction * other.crossZone;
+    totalDuration += direction * other.totalDuration;
+}
+
+// Record layout (little-endian):
+//   [0] requestID [4] requestedZone [8] requestTime [12] slotID [16] zoneID
+//   [20] releaseTime [24] state [25] priority [26] crossZone [27] id length
+//   [28] charge [32..63] vehicle ID, truncated to MAX_VEHICLE_ID bytes
+//   [64] allocatedTime [68..71] unused
+bool HistoryArchive::append(const HistoryNode& node) {
+    if (file == nullptr) {
+        return false;
+    }
+    
+    unsigned char record[RECORD_SIZE];
+    for (int i = 0; i < RECORD_SIZE; i++) {
+        record[i] = 0;
+    }
+    putI32(record, node.request.getRequestID());
+    putI32(record + 4, node.request.getRequestedZone());
+    putI32(record + 8, node.request.getRequestTime());
+    putI32(record + 12, node.allocatedSlotID);
+    putI32(record + 16, node.allocatedZoneID);
+    putI32(record + 20, node.releaseTime);
+    record[24] = (unsigned char)node.request.getState();
+    record[25] = (unsigned char)node.request.getPriority();
+    record[26] = node.isCrossZone ? 1 : 0;
+    
+    string vehicleID = node.request.getVehicleID();
+    int idLength = (int)vehicleID.length();
+    if (idLength > MAX_VEHICLE_ID) {
+        idLength = MAX_VEHICLE_ID;
+    }
+    record[27] = (unsigned char)idLength;
+    putI32(record + 28, node.charge);
+    for (int i = 0; i < idLength; i++) {
+        record[32 + i] = (unsigned char)vehicleID[i];
+    }
+    putI32(record + 64, node.allocatedTime);
+    
+    if (fwrite(record, 1, RECORD_SIZE, file) != RECORD_SIZE) {
+        return false;
+    }
+    indexRecord(node.request.getRequestID(), recordCount);
+    totals.add(node, 1);
+    recordCount++;
+    return true;
+}
+
+bool HistoryArchive::decodeRecord(const unsigned char* record, HistoryNode& out) const {
+    int idLength = record[27];
+    if (idLength > MAX_VEHICLE_ID) {
+        return false;
+    }
+    out.request = ParkingRequest(getI32(record), string((const char*)(record + 32), idLength),
+                                 getI32(record + 4), getI32(record + 8), (PriorityClass)record[25]);
+    out.request.restoreState((RequestState)record[24]);
+    out.allocatedSlotID = getI32(record + 12);
+    out.allocatedZoneID = getI32(record + 16);
+    out.allocatedTime = getI32(record + 64);
+    out.releaseTime = getI32(record + 20);
+    out.charge = getI32(record + 28);
+    out.isCrossZone = (record[26] != 0);
+    out.prev = nullptr;
+    out.next = nullptr;
+    return true;
+}
+
+// Records appended since the file was last mapped are still in the stdio
+// buffer, so they are flushed and the mapping refreshed on demand
+bool HistoryArchive::readRecord(int recordNumber, HistoryNode& out) {
+    if (file == nullptr || recordNumber < 0 || recordNumber >= recordCount) {
+        return false;
+    }
+    if (recordNumber >= mappedRecords) {
+        if (fflush(file) != 0 || !mapping.open(path)) {
+            return false;
+        }
+        mappedRecords = (int)((mapping.getSize() - ARCHIVE_HEADER_SIZE) / RECORD_SIZE);
+        if (recordNumber >= mappedRecords) {
+            return false;
+        }
+    }
+    return decodeRecord(mapping.getData() + ARCHIVE_HEADER_SIZE + (long long)recordNumber * RECORD_SIZE, out);
+}
+
+// The mapping is dropped before the file shrinks under it and re-made on
+// the next read
+bool HistoryArchive::removeLast(HistoryNode& out) {
+    if (!readRecord(recordCount - 1, out)) {
+        return false;
+    }
+    mapping.close();
+    mappedRecords = 0;
+    long long keepBytes = ARCHIVE_HEADER_SIZE + (long long)(recordCount - 1) * RECORD_SIZE;
+    fflush(file);
+#ifdef _WIN32
+    bool truncated = _chsize_s(_fileno(file), keepBytes) == 0;
+#else
+    bool truncated = ftruncate(fileno(file), (off_t)keepBytes) == 0;
+#endif
+    if (!truncated) {
+        return false;
+    }
+    fseek(file, 0, SEEK_END);
+    
+    int requestID = out.request.getRequestID();
+    if (lookupRecord(requestID) == recordCount - 1) {
+        indexRecord(requestID, -1);
+    }
+    totals.add(out, -1);
+    recordCount--;
+    return true;
+}
+
+bool HistoryArchive::sync() {
+    if (file == nullptr || fflush(file) != 0) {
+        return false;
+    }
+#ifdef _WIN32
+    return _commit(_fileno(file)) == 0;
+#else
+    return fsync(fileno(file)) == 0;
+#endif
+}
+
+bool HistoryArchive::find(int requestID, HistoryNode& out) {
+    int recordNumber = lookupRecord(requestID);
+    return recordNumber != -1 && readRecord(recordNumber, out);
+}
+
+const string& HistoryArchive::getPath() const {
+    return path;
+}
+
+int HistoryArchive::getRecordCount() const {
+    return recordCount;
+}
+
+const HistoryTotals& HistoryArchive::getTotals() const {
+    return totals;
+}
+
+int HistoryArchive::getCompletedCount() const {
+    return totals.completed;
+}
+
+int HistoryArchive::getCancelledCount() const {
+    return totals.cancelled;
+}
+
+int HistoryArchive::getCrossZoneCount() const {
+    return totals.crossZone;
+}
+
+long long HistoryArchive::getTotalDuration() const {
+    return totals.totalDuration;
+}
\ No newline at end of file
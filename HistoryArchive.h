@@ -0,0 +1,129 @@
+#ifndef HISTORYARCHIVE_H
+#define HISTORYARCHIVE_H
+
+#include "ParkingRequest.h"
+#include "MappedFile.h"
+#include <cstdio>
+#include <string>
+using namespace std;
+
+struct HistoryNode {
+    ParkingRequest request;
+    int allocatedSlotID;
+    int allocatedZoneID;
+    // When the slot was actually handed over; later than the request time
+    // for a request that waited on the waitlist. Stays, charges and
+    // durations run from here
+    int allocatedTime;
+    int releaseTime;
+    int charge;
+    bool isCrossZone;
+    HistoryNode* prev;
+    HistoryNode* next;
+    
+    HistoryNode() {
+        allocatedSlotID = -1;
+        allocatedZoneID = -1;
+        allocatedTime = -1;
+        releaseTime = -1;
+        charge = 0;
+        isCrossZone = false;
+        prev = nullptr;
+        next = nullptr;
+    }
+    
+    HistoryNode(const ParkingRequest& req, int slotID, int zoneID, bool crossZone) {
+        request = req;
+        allocatedSlotID = slotID;
+        allocatedZoneID = zoneID;
+        allocatedTime = req.getRequestTime();
+        releaseTime = -1;
+        charge = 0;
+        isCrossZone = crossZone;
+        prev = nullptr;
+        next = nullptr;
+    }
+};
+
+// Running analytics totals over a set of history entries; a direction of
+// -1 takes an entry (or another set) back out
+struct HistoryTotals {
+    int entries;
+    int completed;
+    int cancelled;
+    int crossZone;
+    long long totalDuration;
+    
+    HistoryTotals() {
+        entries = 0;
+        completed = 0;
+        cancelled = 0;
+        crossZone = 0;
+        totalDuration = 0;
+    }
+    
+    void add(const HistoryNode& node, int direction);
+    void add(const HistoryTotals& other, int direction);
+};
+
+// On-disk store for finished (released or cancelled) history entries.
+// Entries are appended as fixed-size records, so record i lives at a
+// known offset, and reads go through a memory mapping of the file.
+// Request IDs map to record numbers through an index kept on disk too: an
+// unnamed temporary file holding record number + 1 at offset 4 * request
+// ID (0, or a hole, for none). It needs no syncing, as reopen() rebuilds
+// it in the pass that recomputes the totals. The totals that
+// getAnalytics() needs are kept up to date on append, so archived entries
+// never have to be scanned to compute them. Vehicle IDs are stored
+// truncated to MAX_VEHICLE_ID (32) bytes.
+class HistoryArchive {
+private:
+    FILE* file;
+    string path;
+    MappedFile mapping;
+    int mappedRecords;
+    int recordCount;
+    
+    FILE* indexFile;
+    // Where the last index write ended, so consecutive request IDs are
+    // written without a seek; -1 after a read
+    long long indexWriteEnd;
+    
+    HistoryTotals totals;
+    
+    bool openIndex();
+    void indexRecord(int requestID, int recordNumber);
+    int lookupRecord(int requestID);
+    bool decodeRecord(const unsigned char* record, HistoryNode& out) const;
+
+public:
+    static const int RECORD_SIZE = 72;
+    static const int MAX_VEHICLE_ID = 32;
+    
+    HistoryArchive();
+    ~HistoryArchive();
+    
+    bool open(const string& path);
+    bool reopen(const string& path, int keepRecords);
+    void close();
+    bool isOpen() const;
+    
+    bool append(const HistoryNode& node);
+    // Flushes and fsyncs appended records, so a snapshot that records
+    // getRecordCount() never points past what is on disk
+    bool sync();
+    bool find(int requestID, HistoryNode& out);
+    bool readRecord(int recordNumber, HistoryNode& out);
+    // Takes the newest record back out of the archive (and its totals)
+    bool removeLast(HistoryNode& out);
+    
+    const string& getPath() const;
+    int getRecordCount() const;
+    const HistoryTotals& getTotals() const;
+    int getCompletedCount() const;
+    int getCancelledCount() const;
+    int getCrossZoneCount() const;
+    long long getTotalDuration() const;
+};
+
+#endif
\ No newline at end of file
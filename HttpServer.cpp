@@ -0,0 +1,654 @@
+#include "HttpServer.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+typedef int socklen_t;
+#define CLOSE_SOCKET closesocket
+#define WOULD_BLOCK (WSAGetLastError() == WSAEWOULDBLOCK)
+#define POLL_SOCKETS WSAPoll
+#define SEND_FLAGS 0
+#else
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/epoll.h>
+#endif
+#define CLOSE_SOCKET ::close
+#define WOULD_BLOCK (errno == EAGAIN || errno == EWOULDBLOCK)
+#define POLL_SOCKETS ::poll
+// A peer that hung up must not kill the process with SIGPIPE
+#ifdef MSG_NOSIGNAL
+#define SEND_FLAGS MSG_NOSIGNAL
+#else
+#define SEND_FLAGS 0
+#endif
+#endif
+
+static const size_t MAX_HEADER_SIZE = 64 * 1024;
+static const size_t MAX_BODY_SIZE = 1024 * 1024;
+static const int MAX_EVENTS = 256;
+
+static bool setNonBlocking(long long socket) {
+#ifdef _WIN32
+    u_long enabled = 1;
+    return ioctlsocket((SOCKET)socket, FIONBIO, &enabled) == 0;
+#else
+    int flags = fcntl((int)socket, F_GETFL, 0);
+    return flags != -1 && fcntl((int)socket, F_SETFL, flags | O_NONBLOCK) == 0;
+#endif
+}
+
+static char lowerCase(char c) {
+    return (c >= 'A' && c <= 'Z') ? (char)(c - 'A' + 'a') : c;
+}
+
+static bool equalsIgnoreCase(const string& a, const char* b) {
+    size_t length = strlen(b);
+    if (a.length() != length) {
+        return false;
+    }
+    for (size_t i = 0; i < length; i++) {
+        if (lowerCase(a[i]) != lowerCase(b[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static int hexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+static string urlDecode(const string& text, size_t start, size_t end) {
+    string decoded;
+    for (size_t i = start; i < end; i++) {
+        if (text[i] == '+') {
+            decoded += ' ';
+        } else if (text[i] == '%' && i + 2 < end && hexValue(text[i + 1]) != -1 && hexValue(text[i + 2]) != -1) {
+            decoded += (char)(hexValue(text[i + 1]) * 16 + hexValue(text[i + 2]));
+            i += 2;
+        } else {
+            decoded += text[i];
+        }
+    }
+    return decoded;
+}
+
+// Finds name in an "a=1&b=2" string
+static bool findParameter(const string& encoded, const string& name, string& valueOut) {
+    size_t start = 0;
+    while (start < encoded.length()) {
+        size_t end = encoded.find('&', start);
+        if (end == string::npos) {
+            end = encoded.length();
+        }
+        size_t equals = encoded.find('=', start);
+        size_t keyEnd = (equals != string::npos && equals < end) ? equals : end;
+        if (urlDecode(encoded, start, keyEnd) == name) {
+            valueOut = (keyEnd < end) ? urlDecode(encoded, keyEnd + 1, end) : "";
+            return true;
+        }
+        start = end + 1;
+    }
+    return false;
+}
+
+bool HttpRequest::getParameter(const string& name, string& valueOut) const {
+    if (findParameter(query, name, valueOut)) {
+        return true;
+    }
+    if (contentType.find("application/x-www-form-urlencoded") == 0) {
+        return findParameter(body, name, valueOut);
+    }
+    return false;
+}
+
+// Browsers send Origin on every cross-origin POST, including the simple
+// form posts that need no preflight; same-origin pages name this host
+bool HttpRequest::isCrossOrigin() const {
+    return !origin.empty() && origin != "http://" + host;
+}
+
+// A page whose domain was rebound to 127.0.0.1 is same-origin with itself,
+// so Origin cannot catch it; its Host still carries the attacker's name
+bool HttpRequest::hasLoopbackHost() const {
+    if (localPort == 0) {
+        return true;
+    }
+    char portSuffix[8];
+    snprintf(portSuffix, sizeof(portSuffix), ":%d", localPort);
+    if (host == string("localhost") + portSuffix || host == string("127.0.0.1") + portSuffix) {
+        return true;
+    }
+    return localPort == 80 && (host == "localhost" || host == "127.0.0.1");
+}
+
+const char* HttpServer::getStatusText(int status) {
+    switch (status) {
+        case 200: return "OK";
+        case 204: return "No Content";
+        case 400: return "Bad Request";
+        case 403: return "Forbidden";
+        case 404: return "Not Found";
+        case 405: return "Method Not Allowed";
+        case 409: return "Conflict";
+        case 411: return "Length Required";
+        case 413: return "Payload Too Large";
+        case 431: return "Request Header Fields Too Large";
+        case 500: return "Internal Server Error";
+        default: return "Unknown";
+    }
+}
+
+HttpServer::HttpServer(Handler handler, void* context) : stopRequested(false) {
+    this->handler = handler;
+    this->context = context;
+    listenSocket = -1;
+    port = 0;
+    requestsServed = 0;
+    connectionCapacity = 16;
+    connections = new HttpConnection[connectionCapacity];
+    connectionCount = 0;
+    subscriberCount = 0;
+    tickHandler = nullptr;
+    tickContext = nullptr;
+    tickIntervalMs = 0;
+#ifdef __linux__
+    epollDescriptor = -1;
+#endif
+#ifdef _WIN32
+    WSADATA data;
+    WSAStartup(MAKEWORD(2, 2), &data);
+#endif
+}
+
+HttpServer::~HttpServer() {
+    close();
+    delete[] connections;
+#ifdef _WIN32
+    WSACleanup();
+#endif
+}
+
+bool HttpServer::listen(int requestedPort) {
+    close();
+
+    long long socketHandle = (long long)socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+#ifdef _WIN32
+    if ((SOCKET)socketHandle == INVALID_SOCKET) {
+        return false;
+    }
+#else
+    if (socketHandle < 0) {
+        return false;
+    }
+#endif
+    int reuse = 1;
+    setsockopt(socketHandle, SOL_SOCKET, SO_REUSEADDR, (const char*)&reuse, sizeof(reuse));
+
+    sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons((unsigned short)requestedPort);
+
+    socklen_t length = sizeof(address);
+    if (bind(socketHandle, (sockaddr*)&address, sizeof(address)) != 0
+        || ::listen(socketHandle, SOMAXCONN) != 0
+        || !setNonBlocking(socketHandle)
+        || getsockname(socketHandle, (sockaddr*)&address, &length) != 0) {
+        CLOSE_SOCKET(socketHandle);
+        return false;
+    }
+    listenSocket = socketHandle;
+    port = ntohs(address.sin_port);
+
+#ifdef __linux__
+    epollDescriptor = epoll_create1(0);
+    epoll_event event;
+    event.events = EPOLLIN;
+    event.data.u32 = 0xFFFFFFFFu;
+    if (epollDescriptor == -1 || epoll_ctl(epollDescriptor, EPOLL_CTL_ADD, (int)listenSocket, &event) != 0) {
+        close();
+        return false;
+    }
+#endif
+    stopRequested = false;
+    return true;
+}
+
+void HttpServer::close() {
+    for (int i = 0; i < connectionCapacity; i++) {
+        if (connections[i].socket != -1) {
+            closeConnection(i);
+        }
+    }
+#ifdef __linux__
+    if (epollDescriptor != -1) {
+        ::close(epollDescriptor);
+        epollDescriptor = -1;
+    }
+#endif
+    if (listenSocket != -1) {
+        CLOSE_SOCKET(listenSocket);
+        listenSocket = -1;
+    }
+}
+
+int HttpServer::addConnection(long long socket) {
+    int index = -1;
+    for (int i = 0; i < connectionCapacity; i++) {
+        if (connections[i].socket == -1) {
+            index = i;
+            break;
+        }
+    }
+    if (index == -1) {
+        int newCapacity = connectionCapacity * 2;
+        HttpConnection* newConnections = new HttpConnection[newCapacity];
+        for (int i = 0; i < connectionCapacity; i++) {
+            newConnections[i] = connections[i];
+        }
+        delete[] connections;
+        connections = newConnections;
+        index = connectionCapacity;
+        connectionCapacity = newCapacity;
+    }
+    connections[index] = HttpConnection();
+    connections[index].socket = socket;
+    connectionCount++;
+    return index;
+}
+
+void HttpServer::closeConnection(int index) {
+    HttpConnection& connection = connections[index];
+#ifdef __linux__
+    if (epollDescriptor != -1) {
+        epoll_ctl(epollDescriptor, EPOLL_CTL_DEL, (int)connection.socket, nullptr);
+    }
+#endif
+    CLOSE_SOCKET(connection.socket);
+    if (connection.streaming) {
+        subscriberCount--;
+    }
+    connection = HttpConnection();
+    connectionCount--;
+}
+
+// Interest is read-only unless a response is waiting for the socket to
+// drain, so an idle keep-alive connection never wakes the loop
+void HttpServer::watchConnection(int index, bool add) {
+#ifdef __linux__
+    const HttpConnection& connection = connections[index];
+    epoll_event event;
+    event.events = EPOLLIN;
+    if (connection.outputOffset < connection.output.length()) {
+        event.events |= EPOLLOUT;
+    }
+    event.data.u32 = (unsigned int)index;
+    epoll_ctl(epollDescriptor, add ? EPOLL_CTL_ADD : EPOLL_CTL_MOD, (int)connection.socket, &event);
+#else
+    (void)index;
+    (void)add;
+#endif
+}
+
+void HttpServer::acceptConnections() {
+    while (true) {
+        long long socketHandle = (long long)accept(listenSocket, nullptr, nullptr);
+#ifdef _WIN32
+        if ((SOCKET)socketHandle == INVALID_SOCKET) {
+            return;
+        }
+#else
+        if (socketHandle < 0) {
+            return;
+        }
+#endif
+        int noDelay = 1;
+        setsockopt(socketHandle, IPPROTO_TCP, TCP_NODELAY, (const char*)&noDelay, sizeof(noDelay));
+        if (!setNonBlocking(socketHandle)) {
+            CLOSE_SOCKET(socketHandle);
+            continue;
+        }
+        watchConnection(addConnection(socketHandle), true);
+    }
+}
+
+// Returns false once the connection is gone
+bool HttpServer::readConnection(int index) {
+    char buffer[16384];
+    while (true) {
+        int received = (int)recv(connections[index].socket, buffer, sizeof(buffer), 0);
+        if (received > 0) {
+            connections[index].input.append(buffer, received);
+            if (received < (int)sizeof(buffer)) {
+                break;
+            }
+        } else if (received < 0 && WOULD_BLOCK) {
+            break;
+        } else {
+            closeConnection(index);
+            return false;
+        }
+    }
+    // Subscribers have nothing more to say; only their hang-up matters
+    if (connections[index].streaming) {
+        connections[index].input.clear();
+    } else {
+        processInput(index);
+    }
+    return writeConnection(index);
+}
+
+bool HttpServer::writeConnection(int index) {
+    HttpConnection& connection = connections[index];
+    bool hadOutput = connection.outputOffset < connection.output.length();
+    while (connection.outputOffset < connection.output.length()) {
+        int sent = (int)send(connection.socket, connection.output.data() + connection.outputOffset,
+                             (int)(connection.output.length() - connection.outputOffset), SEND_FLAGS);
+        if (sent > 0) {
+            connection.outputOffset += sent;
+        } else if (sent < 0 && WOULD_BLOCK) {
+            watchConnection(index, false);
+            return true;
+        } else {
+            closeConnection(index);
+            return false;
+        }
+    }
+    connection.output.clear();
+    connection.outputOffset = 0;
+    if (connection.closeAfterWrite) {
+        closeConnection(index);
+        return false;
+    }
+    if (hadOutput) {
+        watchConnection(index, false);
+    }
+    return true;
+}
+
+// Answers every complete request in the input buffer, in order
+void HttpServer::processInput(int index) {
+    HttpConnection& connection = connections[index];
+    size_t consumed = 0;
+
+    while (!connection.closeAfterWrite) {
+        size_t headerEnd = connection.input.find("\r\n\r\n", consumed);
+        HttpResponse response;
+        HttpRequest request;
+        request.localPort = port;
+        size_t requestEnd = 0;
+
+        if (headerEnd == string::npos) {
+            if (connection.input.length() - consumed > MAX_HEADER_SIZE) {
+                response.status = 431;
+                request.keepAlive = false;
+            } else {
+                break;
+            }
+        } else {
+            // Request line: METHOD SP target SP version
+            size_t lineEnd = connection.input.find("\r\n", consumed);
+            string line = connection.input.substr(consumed, lineEnd - consumed);
+            size_t firstSpace = line.find(' ');
+            size_t secondSpace = (firstSpace == string::npos) ? string::npos : line.find(' ', firstSpace + 1);
+            size_t contentLength = 0;
+            bool chunked = false;
+
+            if (secondSpace == string::npos) {
+                response.status = 400;
+                request.keepAlive = false;
+            } else {
+                request.method = line.substr(0, firstSpace);
+                string target = line.substr(firstSpace + 1, secondSpace - firstSpace - 1);
+                size_t question = target.find('?');
+                request.path = target.substr(0, question);
+                request.query = (question == string::npos) ? "" : target.substr(question + 1);
+                request.keepAlive = (line.compare(secondSpace + 1, string::npos, "HTTP/1.0") != 0);
+
+                size_t cursor = lineEnd + 2;
+                while (cursor < headerEnd) {
+                    size_t end = connection.input.find("\r\n", cursor);
+                    size_t colon = connection.input.find(':', cursor);
+                    if (colon != string::npos && colon < end) {
+                        string name = connection.input.substr(cursor, colon - cursor);
+                        size_t valueStart = colon + 1;
+                        while (valueStart < end && connection.input[valueStart] == ' ') {
+                            valueStart++;
+                        }
+                        string value = connection.input.substr(valueStart, end - valueStart);
+                        if (equalsIgnoreCase(name, "content-length")) {
+                            contentLength = (size_t)strtoul(value.c_str(), nullptr, 10);
+                        } else if (equalsIgnoreCase(name, "content-type")) {
+                            request.contentType = value;
+                        } else if (equalsIgnoreCase(name, "host")) {
+                            request.host = value;
+                        } else if (equalsIgnoreCase(name, "origin")) {
+                            request.origin = value;
+                        } else if (equalsIgnoreCase(name, "transfer-encoding")) {
+                            chunked = true;
+                        } else if (equalsIgnoreCase(name, "connection")) {
+                            if (equalsIgnoreCase(value, "close")) {
+                                request.keepAlive = false;
+                            } else if (equalsIgnoreCase(value, "keep-alive")) {
+                                request.keepAlive = true;
+                            }
+                        }
+                    }
+                    cursor = end + 2;
+                }
+
+                if (chunked) {
+                    response.status = 411;
+                    request.keepAlive = false;
+                } else if (contentLength > MAX_BODY_SIZE) {
+                    response.status = 413;
+                    request.keepAlive = false;
+                } else if (connection.input.length() < headerEnd + 4 + contentLength) {
+                    break;
+                } else {
+                    request.body = connection.input.substr(headerEnd + 4, contentLength);
+                    requestEnd = headerEnd + 4 + contentLength;
+                }
+            }
+        }
+
+        if (requestEnd > 0) {
+            consumed = requestEnd;
+            handler(request, response, context);
+        }
+        requestsServed++;
+
+        if (response.streaming && response.status == 200) {
+            if (tickHandler != nullptr) {
+                tickHandler(*this, tickContext);
+            }
+            connection.output += "HTTP/1.1 200 OK\r\nContent-Type: text/event-stream\r\n"
+                                 "Cache-Control: no-cache\r\nConnection: keep-alive\r\n\r\n";
+            connection.output += response.body;
+            connection.streaming = true;
+            subscriberCount++;
+            consumed = connection.input.length();
+            break;
+        }
+
+        char header[256];
+        snprintf(header, sizeof(header),
+                 "HTTP/1.1 %d %s\r\nContent-Type: %s\r\nContent-Length: %u\r\n"
+                 "Connection: %s\r\n\r\n",
+                 response.status, getStatusText(response.status), response.contentType.c_str(),
+                 (unsigned int)response.body.length(), request.keepAlive ? "keep-alive" : "close");
+        connection.output += header;
+        connection.output += response.body;
+        if (!request.keepAlive) {
+            connection.closeAfterWrite = true;
+        }
+    }
+
+    if (consumed > 0) {
+        connection.input.erase(0, consumed);
+    }
+}
+
+bool HttpServer::poll(int timeoutMs) {
+    if (listenSocket == -1) {
+        return false;
+    }
+
+#ifdef __linux__
+    epoll_event events[MAX_EVENTS];
+    int ready = epoll_wait(epollDescriptor, events, MAX_EVENTS, timeoutMs);
+    for (int i = 0; i < ready; i++) {
+        unsigned int index = events[i].data.u32;
+        if (index == 0xFFFFFFFFu) {
+            acceptConnections();
+            continue;
+        }
+        if (connections[index].socket == -1) {
+            continue;
+        }
+        if (events[i].events & (EPOLLERR | EPOLLHUP)) {
+            if (!(events[i].events & EPOLLIN)) {
+                closeConnection(index);
+                continue;
+            }
+        }
+        if (events[i].events & EPOLLIN) {
+            if (!readConnection(index)) {
+                continue;
+            }
+        }
+        if (events[i].events & EPOLLOUT) {
+            writeConnection(index);
+        }
+    }
+    return ready >= 0;
+#else
+    // One pollfd per descriptor, rebuilt each call; slot 0 is the listener
+    pollfd* descriptors = new pollfd[connectionCount + 1];
+    int* owners = new int[connectionCount + 1];
+    int count = 0;
+    descriptors[count].fd = listenSocket;
+    descriptors[count].events = POLLIN;
+    owners[count++] = -1;
+    for (int i = 0; i < connectionCapacity && count <= connectionCount; i++) {
+        if (connections[i].socket != -1) {
+            descriptors[count].fd = connections[i].socket;
+            descriptors[count].events = POLLIN;
+            if (connections[i].outputOffset < connections[i].output.length()) {
+                descriptors[count].events |= POLLOUT;
+            }
+            owners[count++] = i;
+        }
+    }
+
+    int ready = POLL_SOCKETS(descriptors, count, timeoutMs);
+    for (int i = 0; ready > 0 && i < count; i++) {
+        short revents = descriptors[i].revents;
+        if (revents == 0) {
+            continue;
+        }
+        if (owners[i] == -1) {
+            acceptConnections();
+            continue;
+        }
+        int index = owners[i];
+        if (revents & (POLLIN | POLLHUP | POLLERR)) {
+            if (!readConnection(index)) {
+                continue;
+            }
+        }
+        if (revents & POLLOUT) {
+            writeConnection(index);
+        }
+    }
+    delete[] descriptors;
+    delete[] owners;
+    return ready >= 0;
+#endif
+}
+
+void HttpServer::run() {
+    chrono::steady_clock::time_point nextTick = chrono::steady_clock::now()
+                                              + chrono::milliseconds(tickIntervalMs);
+    while (!stopRequested) {
+        int timeout = 100;
+        if (tickHandler != nullptr) {
+            long long untilTick = chrono::duration_cast<chrono::milliseconds>(
+                nextTick - chrono::steady_clock::now()).count();
+            timeout = (untilTick < 0) ? 0 : (untilTick < timeout ? (int)untilTick : timeout);
+        }
+        if (!poll(timeout)) {
+            break;
+        }
+        if (tickHandler != nullptr && chrono::steady_clock::now() >= nextTick) {
+            tickHandler(*this, tickContext);
+            nextTick = chrono::steady_clock::now() + chrono::milliseconds(tickIntervalMs);
+        }
+    }
+}
+
+void HttpServer::setTickHandler(TickHandler tick, void* context, int intervalMs) {
+    tickHandler = tick;
+    tickContext = context;
+    tickIntervalMs = (intervalMs > 0) ? intervalMs : 1;
+}
+
+int HttpServer::broadcast(const string& data) {
+    int delivered = 0;
+    for (int i = 0; i < connectionCapacity && delivered < subscriberCount; i++) {
+        HttpConnection& connection = connections[i];
+        if (connection.socket == -1 || !connection.streaming) {
+            continue;
+        }
+        if (connection.output.length() - connection.outputOffset > MAX_STREAM_BACKLOG) {
+            closeConnection(i);
+            continue;
+        }
+        if (connection.outputOffset > 0) {
+            connection.output.erase(0, connection.outputOffset);
+            connection.outputOffset = 0;
+        }
+        connection.output += data;
+        if (writeConnection(i)) {
+            delivered++;
+        }
+    }
+    return delivered;
+}
+
+void HttpServer::stop() {
+    stopRequested = true;
+}
+
+int HttpServer::getPort() const {
+    return port;
+}
+
+int HttpServer::getConnectionCount() const {
+    return connectionCount;
+}
+
+int HttpServer::getSubscriberCount() const {
+    return subscriberCount;
+}
+
+long long HttpServer::getRequestsServed() const {
+    return requestsServed;
+}
\ No newline at end of file
@@ -0,0 +1,140 @@
+#ifndef HTTPSERVER_H
+#define HTTPSERVER_H
+
+#include <atomic>
+#include <string>
+using namespace std;
+
+struct HttpRequest {
+    string method;
+    string path;
+    string query;
+    string body;
+    string contentType;
+    string host;
+    string origin;
+    // Port the server received this on; 0 for a request built in-process
+    int localPort;
+    bool keepAlive;
+
+    HttpRequest() {
+        localPort = 0;
+        keepAlive = true;
+    }
+
+    // Looks a name up in the query string, then in a form-encoded body
+    bool getParameter(const string& name, string& valueOut) const;
+    // True when a browser sent this from a page on another origin
+    bool isCrossOrigin() const;
+    // True when Host names this server as localhost or 127.0.0.1 on the
+    // port it was received on (or comes from no port at all)
+    bool hasLoopbackHost() const;
+};
+
+// A streaming response is sent as text/event-stream without a length;
+// the body is its first event and the connection then receives every
+// HttpServer::broadcast()
+struct HttpResponse {
+    int status;
+    string contentType;
+    string body;
+    bool streaming;
+
+    HttpResponse() {
+        status = 200;
+        contentType = "application/json";
+        streaming = false;
+    }
+};
+
+struct HttpConnection {
+    long long socket;
+    string input;
+    string output;
+    size_t outputOffset;
+    bool closeAfterWrite;
+    bool streaming;
+
+    HttpConnection() {
+        socket = -1;
+        outputOffset = 0;
+        closeAfterWrite = false;
+        streaming = false;
+    }
+};
+
+// Single-threaded, event-driven HTTP/1.1 server on the loopback interface.
+// Sockets are non-blocking and multiplexed with epoll on Linux (poll or
+// WSAPoll elsewhere). Connections are kept alive, and every complete
+// request already buffered on a connection is answered in order, so
+// pipelined clients get one write for a whole batch. The handler runs on
+// the loop thread, which makes it safe to call into a ParkingSystem.
+class HttpServer {
+public:
+    typedef void (*Handler)(const HttpRequest& request, HttpResponse& response, void* context);
+    typedef void (*TickHandler)(HttpServer& server, void* context);
+
+private:
+    Handler handler;
+    void* context;
+    long long listenSocket;
+    int port;
+    atomic<bool> stopRequested;
+    long long requestsServed;
+
+    HttpConnection* connections;
+    int connectionCapacity;
+    int connectionCount;
+    int subscriberCount;
+
+    TickHandler tickHandler;
+    void* tickContext;
+    int tickIntervalMs;
+#ifdef __linux__
+    int epollDescriptor;
+#endif
+
+    int addConnection(long long socket);
+    void closeConnection(int index);
+    void acceptConnections();
+    bool readConnection(int index);
+    bool writeConnection(int index);
+    void processInput(int index);
+    void watchConnection(int index, bool add);
+
+    HttpServer(const HttpServer&);
+    HttpServer& operator=(const HttpServer&);
+
+public:
+    HttpServer(Handler handler, void* context);
+    ~HttpServer();
+
+    // Port 0 picks a free port, see getPort()
+    bool listen(int port);
+    // Waits up to timeoutMs for socket activity and handles it
+    bool poll(int timeoutMs);
+    // Runs the loop until stop() is called (from any thread)
+    void run();
+    void stop();
+    void close();
+
+    // run() calls the tick handler every intervalMs on the loop thread;
+    // it also runs just before a new stream subscriber is attached, so
+    // anything pending is published to the existing ones first
+    void setTickHandler(TickHandler tick, void* context, int intervalMs);
+    // Queues the same bytes on every streaming connection. A subscriber
+    // more than MAX_STREAM_BACKLOG bytes behind is disconnected instead
+    // of buffering without bound; it reconnects to a fresh snapshot.
+    int broadcast(const string& data);
+
+    int getPort() const;
+    int getConnectionCount() const;
+    int getSubscriberCount() const;
+    long long getRequestsServed() const;
+
+    static const size_t MAX_STREAM_BACKLOG = 1024 * 1024;
+
+    static const char* getStatusText(int status);
+};
+
+#endif
\ No newline at end of file
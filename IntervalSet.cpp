@@ -0,0 +1,139 @@
+#include "IntervalSet.h"
+
+IntervalSet::IntervalSet() {
+    starts = nullptr;
+    ends = nullptr;
+    owners = nullptr;
+    count = 0;
+    capacity = 0;
+}
+
+IntervalSet::~IntervalSet() {
+    delete[] starts;
+    delete[] ends;
+    delete[] owners;
+}
+
+IntervalSet::IntervalSet(const IntervalSet& other) {
+    count = other.count;
+    capacity = other.capacity;
+    starts = nullptr;
+    ends = nullptr;
+    owners = nullptr;
+
+    if (capacity > 0) {
+        starts = new int[capacity];
+        ends = new int[capacity];
+        owners = new int[capacity];
+        for (int i = 0; i < count; i++) {
+            starts[i] = other.starts[i];
+            ends[i] = other.ends[i];
+            owners[i] = other.owners[i];
+        }
+    }
+}
+
+IntervalSet& IntervalSet::operator=(const IntervalSet& other) {
+    if (this != &other) {
+        delete[] starts;
+        delete[] ends;
+        delete[] owners;
+
+        count = other.count;
+        capacity = other.capacity;
+        starts = nullptr;
+        ends = nullptr;
+        owners = nullptr;
+
+        if (capacity > 0) {
+            starts = new int[capacity];
+            ends = new int[capacity];
+            owners = new int[capacity];
+            for (int i = 0; i < count; i++) {
+                starts[i] = other.starts[i];
+                ends[i] = other.ends[i];
+                owners[i] = other.owners[i];
+            }
+        }
+    }
+    return *this;
+}
+
+int IntervalSet::firstEndingAfter(int time) const {
+    int low = 0;
+    int high = count;
+    while (low < high) {
+        int mid = (low + high) / 2;
+        if (ends[mid] > time) {
+            high = mid;
+        } else {
+            low = mid + 1;
+        }
+    }
+    return low;
+}
+
+void IntervalSet::grow() {
+    int newCapacity = (capacity == 0) ? 4 : capacity * 2;
+    int* newStarts = new int[newCapacity];
+    int* newEnds = new int[newCapacity];
+    int* newOwners = new int[newCapacity];
+    for (int i = 0; i < count; i++) {
+        newStarts[i] = starts[i];
+        newEnds[i] = ends[i];
+        newOwners[i] = owners[i];
+    }
+    delete[] starts;
+    delete[] ends;
+    delete[] owners;
+    starts = newStarts;
+    ends = newEnds;
+    owners = newOwners;
+    capacity = newCapacity;
+}
+
+bool IntervalSet::overlaps(int start, int end) const {
+    int i = firstEndingAfter(start);
+    return i < count && starts[i] < end;
+}
+
+bool IntervalSet::insert(int start, int end, int ownerID) {
+    if (end <= start || overlaps(start, end)) {
+        return false;
+    }
+
+    if (count >= capacity) {
+        grow();
+    }
+
+    int position = firstEndingAfter(start);
+    for (int i = count; i > position; i--) {
+        starts[i] = starts[i - 1];
+        ends[i] = ends[i - 1];
+        owners[i] = owners[i - 1];
+    }
+    starts[position] = start;
+    ends[position] = end;
+    owners[position] = ownerID;
+    count++;
+    return true;
+}
+
+bool IntervalSet::remove(int start, int ownerID) {
+    int position = firstEndingAfter(start);
+    if (position >= count || starts[position] != start || owners[position] != ownerID) {
+        return false;
+    }
+
+    for (int i = position; i < count - 1; i++) {
+        starts[i] = starts[i + 1];
+        ends[i] = ends[i + 1];
+        owners[i] = owners[i + 1];
+    }
+    count--;
+    return true;
+}
+
+int IntervalSet::getCount() const {
+    return count;
+}
\ No newline at end of file
@@ -0,0 +1,33 @@
+#ifndef INTERVALSET_H
+#define INTERVALSET_H
+
+// Sorted set of non-overlapping half-open time windows [start, end).
+// Windows are kept in start order in a growable array; because they never
+// overlap their ends are sorted too, so an overlap test is one binary
+// search.
+class IntervalSet {
+private:
+    int* starts;
+    int* ends;
+    int* owners;
+    int count;
+    int capacity;
+
+    int firstEndingAfter(int time) const;
+    void grow();
+
+public:
+    IntervalSet();
+    ~IntervalSet();
+
+    IntervalSet(const IntervalSet& other);
+    IntervalSet& operator=(const IntervalSet& other);
+
+    bool overlaps(int start, int end) const;
+    bool insert(int start, int end, int ownerID);
+    bool remove(int start, int ownerID);
+
+    int getCount() const;
+};
+
+#endif
\ No newline at end of file
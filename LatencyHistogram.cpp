@@ -0,0 +1,110 @@
+#include "LatencyHistogram.h"
+
+LatencyHistogram::LatencyHistogram() {
+    clear();
+}
+
+void LatencyHistogram::clear() {
+    for (int i = 0; i < BUCKET_COUNT; i++) {
+        counts[i] = 0;
+    }
+    totalCount = 0;
+    minValue = 0;
+    maxValue = 0;
+    sum = 0.0;
+}
+
+int LatencyHistogram::bucketFor(long long value) {
+    if (value < SUB_BUCKETS) {
+        return (value < 0) ? 0 : (int)value;
+    }
+    int highestBit = 0;
+    while ((value >> (highestBit + 1)) != 0) {
+        highestBit++;
+    }
+    // Keep the four bits below the highest one as the sub-bucket
+    int shift = highestBit - 4;
+    int sub = (int)((value >> shift) & (SUB_BUCKETS - 1));
+    return (shift + 1) * SUB_BUCKETS + sub;
+}
+
+long long LatencyHistogram::bucketUpperBound(int bucket) {
+    if (bucket < SUB_BUCKETS) {
+        return bucket;
+    }
+    int shift = bucket / SUB_BUCKETS - 1;
+    unsigned long long sub = bucket % SUB_BUCKETS;
+    unsigned long long bound = ((SUB_BUCKETS + sub + 1) << shift) - 1;
+    // The top bucket's edge does not fit in a signed value
+    return (bound > 0x7FFFFFFFFFFFFFFFULL) ? 0x7FFFFFFFFFFFFFFFLL : (long long)bound;
+}
+
+void LatencyHistogram::record(long long nanoseconds) {
+    counts[bucketFor(nanoseconds)]++;
+    if (totalCount == 0 || nanoseconds < minValue) {
+        minValue = nanoseconds;
+    }
+    if (totalCount == 0 || nanoseconds > maxValue) {
+        maxValue = nanoseconds;
+    }
+    totalCount++;
+    sum += (double)nanoseconds;
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+    if (other.totalCount == 0) {
+        return;
+    }
+    for (int i = 0; i < BUCKET_COUNT; i++) {
+        counts[i] += other.counts[i];
+    }
+    if (totalCount == 0 || other.minValue < minValue) {
+        minValue = other.minValue;
+    }
+    if (totalCount == 0 || other.maxValue > maxValue) {
+        maxValue = other.maxValue;
+    }
+    totalCount += other.totalCount;
+    sum += other.sum;
+}
+
+long long LatencyHistogram::getCount() const {
+    return totalCount;
+}
+
+long long LatencyHistogram::getMin() const {
+    return minValue;
+}
+
+long long LatencyHistogram::getMax() const {
+    return maxValue;
+}
+
+double LatencyHistogram::getMean() const {
+    return (totalCount > 0) ? sum / totalCount : 0.0;
+}
+
+// Upper edge of the bucket holding the given percentile (0-100), capped at
+// the largest value actually recorded
+long long LatencyHistogram::getPercentile(double percentile) const {
+    if (totalCount == 0) {
+        return 0;
+    }
+    long long target = (long long)(percentile / 100.0 * totalCount + 0.5);
+    if (target < 1) {
+        target = 1;
+    }
+    if (target > totalCount) {
+        target = totalCount;
+    }
+
+    long long seen = 0;
+    for (int i = 0; i < BUCKET_COUNT; i++) {
+        seen += counts[i];
+        if (seen >= target) {
+            long long bound = bucketUpperBound(i);
+            return (bound < maxValue) ? bound : maxValue;
+        }
+    }
+    return maxValue;
+}
\ No newline at end of file
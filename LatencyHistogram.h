@@ -0,0 +1,36 @@
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+
+// Log-linear histogram of latencies in nanoseconds. Values below 16 get
+// their own bucket; above that each power of two is split into 16 equal
+// buckets, so any recorded value is known to within 1/16 (~6%) while the
+// whole range of a long long fits in under a thousand counters.
+class LatencyHistogram {
+private:
+    static const int SUB_BUCKETS = 16;
+    static const int BUCKET_COUNT = 60 * SUB_BUCKETS;
+
+    long long counts[BUCKET_COUNT];
+    long long totalCount;
+    long long minValue;
+    long long maxValue;
+    double sum;
+
+    static int bucketFor(long long value);
+    static long long bucketUpperBound(int bucket);
+
+public:
+    LatencyHistogram();
+
+    void record(long long nanoseconds);
+    void merge(const LatencyHistogram& other);
+    void clear();
+
+    long long getCount() const;
+    long long getMin() const;
+    long long getMax() const;
+    double getMean() const;
+    long long getPercentile(double percentile) const;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,210 @@
+#include "LayoutLoader.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+static const int MAX_LINE_LENGTH = 1024;
+
+// Splits off the next whitespace-separated token, or returns nullptr at
+// the end of the line
+char* LayoutLoader::nextToken(char*& cursor) {
+    while (*cursor == ' ' || *cursor == '\t' || *cursor == '\r' || *cursor == '\n') {
+        cursor++;
+    }
+    if (*cursor == '\0') {
+        return nullptr;
+    }
+    char* token = cursor;
+    while (*cursor != '\0' && *cursor != ' ' && *cursor != '\t' && *cursor != '\r' && *cursor != '\n') {
+        cursor++;
+    }
+    if (*cursor != '\0') {
+        *cursor++ = '\0';
+    }
+    return token;
+}
+
+bool LayoutLoader::toInt(const char* token, int& value) {
+    if (token == nullptr) {
+        return false;
+    }
+    char* end = nullptr;
+    long parsed = strtol(token, &end, 10);
+    if (end == token || *end != '\0') {
+        return false;
+    }
+    value = (int)parsed;
+    return true;
+}
+
+bool LayoutLoader::parseInt(char*& cursor, int& value) {
+    return toInt(nextToken(cursor), value);
+}
+
+int LayoutLoader::parseAttribute(const char* token) {
+    if (strcmp(token, "ev") == 0) {
+        return SLOT_EV_CHARGER;
+    }
+    if (strcmp(token, "accessible") == 0) {
+        return SLOT_ACCESSIBLE;
+    }
+    if (strcmp(token, "covered") == 0) {
+        return SLOT_COVERED;
+    }
+    if (strcmp(token, "oversized") == 0) {
+        return SLOT_OVERSIZED;
+    }
+    return -1;
+}
+
+ParkingSystem* LayoutLoader::load(const string& path, string& errorOut) {
+    FILE* in = fopen(path.c_str(), "r");
+    if (in == nullptr) {
+        errorOut = "cannot open " + path;
+        return nullptr;
+    }
+
+    ParkingSystem* system = nullptr;
+    char line[MAX_LINE_LENGTH];
+    int lineNumber = 0;
+    int declaredZones = 0;
+    string error = "";
+
+    while (error.empty() && fgets(line, MAX_LINE_LENGTH, in) != nullptr) {
+        lineNumber++;
+        if (strchr(line, '\n') == nullptr && !feof(in)) {
+            error = "line longer than " + to_string(MAX_LINE_LENGTH - 2) + " characters";
+            break;
+        }
+        char* comment = strchr(line, '#');
+        if (comment != nullptr) {
+            *comment = '\0';
+        }
+
+        char* cursor = line;
+        char* directive = nextToken(cursor);
+        if (directive == nullptr) {
+            continue;
+        }
+
+        int a = 0, b = 0, c = 0, d = 0;
+        if (system == nullptr && strcmp(directive, "zones") != 0) {
+            error = "the first directive must be 'zones <count>'";
+        } else if (strcmp(directive, "zones") == 0) {
+            if (system != nullptr) {
+                error = "'zones' given twice";
+            } else if (!parseInt(cursor, a) || a <= 0) {
+                error = "expected a positive zone count";
+            } else {
+                system = new ParkingSystem(a);
+            }
+        } else if (strcmp(directive, "zone") == 0) {
+            if (!parseInt(cursor, a) || !parseInt(cursor, b) || b < 0) {
+                error = "expected 'zone <zoneID> <areaCount>'";
+            } else if (system->getZoneIndex(a) == -1 && declaredZones >= system->getZoneCount()) {
+                error = "more zones than declared by 'zones'";
+            } else {
+                if (system->getZoneIndex(a) == -1) {
+                    declaredZones++;
+                }
+                system->setupZone(a, b);
+            }
+        } else if (strcmp(directive, "area") == 0) {
+            if (!parseInt(cursor, a) || !parseInt(cursor, b) || !parseInt(cursor, c) || !parseInt(cursor, d)
+                || d < 0 || d > 1000) {
+                error = "expected 'area <zoneID> <areaIndex> <areaID> <capacity>' (capacity 0-1000)";
+            } else {
+                int zoneIndex = system->getZoneIndex(a);
+                if (zoneIndex == -1) {
+                    error = "area refers to undeclared zone " + to_string(a);
+                } else if (b < 0 || b >= system->getZones()[zoneIndex].getAreaCount()) {
+                    error = "area index out of range for zone " + to_string(a);
+                } else {
+                    system->setupParkingArea(a, b, c, d);
+                }
+            }
+        } else if (strcmp(directive, "adjacent") == 0) {
+            c = 1;
+            char* weight = nullptr;
+            if (!parseInt(cursor, a) || !parseInt(cursor, b)) {
+                error = "expected 'adjacent <zoneID> <zoneID> [weight]'";
+            } else if ((weight = nextToken(cursor)) != nullptr && (!toInt(weight, c) || c < 0)) {
+                error = "adjacency weight must be a non-negative integer";
+            } else if (system->getZoneIndex(a) == -1 || system->getZoneIndex(b) == -1) {
+                error = "adjacency refers to an undeclared zone";
+            } else {
+                system->addZoneAdjacency(a, b, c);
+            }
+        } else if (strcmp(directive, "attributes") == 0) {
+            if (!parseInt(cursor, a) || !parseInt(cursor, b) || !parseInt(cursor, c) || !parseInt(cursor, d)) {
+                error = "expected 'attributes <zoneID> <areaIndex> <firstSlot> <count> <flag>...'";
+            } else {
+                int mask = 0;
+                char* token = nextToken(cursor);
+                while (token != nullptr && error.empty()) {
+                    int flag = parseAttribute(token);
+                    if (flag == -1) {
+                        error = string("unknown slot attribute '") + token + "'";
+                    }
+                    mask |= flag;
+                    token = nextToken(cursor);
+                }
+                if (error.empty() && !system->setSlotAttributes(a, b, c, d, mask)) {
+                    error = "attributes refer to an undeclared zone or area";
+                }
+            }
+        } else if (strcmp(directive, "closed") == 0) {
+            if (!parseInt(cursor, a) || !parseInt(cursor, b)) {
+                error = "expected 'closed <zoneID> <areaIndex>'";
+            } else if (!system->setAreaOpen(a, b, false)) {
+                error = "closed refers to an undeclared zone or area";
+            }
+        } else if (strcmp(directive, "rate") == 0) {
+            if (!parseInt(cursor, a) || !parseInt(cursor, b) || b < 0) {
+                error = "expected 'rate <zoneID> <ratePerUnit>'";
+            } else if (!system->setZoneRate(a, b)) {
+                error = "rate refers to undeclared zone " + to_string(a);
+            }
+        } else if (strcmp(directive, "surcharge") == 0) {
+            if (!parseInt(cursor, a) || a < 0) {
+                error = "expected 'surcharge <amount>'";
+            } else {
+                system->setCrossZoneSurcharge(a);
+            }
+        } else if (strcmp(directive, "tariff") == 0) {
+            if (!parseInt(cursor, a) || !parseInt(cursor, b) || !system->configureTariff(a, b)) {
+                error = "expected 'tariff <dayLength> <revenueInterval>' (both positive)";
+            }
+        } else if (strcmp(directive, "band") == 0) {
+            if (!parseInt(cursor, a) || !parseInt(cursor, b) || !parseInt(cursor, c)) {
+                error = "expected 'band <start> <end> <percent>'";
+            } else if (!system->setTariffBand(a, b, c)) {
+                error = "band must lie within the tariff day, with start < end and percent >= 0";
+            }
+        } else if (strcmp(directive, "spillover") == 0) {
+            char* policy = nextToken(cursor);
+            if (policy != nullptr && strcmp(policy, "nearest") == 0) {
+                system->setSpilloverPolicy(SPILLOVER_NEAREST);
+            } else if (policy != nullptr && strcmp(policy, "balanced") == 0) {
+                system->setSpilloverPolicy(SPILLOVER_TWO_CHOICES);
+            } else {
+                error = "expected 'spillover nearest|balanced'";
+            }
+        } else {
+            error = string("unknown directive '") + directive + "'";
+        }
+    }
+
+    fclose(in);
+
+    if (error.empty() && system == nullptr) {
+        error = "layout declares no zones";
+        lineNumber = 0;
+    }
+    if (!error.empty()) {
+        errorOut = (lineNumber > 0) ? "line " + to_string(lineNumber) + ": " + error : error;
+        delete system;
+        return nullptr;
+    }
+    return system;
+}
\ No newline at end of file
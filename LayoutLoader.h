@@ -0,0 +1,38 @@
+#ifndef LAYOUTLOADER_H
+#define LAYOUTLOADER_H
+
+#include "ParkingSystem.h"
+#include <string>
+using namespace std;
+
+// Builds a ParkingSystem from a text layout file in a single streaming
+// pass. One directive per line; blank lines and text after '#' are ignored:
+//
+//   zones <count>                                  first directive, sizes the system
+//   zone <zoneID> <areaCount>
+//   area <zoneID> <areaIndex> <areaID> <capacity>
+//   adjacent <zoneID> <zoneID> [weight]            default weight 1
+//   attributes <zoneID> <areaIndex> <firstSlot> <count> <flag>...
+//   closed <zoneID> <areaIndex>                    skipped by allocation
+//   rate <zoneID> <ratePerUnit>                    default 10
+//   surcharge <amount>                             cross-zone, default 50
+//   tariff <dayLength> <revenueInterval>           resets bands, default 1440 1440
+//   band <start> <end> <percent>                   time of day, 100 = base rate
+//   spillover nearest|balanced                     cross-zone choice, default nearest
+//
+// Attribute flags are ev, accessible, covered and oversized.
+// Zones and areas must be declared before they are referenced.
+class LayoutLoader {
+private:
+    static char* nextToken(char*& cursor);
+    static bool toInt(const char* token, int& value);
+    static bool parseInt(char*& cursor, int& value);
+    static int parseAttribute(const char* token);
+
+public:
+    // Returns the new system, or nullptr with a "line N: ..." message in
+    // errorOut when the file cannot be read or a directive is invalid
+    static ParkingSystem* load(const string& path, string& errorOut);
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,438 @@
+#include "LoadGenerator.h"
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+enum WorkloadEvent {
+    EVENT_ARRIVAL,
+    EVENT_OCCUPY,
+    EVENT_CANCEL,
+    EVENT_RELEASE,
+    EVENT_NO_SHOW,
+    EVENT_SAMPLE
+};
+
+static const double TWO_PI = 6.283185307179586;
+
+LoadGenerator::LoadGenerator(ParkingSystem* system, const WorkloadConfig& config) {
+    this->system = system;
+    this->config = config;
+    random.seed(config.seed);
+    zoneIDs = nullptr;
+    zoneCumulative = nullptr;
+    zoneCount = 0;
+    trace = nullptr;
+    lastAdvanceTime = 0;
+    buildZoneDistribution();
+
+    Zone* zones = system->getZones();
+    systemZoneCount = system->getZoneCount();
+    zoneCapacity = new int[systemZoneCount];
+    zoneArrivals = new long long[systemZoneCount];
+    zoneRejected = new long long[systemZoneCount];
+    zoneOccupied = new long long[systemZoneCount];
+    zoneCrossZone = new long long[systemZoneCount];
+    zoneSpilledIn = new long long[systemZoneCount];
+    for (int i = 0; i < systemZoneCount; i++) {
+        zoneCapacity[i] = zones[i].getTotalCapacity();
+        zoneArrivals[i] = 0;
+        zoneRejected[i] = 0;
+        zoneOccupied[i] = 0;
+        zoneCrossZone[i] = 0;
+        zoneSpilledIn[i] = 0;
+    }
+    samples = nullptr;
+    sampleCount = 0;
+    sampleCapacity = 0;
+}
+
+LoadGenerator::~LoadGenerator() {
+    delete[] zoneIDs;
+    delete[] zoneCumulative;
+    delete[] zoneCapacity;
+    delete[] zoneArrivals;
+    delete[] zoneRejected;
+    delete[] zoneOccupied;
+    delete[] zoneCrossZone;
+    delete[] zoneSpilledIn;
+    delete[] samples;
+    if (trace != nullptr) {
+        fclose(trace);
+    }
+}
+
+// Zone k (1-based, setup order) is chosen with weight 1 / k^skew
+void LoadGenerator::buildZoneDistribution() {
+    Zone* zones = system->getZones();
+    int total = system->getZoneCount();
+    zoneIDs = new int[total > 0 ? total : 1];
+    zoneCumulative = new double[total > 0 ? total : 1];
+
+    double sum = 0.0;
+    for (int i = 0; i < total; i++) {
+        if (zones[i].getZoneID() == -1) {
+            continue;
+        }
+        sum += 1.0 / pow((double)(zoneCount + 1), config.zoneSkew);
+        zoneIDs[zoneCount] = zones[i].getZoneID();
+        zoneCumulative[zoneCount] = sum;
+        zoneCount++;
+    }
+    for (int i = 0; i < zoneCount; i++) {
+        zoneCumulative[i] /= sum;
+    }
+}
+
+int LoadGenerator::pickZone() {
+    double u = random.nextDouble();
+    int low = 0;
+    int high = zoneCount - 1;
+    while (low < high) {
+        int mid = (low + high) / 2;
+        if (zoneCumulative[mid] > u) {
+            high = mid;
+        } else {
+            low = mid + 1;
+        }
+    }
+    return zoneIDs[low];
+}
+
+double LoadGenerator::arrivalRateAt(double time) const {
+    double phase = TWO_PI * (time - config.peakTime) / config.diurnalPeriod;
+    return config.arrivalRate * (1.0 + config.diurnalAmplitude * cos(phase));
+}
+
+// Thinning: candidates are drawn at the peak rate and kept with
+// probability rate(t) / peak rate. Returns a time past the duration when
+// no further arrival falls inside it.
+double LoadGenerator::nextArrivalAfter(double time) {
+    double peakRate = config.arrivalRate * (1.0 + fabs(config.diurnalAmplitude));
+    if (peakRate <= 0.0) {
+        return config.duration + 1.0;
+    }
+    while (time <= config.duration) {
+        time += random.exponential(peakRate);
+        if (random.nextDouble() * peakRate < arrivalRateAt(time)) {
+            return time;
+        }
+    }
+    return time;
+}
+
+void LoadGenerator::advanceTo(int time) {
+    if (time <= lastAdvanceTime) {
+        return;
+    }
+    lastAdvanceTime = time;
+    system->advanceTime(time);
+    if (trace != nullptr) {
+        fprintf(trace, "%d advance\n", time);
+        stats.traceEvents++;
+    }
+}
+
+void LoadGenerator::emit(int time, const char* operation, int key) {
+    if (trace != nullptr) {
+        fprintf(trace, "%d %s %d\n", time, operation, key);
+        stats.traceEvents++;
+    }
+}
+
+void LoadGenerator::handleArrival(const ScheduledEvent& event) {
+    double next = nextArrivalAfter(event.time);
+    if (next <= config.duration) {
+        events.push(ScheduledEvent(next, EVENT_ARRIVAL, event.key + 1, -1));
+    }
+
+    int time = (int)event.time;
+    int key = event.key;
+    int zoneID = pickZone();
+    double u = random.nextDouble();
+    PriorityClass priority = PRIORITY_STANDARD;
+    const char* priorityName = "standard";
+    if (u < config.accessibleShare) {
+        priority = PRIORITY_ACCESSIBLE;
+        priorityName = "accessible";
+    } else if (u < config.accessibleShare + config.permitShare) {
+        priority = PRIORITY_PERMIT_HOLDER;
+        priorityName = "permit";
+    }
+
+    string vehicleID = "V" + to_string(key);
+    int requestID = system->createParkingRequest(vehicleID, zoneID, time, priority);
+    if (trace != nullptr) {
+        fprintf(trace, "%d create %d %s %d %s\n", time, key, vehicleID.c_str(), zoneID, priorityName);
+        stats.traceEvents++;
+    }
+    stats.arrivals++;
+    int zoneIndex = system->getZoneIndex(zoneID);
+    if (zoneIndex != -1) {
+        zoneArrivals[zoneIndex]++;
+    }
+
+    if (system->allocateParking(requestID)) {
+        stats.allocated++;
+    } else if (system->isWaitlisted(requestID)) {
+        stats.waitlisted++;
+    }
+    emit(time, "allocate", key);
+
+    double travel = random.exponential(1.0 / config.travelTimeMean);
+    int kind = random.chance(config.cancellationRate) ? EVENT_CANCEL : EVENT_OCCUPY;
+    // Drawn only when enabled, so existing seeds keep their traces
+    if (kind == EVENT_OCCUPY && config.noShowRate > 0.0 && random.chance(config.noShowRate)) {
+        kind = EVENT_NO_SHOW;
+    }
+    events.push(ScheduledEvent(event.time + travel, kind, key, requestID));
+}
+
+void LoadGenerator::handleOccupy(const ScheduledEvent& event) {
+    ParkingRequest* request = system->getActiveRequest(event.requestID);
+    if (request == nullptr) {
+        return;
+    }
+    int time = (int)event.time;
+    int zoneIndex = zoneIndexOf(*request);
+    if (request->getState() == REQUESTED) {
+        system->cancelRequest(event.requestID);
+        emit(time, "cancel", event.key);
+        stats.abandoned++;
+        if (zoneIndex != -1) {
+            zoneRejected[zoneIndex]++;
+        }
+        return;
+    }
+    if (system->occupyParking(event.requestID)) {
+        stats.occupied++;
+        HistoryNode entry;
+        bool crossZone = system->getHistoryEntry(event.requestID, entry) && entry.isCrossZone;
+        if (crossZone) {
+            stats.crossZone++;
+            int allocatedIndex = system->getZoneIndex(entry.allocatedZoneID);
+            if (allocatedIndex != -1) {
+                zoneSpilledIn[allocatedIndex]++;
+            }
+        }
+        if (zoneIndex != -1) {
+            zoneOccupied[zoneIndex]++;
+            zoneCrossZone[zoneIndex] += crossZone ? 1 : 0;
+        }
+        double dwell = random.logNormal(log(config.dwellMedian), config.dwellSigma);
+        events.push(ScheduledEvent(event.time + dwell, EVENT_RELEASE, event.key, event.requestID));
+    }
+    emit(time, "occupy", event.key);
+}
+
+void LoadGenerator::handleCancel(const ScheduledEvent& event) {
+    if (system->getActiveRequest(event.requestID) == nullptr) {
+        return;
+    }
+    if (system->cancelRequest(event.requestID)) {
+        stats.cancelled++;
+    }
+    emit((int)event.time, "cancel", event.key);
+}
+
+void LoadGenerator::handleRelease(const ScheduledEvent& event) {
+    if (system->getActiveRequest(event.requestID) == nullptr) {
+        return;
+    }
+    int time = (int)event.time;
+    if (system->releaseParking(event.requestID, time)) {
+        stats.released++;
+    }
+    emit(time, "release", event.key);
+}
+
+// A held slot is left for the no-show timeout to take back; without one
+// the request is cancelled now so the slot is not held forever
+void LoadGenerator::handleNoShow(const ScheduledEvent& event) {
+    ParkingRequest* request = system->getActiveRequest(event.requestID);
+    if (request == nullptr) {
+        return;
+    }
+    stats.noShows++;
+    if (request->getState() == REQUESTED || system->getNoShowTimeout() <= 0) {
+        system->cancelRequest(event.requestID);
+        emit((int)event.time, "cancel", event.key);
+    }
+}
+
+void LoadGenerator::handleSample(const ScheduledEvent& event) {
+    double next = event.time + config.sampleInterval;
+    if (next <= config.duration) {
+        events.push(ScheduledEvent(next, EVENT_SAMPLE, event.key + 1, -1));
+    }
+    if (sampleCount == sampleCapacity) {
+        int newCapacity = (sampleCapacity > 0) ? sampleCapacity * 2 : 64;
+        double* newSamples = new double[(long long)newCapacity * systemZoneCount];
+        if (samples != nullptr) {
+            memcpy(newSamples, samples, sizeof(double) * sampleCount * systemZoneCount);
+        }
+        delete[] samples;
+        samples = newSamples;
+        sampleCapacity = newCapacity;
+    }
+    Zone* zones = system->getZones();
+    double* row = samples + (long long)sampleCount * systemZoneCount;
+    for (int i = 0; i < systemZoneCount; i++) {
+        int capacity = zoneCapacity[i];
+        row[i] = (capacity > 0) ? (double)(capacity - zones[i].getTotalAvailableSlots()) / capacity : 0.0;
+    }
+    sampleCount++;
+}
+
+int LoadGenerator::zoneIndexOf(const ParkingRequest& request) const {
+    return system->getZoneIndex(request.getRequestedZone());
+}
+
+bool LoadGenerator::run(const string& tracePath) {
+    if (zoneCount == 0) {
+        return false;
+    }
+    if (!tracePath.empty()) {
+        trace = fopen(tracePath.c_str(), "w");
+        if (trace == nullptr) {
+            return false;
+        }
+        fprintf(trace, "# seed %llu, %d zones, %.0f minutes\n", config.seed, zoneCount, config.duration);
+    }
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    lastAdvanceTime = system->getCurrentTime();
+
+    double first = nextArrivalAfter(0.0);
+    if (first <= config.duration) {
+        events.push(ScheduledEvent(first, EVENT_ARRIVAL, 0, -1));
+    }
+    if (config.sampleInterval > 0.0) {
+        events.push(ScheduledEvent(0.0, EVENT_SAMPLE, 0, -1));
+    }
+
+    // Stays that begin before the end of the window run to completion
+    ScheduledEvent event;
+    while (events.pop(event)) {
+        advanceTo((int)event.time);
+        switch (event.kind) {
+            case EVENT_ARRIVAL:
+                handleArrival(event);
+                break;
+            case EVENT_OCCUPY:
+                handleOccupy(event);
+                break;
+            case EVENT_CANCEL:
+                handleCancel(event);
+                break;
+            case EVENT_RELEASE:
+                handleRelease(event);
+                break;
+            case EVENT_NO_SHOW:
+                handleNoShow(event);
+                break;
+            case EVENT_SAMPLE:
+                handleSample(event);
+                break;
+        }
+    }
+    // Lets the no-show timers still pending run out
+    if (system->getNoShowTimeout() > 0) {
+        advanceTo(lastAdvanceTime + system->getNoShowTimeout());
+    }
+
+    stats.wallSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    bool written = true;
+    if (trace != nullptr) {
+        written = (fclose(trace) == 0);
+        trace = nullptr;
+    }
+    return written;
+}
+
+const WorkloadStats& LoadGenerator::getStats() const {
+    return stats;
+}
+
+long long LoadGenerator::getZoneArrivals(int zoneIndex) const {
+    return (zoneIndex >= 0 && zoneIndex < systemZoneCount) ? zoneArrivals[zoneIndex] : 0;
+}
+
+double LoadGenerator::getZoneRejectionRate(int zoneIndex) const {
+    if (zoneIndex < 0 || zoneIndex >= systemZoneCount || zoneArrivals[zoneIndex] == 0) {
+        return 0.0;
+    }
+    return (double)zoneRejected[zoneIndex] / zoneArrivals[zoneIndex];
+}
+
+double LoadGenerator::getZoneCrossZoneRate(int zoneIndex) const {
+    if (zoneIndex < 0 || zoneIndex >= systemZoneCount || zoneOccupied[zoneIndex] == 0) {
+        return 0.0;
+    }
+    return (double)zoneCrossZone[zoneIndex] / zoneOccupied[zoneIndex];
+}
+
+long long LoadGenerator::getZoneSpilledIn(int zoneIndex) const {
+    return (zoneIndex >= 0 && zoneIndex < systemZoneCount) ? zoneSpilledIn[zoneIndex] : 0;
+}
+
+double LoadGenerator::getMeanUtilization(int zoneIndex) const {
+    if (zoneIndex < 0 || zoneIndex >= systemZoneCount || sampleCount == 0) {
+        return 0.0;
+    }
+    double sum = 0.0;
+    for (int s = 0; s < sampleCount; s++) {
+        sum += samples[(long long)s * systemZoneCount + zoneIndex];
+    }
+    return sum / sampleCount;
+}
+
+double LoadGenerator::getPeakUtilization(int zoneIndex) const {
+    double peak = 0.0;
+    for (int s = 0; zoneIndex >= 0 && zoneIndex < systemZoneCount && s < sampleCount; s++) {
+        double value = samples[(long long)s * systemZoneCount + zoneIndex];
+        if (value > peak) {
+            peak = value;
+        }
+    }
+    return peak;
+}
+
+int LoadGenerator::getSampleCount() const {
+    return sampleCount;
+}
+
+double LoadGenerator::getSampleTime(int sample) const {
+    return sample * config.sampleInterval;
+}
+
+double LoadGenerator::getUtilization(int sample, int zoneIndex) const {
+    if (sample < 0 || sample >= sampleCount || zoneIndex < 0 || zoneIndex >= systemZoneCount) {
+        return 0.0;
+    }
+    return samples[(long long)sample * systemZoneCount + zoneIndex];
+}
+
+bool LoadGenerator::writeCurves(const string& path) const {
+    FILE* out = fopen(path.c_str(), "w");
+    if (out == nullptr) {
+        return false;
+    }
+    Zone* zones = system->getZones();
+    fprintf(out, "time");
+    for (int i = 0; i < systemZoneCount; i++) {
+        if (zones[i].getZoneID() != -1) {
+            fprintf(out, ",zone%d", zones[i].getZoneID());
+        }
+    }
+    fprintf(out, "\n");
+    for (int s = 0; s < sampleCount; s++) {
+        fprintf(out, "%.0f", getSampleTime(s));
+        for (int i = 0; i < systemZoneCount; i++) {
+            if (zones[i].getZoneID() != -1) {
+                fprintf(out, ",%.4f", samples[(long long)s * systemZoneCount + i]);
+            }
+        }
+        fprintf(out, "\n");
+    }
+    return fclose(out) == 0;
+}
\ No newline at end of file
@@ -0,0 +1,163 @@
+#ifndef LOADGENERATOR_H
+#define LOADGENERATOR_H
+
+#include "ParkingSystem.h"
+#include "EventQueue.h"
+#include "RandomGenerator.h"
+#include <cstdio>
+#include <string>
+using namespace std;
+
+// Shape of a synthetic workload. Times are in minutes.
+struct WorkloadConfig {
+    unsigned long long seed;
+    double duration;            // arrivals stop after this time
+    double arrivalRate;         // mean arrivals per minute
+    double diurnalAmplitude;    // 0 = homogeneous Poisson, 1 = rate drops to 0 at night
+    double diurnalPeriod;
+    double peakTime;            // offset within the period where the rate peaks
+    double travelTimeMean;      // allocation to arrival at the slot (exponential)
+    double dwellMedian;         // log-normal stay length
+    double dwellSigma;
+    double cancellationRate;    // share of requests cancelled before arriving
+    double noShowRate;          // share of the rest whose driver never arrives
+    double zoneSkew;            // Zipf exponent over zones in setup order, 0 = uniform
+    double permitShare;
+    double accessibleShare;
+    double sampleInterval;      // utilization curve step, 0 = no curves
+
+    WorkloadConfig() {
+        seed = 1;
+        duration = 1440.0;
+        arrivalRate = 2.0;
+        diurnalAmplitude = 0.8;
+        diurnalPeriod = 1440.0;
+        peakTime = 720.0;
+        travelTimeMean = 10.0;
+        dwellMedian = 90.0;
+        dwellSigma = 0.8;
+        cancellationRate = 0.05;
+        noShowRate = 0.0;
+        zoneSkew = 1.0;
+        permitShare = 0.1;
+        accessibleShare = 0.03;
+        sampleInterval = 0.0;
+    }
+};
+
+struct WorkloadStats {
+    long long arrivals;
+    long long allocated;
+    long long waitlisted;
+    long long cancelled;
+    long long abandoned;
+    long long noShows;
+    long long occupied;
+    long long crossZone;
+    long long released;
+    long long traceEvents;
+    double wallSeconds;
+
+    WorkloadStats() {
+        arrivals = 0;
+        allocated = 0;
+        waitlisted = 0;
+        cancelled = 0;
+        abandoned = 0;
+        noShows = 0;
+        occupied = 0;
+        crossZone = 0;
+        released = 0;
+        traceEvents = 0;
+        wallSeconds = 0.0;
+    }
+};
+
+// Drives a ParkingSystem with a seeded synthetic workload: non-homogeneous
+// Poisson arrivals following a daily cosine curve, Zipf-skewed zone
+// choice, exponential travel times and log-normal stays. Every operation
+// it performs can be written as a TraceReplayer trace, so the same seed
+// and layout always yield the same trace and a replay of that trace
+// leaves a fresh system in the same state.
+//
+// A request that is still waitlisted when its driver would have arrived
+// is abandoned (cancelled); that is what the report counts as rejected.
+// A no-show's allocation is left to the system's no-show timeout, or
+// cancelled when the driver was due if no timeout is set.
+//
+// Run without a trace it doubles as a capacity-planning simulator: the
+// event times are the virtual clock, and per zone (by system zone index)
+// it counts arrivals, rejections and vehicles parked in another zone,
+// and samples slot utilization every sampleInterval minutes.
+class LoadGenerator {
+private:
+    ParkingSystem* system;
+    WorkloadConfig config;
+    WorkloadStats stats;
+    RandomGenerator random;
+    EventQueue events;
+
+    int* zoneIDs;
+    double* zoneCumulative;
+    int zoneCount;
+
+    FILE* trace;
+    int lastAdvanceTime;
+
+    int systemZoneCount;
+    int* zoneCapacity;
+    long long* zoneArrivals;
+    long long* zoneRejected;
+    long long* zoneOccupied;
+    long long* zoneCrossZone;
+    long long* zoneSpilledIn;
+    // sampleCount rows of systemZoneCount utilizations (0..1)
+    double* samples;
+    int sampleCount;
+    int sampleCapacity;
+
+    void buildZoneDistribution();
+    int pickZone();
+    double arrivalRateAt(double time) const;
+    double nextArrivalAfter(double time);
+    void advanceTo(int time);
+    void emit(int time, const char* operation, int key);
+
+    void handleArrival(const ScheduledEvent& event);
+    void handleOccupy(const ScheduledEvent& event);
+    void handleCancel(const ScheduledEvent& event);
+    void handleRelease(const ScheduledEvent& event);
+    void handleNoShow(const ScheduledEvent& event);
+    void handleSample(const ScheduledEvent& event);
+    int zoneIndexOf(const ParkingRequest& request) const;
+
+    LoadGenerator(const LoadGenerator&);
+    LoadGenerator& operator=(const LoadGenerator&);
+
+public:
+    LoadGenerator(ParkingSystem* system, const WorkloadConfig& config);
+    ~LoadGenerator();
+
+    // Runs the whole workload; tracePath may be empty to skip the trace
+    bool run(const string& tracePath);
+
+    const WorkloadStats& getStats() const;
+
+    // Per zone, by system zone index (see ParkingSystem::getZoneIndex)
+    long long getZoneArrivals(int zoneIndex) const;
+    double getZoneRejectionRate(int zoneIndex) const;
+    // Share of the zone's parked vehicles that were placed in another zone
+    double getZoneCrossZoneRate(int zoneIndex) const;
+    // Vehicles from other zones parked here, i.e. the overflow it absorbed
+    long long getZoneSpilledIn(int zoneIndex) const;
+    double getMeanUtilization(int zoneIndex) const;
+    double getPeakUtilization(int zoneIndex) const;
+
+    int getSampleCount() const;
+    double getSampleTime(int sample) const;
+    double getUtilization(int sample, int zoneIndex) const;
+    // One row per sample: time, then every configured zone's utilization
+    bool writeCurves(const string& path) const;
+};
+
+#endif
\ No newline at end of file
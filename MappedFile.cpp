@@ -0,0 +1,121 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile() {
+    data = nullptr;
+    size = 0;
+#ifdef _WIN32
+    fileHandle = INVALID_HANDLE_VALUE;
+    mappingHandle = nullptr;
+#else
+    descriptor = -1;
+#endif
+}
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+#ifdef _WIN32
+
+bool MappedFile::open(const string& path) {
+    close();
+
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    fileHandle = file;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+        close();
+        return false;
+    }
+    size = fileSize.QuadPart;
+
+    mappingHandle = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mappingHandle == nullptr) {
+        close();
+        return false;
+    }
+    data = (const unsigned char*)MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+    if (data == nullptr) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void MappedFile::close() {
+    if (data != nullptr) {
+        UnmapViewOfFile(data);
+    }
+    if (mappingHandle != nullptr) {
+        CloseHandle(mappingHandle);
+    }
+    if (fileHandle != INVALID_HANDLE_VALUE) {
+        CloseHandle(fileHandle);
+    }
+    data = nullptr;
+    size = 0;
+    fileHandle = INVALID_HANDLE_VALUE;
+    mappingHandle = nullptr;
+}
+
+#else
+
+bool MappedFile::open(const string& path) {
+    close();
+
+    descriptor = ::open(path.c_str(), O_RDONLY);
+    if (descriptor == -1) {
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(descriptor, &info) != 0 || info.st_size == 0) {
+        close();
+        return false;
+    }
+    size = info.st_size;
+
+    void* mapped = mmap(nullptr, (size_t)size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    if (mapped == MAP_FAILED) {
+        close();
+        return false;
+    }
+    data = (const unsigned char*)mapped;
+    return true;
+}
+
+void MappedFile::close() {
+    if (data != nullptr) {
+        munmap((void*)data, (size_t)size);
+    }
+    if (descriptor != -1) {
+        ::close(descriptor);
+    }
+    data = nullptr;
+    size = 0;
+    descriptor = -1;
+}
+
+#endif
+
+const unsigned char* MappedFile::getData() const {
+    return data;
+}
+
+long long MappedFile::getSize() const {
+    return size;
+}
\ No newline at end of file
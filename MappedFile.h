@@ -0,0 +1,31 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <string>
+using namespace std;
+
+// Read-only memory mapping of a whole file. Pages are loaded by the OS on
+// first touch, so opening is O(1) and nothing is copied up front.
+class MappedFile {
+private:
+    const unsigned char* data;
+    long long size;
+#ifdef _WIN32
+    void* fileHandle;
+    void* mappingHandle;
+#else
+    int descriptor;
+#endif
+
+public:
+    MappedFile();
+    ~MappedFile();
+
+    bool open(const string& path);
+    void close();
+
+    const unsigned char* getData() const;
+    long long getSize() const;
+};
+
+#endif
\ No newline at end of file
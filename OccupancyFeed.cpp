@@ -0,0 +1,130 @@
+#include "OccupancyFeed.h"
+#include <cstdio>
+
+static int slotKey(const OccupancyDelta& delta) {
+    return delta.areaID * 1000 + delta.slotIndex;
+}
+
+OccupancyFeed::OccupancyFeed() {
+    pendingCapacity = 64;
+    pending = new OccupancyDelta[pendingCapacity];
+    pendingPositions = new int[pendingCapacity];
+    pendingCount = 0;
+
+    tableCapacity = pendingCapacity * 2;
+    table = new int[tableCapacity];
+    for (int i = 0; i < tableCapacity; i++) {
+        table[i] = -1;
+    }
+
+    frameNumber = 0;
+    recordedCount = 0;
+    publishedCount = 0;
+}
+
+OccupancyFeed::~OccupancyFeed() {
+    delete[] pending;
+    delete[] pendingPositions;
+    delete[] table;
+}
+
+// Table position holding the key, or the empty position where it belongs
+int OccupancyFeed::findPosition(int key) const {
+    int mask = tableCapacity - 1;
+    int position = (int)(((unsigned int)key * 2654435761u) & (unsigned int)mask);
+    while (table[position] != -1 && slotKey(pending[table[position]]) != key) {
+        position = (position + 1) & mask;
+    }
+    return position;
+}
+
+// Doubles both arrays, keeping the table at most half full
+void OccupancyFeed::grow() {
+    int newCapacity = pendingCapacity * 2;
+    OccupancyDelta* newPending = new OccupancyDelta[newCapacity];
+    int* newPositions = new int[newCapacity];
+    for (int i = 0; i < pendingCount; i++) {
+        newPending[i] = pending[i];
+    }
+    delete[] pending;
+    delete[] pendingPositions;
+    pending = newPending;
+    pendingPositions = newPositions;
+    pendingCapacity = newCapacity;
+
+    delete[] table;
+    tableCapacity = newCapacity * 2;
+    table = new int[tableCapacity];
+    for (int i = 0; i < tableCapacity; i++) {
+        table[i] = -1;
+    }
+    for (int i = 0; i < pendingCount; i++) {
+        int position = findPosition(slotKey(pending[i]));
+        table[position] = i;
+        pendingPositions[i] = position;
+    }
+}
+
+void OccupancyFeed::record(const OccupancyDelta& delta) {
+    recordedCount++;
+    int position = findPosition(slotKey(delta));
+    if (table[position] != -1) {
+        pending[table[position]].to = delta.to;
+        return;
+    }
+    if (pendingCount == pendingCapacity) {
+        grow();
+        position = findPosition(slotKey(delta));
+    }
+    pending[pendingCount] = delta;
+    pendingPositions[pendingCount] = position;
+    table[position] = pendingCount;
+    pendingCount++;
+}
+
+bool OccupancyFeed::takeFrame(string& frameOut) {
+    frameOut.clear();
+    int published = 0;
+    char entry[80];
+    for (int i = 0; i < pendingCount; i++) {
+        const OccupancyDelta& delta = pending[i];
+        // Every key is cleared at once, so no probe chain is left broken
+        table[pendingPositions[i]] = -1;
+        if (delta.from == delta.to) {
+            continue;
+        }
+        snprintf(entry, sizeof(entry), "%s[%d,%d,%d,%d,%d]", (published == 0) ? "" : ",",
+                 delta.zoneID, delta.areaID, delta.slotIndex, (int)delta.from, (int)delta.to);
+        frameOut += entry;
+        published++;
+    }
+    pendingCount = 0;
+
+    if (published == 0) {
+        return false;
+    }
+    frameNumber++;
+    publishedCount += published;
+    frameOut = "id: " + to_string(frameNumber) + "\nevent: occupancy\ndata: [" + frameOut + "]\n\n";
+    return true;
+}
+
+int OccupancyFeed::getPendingCount() const {
+    return pendingCount;
+}
+
+long long OccupancyFeed::getFrameNumber() const {
+    return frameNumber;
+}
+
+long long OccupancyFeed::getRecordedCount() const {
+    return recordedCount;
+}
+
+long long OccupancyFeed::getPublishedCount() const {
+    return publishedCount;
+}
+
+void OccupancyFeed::onDelta(const OccupancyDelta& delta, void* context) {
+    ((OccupancyFeed*)context)->record(delta);
+}
\ No newline at end of file
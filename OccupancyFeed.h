@@ -0,0 +1,58 @@
+#ifndef OCCUPANCYFEED_H
+#define OCCUPANCYFEED_H
+
+#include "ParkingSystem.h"
+#include <string>
+using namespace std;
+
+// Collects slot transitions from a ParkingSystem (see onDelta) between
+// publishes and hands them out as one server-sent-events frame:
+//
+//   id: <frame number>
+//   event: occupancy
+//   data: [[zone,area,slot,from,to],...]
+//
+// States are SlotOccupancy values. A slot that changes several times
+// before the next frame appears once, with its first "from" and last
+// "to", and drops out if it ends where it started. Recording is an O(1)
+// hash probe, and the frame is built once however many clients read it.
+class OccupancyFeed {
+private:
+    OccupancyDelta* pending;
+    int* pendingPositions;
+    int pendingCount;
+    int pendingCapacity;
+
+    // Open addressing from slot key to pending index, -1 when empty
+    int* table;
+    int tableCapacity;
+
+    long long frameNumber;
+    long long recordedCount;
+    long long publishedCount;
+
+    int findPosition(int key) const;
+    void grow();
+
+    OccupancyFeed(const OccupancyFeed&);
+    OccupancyFeed& operator=(const OccupancyFeed&);
+
+public:
+    OccupancyFeed();
+    ~OccupancyFeed();
+
+    void record(const OccupancyDelta& delta);
+    // Builds the frame for everything recorded since the last call and
+    // clears it; false (and no frame) when nothing changed
+    bool takeFrame(string& frameOut);
+
+    int getPendingCount() const;
+    long long getFrameNumber() const;
+    long long getRecordedCount() const;
+    long long getPublishedCount() const;
+
+    // ParkingSystem OccupancyListener adapter; context is the feed
+    static void onDelta(const OccupancyDelta& delta, void* context);
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,284 @@
+#include "OccupancyTimeline.h"
+#include "Snapshot.h"
+
+OccupancyTimeline::OccupancyTimeline() {
+    zoneCount = 0;
+    bucketWidth = 1;
+    bucketCount = 0;
+    sumTree = nullptr;
+    maxTree = nullptr;
+    lazyTree = nullptr;
+}
+
+OccupancyTimeline::OccupancyTimeline(int zoneCount, int bucketWidth, int bucketCount) {
+    this->zoneCount = zoneCount;
+    this->bucketWidth = (bucketWidth > 0) ? bucketWidth : 1;
+    this->bucketCount = (bucketCount > 0) ? bucketCount : 1;
+
+    // Trees are allocated on first use so unused zones cost nothing
+    sumTree = new long long*[zoneCount];
+    maxTree = new int*[zoneCount];
+    lazyTree = new int*[zoneCount];
+    for (int i = 0; i < zoneCount; i++) {
+        sumTree[i] = nullptr;
+        maxTree[i] = nullptr;
+        lazyTree[i] = nullptr;
+    }
+}
+
+OccupancyTimeline::~OccupancyTimeline() {
+    releaseTrees();
+}
+
+OccupancyTimeline::OccupancyTimeline(const OccupancyTimeline& other) {
+    sumTree = nullptr;
+    maxTree = nullptr;
+    lazyTree = nullptr;
+    copyFrom(other);
+}
+
+OccupancyTimeline& OccupancyTimeline::operator=(const OccupancyTimeline& other) {
+    if (this != &other) {
+        releaseTrees();
+        copyFrom(other);
+    }
+    return *this;
+}
+
+void OccupancyTimeline::releaseTrees() {
+    if (sumTree != nullptr) {
+        for (int i = 0; i < zoneCount; i++) {
+            delete[] sumTree[i];
+            delete[] maxTree[i];
+            delete[] lazyTree[i];
+        }
+    }
+    delete[] sumTree;
+    delete[] maxTree;
+    delete[] lazyTree;
+    sumTree = nullptr;
+    maxTree = nullptr;
+    lazyTree = nullptr;
+}
+
+void OccupancyTimeline::copyFrom(const OccupancyTimeline& other) {
+    zoneCount = other.zoneCount;
+    bucketWidth = other.bucketWidth;
+    bucketCount = other.bucketCount;
+
+    if (other.sumTree == nullptr) {
+        return;
+    }
+
+    int treeSize = 4 * bucketCount;
+    sumTree = new long long*[zoneCount];
+    maxTree = new int*[zoneCount];
+    lazyTree = new int*[zoneCount];
+    for (int i = 0; i < zoneCount; i++) {
+        sumTree[i] = nullptr;
+        maxTree[i] = nullptr;
+        lazyTree[i] = nullptr;
+        if (other.sumTree[i] != nullptr) {
+            sumTree[i] = new long long[treeSize];
+            maxTree[i] = new int[treeSize];
+            lazyTree[i] = new int[treeSize];
+            for (int j = 0; j < treeSize; j++) {
+                sumTree[i][j] = other.sumTree[i][j];
+                maxTree[i][j] = other.maxTree[i][j];
+                lazyTree[i][j] = other.lazyTree[i][j];
+            }
+        }
+    }
+}
+
+// Times before 0 fall in the first bucket; -1 past the last one
+int OccupancyTimeline::toBucket(int time) const {
+    if (time < 0) {
+        return 0;
+    }
+    int bucket = time / bucketWidth;
+    return (bucket < bucketCount) ? bucket : -1;
+}
+
+bool OccupancyTimeline::coversTime(int time) const {
+    return time >= 0 && time / bucketWidth < bucketCount;
+}
+
+void OccupancyTimeline::ensureZone(int zoneIndex) {
+    if (sumTree[zoneIndex] != nullptr) {
+        return;
+    }
+    int treeSize = 4 * bucketCount;
+    sumTree[zoneIndex] = new long long[treeSize];
+    maxTree[zoneIndex] = new int[treeSize];
+    lazyTree[zoneIndex] = new int[treeSize];
+    for (int i = 0; i < treeSize; i++) {
+        sumTree[zoneIndex][i] = 0;
+        maxTree[zoneIndex][i] = 0;
+        lazyTree[zoneIndex][i] = 0;
+    }
+}
+
+// Lazy values are never pushed down: a node's sum/max already include its
+// own pending add, and queries carry the ancestors' pending adds with them.
+void OccupancyTimeline::rangeAdd(int zoneIndex, int node, int low, int high, int from, int to, int delta) {
+    if (to < low || high < from) {
+        return;
+    }
+    if (from <= low && high <= to) {
+        sumTree[zoneIndex][node] += (long long)delta * (high - low + 1);
+        maxTree[zoneIndex][node] += delta;
+        lazyTree[zoneIndex][node] += delta;
+        return;
+    }
+
+    int mid = (low + high) / 2;
+    rangeAdd(zoneIndex, 2 * node, low, mid, from, to, delta);
+    rangeAdd(zoneIndex, 2 * node + 1, mid + 1, high, from, to, delta);
+
+    int pending = lazyTree[zoneIndex][node];
+    int leftMax = maxTree[zoneIndex][2 * node];
+    int rightMax = maxTree[zoneIndex][2 * node + 1];
+    sumTree[zoneIndex][node] = sumTree[zoneIndex][2 * node] + sumTree[zoneIndex][2 * node + 1]
+                               + (long long)pending * (high - low + 1);
+    maxTree[zoneIndex][node] = ((leftMax > rightMax) ? leftMax : rightMax) + pending;
+}
+
+long long OccupancyTimeline::rangeSum(int zoneIndex, int node, int low, int high, int from, int to, long long pending) const {
+    if (to < low || high < from) {
+        return 0;
+    }
+    if (from <= low && high <= to) {
+        return sumTree[zoneIndex][node] + pending * (high - low + 1);
+    }
+
+    int mid = (low + high) / 2;
+    long long childPending = pending + lazyTree[zoneIndex][node];
+    return rangeSum(zoneIndex, 2 * node, low, mid, from, to, childPending)
+         + rangeSum(zoneIndex, 2 * node + 1, mid + 1, high, from, to, childPending);
+}
+
+int OccupancyTimeline::rangeMax(int zoneIndex, int node, int low, int high, int from, int to, int pending) const {
+    if (from <= low && high <= to) {
+        return maxTree[zoneIndex][node] + pending;
+    }
+
+    int mid = (low + high) / 2;
+    int childPending = pending + lazyTree[zoneIndex][node];
+    if (to <= mid) {
+        return rangeMax(zoneIndex, 2 * node, low, mid, from, to, childPending);
+    }
+    if (from > mid) {
+        return rangeMax(zoneIndex, 2 * node + 1, mid + 1, high, from, to, childPending);
+    }
+    int leftMax = rangeMax(zoneIndex, 2 * node, low, mid, from, to, childPending);
+    int rightMax = rangeMax(zoneIndex, 2 * node + 1, mid + 1, high, from, to, childPending);
+    return (leftMax > rightMax) ? leftMax : rightMax;
+}
+
+// A stay is open-ended when it starts: it counts in every bucket from its
+// start onwards until endStay() subtracts it from the release bucket on.
+// A stay ends no earlier than it starts, so one started past the timeline
+// also ends past it and neither call touches the tree.
+void OccupancyTimeline::startStay(int zoneIndex, int startTime) {
+    if (zoneIndex < 0 || zoneIndex >= zoneCount || toBucket(startTime) == -1) {
+        return;
+    }
+    ensureZone(zoneIndex);
+    rangeAdd(zoneIndex, 1, 0, bucketCount - 1, toBucket(startTime), bucketCount - 1, 1);
+}
+
+void OccupancyTimeline::endStay(int zoneIndex, int endTime) {
+    if (zoneIndex < 0 || zoneIndex >= zoneCount || toBucket(endTime) == -1) {
+        return;
+    }
+    ensureZone(zoneIndex);
+    rangeAdd(zoneIndex, 1, 0, bucketCount - 1, toBucket(endTime), bucketCount - 1, -1);
+}
+
+long long OccupancyTimeline::getOccupancySum(int zoneIndex, int fromTime, int toTime) const {
+    if (zoneIndex < 0 || zoneIndex >= zoneCount || sumTree[zoneIndex] == nullptr
+        || getBucketSpan(fromTime, toTime) == 0) {
+        return 0;
+    }
+    return rangeSum(zoneIndex, 1, 0, bucketCount - 1, toBucket(fromTime), toBucket(toTime), 0);
+}
+
+int OccupancyTimeline::getPeakOccupancy(int zoneIndex, int fromTime, int toTime) const {
+    if (zoneIndex < 0 || zoneIndex >= zoneCount || sumTree[zoneIndex] == nullptr
+        || getBucketSpan(fromTime, toTime) == 0) {
+        return 0;
+    }
+    return rangeMax(zoneIndex, 1, 0, bucketCount - 1, toBucket(fromTime), toBucket(toTime), 0);
+}
+
+int OccupancyTimeline::getBucketSpan(int fromTime, int toTime) const {
+    if (toTime < fromTime || !coversTime(fromTime) || !coversTime(toTime)) {
+        return 0;
+    }
+    return toBucket(toTime) - toBucket(fromTime) + 1;
+}
+
+int OccupancyTimeline::getBucketWidth() const {
+    return bucketWidth;
+}
+
+int OccupancyTimeline::getBucketCount() const {
+    return bucketCount;
+}
+
+// Trees are stored as-is so range queries keep working after a restart
+void OccupancyTimeline::writeSnapshot(SnapshotWriter& out) const {
+    out.writeI32(zoneCount);
+    out.writeI32(bucketWidth);
+    out.writeI32(bucketCount);
+
+    int treeSize = 4 * bucketCount;
+    for (int i = 0; i < zoneCount; i++) {
+        bool present = (sumTree != nullptr && sumTree[i] != nullptr);
+        out.writeBool(present);
+        if (present) {
+            for (int j = 0; j < treeSize; j++) {
+                out.writeI64(sumTree[i][j]);
+                out.writeI32(maxTree[i][j]);
+                out.writeI32(lazyTree[i][j]);
+            }
+        }
+    }
+}
+
+bool OccupancyTimeline::readSnapshot(SnapshotReader& in) {
+    int savedZones = in.readI32();
+    int savedWidth = in.readI32();
+    int savedBuckets = in.readI32();
+    if (in.hasFailed() || savedZones < 0 || savedWidth <= 0 || savedBuckets <= 0) {
+        return false;
+    }
+
+    releaseTrees();
+    zoneCount = savedZones;
+    bucketWidth = savedWidth;
+    bucketCount = savedBuckets;
+    sumTree = new long long*[zoneCount];
+    maxTree = new int*[zoneCount];
+    lazyTree = new int*[zoneCount];
+    for (int i = 0; i < zoneCount; i++) {
+        sumTree[i] = nullptr;
+        maxTree[i] = nullptr;
+        lazyTree[i] = nullptr;
+    }
+
+    int treeSize = 4 * bucketCount;
+    for (int i = 0; i < zoneCount; i++) {
+        if (!in.readBool()) {
+            continue;
+        }
+        ensureZone(i);
+        for (int j = 0; j < treeSize; j++) {
+            sumTree[i][j] = in.readI64();
+            maxTree[i][j] = in.readI32();
+            lazyTree[i][j] = in.readI32();
+        }
+    }
+    return !in.hasFailed();
+}
\ No newline at end of file
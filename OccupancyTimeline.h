@@ -0,0 +1,56 @@
+#ifndef OCCUPANCYTIMELINE_H
+#define OCCUPANCYTIMELINE_H
+
+#include "Snapshot.h"
+
+// Per-zone occupancy over fixed-width time buckets.
+// Each zone owns a segment tree with lazy range-add that keeps both the
+// sum and the maximum of the bucket occupancies, so a stay is recorded in
+// O(log b) and range utilization / peak queries also run in O(log b).
+// The timeline covers [0, bucketWidth * bucketCount): a stay that starts
+// past the end is not recorded, one that ends past it counts to the last
+// bucket, and queries reaching past the end are refused.
+class OccupancyTimeline {
+private:
+    int zoneCount;
+    int bucketWidth;
+    int bucketCount;
+
+    long long** sumTree;
+    int** maxTree;
+    int** lazyTree;
+
+    int toBucket(int time) const;
+    void ensureZone(int zoneIndex);
+    void releaseTrees();
+    void copyFrom(const OccupancyTimeline& other);
+
+    void rangeAdd(int zoneIndex, int node, int low, int high, int from, int to, int delta);
+    long long rangeSum(int zoneIndex, int node, int low, int high, int from, int to, long long pending) const;
+    int rangeMax(int zoneIndex, int node, int low, int high, int from, int to, int pending) const;
+
+public:
+    OccupancyTimeline();
+    OccupancyTimeline(int zoneCount, int bucketWidth, int bucketCount);
+    ~OccupancyTimeline();
+
+    OccupancyTimeline(const OccupancyTimeline& other);
+    OccupancyTimeline& operator=(const OccupancyTimeline& other);
+
+    void startStay(int zoneIndex, int startTime);
+    void endStay(int zoneIndex, int endTime);
+
+    long long getOccupancySum(int zoneIndex, int fromTime, int toTime) const;
+    int getPeakOccupancy(int zoneIndex, int fromTime, int toTime) const;
+    // 0 when the range is empty or not covered by the timeline
+    int getBucketSpan(int fromTime, int toTime) const;
+    bool coversTime(int time) const;
+
+    int getBucketWidth() const;
+    int getBucketCount() const;
+
+    void writeSnapshot(SnapshotWriter& out) const;
+    bool readSnapshot(SnapshotReader& in);
+};
+
+#endif
\ No newline at end of file
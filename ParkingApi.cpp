@@ -0,0 +1,449 @@
+#include "ParkingApi.h"
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+
+ParkingApi::ParkingApi(ParkingSystem* system, const string& staticRoot) {
+    this->system = system;
+    this->staticRoot = staticRoot;
+    feed = nullptr;
+}
+
+void ParkingApi::setOccupancyFeed(OccupancyFeed* feed) {
+    this->feed = feed;
+}
+
+void ParkingApi::dispatch(const HttpRequest& request, HttpResponse& response, void* context) {
+    ((ParkingApi*)context)->handle(request, response);
+}
+
+void ParkingApi::publish(HttpServer& server, void* context) {
+    ParkingApi* api = (ParkingApi*)context;
+    OccupancyFeed* feed = api->feed;
+    string frame;
+    // The tick doubles as the log's idle flush when traffic stops
+    api->system->flushWriteAheadLogIfDue();
+    // Taken even with no subscribers, so pending deltas never pile up
+    if (feed != nullptr && feed->takeFrame(frame)) {
+        server.broadcast(frame);
+    }
+}
+
+const char* ParkingApi::getStateName(RequestState state) {
+    switch (state) {
+        case REQUESTED: return "REQUESTED";
+        case ALLOCATED: return "ALLOCATED";
+        case OCCUPIED: return "OCCUPIED";
+        case RELEASED: return "RELEASED";
+        case CANCELLED: return "CANCELLED";
+        default: return "UNKNOWN";
+    }
+}
+
+void ParkingApi::appendJsonString(string& json, const string& text) {
+    json += '"';
+    for (size_t i = 0; i < text.length(); i++) {
+        char c = text[i];
+        if (c == '"' || c == '\\') {
+            json += '\\';
+            json += c;
+        } else if ((unsigned char)c < 0x20) {
+            char escaped[8];
+            snprintf(escaped, sizeof(escaped), "\\u%04x", (unsigned char)c);
+            json += escaped;
+        } else {
+            json += c;
+        }
+    }
+    json += '"';
+}
+
+void ParkingApi::fail(HttpResponse& response, int status, const string& error) {
+    response.status = status;
+    response.contentType = "application/json";
+    response.body = "{\"ok\":false,\"error\":";
+    appendJsonString(response.body, error);
+    response.body += "}";
+}
+
+bool ParkingApi::getInt(const HttpRequest& request, const char* name, int& valueOut) {
+    string value;
+    if (!request.getParameter(name, value) || value.empty()) {
+        return false;
+    }
+    char* end = nullptr;
+    long parsed = strtol(value.c_str(), &end, 10);
+    if (*end != '\0') {
+        return false;
+    }
+    valueOut = (int)parsed;
+    return true;
+}
+
+// Where the request stands: live state while active, else its history entry
+void ParkingApi::describeRequest(int requestID, string& json) {
+    HistoryNode entry;
+    bool inHistory = system->getHistoryEntry(requestID, entry);
+    ParkingRequest* active = system->getActiveRequest(requestID);
+    const ParkingRequest& request = (active != nullptr) ? *active : entry.request;
+
+    json += "\"requestID\":" + to_string(requestID);
+    json += ",\"vehicleID\":";
+    appendJsonString(json, request.getVehicleID());
+    json += ",\"zone\":" + to_string(request.getRequestedZone());
+    json += ",\"requestTime\":" + to_string(request.getRequestTime());
+    json += ",\"state\":\"";
+    json += getStateName(request.getState());
+    json += "\"";
+    if (inHistory && entry.allocatedSlotID != -1) {
+        json += ",\"allocatedZone\":" + to_string(entry.allocatedZoneID);
+        json += ",\"allocatedSlot\":" + to_string(entry.allocatedSlotID);
+        json += ",\"crossZone\":";
+        json += entry.isCrossZone ? "true" : "false";
+        json += ",\"allocatedTime\":" + to_string(entry.allocatedTime);
+    }
+    if (inHistory && entry.releaseTime != -1) {
+        json += ",\"releaseTime\":" + to_string(entry.releaseTime);
+        json += ",\"duration\":" + to_string(entry.releaseTime - entry.allocatedTime);
+        json += ",\"charge\":" + to_string(entry.charge);
+    }
+    if (active != nullptr && system->isWaitlisted(requestID)) {
+        json += ",\"waitlisted\":true";
+    }
+}
+
+void ParkingApi::describeZones(string& json) {
+    Zone* zones = system->getZones();
+    json += "{\"zones\":[";
+    bool first = true;
+    for (int i = 0; i < system->getZoneCount(); i++) {
+        if (zones[i].getZoneID() == -1) {
+            continue;
+        }
+        int capacity = zones[i].getTotalCapacity();
+        int available = zones[i].getTotalAvailableSlots();
+        json += first ? "{" : ",{";
+        json += "\"id\":" + to_string(zones[i].getZoneID());
+        json += ",\"capacity\":" + to_string(capacity);
+        json += ",\"occupied\":" + to_string(capacity - available);
+        json += ",\"waiting\":" + to_string(system->getWaitlistLength(zones[i].getZoneID()));
+        json += "}";
+        first = false;
+    }
+    json += "]}";
+}
+
+// Straight from the tariff engine's running totals: O(zones + intervals)
+void ParkingApi::describeRevenue(string& json) {
+    const TariffEngine* tariff = system->getTariff();
+    Zone* zones = system->getZones();
+    json = "{\"totalRevenue\":" + to_string(tariff->getTotalRevenue());
+    json += ",\"charges\":" + to_string(tariff->getChargeCount());
+    json += ",\"crossZoneSurcharge\":" + to_string(tariff->getCrossZoneSurcharge());
+    json += ",\"zones\":[";
+    bool first = true;
+    for (int i = 0; i < system->getZoneCount(); i++) {
+        if (zones[i].getZoneID() == -1) {
+            continue;
+        }
+        json += first ? "{" : ",{";
+        json += "\"id\":" + to_string(zones[i].getZoneID());
+        json += ",\"rate\":" + to_string(tariff->getZoneRate(i));
+        json += ",\"revenue\":" + to_string(tariff->getZoneRevenue(i));
+        json += "}";
+        first = false;
+    }
+    json += "],\"intervalWidth\":" + to_string(tariff->getIntervalWidth());
+    json += ",\"intervals\":[";
+    for (int i = 0; i < tariff->getIntervalCount(); i++) {
+        json += (i == 0) ? "" : ",";
+        json += to_string(tariff->getIntervalRevenue(i));
+    }
+    json += "]}";
+}
+
+void ParkingApi::handleRequestAction(const HttpRequest& request, HttpResponse& response, int requestID,
+                                     const string& action) {
+    if (action.empty() && request.method == "GET") {
+        if (system->getActiveRequest(requestID) == nullptr) {
+            HistoryNode entry;
+            if (!system->getHistoryEntry(requestID, entry)) {
+                fail(response, 404, "unknown request");
+                return;
+            }
+        }
+        response.body = "{\"ok\":true,";
+        describeRequest(requestID, response.body);
+        response.body += "}";
+        return;
+    }
+    if (request.method != "POST") {
+        fail(response, 405, "use POST");
+        return;
+    }
+
+    bool succeeded = false;
+    if (action == "allocate") {
+        succeeded = system->allocateParking(requestID);
+    } else if (action == "occupy") {
+        succeeded = system->occupyParking(requestID);
+    } else if (action == "cancel") {
+        succeeded = system->cancelRequest(requestID);
+    } else if (action == "release") {
+        int time = 0;
+        if (!getInt(request, "time", time)) {
+            fail(response, 400, "release needs time");
+            return;
+        }
+        succeeded = system->releaseParking(requestID, time);
+    } else {
+        fail(response, 404, "unknown action");
+        return;
+    }
+
+    ParkingRequest* active = system->getActiveRequest(requestID);
+    HistoryNode entry;
+    if (active == nullptr && !system->getHistoryEntry(requestID, entry)) {
+        fail(response, 404, "unknown request");
+        return;
+    }
+    response.status = succeeded ? 200 : 409;
+    response.body = succeeded ? "{\"ok\":true," : "{\"ok\":false,\"error\":\"" + action + " rejected\",";
+    describeRequest(requestID, response.body);
+    response.body += "}";
+}
+
+void ParkingApi::handle(const HttpRequest& request, HttpResponse& response) {
+    const string& path = request.path;
+    // The server only listens on loopback, but a rebound DNS name can still
+    // point a browser at it; such requests name the wrong host
+    if (!request.hasLoopbackHost()) {
+        fail(response, 403, "unexpected host");
+        return;
+    }
+    // No CORS headers are sent, so other sites cannot read responses; this
+    // stops them changing state with form posts they need not read
+    if (request.method != "GET" && request.isCrossOrigin()) {
+        fail(response, 403, "cross-origin requests are not accepted");
+        return;
+    }
+    if (path.compare(0, 5, "/api/") != 0) {
+        serveStatic(request, response);
+        return;
+    }
+
+    if (path == "/api/zones" && request.method == "GET") {
+        response.body.clear();
+        describeZones(response.body);
+    } else if (path == "/api/stream" && request.method == "GET") {
+        if (feed == nullptr) {
+            fail(response, 404, "streaming is not enabled");
+            return;
+        }
+        // The snapshot already includes anything pending in the feed;
+        // HttpServer publishes that before this client subscribes
+        response.streaming = true;
+        response.body = "retry: 1000\nevent: zones\ndata: ";
+        describeZones(response.body);
+        response.body += "\n\n";
+    } else if (path == "/api/analytics" && request.method == "GET") {
+        ParkingAnalytics analytics = system->getAnalytics();
+        char json[352];
+        snprintf(json, sizeof(json),
+                 "{\"totalRequests\":%d,\"completedRequests\":%d,\"cancelledRequests\":%d,"
+                 "\"averageParkingDuration\":%.2f,\"crossZoneAllocations\":%d,"
+                 "\"utilizationRate\":%.4f,\"peakZone\":%d,\"totalRevenue\":%lld}",
+                 analytics.totalRequests, analytics.completedRequests, analytics.cancelledRequests,
+                 analytics.averageParkingDuration, analytics.crossZoneAllocations,
+                 analytics.zoneUtilizationRate, system->getPeakUsageZone(), analytics.totalRevenue);
+        response.body = json;
+    } else if (path == "/api/revenue" && request.method == "GET") {
+        describeRevenue(response.body);
+    } else if (path == "/api/capacity" && request.method == "GET") {
+        // Both bounds are inclusive zone IDs; a missing one leaves that end open
+        int from = INT_MIN;
+        int to = INT_MAX;
+        string value;
+        if ((request.getParameter("from", value) && !getInt(request, "from", from))
+            || (request.getParameter("to", value) && !getInt(request, "to", to))) {
+            fail(response, 400, "from and to must be zone IDs");
+            return;
+        }
+        response.body = "{\"freeSlots\":" + to_string(system->getFreeSlotsBetween(from, to));
+        response.body += ",\"mostAvailableZone\":" + to_string(system->getMostAvailableZone(from, to)) + "}";
+    } else if (path == "/api/metrics" && request.method == "GET") {
+        response.contentType = "text/plain; version=0.0.4";
+        response.body = system->getMetricsText();
+    } else if (path == "/api/requests") {
+        if (request.method != "POST") {
+            fail(response, 405, "use POST");
+            return;
+        }
+        string vehicle;
+        string priorityName;
+        int zone = 0;
+        int time = 0;
+        if (!request.getParameter("vehicle", vehicle) || vehicle.empty()
+            || !getInt(request, "zone", zone) || !getInt(request, "time", time)) {
+            fail(response, 400, "expected vehicle, zone and time");
+            return;
+        }
+        if (system->getZoneIndex(zone) == -1) {
+            fail(response, 400, "unknown zone");
+            return;
+        }
+        PriorityClass priority = PRIORITY_STANDARD;
+        if (request.getParameter("priority", priorityName)) {
+            if (priorityName == "permit") {
+                priority = PRIORITY_PERMIT_HOLDER;
+            } else if (priorityName == "accessible") {
+                priority = PRIORITY_ACCESSIBLE;
+            } else if (priorityName != "standard") {
+                fail(response, 400, "unknown priority");
+                return;
+            }
+        }
+        int requestID = system->createParkingRequest(vehicle, zone, time, priority);
+        response.body = "{\"ok\":true,";
+        describeRequest(requestID, response.body);
+        response.body += "}";
+    } else if (path.compare(0, 14, "/api/requests/") == 0) {
+        size_t idEnd = path.find('/', 14);
+        string idText = path.substr(14, (idEnd == string::npos) ? string::npos : idEnd - 14);
+        char* end = nullptr;
+        long requestID = strtol(idText.c_str(), &end, 10);
+        if (idText.empty() || *end != '\0' || requestID <= 0) {
+            fail(response, 400, "bad request ID");
+            return;
+        }
+        string action = (idEnd == string::npos) ? "" : path.substr(idEnd + 1);
+        handleRequestAction(request, response, (int)requestID, action);
+    } else if (path == "/api/rollback") {
+        if (request.method != "POST") {
+            fail(response, 405, "use POST");
+            return;
+        }
+        int count = 1;
+        getInt(request, "count", count);
+        if (count < 1 || !system->rollbackLastKAllocations(count)) {
+            fail(response, 409, "nothing to roll back");
+            return;
+        }
+        response.body = "{\"ok\":true}";
+    } else if (path == "/api/bookings") {
+        handleGroupBooking(request, response);
+    } else if (path == "/api/undo" || path == "/api/redo") {
+        if (request.method != "POST") {
+            fail(response, 405, "use POST");
+            return;
+        }
+        bool undo = (path == "/api/undo");
+        if (!(undo ? system->undoLastOperation() : system->redoLastOperation())) {
+            fail(response, 409, undo ? "nothing to undo" : "nothing to redo");
+            return;
+        }
+        response.body = "{\"ok\":true}";
+    } else {
+        fail(response, 404, "unknown endpoint");
+    }
+}
+
+// Books `count` slots in one zone for vehicles <vehicle>-1..<vehicle>-count,
+// all or nothing: the allocations run in one transaction, aborted (and the
+// new requests cancelled) as soon as one fails or spills into another zone
+void ParkingApi::handleGroupBooking(const HttpRequest& request, HttpResponse& response) {
+    if (request.method != "POST") {
+        fail(response, 405, "use POST");
+        return;
+    }
+    string vehicle;
+    int zone = 0;
+    int time = 0;
+    int count = 0;
+    if (!request.getParameter("vehicle", vehicle) || vehicle.empty() || !getInt(request, "zone", zone)
+        || !getInt(request, "time", time) || !getInt(request, "count", count)) {
+        fail(response, 400, "expected vehicle, zone, time and count");
+        return;
+    }
+    if (system->getZoneIndex(zone) == -1 || count < 1 || count > MAX_GROUP_BOOKING) {
+        fail(response, 400, "unknown zone or bad count");
+        return;
+    }
+    if (!system->beginTransaction()) {
+        fail(response, 409, "another transaction is open");
+        return;
+    }
+    
+    int* requestIDs = new int[count];
+    bool booked = true;
+    HistoryNode entry;
+    for (int i = 0; i < count && booked; i++) {
+        requestIDs[i] = system->createParkingRequest(vehicle + "-" + to_string(i + 1), zone, time);
+        booked = system->allocateParking(requestIDs[i]) && system->getHistoryEntry(requestIDs[i], entry)
+                 && entry.allocatedZoneID == zone;
+        if (!booked) {
+            count = i + 1;
+        }
+    }
+    
+    if (!booked) {
+        system->abortTransaction();
+        for (int i = 0; i < count; i++) {
+            system->cancelRequest(requestIDs[i]);
+        }
+        delete[] requestIDs;
+        fail(response, 409, "not enough free slots in the zone");
+        return;
+    }
+    system->commitTransaction();
+    
+    response.body = "{\"ok\":true,\"requests\":[";
+    for (int i = 0; i < count; i++) {
+        if (i > 0) {
+            response.body += ",";
+        }
+        response.body += "{";
+        describeRequest(requestIDs[i], response.body);
+        response.body += "}";
+    }
+    response.body += "]}";
+    delete[] requestIDs;
+}
+
+static const char* contentTypeFor(const string& path) {
+    size_t dot = path.rfind('.');
+    string extension = (dot == string::npos) ? "" : path.substr(dot + 1);
+    if (extension == "html") return "text/html; charset=utf-8";
+    if (extension == "js") return "application/javascript";
+    if (extension == "css") return "text/css";
+    if (extension == "json") return "application/json";
+    if (extension == "png") return "image/png";
+    if (extension == "svg") return "image/svg+xml";
+    return "application/octet-stream";
+}
+
+void ParkingApi::serveStatic(const HttpRequest& request, HttpResponse& response) {
+    if (staticRoot.empty() || request.method != "GET") {
+        fail(response, 404, "not found");
+        return;
+    }
+    string relative = (request.path == "/") ? "/index.html" : request.path;
+    if (relative.find("..") != string::npos) {
+        fail(response, 400, "bad path");
+        return;
+    }
+
+    FILE* in = fopen((staticRoot + relative).c_str(), "rb");
+    if (in == nullptr) {
+        fail(response, 404, "not found");
+        return;
+    }
+    response.body.clear();
+    char buffer[8192];
+    size_t read;
+    while ((read = fread(buffer, 1, sizeof(buffer), in)) > 0) {
+        response.body.append(buffer, read);
+    }
+    fclose(in);
+    response.contentType = contentTypeFor(relative);
+}
\ No newline at end of file
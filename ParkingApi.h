@@ -0,0 +1,68 @@
+#ifndef PARKINGAPI_H
+#define PARKINGAPI_H
+
+#include "ParkingSystem.h"
+#include "HttpServer.h"
+#include "OccupancyFeed.h"
+#include <string>
+using namespace std;
+
+// JSON endpoints over a ParkingSystem, for HttpServer. Parameters come
+// from the query string or a form-encoded body.
+//
+//   GET  /api/zones                          capacity and occupancy per zone
+//   GET  /api/stream                         event stream: a "zones" snapshot,
+//                                            then "occupancy" deltas (see
+//                                            OccupancyFeed); needs a feed
+//   GET  /api/analytics
+//   GET  /api/revenue                        totals per zone and per interval
+//   GET  /api/capacity       [from, to]      free slots over a zone ID range
+//                                            and the zone with the most
+//   GET  /api/metrics                        text exposition (see ParkingMetrics)
+//   GET  /api/requests/<id>
+//   POST /api/requests       vehicle, zone, time [, priority]
+//   POST /api/requests/<id>/allocate | occupy | cancel
+//   POST /api/requests/<id>/release          time
+//   POST /api/bookings       vehicle, zone, time, count
+//                                            all-or-nothing group booking
+//   POST /api/rollback       [count]
+//   POST /api/undo | /api/redo               last operation, whole
+//
+// Anything else is served from the static file root when one is set.
+// A rejected operation answers 409 with {"ok":false,"error":...}.
+// A request whose Host is not localhost or 127.0.0.1 on the server's port,
+// or a cross-origin non-GET, answers 403.
+class ParkingApi {
+private:
+    ParkingSystem* system;
+    string staticRoot;
+    OccupancyFeed* feed;
+
+    void handleGroupBooking(const HttpRequest& request, HttpResponse& response);
+    void handleRequestAction(const HttpRequest& request, HttpResponse& response, int requestID, const string& action);
+    void describeRequest(int requestID, string& json);
+    void describeZones(string& json);
+    void describeRevenue(string& json);
+    void serveStatic(const HttpRequest& request, HttpResponse& response);
+
+    static void fail(HttpResponse& response, int status, const string& error);
+    static bool getInt(const HttpRequest& request, const char* name, int& valueOut);
+
+public:
+    static const int MAX_GROUP_BOOKING = 1000;
+
+    ParkingApi(ParkingSystem* system, const string& staticRoot);
+
+    // The feed must be attached as the system's occupancy listener
+    void setOccupancyFeed(OccupancyFeed* feed);
+    void handle(const HttpRequest& request, HttpResponse& response);
+
+    // HttpServer::Handler adapter; context is the ParkingApi
+    static void dispatch(const HttpRequest& request, HttpResponse& response, void* context);
+    // HttpServer::TickHandler adapter: broadcasts the feed's pending frame
+    static void publish(HttpServer& server, void* context);
+    static void appendJsonString(string& json, const string& text);
+    static const char* getStateName(RequestState state);
+};
+
+#endif
\ No newline at end of file
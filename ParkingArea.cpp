@@ -6,6 +6,8 @@ ParkingArea::ParkingArea() {
     capacity = 0;
     occupiedCount = 0;
     slots = nullptr;
+    bookings = nullptr;
+    shareCount = 1;
 }
 
 ParkingArea::ParkingArea(int areaID, int zoneID, int capacity) {
@@ -13,16 +15,95 @@ ParkingArea::ParkingArea(int areaID, int zoneID, int capacity) {
     this->zoneID = zoneID;
     this->capacity = capacity;
     this->occupiedCount = 0;
+    this->bookings = nullptr;
+    this->shareCount = 1;
     
     slots = new ParkingSlot[capacity];
     
     for (int i = 0; i < capacity; i++) {
         slots[i] = ParkingSlot(areaID * 1000 + i, zoneID);
     }
+    resetFreeSlots();
+}
+
+// Rebuilds the area in place, avoiding the temporary and copy of
+// assigning a freshly constructed area
+void ParkingArea::configure(int areaID, int zoneID, int capacity) {
+    delete[] slots;
+    delete[] bookings;
+    
+    this->areaID = areaID;
+    this->zoneID = zoneID;
+    this->capacity = capacity;
+    this->occupiedCount = 0;
+    this->bookings = nullptr;
+    
+    slots = new ParkingSlot[capacity];
+    for (int i = 0; i < capacity; i++) {
+        slots[i] = ParkingSlot(areaID * 1000 + i, zoneID);
+    }
+    resetFreeSlots();
+}
+
+bool ParkingArea::resize(int newCapacity) {
+    if (newCapacity < 0) {
+        return false;
+    }
+    for (int i = newCapacity; i < capacity; i++) {
+        if (!slots[i].getAvailability()) {
+            return false;
+        }
+    }
+    if (hasBookingsFrom(newCapacity)) {
+        return false;
+    }
+    
+    ParkingSlot* newSlots = new ParkingSlot[newCapacity];
+    for (int i = 0; i < newCapacity; i++) {
+        newSlots[i] = (i < capacity) ? slots[i] : ParkingSlot(areaID * 1000 + i, zoneID);
+    }
+    delete[] slots;
+    slots = newSlots;
+    
+    if (bookings != nullptr) {
+        IntervalSet* newBookings = new IntervalSet[newCapacity];
+        for (int i = 0; i < newCapacity && i < capacity; i++) {
+            newBookings[i] = bookings[i];
+        }
+        delete[] bookings;
+        bookings = newBookings;
+    }
+    
+    freeSlots.resizeKeeping(newCapacity);
+    walkInSlots.resizeKeeping(newCapacity);
+    for (int i = capacity; i < newCapacity; i++) {
+        freeSlots.set(i);
+        walkInSlots.set(i);
+    }
+    capacity = newCapacity;
+    return true;
+}
+
+void ParkingArea::resetFreeSlots() {
+    freeSlots.resize(capacity);
+    walkInSlots.resize(capacity);
+    for (int i = 0; i < capacity; i++) {
+        freeSlots.set(i);
+        walkInSlots.set(i);
+    }
+}
+
+void ParkingArea::refreshWalkIn(int index) {
+    if (freeSlots.test(index) && (bookings == nullptr || bookings[index].getCount() == 0)) {
+        walkInSlots.set(index);
+    } else {
+        walkInSlots.clear(index);
+    }
 }
 
 ParkingArea::~ParkingArea() {
     delete[] slots;
+    delete[] bookings;
 }
 
 ParkingArea::ParkingArea(const ParkingArea& other) {
@@ -30,6 +111,9 @@ ParkingArea::ParkingArea(const ParkingArea& other) {
     zoneID = other.zoneID;
     capacity = other.capacity;
     occupiedCount = other.occupiedCount;
+    freeSlots = other.freeSlots;
+    walkInSlots = other.walkInSlots;
+    shareCount = 1;
     
     if (other.slots != nullptr) {
         slots = new ParkingSlot[capacity];
@@ -39,16 +123,21 @@ ParkingArea::ParkingArea(const ParkingArea& other) {
     } else {
         slots = nullptr;
     }
+    
+    copyBookings(other);
 }
 
 ParkingArea& ParkingArea::operator=(const ParkingArea& other) {
     if (this != &other) {
         delete[] slots;
+        delete[] bookings;
         
         areaID = other.areaID;
         zoneID = other.zoneID;
         capacity = other.capacity;
         occupiedCount = other.occupiedCount;
+        freeSlots = other.freeSlots;
+        walkInSlots = other.walkInSlots;
         
         if (other.slots != nullptr) {
             slots = new ParkingSlot[capacity];
@@ -58,10 +147,35 @@ ParkingArea& ParkingArea::operator=(const ParkingArea& other) {
         } else {
             slots = nullptr;
         }
+        
+        copyBookings(other);
     }
     return *this;
 }
 
+void ParkingArea::share() {
+    shareCount++;
+}
+
+bool ParkingArea::unshare() {
+    return --shareCount == 0;
+}
+
+bool ParkingArea::isShared() const {
+    return shareCount > 1;
+}
+
+void ParkingArea::copyBookings(const ParkingArea& other) {
+    if (other.bookings != nullptr) {
+        bookings = new IntervalSet[capacity];
+        for (int i = 0; i < capacity; i++) {
+            bookings[i] = other.bookings[i];
+        }
+    } else {
+        bookings = nullptr;
+    }
+}
+
 int ParkingArea::getAreaID() const {
     return areaID;
 }
@@ -79,22 +193,52 @@ int ParkingArea::getOccupiedCount() const {
 }
 
 int ParkingArea::getAvailableCount() const {
-    int available = 0;
-    for (int i = 0; i < capacity; i++) {
-        if (slots[i].getAvailability()) {
-            available++;
-        }
-    }
-    return available;
+    return capacity - occupiedCount;
 }
 
 ParkingSlot* ParkingArea::findAvailableSlot() {
-    for (int i = 0; i < capacity; i++) {
-        if (slots[i].getAvailability()) {
-            return &slots[i];
+    int index = freeSlots.findFirst();
+    return (index != -1) ? &slots[index] : nullptr;
+}
+
+int ParkingArea::findAvailableSlotIndex() const {
+    return freeSlots.findFirst();
+}
+
+int ParkingArea::findSlotForStay(int stayStart, int stayEnd) const {
+    int index = walkInSlots.findFirst();
+    if (index != -1 || bookings == nullptr) {
+        return index;
+    }
+    // Every free slot left is booked
+    for (index = freeSlots.findFirst(); index != -1; index = freeSlots.findNext(index + 1)) {
+        if (!bookings[index].overlaps(stayStart, stayEnd)) {
+            return index;
         }
     }
-    return nullptr;
+    return -1;
+}
+
+bool ParkingArea::occupySlot(int index) {
+    if (index < 0 || index >= capacity || !slots[index].getAvailability()) {
+        return false;
+    }
+    slots[index].occupySlot();
+    freeSlots.clear(index);
+    walkInSlots.clear(index);
+    occupiedCount++;
+    return true;
+}
+
+bool ParkingArea::freeSlot(int index) {
+    if (index < 0 || index >= capacity || slots[index].getAvailability()) {
+        return false;
+    }
+    slots[index].freeSlot();
+    freeSlots.set(index);
+    refreshWalkIn(index);
+    occupiedCount--;
+    return true;
 }
 
 ParkingSlot* ParkingArea::getSlot(int index) {
@@ -104,6 +248,140 @@ ParkingSlot* ParkingArea::getSlot(int index) {
     return nullptr;
 }
 
+const ParkingSlot* ParkingArea::getSlot(int index) const {
+    if (index >= 0 && index < capacity) {
+        return &slots[index];
+    }
+    return nullptr;
+}
+
 ParkingSlot* ParkingArea::getSlots() {
     return slots;
+}
+
+int ParkingArea::getSlotIndex(int slotID) const {
+    int index = slotID - areaID * 1000;
+    if (index >= 0 && index < capacity) {
+        return index;
+    }
+    return -1;
+}
+
+// Areas without any booking have no calendar allocated, so every slot is
+// free for any window. A slot that is occupied now may still be held when
+// the window opens, so free slots are tried first
+int ParkingArea::findSlotFreeDuring(int startTime, int endTime) const {
+    if (capacity == 0 || endTime <= startTime) {
+        return -1;
+    }
+    for (int i = freeSlots.findFirst(); i != -1; i = freeSlots.findNext(i + 1)) {
+        if (bookings == nullptr || !bookings[i].overlaps(startTime, endTime)) {
+            return i;
+        }
+    }
+    if (bookings == nullptr) {
+        return 0;
+    }
+    for (int i = 0; i < capacity; i++) {
+        if (!slots[i].getAvailability() && !bookings[i].overlaps(startTime, endTime)) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+bool ParkingArea::bookSlot(int index, int startTime, int endTime, int requestID) {
+    if (index < 0 || index >= capacity) {
+        return false;
+    }
+    if (bookings == nullptr) {
+        bookings = new IntervalSet[capacity];
+    }
+    if (!bookings[index].insert(startTime, endTime, requestID)) {
+        return false;
+    }
+    walkInSlots.clear(index);
+    return true;
+}
+
+bool ParkingArea::unbookSlot(int index, int startTime, int requestID) {
+    if (index < 0 || index >= capacity || bookings == nullptr) {
+        return false;
+    }
+    if (!bookings[index].remove(startTime, requestID)) {
+        return false;
+    }
+    refreshWalkIn(index);
+    return true;
+}
+
+bool ParkingArea::hasBookingsFrom(int firstIndex) const {
+    if (bookings == nullptr) {
+        return false;
+    }
+    for (int i = (firstIndex > 0) ? firstIndex : 0; i < capacity; i++) {
+        if (bookings[i].getCount() > 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void ParkingArea::setSlotAttributes(int firstIndex, int count, int mask) {
+    for (int i = firstIndex; i < firstIndex + count; i++) {
+        if (i >= 0 && i < capacity) {
+            slots[i].setAttributes(mask);
+        }
+    }
+}
+
+int ParkingArea::countSlotsWithAttributes(int mask) const {
+    int count = 0;
+    for (int i = 0; i < capacity; i++) {
+        if (slots[i].hasAttributes(mask)) {
+            count++;
+        }
+    }
+    return count;
+}
+
+bool ParkingArea::hasSlotAttributes() const {
+    for (int i = 0; i < capacity; i++) {
+        if (slots[i].getAttributes() != 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// One bit per slot, set when the slot is occupied
+int ParkingArea::getBitmapSize() const {
+    return (capacity + 7) / 8;
+}
+
+void ParkingArea::writeOccupancyBitmap(unsigned char* bitmap) const {
+    int bytes = getBitmapSize();
+    for (int i = 0; i < bytes; i++) {
+        bitmap[i] = 0;
+    }
+    for (int i = 0; i < capacity; i++) {
+        if (!slots[i].getAvailability()) {
+            bitmap[i >> 3] |= (unsigned char)(1 << (i & 7));
+        }
+    }
+}
+
+void ParkingArea::loadOccupancyBitmap(const unsigned char* bitmap) {
+    occupiedCount = 0;
+    for (int i = 0; i < capacity; i++) {
+        if (bitmap[i >> 3] & (1 << (i & 7))) {
+            slots[i].occupySlot();
+            freeSlots.clear(i);
+            occupiedCount++;
+        } else {
+            slots[i].freeSlot();
+            freeSlots.set(i);
+        }
+        refreshWalkIn(i);
+    }
 }
\ No newline at end of file
@@ -2,6 +2,8 @@
 #define PARKINGAREA_H
 
 #include "ParkingSlot.h"
+#include "IntervalSet.h"
+#include "SummaryBitmap.h"
 
 class ParkingArea {
 private:
@@ -10,6 +12,20 @@ private:
     ParkingSlot* slots;
     int capacity;
     int occupiedCount;
+    IntervalSet* bookings;
+    // Bit set per free slot; change availability through occupySlot and
+    // freeSlot below so it stays in step with the slots
+    SummaryBitmap freeSlots;
+    // Free slots with no booking, which walk-ins take first; a booked
+    // slot is only handed to a stay that ends before its next booking
+    SummaryBitmap walkInSlots;
+    // Zones copied from one another share an area until one of them
+    // changes it (see Zone::ownArea); a copy starts unshared
+    int shareCount;
+    
+    void copyBookings(const ParkingArea& other);
+    void resetFreeSlots();
+    void refreshWalkIn(int index);
 
 public:
     ParkingArea();
@@ -19,6 +35,16 @@ public:
     ParkingArea(const ParkingArea& other);
     ParkingArea& operator=(const ParkingArea& other);
     
+    void configure(int areaID, int zoneID, int capacity);
+    
+    void share();
+    // True once no zone holds the area any more
+    bool unshare();
+    bool isShared() const;
+    // Keeps the slots that stay; false (and unchanged) when shrinking
+    // would drop an occupied or booked slot
+    bool resize(int newCapacity);
+    
     int getAreaID() const;
     int getZoneID() const;
     int getCapacity() const;
@@ -26,8 +52,32 @@ public:
     int getAvailableCount() const;
     
     ParkingSlot* findAvailableSlot();
+    int findAvailableSlotIndex() const;
+    // A free slot whose bookings leave [stayStart, stayEnd) clear, or -1;
+    // unbooked slots are found in O(1), booked ones are checked one by one
+    int findSlotForStay(int stayStart, int stayEnd) const;
+    // False when the slot is out of range or already in that state
+    bool occupySlot(int index);
+    bool freeSlot(int index);
     ParkingSlot* getSlot(int index);
+    const ParkingSlot* getSlot(int index) const;
     ParkingSlot* getSlots();
+    int getSlotIndex(int slotID) const;
+    
+    // Prefers slots free right now, whose current stay cannot run into
+    // the window; O(slots x log bookings)
+    int findSlotFreeDuring(int startTime, int endTime) const;
+    bool bookSlot(int index, int startTime, int endTime, int requestID);
+    bool unbookSlot(int index, int startTime, int requestID);
+    bool hasBookingsFrom(int firstIndex) const;
+    
+    void setSlotAttributes(int firstIndex, int count, int mask);
+    int countSlotsWithAttributes(int mask) const;
+    bool hasSlotAttributes() const;
+    
+    int getBitmapSize() const;
+    void writeOccupancyBitmap(unsigned char* bitmap) const;
+    void loadOccupancyBitmap(const unsigned char* bitmap);
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,182 @@
+#include "ParkingMetrics.h"
+#include <cstdio>
+
+static const double QUANTILES[] = { 50.0, 90.0, 99.0, 99.9 };
+static const int QUANTILE_COUNT = 4;
+
+ParkingMetrics::ParkingMetrics(int zoneCount) {
+    this->zoneCount = zoneCount;
+    zoneMetrics = new ZoneMetrics[zoneCount > 0 ? zoneCount : 1];
+    clear();
+}
+
+ParkingMetrics::~ParkingMetrics() {
+    delete[] zoneMetrics;
+}
+
+void ParkingMetrics::clear() {
+    for (int i = 0; i < METRIC_OPERATION_COUNT; i++) {
+        calls[i].store(0, memory_order_relaxed);
+        failures[i].store(0, memory_order_relaxed);
+        latencies[i].clear();
+    }
+    searchLength.clear();
+    crossZoneAllocations.store(0, memory_order_relaxed);
+    allocations.store(0, memory_order_relaxed);
+    for (int z = 0; z < zoneCount; z++) {
+        ZoneMetrics& zone = zoneMetrics[z];
+        zone.allocations.store(0, memory_order_relaxed);
+        zone.spilledIn.store(0, memory_order_relaxed);
+        zone.spilledOut.store(0, memory_order_relaxed);
+        zone.failures.store(0, memory_order_relaxed);
+        zone.releases.store(0, memory_order_relaxed);
+        zone.allocateLatency.clear();
+    }
+}
+
+void ParkingMetrics::recordOperation(MetricOperation operation, long long nanoseconds, bool succeeded, int zoneIndex) {
+    calls[operation].fetch_add(1, memory_order_relaxed);
+    if (!succeeded) {
+        failures[operation].fetch_add(1, memory_order_relaxed);
+    }
+    latencies[operation].record(nanoseconds);
+    if (operation == METRIC_ALLOCATE && zoneIndex >= 0 && zoneIndex < zoneCount) {
+        zoneMetrics[zoneIndex].allocateLatency.record(nanoseconds);
+    }
+}
+
+void ParkingMetrics::recordAllocation(int requestedZoneIndex, int allocatedZoneIndex, int zonesProbed) {
+    allocations.fetch_add(1, memory_order_relaxed);
+    searchLength.record(zonesProbed);
+    if (allocatedZoneIndex >= 0 && allocatedZoneIndex < zoneCount) {
+        zoneMetrics[allocatedZoneIndex].allocations.fetch_add(1, memory_order_relaxed);
+    }
+    if (requestedZoneIndex != allocatedZoneIndex) {
+        crossZoneAllocations.fetch_add(1, memory_order_relaxed);
+        if (allocatedZoneIndex >= 0 && allocatedZoneIndex < zoneCount) {
+            zoneMetrics[allocatedZoneIndex].spilledIn.fetch_add(1, memory_order_relaxed);
+        }
+        if (requestedZoneIndex >= 0 && requestedZoneIndex < zoneCount) {
+            zoneMetrics[requestedZoneIndex].spilledOut.fetch_add(1, memory_order_relaxed);
+        }
+    }
+}
+
+void ParkingMetrics::recordAllocationFailure(int requestedZoneIndex) {
+    if (requestedZoneIndex >= 0 && requestedZoneIndex < zoneCount) {
+        zoneMetrics[requestedZoneIndex].failures.fetch_add(1, memory_order_relaxed);
+    }
+}
+
+void ParkingMetrics::recordRelease(int zoneIndex) {
+    if (zoneIndex >= 0 && zoneIndex < zoneCount) {
+        zoneMetrics[zoneIndex].releases.fetch_add(1, memory_order_relaxed);
+    }
+}
+
+long long ParkingMetrics::getCallCount(MetricOperation operation) const {
+    return calls[operation].load(memory_order_relaxed);
+}
+
+long long ParkingMetrics::getFailureCount(MetricOperation operation) const {
+    return failures[operation].load(memory_order_relaxed);
+}
+
+const AtomicHistogram& ParkingMetrics::getLatency(MetricOperation operation) const {
+    return latencies[operation];
+}
+
+const AtomicHistogram& ParkingMetrics::getSearchLength() const {
+    return searchLength;
+}
+
+long long ParkingMetrics::getAllocationCount() const {
+    return allocations.load(memory_order_relaxed);
+}
+
+double ParkingMetrics::getCrossZoneRate() const {
+    long long total = getAllocationCount();
+    return (total > 0) ? (double)crossZoneAllocations.load(memory_order_relaxed) / total : 0.0;
+}
+
+double ParkingMetrics::getMaxSpilloverShare() const {
+    long long total = crossZoneAllocations.load(memory_order_relaxed);
+    long long largest = 0;
+    for (int z = 0; z < zoneCount; z++) {
+        long long spilledIn = zoneMetrics[z].spilledIn.load(memory_order_relaxed);
+        if (spilledIn > largest) {
+            largest = spilledIn;
+        }
+    }
+    return (total > 0) ? (double)largest / total : 0.0;
+}
+
+const ZoneMetrics* ParkingMetrics::getZoneMetrics(int zoneIndex) const {
+    if (zoneIndex < 0 || zoneIndex >= zoneCount) {
+        return nullptr;
+    }
+    return &zoneMetrics[zoneIndex];
+}
+
+const char* ParkingMetrics::getOperationName(MetricOperation operation) {
+    switch (operation) {
+        case METRIC_CREATE: return "create";
+        case METRIC_ALLOCATE: return "allocate";
+        case METRIC_OCCUPY: return "occupy";
+        case METRIC_RELEASE: return "release";
+        case METRIC_CANCEL: return "cancel";
+        case METRIC_ROLLBACK: return "rollback";
+        default: return "unknown";
+    }
+}
+
+// One "name{labels} value" line; labels may be empty
+static void appendMetric(string& out, const char* name, const char* labels, long long value) {
+    char line[192];
+    if (labels[0] == '\0') {
+        snprintf(line, sizeof(line), "%s %lld\n", name, value);
+    } else {
+        snprintf(line, sizeof(line), "%s{%s} %lld\n", name, labels, value);
+    }
+    out += line;
+}
+
+void ParkingMetrics::writeText(string& out, const Zone* zones, int zoneCount) const {
+    char labels[96];
+    out += "# TYPE parking_operation_latency_ns summary\n";
+    for (int i = 0; i < METRIC_OPERATION_COUNT; i++) {
+        const char* name = getOperationName((MetricOperation)i);
+        for (int q = 0; q < QUANTILE_COUNT; q++) {
+            snprintf(labels, sizeof(labels), "op=\"%s\",quantile=\"%g\"", name, QUANTILES[q] / 100.0);
+            appendMetric(out, "parking_operation_latency_ns", labels, latencies[i].getPercentile(QUANTILES[q]));
+        }
+        snprintf(labels, sizeof(labels), "op=\"%s\"", name);
+        appendMetric(out, "parking_operation_latency_ns_count", labels, getCallCount((MetricOperation)i));
+        appendMetric(out, "parking_operation_failures_total", labels, getFailureCount((MetricOperation)i));
+    }
+
+    out += "# TYPE parking_allocation_search_zones summary\n";
+    for (int q = 0; q < QUANTILE_COUNT; q++) {
+        snprintf(labels, sizeof(labels), "quantile=\"%g\"", QUANTILES[q] / 100.0);
+        appendMetric(out, "parking_allocation_search_zones", labels, searchLength.getPercentile(QUANTILES[q]));
+    }
+    appendMetric(out, "parking_allocations_total", "", getAllocationCount());
+    appendMetric(out, "parking_cross_zone_allocations_total", "", crossZoneAllocations.load(memory_order_relaxed));
+    appendMetric(out, "parking_spillover_max_share_permille", "", (long long)(getMaxSpilloverShare() * 1000 + 0.5));
+
+    out += "# TYPE parking_zone_allocations_total counter\n";
+    for (int z = 0; z < zoneCount && z < this->zoneCount; z++) {
+        if (zones[z].getZoneID() == -1) {
+            continue;
+        }
+        const ZoneMetrics& zone = zoneMetrics[z];
+        snprintf(labels, sizeof(labels), "zone=\"%d\"", zones[z].getZoneID());
+        appendMetric(out, "parking_zone_allocations_total", labels, zone.allocations.load(memory_order_relaxed));
+        appendMetric(out, "parking_zone_spilled_in_total", labels, zone.spilledIn.load(memory_order_relaxed));
+        appendMetric(out, "parking_zone_spilled_out_total", labels, zone.spilledOut.load(memory_order_relaxed));
+        appendMetric(out, "parking_zone_allocation_failures_total", labels, zone.failures.load(memory_order_relaxed));
+        appendMetric(out, "parking_zone_releases_total", labels, zone.releases.load(memory_order_relaxed));
+        snprintf(labels, sizeof(labels), "zone=\"%d\",quantile=\"0.99\"", zones[z].getZoneID());
+        appendMetric(out, "parking_zone_allocate_latency_ns", labels, zone.allocateLatency.getPercentile(99.0));
+    }
+}
\ No newline at end of file
@@ -0,0 +1,112 @@
+#ifndef PARKINGMETRICS_H
+#define PARKINGMETRICS_H
+
+#include "AtomicHistogram.h"
+#include "Zone.h"
+#include <atomic>
+#include <chrono>
+#include <string>
+using namespace std;
+
+// Instrumentation is on unless the build defines PARKING_NO_METRICS, which
+// removes every counter and clock read from ParkingSystem
+#ifndef PARKING_NO_METRICS
+#define PARKING_METRICS_ENABLED
+#endif
+
+enum MetricOperation {
+    METRIC_CREATE,
+    METRIC_ALLOCATE,
+    METRIC_OCCUPY,
+    METRIC_RELEASE,
+    METRIC_CANCEL,
+    METRIC_ROLLBACK,
+    METRIC_OPERATION_COUNT
+};
+
+struct ZoneMetrics {
+    atomic<long long> allocations;      // slots handed out in this zone
+    atomic<long long> spilledIn;        // ...of which for another zone's request
+    atomic<long long> spilledOut;       // this zone's requests served by a neighbour
+    atomic<long long> failures;         // this zone's requests sent to the waitlist
+    atomic<long long> releases;
+    AtomicHistogram allocateLatency;
+
+    ZoneMetrics() : allocateLatency(0) {
+        allocations.store(0);
+        spilledIn.store(0);
+        spilledOut.store(0);
+        failures.store(0);
+        releases.store(0);
+    }
+};
+
+// Per-operation call counts, failures and latency histograms, plus
+// per-zone allocation counters, for ParkingSystem's public operations.
+// Zones are addressed by their index in the system's zone array.
+class ParkingMetrics {
+private:
+    atomic<long long> calls[METRIC_OPERATION_COUNT];
+    atomic<long long> failures[METRIC_OPERATION_COUNT];
+    AtomicHistogram latencies[METRIC_OPERATION_COUNT];
+    AtomicHistogram searchLength;
+    atomic<long long> crossZoneAllocations;
+    atomic<long long> allocations;
+
+    ZoneMetrics* zoneMetrics;
+    int zoneCount;
+
+    ParkingMetrics(const ParkingMetrics&);
+    ParkingMetrics& operator=(const ParkingMetrics&);
+
+public:
+    ParkingMetrics(int zoneCount);
+    ~ParkingMetrics();
+
+    void recordOperation(MetricOperation operation, long long nanoseconds, bool succeeded, int zoneIndex);
+    void recordAllocation(int requestedZoneIndex, int allocatedZoneIndex, int zonesProbed);
+    void recordAllocationFailure(int requestedZoneIndex);
+    void recordRelease(int zoneIndex);
+    void clear();
+
+    long long getCallCount(MetricOperation operation) const;
+    long long getFailureCount(MetricOperation operation) const;
+    const AtomicHistogram& getLatency(MetricOperation operation) const;
+    const AtomicHistogram& getSearchLength() const;
+    long long getAllocationCount() const;
+    double getCrossZoneRate() const;
+    // Largest fraction of all cross-zone allocations taken by one zone;
+    // near 1 when a single neighbour absorbs every overflow
+    double getMaxSpilloverShare() const;
+    const ZoneMetrics* getZoneMetrics(int zoneIndex) const;
+
+    // Prometheus-style text exposition; zones supplies the zone IDs
+    void writeText(string& out, const Zone* zones, int zoneCount) const;
+
+    static const char* getOperationName(MetricOperation operation);
+};
+
+// Times one ParkingSystem call and records it when finished
+class OperationTimer {
+private:
+    ParkingMetrics* metrics;
+    MetricOperation operation;
+    int zoneIndex;
+    chrono::steady_clock::time_point start;
+
+public:
+    OperationTimer(ParkingMetrics* metrics, MetricOperation operation, int zoneIndex) {
+        this->metrics = metrics;
+        this->operation = operation;
+        this->zoneIndex = zoneIndex;
+        start = chrono::steady_clock::now();
+    }
+
+    bool finish(bool succeeded) {
+        long long elapsed = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count();
+        metrics->recordOperation(operation, elapsed, succeeded, zoneIndex);
+        return succeeded;
+    }
+};
+
+#endif
\ No newline at end of file
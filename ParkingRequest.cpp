@@ -1,11 +1,27 @@
 #include "ParkingRequest.h"
 
+// Next state for every [state][event]. An entry equal to its own row's
+// state marks an illegal event, so a transition is one lookup and one
+// comparison with no per-event branches.
+static constexpr RequestState TRANSITIONS[REQUEST_STATE_COUNT][REQUEST_EVENT_COUNT] = {
+    //             ALLOCATE   OCCUPY     RELEASE    CANCEL
+    /* REQUESTED */ { ALLOCATED, REQUESTED, REQUESTED, CANCELLED },
+    /* ALLOCATED */ { ALLOCATED, OCCUPIED,  ALLOCATED, CANCELLED },
+    /* OCCUPIED  */ { OCCUPIED,  OCCUPIED,  RELEASED,  OCCUPIED  },
+    /* RELEASED  */ { RELEASED,  RELEASED,  RELEASED,  RELEASED  },
+    /* CANCELLED */ { CANCELLED, CANCELLED, CANCELLED, CANCELLED }
+};
+
+static_assert(TRANSITIONS[OCCUPIED][REQUEST_CANCEL] == OCCUPIED, "an occupied slot must be released, not cancelled");
+static_assert(TRANSITIONS[RELEASED][REQUEST_ALLOCATE] == RELEASED, "released requests are final");
+
 ParkingRequest::ParkingRequest() {
     requestID = -1;
     vehicleID = "";
     requestedZone = -1;
     requestTime = 0;
     state = REQUESTED;
+    priority = PRIORITY_STANDARD;
 }
 
 ParkingRequest::ParkingRequest(int requestID, string vehicleID, int requestedZone, int requestTime) {
@@ -14,6 +30,16 @@ ParkingRequest::ParkingRequest(int requestID, string vehicleID, int requestedZon
     this->requestedZone = requestedZone;
     this->requestTime = requestTime;
     this->state = REQUESTED;
+    this->priority = PRIORITY_STANDARD;
+}
+
+ParkingRequest::ParkingRequest(int requestID, string vehicleID, int requestedZone, int requestTime, PriorityClass priority) {
+    this->requestID = requestID;
+    this->vehicleID = vehicleID;
+    this->requestedZone = requestedZone;
+    this->requestTime = requestTime;
+    this->state = REQUESTED;
+    this->priority = priority;
 }
 
 int ParkingRequest::getRequestID() const {
@@ -36,34 +62,51 @@ RequestState ParkingRequest::getState() const {
     return state;
 }
 
+PriorityClass ParkingRequest::getPriority() const {
+    return priority;
+}
+
+bool ParkingRequest::apply(RequestEvent event) {
+    RequestState next = TRANSITIONS[state][event];
+    bool legal = (next != state);
+    state = next;
+    return legal;
+}
+
 bool ParkingRequest::allocate() {
-    if (state == REQUESTED) {
-        state = ALLOCATED;
-        return true;
-    }
-    return false;
+    return apply(REQUEST_ALLOCATE);
 }
 
 bool ParkingRequest::occupy() {
-    if (state == ALLOCATED) {
-        state = OCCUPIED;
-        return true;
-    }
-    return false;
+    return apply(REQUEST_OCCUPY);
 }
 
 bool ParkingRequest::release() {
-    if (state == OCCUPIED) {
-        state = RELEASED;
-        return true;
-    }
-    return false;
+    return apply(REQUEST_RELEASE);
 }
 
 bool ParkingRequest::cancel() {
-    if (state == REQUESTED || state == ALLOCATED) {
-        state = CANCELLED;
-        return true;
+    return apply(REQUEST_CANCEL);
+}
+
+bool ParkingRequest::isLegal(RequestState state, RequestEvent event) {
+    return TRANSITIONS[state][event] != state;
+}
+
+// Requests only change state through their transitions, so a saved state
+// is reached by replaying the path that leads to it
+void ParkingRequest::restoreState(RequestState target) {
+    if (target == CANCELLED) {
+        cancel();
+        return;
+    }
+    if (target == ALLOCATED || target == OCCUPIED || target == RELEASED) {
+        allocate();
+    }
+    if (target == OCCUPIED || target == RELEASED) {
+        occupy();
+    }
+    if (target == RELEASED) {
+        release();
     }
-    return false;
 }
\ No newline at end of file
@@ -12,6 +12,24 @@ enum RequestState {
     CANCELLED
 };
 
+// What can happen to a request; see the transition table in ParkingRequest.cpp
+enum RequestEvent {
+    REQUEST_ALLOCATE,
+    REQUEST_OCCUPY,
+    REQUEST_RELEASE,
+    REQUEST_CANCEL
+};
+
+const int REQUEST_STATE_COUNT = 5;
+const int REQUEST_EVENT_COUNT = 4;
+
+// Waitlist priority classes, higher values are served first
+enum PriorityClass {
+    PRIORITY_STANDARD,
+    PRIORITY_PERMIT_HOLDER,
+    PRIORITY_ACCESSIBLE
+};
+
 class ParkingRequest {
 private:
     int requestID;
@@ -19,21 +37,29 @@ private:
     int requestedZone;
     int requestTime;
     RequestState state;
+    PriorityClass priority;
 
 public:
     ParkingRequest();
     ParkingRequest(int requestID, string vehicleID, int requestedZone, int requestTime);
+    ParkingRequest(int requestID, string vehicleID, int requestedZone, int requestTime, PriorityClass priority);
     
     int getRequestID() const;
     string getVehicleID() const;
     int getRequestedZone() const;
     int getRequestTime() const;
     RequestState getState() const;
+    PriorityClass getPriority() const;
     
+    // Moves to the table's next state; false (state unchanged) when the
+    // event is not legal in the current state
+    bool apply(RequestEvent event);
     bool allocate();
     bool occupy();
     bool release();
     bool cancel();
+    static bool isLegal(RequestState state, RequestEvent event);
+    void restoreState(RequestState target);
 };
 
 #endif
\ No newline at end of file
@@ -4,12 +4,14 @@ ParkingSlot::ParkingSlot() {
     slotID = -1;
     zoneID = -1;
     isAvailable = true;
+    attributes = 0;
 }
 
 ParkingSlot::ParkingSlot(int slotID, int zoneID) {
     this->slotID = slotID;
     this->zoneID = zoneID;
     this->isAvailable = true;
+    this->attributes = 0;
 }
 
 int ParkingSlot::getSlotID() const {
@@ -31,3 +33,15 @@ void ParkingSlot::occupySlot() {
 void ParkingSlot::freeSlot() {
     isAvailable = true;
 }
+
+int ParkingSlot::getAttributes() const {
+    return attributes;
+}
+
+bool ParkingSlot::hasAttributes(int mask) const {
+    return (attributes & mask) == mask;
+}
+
+void ParkingSlot::setAttributes(int mask) {
+    attributes = (unsigned char)mask;
+}
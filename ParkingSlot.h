@@ -1,11 +1,20 @@
 #ifndef PARKINGSLOT_H
 #define PARKINGSLOT_H
 
+// Physical features of a slot, combined as a bit mask
+enum SlotAttribute {
+    SLOT_EV_CHARGER = 1,
+    SLOT_ACCESSIBLE = 2,
+    SLOT_COVERED = 4,
+    SLOT_OVERSIZED = 8
+};
+
 class ParkingSlot {
 private:
     int slotID;
     int zoneID;
     bool isAvailable;
+    unsigned char attributes;
 
 public:
     ParkingSlot();
@@ -14,6 +23,9 @@ public:
     int getSlotID() const;
     int getZoneID() const;
     bool getAvailability() const;
+    int getAttributes() const;
+    bool hasAttributes(int mask) const;
+    void setAttributes(int mask);
 
     void occupySlot();
     void freeSlot();
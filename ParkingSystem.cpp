@@ -1,26 +1,136 @@
 #include "ParkingSystem.h"
+#include "MappedFile.h"
+#include <cstdio>
 #include <iostream>
 
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+static const unsigned char SNAPSHOT_MAGIC[4] = { 'P', 'K', 'S', 'N' };
+static const int SNAPSHOT_VERSION = 10;
+static const int SNAPSHOT_HEADER_SIZE = 28;
+static const int MIN_WAITLIST_SWEEP = 32;
+
+// Context for sweeping one zone's waitlist heap
+struct WaitlistSweep {
+    const ParkingSystem* system;
+    int zoneIndex;
+};
+
+// A copy of the request in `state`; restoreState only moves forward from
+// REQUESTED, so the request is rebuilt first
+static ParkingRequest withState(const ParkingRequest& request, RequestState state) {
+    ParkingRequest copy(request.getRequestID(), request.getVehicleID(), request.getRequestedZone(),
+                        request.getRequestTime(), request.getPriority());
+    copy.restoreState(state);
+    return copy;
+}
+
 ParkingSystem::ParkingSystem(int zoneCount) {
     this->zoneCount = zoneCount;
     zones = new Zone[zoneCount];
+    configuredZoneCount = 0;
+    zoneIndex = new ZoneIndex(zoneCount);
+    areaZones = new ZoneIndex(zoneCount);
     engine = nullptr;
     rollbackManager = new RollbackManager(1000);
+    undoLog = new UndoLog(1000);
+    undoGroup = 0;
+    undoDepth = 0;
+    handOffTime = INT_MIN;
+    redoing = false;
+    transactionOpen = false;
+    transactionStart = 0;
+    savepointCapacity = 4;
+    savepoints = new long long[savepointCapacity];
+    savepointCount = 0;
+    timeline = new OccupancyTimeline(zoneCount, 10, 1024);
+    tariff = new TariffEngine(zoneCount);
+    
+    zoneOccupancy = new int[zoneCount];
+    for (int i = 0; i < zoneCount; i++) {
+        zoneOccupancy[i] = 0;
+    }
+    busiestZones = new ZoneHeap(zoneCount, true);
+    emptiestZones = new ZoneHeap(zoneCount, false);
+    capacityTree = new ZoneCapacityTree(zoneCount);
+    
+    waitlists = new WaitlistQueue[zoneCount];
+    waitingCounts = new int[zoneCount];
+    for (int i = 0; i < zoneCount; i++) {
+        waitingCounts[i] = 0;
+    }
     
     activeRequestCapacity = 10;
     activeRequests = new ParkingRequest[activeRequestCapacity];
     activeRequestCount = 0;
     
+    requestSlots = new ZoneIndex(16);
+    requestEntryCount = 0;
+    requestEntryCapacity = 16;
+    requestEntries = new RequestIndexEntry[requestEntryCapacity];
+    freeRequestEntries = new int[requestEntryCapacity];
+    freeRequestEntryCount = 0;
+    for (int s = 0; s < REQUEST_STATE_COUNT; s++) {
+        stateHeads[s] = -1;
+        stateCounts[s] = 0;
+    }
+    
+    timerWheel = new TimerWheel(0);
+    noShowTimeout = 0;
+    maxStayDuration = 0;
+    overstayedCount = 0;
+    spilloverPolicy = SPILLOVER_NEAREST;
+    
     historyHead = nullptr;
     historyCount = 0;
+    archive = nullptr;
     nextRequestID = 1;
+    
+    wal = nullptr;
+    snapshotSequence = 0;
+    replayingLog = false;
+    logSuppressDepth = 0;
+    
+#ifdef PARKING_METRICS_ENABLED
+    metrics = new ParkingMetrics(zoneCount);
+#endif
+    
+    occupancyListener = nullptr;
+    occupancyContext = nullptr;
 }
 
 ParkingSystem::~ParkingSystem() {
+    delete wal;
     delete[] zones;
+    delete zoneIndex;
+    if (areaZones->unshare()) {
+        delete areaZones;
+    }
     delete engine;
     delete rollbackManager;
+    delete undoLog;
+    delete[] savepoints;
+    delete timeline;
+    delete tariff;
+    delete[] zoneOccupancy;
+    delete busiestZones;
+    delete emptiestZones;
+    delete capacityTree;
+    delete[] waitlists;
+    delete[] waitingCounts;
     delete[] activeRequests;
+    delete requestSlots;
+    delete[] requestEntries;
+    delete[] freeRequestEntries;
+    delete timerWheel;
+    delete archive;
+#ifdef PARKING_METRICS_ENABLED
+    delete metrics;
+#endif
     
     while (historyHead != nullptr) {
         HistoryNode* temp = historyHead;
@@ -29,53 +139,282 @@ ParkingSystem::~ParkingSystem() {
     }
 }
 
+// Zones fill the array in setup order; setting up an existing zone ID
+// again replaces that zone
 void ParkingSystem::setupZone(int zoneID, int areaCount) {
-    for (int i = 0; i < zoneCount; i++) {
-        if (zones[i].getZoneID() == -1 || zones[i].getZoneID() == zoneID) {
-            zones[i] = Zone(zoneID, areaCount);
-            
-            if (engine == nullptr) {
-                engine = new AllocationEngine(zones, zoneCount);
-            }
+    logOperation(LOG_SETUP_ZONE, zoneID, areaCount, 0, 0, "");
+    int i = zoneIndex->find(zoneID);
+    if (i == -1) {
+        if (configuredZoneCount >= zoneCount) {
             return;
         }
+        i = configuredZoneCount++;
+        zoneIndex->insert(zoneID, i);
+        capacityTree->addZone(zoneID, i);
+    }
+    
+    const Zone& replaced = zones[i];
+    for (int a = 0; a < replaced.getAreaCount(); a++) {
+        unindexArea(i, replaced.getArea(a)->getAreaID());
+    }
+    zones[i] = Zone(zoneID, areaCount);
+    
+    zoneOccupancy[i] = 0;
+    busiestZones->insert(i, 0);
+    emptiestZones->insert(i, 1);
+    capacityTree->update(i, 0);
+    
+    if (engine == nullptr) {
+        engine = new AllocationEngine(zones, zoneCount, zoneIndex);
+        engine->setSpilloverPolicy(spilloverPolicy);
     }
 }
 
 void ParkingSystem::setupParkingArea(int zoneID, int areaIndex, int areaID, int slotCapacity) {
-    for (int i = 0; i < zoneCount; i++) {
-        if (zones[i].getZoneID() == zoneID) {
-            zones[i].initializeArea(areaIndex, areaID, slotCapacity);
-            return;
+    logOperation(LOG_SETUP_AREA, zoneID, areaIndex, areaID, slotCapacity, "");
+    int i = zoneIndex->find(zoneID);
+    if (i != -1 && areaIndex >= 0 && areaIndex < zones[i].getAreaCount()) {
+        const Zone& zone = zones[i];
+        unindexArea(i, zone.getArea(areaIndex)->getAreaID());
+        zones[i].initializeArea(areaIndex, areaID, slotCapacity);
+        if (areaID >= 0) {
+            ownAreaZones()->insert(areaID, i);
         }
+        adjustZoneOccupancy(i, 0);
+    }
+}
+
+// An ID set up twice keeps pointing at its latest zone
+void ParkingSystem::unindexArea(int zoneIndex, int areaID) {
+    if (areaID >= 0 && areaZones->find(areaID) == zoneIndex) {
+        ownAreaZones()->remove(areaID);
+    }
+}
+
+ZoneIndex* ParkingSystem::ownAreaZones() {
+    if (areaZones->isShared()) {
+        areaZones->unshare();
+        areaZones = new ZoneIndex(*areaZones);
     }
+    return areaZones;
 }
 
 void ParkingSystem::addZoneAdjacency(int zoneID1, int zoneID2) {
-    for (int i = 0; i < zoneCount; i++) {
-        if (zones[i].getZoneID() == zoneID1) {
-            zones[i].addAdjacentZone(zoneID2);
-        }
-        if (zones[i].getZoneID() == zoneID2) {
-            zones[i].addAdjacentZone(zoneID1);
+    addZoneAdjacency(zoneID1, zoneID2, 1);
+}
+
+// Lower weights are tried first when a request spills over to a neighbour
+void ParkingSystem::addZoneAdjacency(int zoneID1, int zoneID2, int weight) {
+    logOperation(LOG_ADJACENCY, zoneID1, zoneID2, weight, 0, "");
+    int first = zoneIndex->find(zoneID1);
+    int second = zoneIndex->find(zoneID2);
+    if (first != -1) {
+        zones[first].addAdjacentZone(zoneID2, weight);
+    }
+    if (second != -1) {
+        zones[second].addAdjacentZone(zoneID1, weight);
+    }
+}
+
+bool ParkingSystem::setSlotAttributes(int zoneID, int areaIndex, int firstSlot, int count, int mask) {
+    int i = zoneIndex->find(zoneID);
+    if (i == -1 || zones[i].getArea(areaIndex) == nullptr || mask < 0 || mask > 0xFF) {
+        return false;
+    }
+    logOperation(LOG_SLOT_ATTRIBUTES, zoneID, areaIndex, firstSlot, (count << 8) | mask, "");
+    zones[i].getArea(areaIndex)->setSlotAttributes(firstSlot, count, mask);
+    return true;
+}
+
+bool ParkingSystem::setAreaOpen(int zoneID, int areaIndex, bool open) {
+    int i = zoneIndex->find(zoneID);
+    if (i == -1 || areaIndex < 0 || areaIndex >= zones[i].getAreaCount()) {
+        return false;
+    }
+    logOperation(LOG_SET_AREA_OPEN, zoneID, areaIndex, open ? 1 : 0, 0, "");
+    return zones[i].setAreaOpen(areaIndex, open);
+}
+
+// Area IDs number the slots (area ID * 1000 + index), so they must be
+// unique across the whole facility
+int ParkingSystem::addParkingArea(int zoneID, int areaID, int slotCapacity) {
+    int i = zoneIndex->find(zoneID);
+    if (i == -1 || transactionOpen || areaID < 0 || slotCapacity < 0 || slotCapacity > 1000
+        || areaZones->find(areaID) != -1) {
+        return -1;
+    }
+    int areaIndex = zones[i].addArea(areaID, slotCapacity);
+    if (areaIndex == -1) {
+        return -1;
+    }
+    ownAreaZones()->insert(areaID, i);
+    logOperation(LOG_ADD_AREA, zoneID, areaID, slotCapacity, 0, "");
+    adjustZoneOccupancy(i, 0);
+    serveWaitlistAfterGrowth(i, slotCapacity);
+    return areaIndex;
+}
+
+// Slots that go away may still be named by undo records, so the undo log
+// is dropped; the rollback stack only holds allocated (occupied) slots
+bool ParkingSystem::removeParkingArea(int zoneID, int areaIndex) {
+    int i = zoneIndex->find(zoneID);
+    if (i == -1 || transactionOpen || areaIndex < 0 || areaIndex >= zones[i].getAreaCount()) {
+        return false;
+    }
+    const Zone& zone = zones[i];
+    int areaID = zone.getArea(areaIndex)->getAreaID();
+    if (!zones[i].removeArea(areaIndex)) {
+        return false;
+    }
+    unindexArea(i, areaID);
+    logOperation(LOG_REMOVE_AREA, zoneID, areaIndex, 0, 0, "");
+    adjustZoneOccupancy(i, 0);
+    undoLog->clear();
+    return true;
+}
+
+bool ParkingSystem::resizeParkingArea(int zoneID, int areaIndex, int slotCapacity) {
+    int i = zoneIndex->find(zoneID);
+    if (i == -1 || transactionOpen || areaIndex < 0 || areaIndex >= zones[i].getAreaCount() || slotCapacity < 0
+        || slotCapacity > 1000) {
+        return false;
+    }
+    const Zone& zone = zones[i];
+    int added = slotCapacity - zone.getArea(areaIndex)->getCapacity();
+    if (!zones[i].resizeArea(areaIndex, slotCapacity)) {
+        return false;
+    }
+    logOperation(LOG_RESIZE_AREA, zoneID, areaIndex, slotCapacity, 0, "");
+    adjustZoneOccupancy(i, 0);
+    if (added < 0) {
+        undoLog->clear();
+    } else {
+        serveWaitlistAfterGrowth(i, added);
+    }
+    return true;
+}
+
+bool ParkingSystem::removeZoneAdjacency(int zoneID1, int zoneID2) {
+    int first = zoneIndex->find(zoneID1);
+    int second = zoneIndex->find(zoneID2);
+    if (first == -1 || second == -1 || !zones[first].isAdjacentTo(zoneID2)) {
+        return false;
+    }
+    logOperation(LOG_REMOVE_ADJACENCY, zoneID1, zoneID2, 0, 0, "");
+    zones[first].removeAdjacentZone(zoneID2);
+    zones[second].removeAdjacentZone(zoneID1);
+    return true;
+}
+
+// New slots go to waiting requests as if that many had just been
+// released, stopping early once a hand-off no longer takes a slot here
+void ParkingSystem::serveWaitlistAfterGrowth(int zoneIndex, int added) {
+    beginUndoGroup();
+    for (int n = 0; n < added; n++) {
+        int before = zones[zoneIndex].getTotalAvailableSlots();
+        drainWaitlist(zoneIndex);
+        if (zones[zoneIndex].getTotalAvailableSlots() == before) {
+            break;
         }
     }
+    endUndoGroup();
+}
+
+int ParkingSystem::countSlotsWithAttributes(int zoneID, int mask) const {
+    int i = zoneIndex->find(zoneID);
+    if (i == -1) {
+        return 0;
+    }
+    const Zone& zone = zones[i];
+    int count = 0;
+    for (int a = 0; a < zone.getAreaCount(); a++) {
+        count += zone.getArea(a)->countSlotsWithAttributes(mask);
+    }
+    return count;
 }
 
 int ParkingSystem::createParkingRequest(string vehicleID, int requestedZone, int requestTime) {
+    return createParkingRequest(vehicleID, requestedZone, requestTime, PRIORITY_STANDARD);
+}
+
+int ParkingSystem::createParkingRequest(string vehicleID, int requestedZone, int requestTime, PriorityClass priority) {
+#ifdef PARKING_METRICS_ENABLED
+    OperationTimer timer(metrics, METRIC_CREATE, -1);
+#endif
+    int requestID = createRequestInternal(vehicleID, requestedZone, requestTime, priority);
+    logOperation(LOG_CREATE, requestID, requestedZone, requestTime, (int)priority, vehicleID);
+#ifdef PARKING_METRICS_ENABLED
+    timer.finish(true);
+#endif
+    return requestID;
+}
+
+int ParkingSystem::createRequestInternal(string vehicleID, int requestedZone, int requestTime, PriorityClass priority) {
     if (activeRequestCount >= activeRequestCapacity) {
         expandActiveRequests();
     }
     
     int requestID = nextRequestID++;
-    activeRequests[activeRequestCount++] = ParkingRequest(requestID, vehicleID, requestedZone, requestTime);
+    requestEntry(requestID).position = activeRequestCount;
+    activeRequests[activeRequestCount++] = ParkingRequest(requestID, vehicleID, requestedZone, requestTime, priority);
+    linkRequestState(requestID, REQUESTED);
+    
+    return requestID;
+}
+
+int ParkingSystem::createReservation(string vehicleID, int requestedZone, int startTime, int endTime) {
+    if (engine == nullptr || endTime <= startTime) {
+        return -1;
+    }
+    
+    int requestID = createRequestInternal(vehicleID, requestedZone, startTime, PRIORITY_STANDARD);
+    logOperation(LOG_RESERVE, requestedZone, startTime, endTime, 0, vehicleID);
+    ParkingRequest* request = findActiveRequest(requestID);
+    
+    AllocationResult result = engine->reserveSlot(*request, startTime, endTime);
+    if (!result.success) {
+        removeActiveRequest(requestID);
+        return -1;
+    }
+    
+    RequestIndexEntry& entry = *findRequestEntry(requestID);
+    entry.reservedSlotID = result.allocatedSlotID;
+    entry.reservedZoneID = result.allocatedZoneID;
+    entry.reservationStart = startTime;
+    entry.reservationEnd = endTime;
+    entry.reservedCrossZone = result.isCrossZone;
+    
+    // The request stays REQUESTED until its window opens in advanceTime()
+    scheduleRequestTimer(requestID, startTime, RESERVATION_START_TIMER);
     
     return requestID;
 }
 
+bool ParkingSystem::hasReservation(int requestID) const {
+    const RequestIndexEntry* entry = findRequestEntry(requestID);
+    return entry != nullptr && entry->reservedSlotID != -1;
+}
+
 bool ParkingSystem::allocateParking(int requestID) {
+    beginUndoGroup();
+#ifdef PARKING_METRICS_ENABLED
     ParkingRequest* request = findActiveRequest(requestID);
-    if (request == nullptr) {
+    int zoneIndex = (request != nullptr) ? findZoneIndex(request->getRequestedZone()) : -1;
+    OperationTimer timer(metrics, METRIC_ALLOCATE, zoneIndex);
+    bool allocated = timer.finish(allocateInternal(requestID));
+#else
+    bool allocated = allocateInternal(requestID);
+#endif
+    endUndoGroup();
+    return allocated;
+}
+
+bool ParkingSystem::allocateInternal(int requestID) {
+    // Logged even when it fails, since a failed attempt joins the waitlist
+    logOperation(LOG_ALLOCATE, requestID, 0, 0, 0, "");
+    
+    ParkingRequest* request = findActiveRequest(requestID);
+    if (request == nullptr || engine == nullptr) {
         return false;
     }
     
@@ -83,35 +422,118 @@ bool ParkingSystem::allocateParking(int requestID) {
         return false;
     }
     
-    AllocationResult result = engine->allocateSlot(*request);
+    AllocationResult result;
+    RequestIndexEntry& entry = *findRequestEntry(requestID);
+    if (entry.reservedSlotID != -1 && engine->allocateReservedSlot(entry.reservedSlotID, entry.reservedZoneID)) {
+        result.success = true;
+        result.allocatedSlotID = entry.reservedSlotID;
+        result.allocatedZoneID = entry.reservedZoneID;
+        result.isCrossZone = entry.reservedCrossZone;
+    } else if (entry.reservedSlotID != -1) {
+        // The reserved slot is still held by someone else when the window
+        // opens: any slot free for the booked window will do
+        result = engine->allocateSlot(*request, entry.reservationStart, entry.reservationEnd);
+    } else {
+        // A walk-in's stay runs from now until released, or for at most the
+        // maximum stay, and must not run into another driver's booking
+        int stayStart = stayStartFor(*request);
+        int stayEnd = (maxStayDuration > 0) ? stayStart + maxStayDuration : INT_MAX;
+        result = engine->allocateSlot(*request, stayStart, stayEnd);
+    }
     
     if (result.success) {
-        request->allocate();
-        
-        AllocationOperation op(requestID, request->getVehicleID(), 
-                              result.allocatedSlotID, result.allocatedZoneID,
-                              request->getRequestTime(), REQUESTED, ALLOCATED);
-        rollbackManager->pushOperation(op);
-        
-        addToHistory(*request, result.allocatedSlotID, result.allocatedZoneID, result.isCrossZone);
-        
+        commitAllocation(request, result);
         return true;
     }
     
+    // No capacity in the zone or its neighbours: queue the request so the
+    // next freed slot is handed to it without the caller retrying
+#ifdef PARKING_METRICS_ENABLED
+    metrics->recordAllocationFailure(findZoneIndex(request->getRequestedZone()));
+#endif
+    if (!entry.waitlisted) {
+        UndoRecord undo(UNDO_WAITLIST, REQUESTED, requestID, -1, -1, request->getRequestTime());
+        recordUndo(undo);
+    }
+    addToWaitlist(*request);
     return false;
 }
 
+// The stay starts when the slot is handed over: the request time, or now
+// (or the freeing release) if that is later
+int ParkingSystem::stayStartFor(const ParkingRequest& request) const {
+    int stayStart = request.getRequestTime();
+    if (timerWheel->getCurrentTime() > stayStart) {
+        stayStart = timerWheel->getCurrentTime();
+    }
+    if (handOffTime > stayStart) {
+        stayStart = handOffTime;
+    }
+    return stayStart;
+}
+
+void ParkingSystem::commitAllocation(ParkingRequest* request, const AllocationResult& result) {
+    int requestID = request->getRequestID();
+    int stayStart = stayStartFor(*request);
+    
+    UndoRecord undo(REQUEST_ALLOCATE, REQUESTED, requestID, result.allocatedSlotID, result.allocatedZoneID,
+                    stayStart);
+    undo.crossZone = result.isCrossZone;
+    undo.wasWaitlisted = findRequestEntry(requestID)->waitlisted;
+    recordUndo(undo);
+    
+    removeFromWaitlist(requestID);
+    applyRequestEvent(request, REQUEST_ALLOCATE);
+    int zoneIndex = findZoneIndex(result.allocatedZoneID);
+    timeline->startStay(zoneIndex, stayStart);
+    adjustZoneOccupancy(zoneIndex, 1);
+#ifdef PARKING_METRICS_ENABLED
+    metrics->recordAllocation(findZoneIndex(request->getRequestedZone()), zoneIndex, result.zonesProbed);
+#endif
+    
+    AllocationOperation op(requestID, request->getVehicleID(), 
+                          result.allocatedSlotID, result.allocatedZoneID,
+                          stayStart, REQUESTED, ALLOCATED);
+    rollbackManager->pushOperation(op);
+    publishSlotChange(result.allocatedZoneID, result.allocatedSlotID, SLOT_FREE, SLOT_ALLOCATED);
+    
+    addToHistory(*request, result.allocatedSlotID, result.allocatedZoneID, result.isCrossZone, stayStart);
+    
+    armStateTimer(requestID, ALLOCATED, stayStart);
+}
+
 bool ParkingSystem::occupyParking(int requestID) {
+    beginUndoGroup();
+#ifdef PARKING_METRICS_ENABLED
+    OperationTimer timer(metrics, METRIC_OCCUPY, -1);
+    bool occupied = timer.finish(occupyInternal(requestID));
+#else
+    bool occupied = occupyInternal(requestID);
+#endif
+    endUndoGroup();
+    return occupied;
+}
+
+bool ParkingSystem::occupyInternal(int requestID) {
     ParkingRequest* request = findActiveRequest(requestID);
     if (request == nullptr) {
         return false;
     }
     
-    if (request->occupy()) {
+    if (applyRequestEvent(request, REQUEST_OCCUPY)) {
+        logOperation(LOG_OCCUPY, requestID, 0, 0, 0, "");
+        
         HistoryNode* histNode = findInHistory(requestID);
         if (histNode != nullptr) {
-            histNode->request = *request;
+            UndoRecord undo(REQUEST_OCCUPY, ALLOCATED, requestID, histNode->allocatedSlotID,
+                            histNode->allocatedZoneID, histNode->allocatedTime);
+            recordUndo(undo);
+            updateHistoryNode(histNode, *request, histNode->releaseTime, histNode->charge);
+            publishSlotChange(histNode->allocatedZoneID, histNode->allocatedSlotID, SLOT_ALLOCATED, SLOT_OCCUPIED);
         }
+        
+        int stayStart = (histNode != nullptr) ? histNode->allocatedTime : request->getRequestTime();
+        armStateTimer(requestID, OCCUPIED, stayStart);
         return true;
     }
     
@@ -119,6 +541,18 @@ bool ParkingSystem::occupyParking(int requestID) {
 }
 
 bool ParkingSystem::releaseParking(int requestID, int releaseTime) {
+    beginUndoGroup();
+#ifdef PARKING_METRICS_ENABLED
+    OperationTimer timer(metrics, METRIC_RELEASE, -1);
+    bool released = timer.finish(releaseInternal(requestID, releaseTime));
+#else
+    bool released = releaseInternal(requestID, releaseTime);
+#endif
+    endUndoGroup();
+    return released;
+}
+
+bool ParkingSystem::releaseInternal(int requestID, int releaseTime) {
     ParkingRequest* request = findActiveRequest(requestID);
     if (request == nullptr) {
         return false;
@@ -129,14 +563,47 @@ bool ParkingSystem::releaseParking(int requestID, int releaseTime) {
         return false;
     }
     
-    if (request->release()) {
-        engine->freeSlot(histNode->allocatedSlotID, histNode->allocatedZoneID);
+    if (applyRequestEvent(request, REQUEST_RELEASE)) {
+        logOperation(LOG_RELEASE, requestID, releaseTime, 0, 0, "");
+        
+        int freedZoneIndex = -1;
+        if (engine->freeSlot(histNode->allocatedSlotID, histNode->allocatedZoneID)) {
+            freedZoneIndex = findZoneIndex(histNode->allocatedZoneID);
+            timeline->endStay(freedZoneIndex, releaseTime);
+            adjustZoneOccupancy(freedZoneIndex, -1);
+#ifdef PARKING_METRICS_ENABLED
+            metrics->recordRelease(freedZoneIndex);
+#endif
+            publishSlotChange(histNode->allocatedZoneID, histNode->allocatedSlotID, SLOT_OCCUPIED, SLOT_FREE);
+        }
+        
+        int chargedZoneIndex = findZoneIndex(histNode->allocatedZoneID);
+        int charge = tariff->computeCharge(chargedZoneIndex, histNode->allocatedTime, releaseTime,
+                                           histNode->isCrossZone);
+        updateHistoryNode(histNode, *request, releaseTime, charge);
+        tariff->recordCharge(chargedZoneIndex, releaseTime, histNode->charge);
         
-        histNode->request = *request;
-        histNode->releaseTime = releaseTime;
+        UndoRecord undo(REQUEST_RELEASE, OCCUPIED, requestID, histNode->allocatedSlotID,
+                        histNode->allocatedZoneID, releaseTime);
+        undo.charge = histNode->charge;
+        undo.crossZone = histNode->isCrossZone;
+        recordUndo(undo);
+        archiveHistoryNode(histNode);
+        
+        cancelRequestTimer(requestID);
+        releaseReservation(requestID);
+        RequestIndexEntry* entry = findRequestEntry(requestID);
+        if (entry->overstayed) {
+            entry->overstayed = false;
+            overstayedCount--;
+        }
         
         removeActiveRequest(requestID);
         
+        if (freedZoneIndex != -1) {
+            drainWaitlist(freedZoneIndex, releaseTime);
+        }
+        
         return true;
     }
     
@@ -144,6 +611,18 @@ bool ParkingSystem::releaseParking(int requestID, int releaseTime) {
 }
 
 bool ParkingSystem::cancelRequest(int requestID) {
+    beginUndoGroup();
+#ifdef PARKING_METRICS_ENABLED
+    OperationTimer timer(metrics, METRIC_CANCEL, -1);
+    bool cancelled = timer.finish(cancelInternal(requestID));
+#else
+    bool cancelled = cancelInternal(requestID);
+#endif
+    endUndoGroup();
+    return cancelled;
+}
+
+bool ParkingSystem::cancelInternal(int requestID) {
     ParkingRequest* request = findActiveRequest(requestID);
     if (request == nullptr) {
         return false;
@@ -151,18 +630,41 @@ bool ParkingSystem::cancelRequest(int requestID) {
     
     RequestState oldState = request->getState();
     
-    if (request->cancel()) {
+    if (applyRequestEvent(request, REQUEST_CANCEL)) {
+        logOperation(LOG_CANCEL, requestID, 0, 0, 0, "");
+        
+        UndoRecord undo(REQUEST_CANCEL, oldState, requestID, -1, -1, request->getRequestTime());
+        undo.wasWaitlisted = findRequestEntry(requestID)->waitlisted;
+        int freedZoneIndex = -1;
         if (oldState == ALLOCATED) {
             HistoryNode* histNode = findInHistory(requestID);
             if (histNode != nullptr) {
-                engine->freeSlot(histNode->allocatedSlotID, histNode->allocatedZoneID);
-                histNode->request = *request;
+                undo.slotID = histNode->allocatedSlotID;
+                undo.zoneID = histNode->allocatedZoneID;
+                undo.time = histNode->allocatedTime;
+                if (engine->freeSlot(histNode->allocatedSlotID, histNode->allocatedZoneID)) {
+                    freedZoneIndex = findZoneIndex(histNode->allocatedZoneID);
+                    timeline->endStay(freedZoneIndex, histNode->allocatedTime);
+                    adjustZoneOccupancy(freedZoneIndex, -1);
+                    publishSlotChange(histNode->allocatedZoneID, histNode->allocatedSlotID,
+                                      SLOT_ALLOCATED, SLOT_FREE);
+                }
+                updateHistoryNode(histNode, *request, histNode->releaseTime, histNode->charge);
             }
         } else if (oldState == REQUESTED) {
-            addToHistory(*request, -1, -1, false);
+            addToHistory(*request, -1, -1, false, request->getRequestTime());
         }
+        recordUndo(undo);
+        archiveHistoryNode(findInHistory(requestID));
         
+        cancelRequestTimer(requestID);
+        releaseReservation(requestID);
+        removeFromWaitlist(requestID);
         removeActiveRequest(requestID);
+        
+        if (freedZoneIndex != -1) {
+            drainWaitlist(freedZoneIndex);
+        }
         return true;
     }
     
@@ -170,169 +672,1765 @@ bool ParkingSystem::cancelRequest(int requestID) {
 }
 
 bool ParkingSystem::rollbackLastAllocation() {
-    AllocationOperation op;
-    if (!rollbackManager->popOperation(op)) {
+    beginUndoGroup();
+#ifdef PARKING_METRICS_ENABLED
+    OperationTimer timer(metrics, METRIC_ROLLBACK, -1);
+    bool rolledBack = timer.finish(rollbackInternal());
+#else
+    bool rolledBack = rollbackInternal();
+#endif
+    endUndoGroup();
+    return rolledBack;
+}
+
+// Only a request still ALLOCATED to the operation's slot can be rolled
+// back; operations whose request has since been occupied, released,
+// cancelled or undone are stale and skipped, so a slot is never freed from
+// under a parked vehicle or a later request
+bool ParkingSystem::rollbackInternal() {
+    if (rollbackManager->isEmpty()) {
         return false;
     }
+    logOperation(LOG_ROLLBACK, 0, 0, 0, 0, "");
+    
+    AllocationOperation op;
+    ParkingRequest* request = nullptr;
+    while (request == nullptr) {
+        if (!rollbackManager->popOperation(op)) {
+            return false;
+        }
+        request = findActiveRequest(op.requestID);
+        HistoryNode* histNode = findInHistory(op.requestID);
+        bool current = request != nullptr && request->getState() == ALLOCATED
+                    && histNode != nullptr && histNode->allocatedSlotID == op.allocatedSlotID;
+        if (!current) {
+            request = nullptr;
+        }
+    }
+    
+    UndoRecord undo(UNDO_ROLLBACK, ALLOCATED, op.requestID, op.allocatedSlotID, op.allocatedZoneID,
+                    op.requestTime);
+    recordUndo(undo);
     
-    ParkingRequest* request = findActiveRequest(op.requestID);
+    int freedZoneIndex = -1;
+    if (engine->freeSlot(op.allocatedSlotID, op.allocatedZoneID)) {
+        freedZoneIndex = findZoneIndex(op.allocatedZoneID);
+        timeline->endStay(freedZoneIndex, op.requestTime);
+        adjustZoneOccupancy(freedZoneIndex, -1);
+        publishSlotChange(op.allocatedZoneID, op.allocatedSlotID, SLOT_ALLOCATED, SLOT_FREE);
+    }
     
-    engine->freeSlot(op.allocatedSlotID, op.allocatedZoneID);
+    // The history entry keeps its ALLOCATED state, as before archiving
+    applyRequestEvent(request, REQUEST_CANCEL);
+    archiveHistoryNode(findInHistory(op.requestID));
+    cancelRequestTimer(op.requestID);
+    releaseReservation(op.requestID);
     
-    if (request != nullptr) {
-        request->cancel();
+    if (freedZoneIndex != -1) {
+        drainWaitlist(freedZoneIndex);
     }
     
     return true;
 }
 
-bool ParkingSystem::rollbackLastKAllocations(int k) {
-    int rolledBack = 0;
-    for (int i = 0; i < k; i++) {
-        if (rollbackLastAllocation()) {
-            rolledBack++;
-        } else {
-            break;
-        }
+void ParkingSystem::beginUndoGroup() {
+    if (undoDepth == 0) {
+        undoGroup++;
     }
-    return rolledBack > 0;
+    undoDepth++;
 }
 
-ParkingAnalytics ParkingSystem::getAnalytics() const {
-    ParkingAnalytics analytics;
-    
-    int totalDuration = 0;
-    int completedCount = 0;
-    int crossZoneCount = 0;
-    
-    HistoryNode* current = historyHead;
-    while (current != nullptr) {
-        analytics.totalRequests++;
-        
-        if (current->request.getState() == RELEASED && current->releaseTime != -1) {
-            completedCount++;
-            int duration = current->releaseTime - current->request.getRequestTime();
-            totalDuration += duration;
-        }
-        
-        if (current->request.getState() == CANCELLED) {
-            analytics.cancelledRequests++;
-        }
-        
-        if (current->isCrossZone) {
-            crossZoneCount++;
-        }
-        
-        current = current->next;
+void ParkingSystem::endUndoGroup() {
+    undoDepth--;
+}
+
+void ParkingSystem::recordUndo(UndoRecord& record) {
+    if (redoing) {
+        return;
     }
-    
-    analytics.completedRequests = completedCount;
-    analytics.crossZoneAllocations = crossZoneCount;
-    
-    if (completedCount > 0) {
-        analytics.averageParkingDuration = (double)totalDuration / completedCount;
+    record.group = undoGroup;
+    undoLog->record(record);
+}
+
+// Transitions are undone newest first. Each one checks that the request is
+// still where the transition left it and fails otherwise, leaving the rest
+// of the group in place.
+bool ParkingSystem::undoLastOperation() {
+    if (transactionOpen) {
+        return false;
     }
-    
-    int totalSlots = 0;
-    int occupiedSlots = 0;
-    for (int i = 0; i < zoneCount; i++) {
-        totalSlots += zones[i].getTotalCapacity();
-        occupiedSlots += (zones[i].getTotalCapacity() - zones[i].getTotalAvailableSlots());
+    logOperation(LOG_UNDO, 0, 0, 0, 0, "");
+    UndoRecord record;
+    if (!undoLog->peekUndo(record)) {
+        return false;
     }
     
-    if (totalSlots > 0) {
-        analytics.zoneUtilizationRate = (double)occupiedSlots / totalSlots * 100.0;
+    int group = record.group;
+    bool undone = true;
+    logSuppressDepth++;
+    while (undoLog->peekUndo(record) && record.group == group) {
+        if (!undoRecord(record)) {
+            undone = false;
+            break;
+        }
+        undoLog->commitUndo();
     }
-    
-    return analytics;
+    logSuppressDepth--;
+    return undone;
 }
 
-void ParkingSystem::printZoneUtilization() const {
-    std::cout << "\n=== Zone Utilization ===" << std::endl;
-    for (int i = 0; i < zoneCount; i++) {
-        int total = zones[i].getTotalCapacity();
-        int available = zones[i].getTotalAvailableSlots();
-        int occupied = total - available;
-        double utilization = (total > 0) ? ((double)occupied / total * 100.0) : 0.0;
-        
-        std::cout << "Zone " << zones[i].getZoneID() << ": "
-                  << occupied << "/" << total << " occupied ("
-                  << utilization << "%)" << std::endl;
+// Transitions are redone oldest first through the same code that made them,
+// except that waitlist hand-offs come from the log rather than being
+// derived again
+bool ParkingSystem::redoLastOperation() {
+    if (transactionOpen) {
+        return false;
+    }
+    logOperation(LOG_REDO, 0, 0, 0, 0, "");
+    UndoRecord record;
+    if (!undoLog->peekRedo(record)) {
+        return false;
+    }
+    
+    int group = record.group;
+    bool redone = true;
+    logSuppressDepth++;
+    redoing = true;
+    while (undoLog->peekRedo(record) && record.group == group) {
+        if (!redoRecord(record)) {
+            redone = false;
+            break;
+        }
+        undoLog->commitRedo();
     }
+    redoing = false;
+    logSuppressDepth--;
+    return redone;
 }
 
-int ParkingSystem::getPeakUsageZone() const {
-    int peakZoneID = -1;
-    int maxOccupied = -1;
-    
-    for (int i = 0; i < zoneCount; i++) {
-        int occupied = zones[i].getTotalCapacity() - zones[i].getTotalAvailableSlots();
-        if (occupied > maxOccupied) {
-            maxOccupied = occupied;
-            peakZoneID = zones[i].getZoneID();
+// Undoes the newest records until the log is back at `position`; what was
+// undone cannot be redone
+bool ParkingSystem::undoToPosition(long long position) {
+    UndoRecord record;
+    bool undone = true;
+    logSuppressDepth++;
+    while (undoLog->getPosition() > position && undoLog->peekUndo(record)) {
+        if (!undoRecord(record)) {
+            undone = false;
+            break;
         }
+        undoLog->commitUndo();
     }
-    
-    return peakZoneID;
+    undoLog->discardRedo();
+    logSuppressDepth--;
+    return undone;
 }
 
-void ParkingSystem::expandActiveRequests() {
-    activeRequestCapacity *= 2;
-    ParkingRequest* newArray = new ParkingRequest[activeRequestCapacity];
-    for (int i = 0; i < activeRequestCount; i++) {
-        newArray[i] = activeRequests[i];
+bool ParkingSystem::beginTransaction() {
+    if (transactionOpen) {
+        return false;
     }
-    delete[] activeRequests;
-    activeRequests = newArray;
+    logOperation(LOG_BEGIN_TRANSACTION, 0, 0, 0, 0, "");
+    beginUndoGroup();
+    undoLog->setPinnedGroup(undoGroup);
+    transactionOpen = true;
+    transactionStart = undoLog->getPosition();
+    savepointCount = 0;
+    return true;
 }
 
-ParkingRequest* ParkingSystem::findActiveRequest(int requestID) {
-    for (int i = 0; i < activeRequestCount; i++) {
-        if (activeRequests[i].getRequestID() == requestID) {
-            return &activeRequests[i];
+int ParkingSystem::setSavepoint() {
+    if (!transactionOpen) {
+        return -1;
+    }
+    logOperation(LOG_SAVEPOINT, 0, 0, 0, 0, "");
+    if (savepointCount == savepointCapacity) {
+        long long* newSavepoints = new long long[savepointCapacity * 2];
+        for (int i = 0; i < savepointCount; i++) {
+            newSavepoints[i] = savepoints[i];
         }
+        delete[] savepoints;
+        savepoints = newSavepoints;
+        savepointCapacity *= 2;
     }
-    return nullptr;
+    savepoints[savepointCount] = undoLog->getPosition();
+    return savepointCount++;
 }
 
-void ParkingSystem::removeActiveRequest(int requestID) {
-    for (int i = 0; i < activeRequestCount; i++) {
-        if (activeRequests[i].getRequestID() == requestID) {
-            for (int j = i; j < activeRequestCount - 1; j++) {
-                activeRequests[j] = activeRequests[j + 1];
-            }
-            activeRequestCount--;
-            return;
-        }
+bool ParkingSystem::rollbackToSavepoint(int savepoint) {
+    if (!transactionOpen || savepoint < 0 || savepoint >= savepointCount) {
+        return false;
     }
+    logOperation(LOG_ROLLBACK_TO_SAVEPOINT, savepoint, 0, 0, 0, "");
+    savepointCount = savepoint + 1;
+    return undoToPosition(savepoints[savepoint]);
 }
 
-void ParkingSystem::addToHistory(const ParkingRequest& request, int slotID, int zoneID, bool crossZone) {
-    HistoryNode* newNode = new HistoryNode(request, slotID, zoneID, crossZone);
-    newNode->next = historyHead;
-    historyHead = newNode;
-    historyCount++;
+bool ParkingSystem::commitTransaction() {
+    if (!transactionOpen) {
+        return false;
+    }
+    logOperation(LOG_COMMIT_TRANSACTION, 0, 0, 0, 0, "");
+    transactionOpen = false;
+    savepointCount = 0;
+    undoLog->setPinnedGroup(-1);
+    endUndoGroup();
+    return true;
 }
 
-HistoryNode* ParkingSystem::findInHistory(int requestID) {
-    HistoryNode* current = historyHead;
-    while (current != nullptr) {
-        if (current->request.getRequestID() == requestID) {
-            return current;
-        }
-        current = current->next;
+bool ParkingSystem::abortTransaction() {
+    if (!transactionOpen) {
+        return false;
     }
-    return nullptr;
+    logOperation(LOG_ABORT_TRANSACTION, 0, 0, 0, 0, "");
+    bool aborted = undoToPosition(transactionStart);
+    transactionOpen = false;
+    savepointCount = 0;
+    undoLog->setPinnedGroup(-1);
+    endUndoGroup();
+    return aborted;
 }
 
-Zone* ParkingSystem::getZones() {
-    return zones;
+bool ParkingSystem::inTransaction() const {
+    return transactionOpen;
 }
 
-int ParkingSystem::getZoneCount() const {
-    return zoneCount;
+bool ParkingSystem::canUndo() const {
+    return undoLog->getUndoCount() > 0;
 }
 
-ParkingRequest* ParkingSystem::getActiveRequest(int requestID) {
-    return findActiveRequest(requestID);
+bool ParkingSystem::canRedo() const {
+    return undoLog->getRedoCount() > 0;
+}
+
+bool ParkingSystem::undoRecord(const UndoRecord& record) {
+    int requestID = record.requestID;
+    ParkingRequest* request = findActiveRequest(requestID);
+    HistoryNode* histNode = nullptr;
+    AllocationOperation op;
+    
+    switch (record.event) {
+        case REQUEST_ALLOCATE:
+            if (request == nullptr || request->getState() != ALLOCATED) {
+                return false;
+            }
+            dropSlot(record.zoneID, record.slotID, SLOT_ALLOCATED, record.time);
+            forceRequestState(request, REQUESTED);
+            discardHistoryNode(requestID);
+            cancelRequestTimer(requestID);
+            if (rollbackManager->peekOperation(op) && op.requestID == requestID && op.allocatedSlotID == record.slotID) {
+                rollbackManager->popOperation(op);
+            }
+            if (record.wasWaitlisted) {
+                addToWaitlist(*request);
+            }
+            return true;
+            
+        case REQUEST_OCCUPY:
+            if (request == nullptr || request->getState() != OCCUPIED) {
+                return false;
+            }
+            forceRequestState(request, ALLOCATED);
+            histNode = findInHistory(requestID);
+            if (histNode != nullptr) {
+                updateHistoryNode(histNode, *request, histNode->releaseTime, histNode->charge);
+            }
+            publishSlotChange(record.zoneID, record.slotID, SLOT_OCCUPIED, SLOT_ALLOCATED);
+            if (findRequestEntry(requestID)->overstayed) {
+                findRequestEntry(requestID)->overstayed = false;
+                overstayedCount--;
+            }
+            armStateTimer(requestID, ALLOCATED, record.time);
+            return true;
+            
+        case REQUEST_RELEASE:
+            histNode = (request == nullptr) ? reclaimHistoryNode(requestID) : nullptr;
+            if (histNode == nullptr || histNode->request.getState() != RELEASED
+                || !holdSlot(record.zoneID, record.slotID, SLOT_OCCUPIED, record.time)) {
+                return false;
+            }
+            tariff->reverseCharge(findZoneIndex(record.zoneID), record.time, record.charge);
+            updateHistoryNode(histNode, withState(histNode->request, OCCUPIED), -1, 0);
+            restoreActiveRequest(histNode->request);
+            armStateTimer(requestID, OCCUPIED, record.time);
+            return true;
+            
+        case REQUEST_CANCEL:
+            histNode = (request == nullptr) ? reclaimHistoryNode(requestID) : nullptr;
+            if (histNode == nullptr || histNode->request.getState() != CANCELLED) {
+                return false;
+            }
+            if (record.fromState == ALLOCATED) {
+                if (!holdSlot(record.zoneID, record.slotID, SLOT_ALLOCATED, record.time)) {
+                    return false;
+                }
+                updateHistoryNode(histNode, withState(histNode->request, ALLOCATED), histNode->releaseTime,
+                                  histNode->charge);
+                restoreActiveRequest(histNode->request);
+                armStateTimer(requestID, ALLOCATED, record.time);
+            } else {
+                ParkingRequest restored = withState(histNode->request, REQUESTED);
+                discardHistoryNode(requestID);
+                request = restoreActiveRequest(restored);
+                if (record.wasWaitlisted) {
+                    addToWaitlist(*request);
+                }
+            }
+            return true;
+            
+        case UNDO_ROLLBACK:
+            if (request == nullptr || request->getState() != CANCELLED) {
+                return false;
+            }
+            histNode = reclaimHistoryNode(requestID);
+            if (histNode == nullptr || !holdSlot(record.zoneID, record.slotID, SLOT_ALLOCATED, record.time)) {
+                return false;
+            }
+            forceRequestState(request, ALLOCATED);
+            rollbackManager->pushOperation(AllocationOperation(requestID, request->getVehicleID(), record.slotID,
+                                                               record.zoneID, record.time, REQUESTED, ALLOCATED));
+            armStateTimer(requestID, ALLOCATED, record.time);
+            return true;
+            
+        case UNDO_WAITLIST:
+            if (request == nullptr || request->getState() != REQUESTED) {
+                return false;
+            }
+            removeFromWaitlist(requestID);
+            return true;
+    }
+    return false;
+}
+
+bool ParkingSystem::redoRecord(const UndoRecord& record) {
+    ParkingRequest* request = findActiveRequest(record.requestID);
+    
+    switch (record.event) {
+        case REQUEST_ALLOCATE: {
+            if (request == nullptr || request->getState() != REQUESTED
+                || !engine->allocateReservedSlot(record.slotID, record.zoneID)) {
+                return false;
+            }
+            AllocationResult result;
+            result.success = true;
+            result.allocatedSlotID = record.slotID;
+            result.allocatedZoneID = record.zoneID;
+            result.isCrossZone = record.crossZone;
+            int previousHandOff = handOffTime;
+            handOffTime = record.time;
+            commitAllocation(request, result);
+            handOffTime = previousHandOff;
+            return true;
+        }
+        case REQUEST_OCCUPY:
+            return occupyInternal(record.requestID);
+        case REQUEST_RELEASE:
+            return releaseInternal(record.requestID, record.time);
+        case REQUEST_CANCEL:
+            return cancelInternal(record.requestID);
+        case UNDO_ROLLBACK:
+            return rollbackInternal();
+        case UNDO_WAITLIST:
+            if (request == nullptr || request->getState() != REQUESTED) {
+                return false;
+            }
+            addToWaitlist(*request);
+            return true;
+    }
+    return false;
+}
+
+// Puts a slot back into the state a transition took it out of, with the
+// zone totals and timeline to match
+bool ParkingSystem::holdSlot(int zoneID, int slotID, SlotOccupancy state, int stayStart) {
+    if (!engine->allocateReservedSlot(slotID, zoneID)) {
+        return false;
+    }
+    int zoneIndex = findZoneIndex(zoneID);
+    timeline->startStay(zoneIndex, stayStart);
+    adjustZoneOccupancy(zoneIndex, 1);
+    publishSlotChange(zoneID, slotID, SLOT_FREE, state);
+    return true;
+}
+
+void ParkingSystem::dropSlot(int zoneID, int slotID, SlotOccupancy state, int stayEnd) {
+    if (!engine->freeSlot(slotID, zoneID)) {
+        return;
+    }
+    int zoneIndex = findZoneIndex(zoneID);
+    timeline->endStay(zoneIndex, stayEnd);
+    adjustZoneOccupancy(zoneIndex, -1);
+    publishSlotChange(zoneID, slotID, state, SLOT_FREE);
+}
+
+bool ParkingSystem::rollbackLastKAllocations(int k) {
+    int rolledBack = 0;
+    for (int i = 0; i < k; i++) {
+        if (rollbackLastAllocation()) {
+            rolledBack++;
+        } else {
+            break;
+        }
+    }
+    return rolledBack > 0;
+}
+
+ParkingAnalytics ParkingSystem::getAnalytics() const {
+    ParkingAnalytics analytics;
+    
+    // Running totals, so history is never scanned: resident entries, those
+    // moved to the archive and those a fork inherited
+    HistoryTotals totals = residentTotals;
+    totals.add(inheritedTotals, 1);
+    if (archive != nullptr) {
+        totals.add(archive->getTotals(), 1);
+    }
+    analytics.totalRequests = totals.entries;
+    analytics.completedRequests = totals.completed;
+    analytics.cancelledRequests = totals.cancelled;
+    analytics.crossZoneAllocations = totals.crossZone;
+    analytics.totalRevenue = tariff->getTotalRevenue();
+    
+    if (totals.completed > 0) {
+        analytics.averageParkingDuration = (double)totals.totalDuration / totals.completed;
+    }
+    
+    int totalSlots = 0;
+    int occupiedSlots = 0;
+    for (int i = 0; i < zoneCount; i++) {
+        totalSlots += zones[i].getTotalCapacity();
+        occupiedSlots += (zones[i].getTotalCapacity() - zones[i].getTotalAvailableSlots());
+    }
+    
+    if (totalSlots > 0) {
+        analytics.zoneUtilizationRate = (double)occupiedSlots / totalSlots * 100.0;
+    }
+    
+    return analytics;
+}
+
+void ParkingSystem::printZoneUtilization() const {
+    std::cout << "\n=== Zone Utilization ===" << std::endl;
+    for (int i = 0; i < zoneCount; i++) {
+        int total = zones[i].getTotalCapacity();
+        int available = zones[i].getTotalAvailableSlots();
+        int occupied = total - available;
+        double utilization = (total > 0) ? ((double)occupied / total * 100.0) : 0.0;
+        
+        std::cout << "Zone " << zones[i].getZoneID() << ": "
+                  << occupied << "/" << total << " occupied ("
+                  << utilization << "%)" << std::endl;
+    }
+}
+
+int ParkingSystem::getPeakUsageZone() const {
+    int zoneIndex = busiestZones->top();
+    if (zoneIndex == -1) {
+        return -1;
+    }
+    return zones[zoneIndex].getZoneID();
+}
+
+int ParkingSystem::getTopKZones(int k, int* zoneIDsOut) const {
+    int found = busiestZones->getTopK(k, zoneIDsOut);
+    for (int i = 0; i < found; i++) {
+        zoneIDsOut[i] = zones[zoneIDsOut[i]].getZoneID();
+    }
+    return found;
+}
+
+int ParkingSystem::getLeastUtilizedZones(int k, int* zoneIDsOut) const {
+    int found = emptiestZones->getTopK(k, zoneIDsOut);
+    for (int i = 0; i < found; i++) {
+        zoneIDsOut[i] = zones[zoneIDsOut[i]].getZoneID();
+    }
+    return found;
+}
+
+long long ParkingSystem::getFreeSlotsBetween(int fromZoneID, int toZoneID) const {
+    return capacityTree->rangeSum(fromZoneID, toZoneID);
+}
+
+int ParkingSystem::getMostAvailableZone(int fromZoneID, int toZoneID) const {
+    int i = capacityTree->rangeArgMax(fromZoneID, toZoneID);
+    return (i != -1) ? zones[i].getZoneID() : -1;
+}
+
+bool ParkingSystem::configureTimeline(int bucketWidth, int bucketCount) {
+    if (stateCounts[ALLOCATED] > 0 || stateCounts[OCCUPIED] > 0) {
+        return false;
+    }
+    logOperation(LOG_CONFIGURE_TIMELINE, bucketWidth, bucketCount, 0, 0, "");
+    delete timeline;
+    timeline = new OccupancyTimeline(zoneCount, bucketWidth, bucketCount);
+    return true;
+}
+
+// Average occupied share of the zone's slots over [fromTime, toTime],
+// measured at bucket granularity
+double ParkingSystem::getZoneUtilizationBetween(int zoneID, int fromTime, int toTime) const {
+    int zoneIndex = findZoneIndex(zoneID);
+    if (zoneIndex == -1) {
+        return 0.0;
+    }
+    
+    int capacity = zones[zoneIndex].getTotalCapacity();
+    int buckets = timeline->getBucketSpan(fromTime, toTime);
+    if (capacity == 0 || buckets == 0) {
+        return 0.0;
+    }
+    
+    long long occupied = timeline->getOccupancySum(zoneIndex, fromTime, toTime);
+    return (double)occupied / ((double)capacity * buckets) * 100.0;
+}
+
+int ParkingSystem::getPeakOccupancyBetween(int zoneID, int fromTime, int toTime) const {
+    int zoneIndex = findZoneIndex(zoneID);
+    if (zoneIndex == -1) {
+        return 0;
+    }
+    return timeline->getPeakOccupancy(zoneIndex, fromTime, toTime);
+}
+
+bool ParkingSystem::setZoneRate(int zoneID, int ratePerUnit) {
+    logOperation(LOG_SET_ZONE_RATE, zoneID, ratePerUnit, 0, 0, "");
+    return tariff->setZoneRate(findZoneIndex(zoneID), ratePerUnit);
+}
+
+void ParkingSystem::setCrossZoneSurcharge(int amount) {
+    logOperation(LOG_SET_SURCHARGE, amount, 0, 0, 0, "");
+    tariff->setCrossZoneSurcharge(amount);
+}
+
+// Resets the bands and the revenue intervals (zone totals are kept)
+bool ParkingSystem::configureTariff(int dayLength, int revenueInterval) {
+    logOperation(LOG_CONFIGURE_TARIFF, dayLength, revenueInterval, 0, 0, "");
+    return tariff->configure(dayLength, revenueInterval);
+}
+
+bool ParkingSystem::setTariffBand(int startTime, int endTime, int percent) {
+    logOperation(LOG_SET_TARIFF_BAND, startTime, endTime, percent, 0, "");
+    return tariff->setBand(startTime, endTime, percent);
+}
+
+long long ParkingSystem::getZoneRevenue(int zoneID) const {
+    return tariff->getZoneRevenue(findZoneIndex(zoneID));
+}
+
+long long ParkingSystem::getTotalRevenue() const {
+    return tariff->getTotalRevenue();
+}
+
+const TariffEngine* ParkingSystem::getTariff() const {
+    return tariff;
+}
+
+void ParkingSystem::setNoShowTimeout(int timeout) {
+    logOperation(LOG_SET_NO_SHOW, timeout, 0, 0, 0, "");
+    noShowTimeout = timeout;
+}
+
+int ParkingSystem::getNoShowTimeout() const {
+    return noShowTimeout;
+}
+
+void ParkingSystem::setMaxStayDuration(int duration) {
+    logOperation(LOG_SET_MAX_STAY, duration, 0, 0, 0, "");
+    maxStayDuration = duration;
+}
+
+void ParkingSystem::setSpilloverPolicy(SpilloverPolicy policy) {
+    logOperation(LOG_SET_SPILLOVER, (int)policy, 0, 0, 0, "");
+    spilloverPolicy = policy;
+    if (engine != nullptr) {
+        engine->setSpilloverPolicy(policy);
+    }
+}
+
+SpilloverPolicy ParkingSystem::getSpilloverPolicy() const {
+    return spilloverPolicy;
+}
+
+// Fires every timer due up to `now`: reservations whose window opened are
+// allocated, allocated requests whose driver never arrived are cancelled
+// (freeing their slot) and occupied requests past the maximum stay are
+// flagged. Returns how many requests were affected.
+int ParkingSystem::advanceTime(int now) {
+    logOperation(LOG_ADVANCE_TIME, now, 0, 0, 0, "");
+    logSuppressDepth++;
+    beginUndoGroup();
+    
+    TimerNode* expired = timerWheel->advance(now);
+    int handled = 0;
+    
+    // Detach the whole batch first: handling one timer can re-arm another
+    // request whose expired node is further down this list
+    for (TimerNode* node = expired; node != nullptr; node = node->next) {
+        RequestIndexEntry* entry = findRequestEntry(node->requestID);
+        if (entry != nullptr && entry->timer == node) {
+            entry->timer = nullptr;
+        }
+    }
+    
+    while (expired != nullptr) {
+        TimerNode* next = expired->next;
+        int requestID = expired->requestID;
+        
+        // A request re-armed earlier in this batch runs on its new timer
+        ParkingRequest* request = findActiveRequest(requestID);
+        if (request != nullptr && findRequestEntry(requestID)->timer == nullptr) {
+            if (expired->kind == NO_SHOW_TIMER && request->getState() == ALLOCATED) {
+                if (cancelRequest(requestID)) {
+                    handled++;
+                }
+            } else if (expired->kind == MAX_STAY_TIMER && request->getState() == OCCUPIED
+                       && !findRequestEntry(requestID)->overstayed) {
+                findRequestEntry(requestID)->overstayed = true;
+                overstayedCount++;
+                handled++;
+            } else if (expired->kind == RESERVATION_START_TIMER && request->getState() == REQUESTED) {
+                if (allocateParking(requestID)) {
+                    handled++;
+                }
+            }
+        }
+        
+        delete expired;
+        expired = next;
+    }
+    
+    endUndoGroup();
+    logSuppressDepth--;
+    return handled;
+}
+
+int ParkingSystem::getCurrentTime() const {
+    return timerWheel->getCurrentTime();
+}
+
+bool ParkingSystem::isOverstayed(int requestID) const {
+    const RequestIndexEntry* entry = findRequestEntry(requestID);
+    return entry != nullptr && entry->overstayed;
+}
+
+int ParkingSystem::getOverstayedCount() const {
+    return overstayedCount;
+}
+
+void ParkingSystem::scheduleRequestTimer(int requestID, int deadline, TimerKind kind) {
+    cancelRequestTimer(requestID);
+    findRequestEntry(requestID)->timer = timerWheel->schedule(requestID, deadline, kind);
+}
+
+void ParkingSystem::cancelRequestTimer(int requestID) {
+    RequestIndexEntry* entry = findRequestEntry(requestID);
+    if (entry != nullptr && entry->timer != nullptr) {
+        timerWheel->cancel(entry->timer);
+        entry->timer = nullptr;
+    }
+}
+
+// The no-show window runs while ALLOCATED and the maximum stay while
+// OCCUPIED, from the request time or from now if that has passed
+void ParkingSystem::armStateTimer(int requestID, RequestState state, int requestTime) {
+    cancelRequestTimer(requestID);
+    int duration = (state == ALLOCATED) ? noShowTimeout : (state == OCCUPIED) ? maxStayDuration : 0;
+    if (duration <= 0) {
+        return;
+    }
+    int base = requestTime;
+    if (timerWheel->getCurrentTime() > base) {
+        base = timerWheel->getCurrentTime();
+    }
+    scheduleRequestTimer(requestID, base + duration, (state == ALLOCATED) ? NO_SHOW_TIMER : MAX_STAY_TIMER);
+}
+
+void ParkingSystem::releaseReservation(int requestID) {
+    RequestIndexEntry* entry = findRequestEntry(requestID);
+    if (entry == nullptr || entry->reservedSlotID == -1) {
+        return;
+    }
+    engine->cancelReservation(entry->reservedSlotID, entry->reservedZoneID, entry->reservationStart, requestID);
+    entry->reservedSlotID = -1;
+    entry->reservedZoneID = -1;
+}
+
+bool ParkingSystem::isWaitlisted(int requestID) const {
+    const RequestIndexEntry* entry = findRequestEntry(requestID);
+    return entry != nullptr && entry->waitlisted;
+}
+
+int ParkingSystem::getWaitlistLength(int zoneID) const {
+    int zoneIndex = findZoneIndex(zoneID);
+    if (zoneIndex == -1) {
+        return 0;
+    }
+    return waitingCounts[zoneIndex];
+}
+
+void ParkingSystem::addToWaitlist(const ParkingRequest& request) {
+    int requestID = request.getRequestID();
+    int zoneIndex = findZoneIndex(request.getRequestedZone());
+    RequestIndexEntry* entry = findRequestEntry(requestID);
+    if (zoneIndex == -1 || entry->waitlisted) {
+        return;
+    }
+    
+    // Stale entries (see removeFromWaitlist) are swept once they make up
+    // most of the heap, so the sweep is amortized O(1) per removal
+    if (waitlists[zoneIndex].getSize() >= 2 * waitingCounts[zoneIndex] + MIN_WAITLIST_SWEEP) {
+        WaitlistSweep sweep = { this, zoneIndex };
+        waitlists[zoneIndex].retain(isStillWaiting, &sweep);
+    }
+    waitlists[zoneIndex].push(WaitlistEntry(requestID, request.getPriority(), request.getRequestTime()));
+    entry->waitlisted = true;
+    entry->waitlistZoneIndex = zoneIndex;
+    waitingCounts[zoneIndex]++;
+}
+
+// Heap entries are dropped lazily: leaving the waitlist only clears the
+// flag, and the stale entry is discarded when it reaches the top
+void ParkingSystem::removeFromWaitlist(int requestID) {
+    RequestIndexEntry* entry = findRequestEntry(requestID);
+    if (entry == nullptr || !entry->waitlisted) {
+        return;
+    }
+    entry->waitlisted = false;
+    waitingCounts[entry->waitlistZoneIndex]--;
+    entry->waitlistZoneIndex = -1;
+}
+
+bool ParkingSystem::isStillWaiting(int requestID, void* context) {
+    const WaitlistSweep* sweep = (const WaitlistSweep*)context;
+    const RequestIndexEntry* entry = sweep->system->findRequestEntry(requestID);
+    return entry != nullptr && entry->waitlisted && entry->waitlistZoneIndex == sweep->zoneIndex;
+}
+
+bool ParkingSystem::hasWaitingTop(int zoneIndex) {
+    WaitlistEntry top;
+    while (waitlists[zoneIndex].peek(top)) {
+        if (isWaitlisted(top.requestID)) {
+            return true;
+        }
+        waitlists[zoneIndex].pop(top);
+    }
+    return false;
+}
+
+// Hands the slot just freed in a zone to the best waiting request: the
+// zone's own waitlist first, then the best head among the waitlists of
+// adjacent zones, whose requests may spill over into this one.
+void ParkingSystem::drainWaitlist(int zoneIndex) {
+    drainWaitlist(zoneIndex, timerWheel->getCurrentTime());
+}
+
+// `time` is when the slot came free; the request served starts its stay then
+void ParkingSystem::drainWaitlist(int zoneIndex, int time) {
+    // A redo replays the hand-offs as recorded instead
+    if (redoing) {
+        return;
+    }
+    int source = -1;
+    if (hasWaitingTop(zoneIndex)) {
+        source = zoneIndex;
+    } else {
+        WaitlistEntry best;
+        for (int i = 0; i < zones[zoneIndex].getAdjacentZoneCount(); i++) {
+            int adjacentIndex = findZoneIndex(zones[zoneIndex].getAdjacentZone(i));
+            WaitlistEntry top;
+            if (adjacentIndex != -1 && hasWaitingTop(adjacentIndex) && waitlists[adjacentIndex].peek(top)) {
+                if (source == -1 || WaitlistQueue::servedBefore(top, best)) {
+                    source = adjacentIndex;
+                    best = top;
+                }
+            }
+        }
+    }
+    
+    if (source == -1) {
+        return;
+    }
+    
+    // The request is still flagged as waiting when allocateParking runs;
+    // commitAllocation clears the flag and records that it was set, so an
+    // undo puts the request back on the waitlist. If the allocation fails
+    // it is queued again
+    WaitlistEntry next;
+    waitlists[source].pop(next);
+    
+    // Replaying the freeing operation re-derives this allocation
+    logSuppressDepth++;
+    int previousHandOff = handOffTime;
+    handOffTime = time;
+    bool allocated = allocateParking(next.requestID);
+    handOffTime = previousHandOff;
+    if (!allocated) {
+        removeFromWaitlist(next.requestID);
+        ParkingRequest* request = findActiveRequest(next.requestID);
+        if (request != nullptr && request->getState() == REQUESTED) {
+            addToWaitlist(*request);
+        }
+    }
+    logSuppressDepth--;
+}
+
+void ParkingSystem::expandActiveRequests() {
+    activeRequestCapacity *= 2;
+    ParkingRequest* newArray = new ParkingRequest[activeRequestCapacity];
+    for (int i = 0; i < activeRequestCount; i++) {
+        newArray[i] = activeRequests[i];
+    }
+    delete[] activeRequests;
+    activeRequests = newArray;
+}
+
+RequestIndexEntry* ParkingSystem::findRequestEntry(int requestID) const {
+    int slot = requestSlots->find(requestID);
+    return (slot != -1) ? &requestEntries[slot] : nullptr;
+}
+
+// Finds or adds the entry. Adding one may move the others, so no entry
+// reference is held across a call that can add
+RequestIndexEntry& ParkingSystem::requestEntry(int requestID) {
+    int slot = requestSlots->find(requestID);
+    if (slot != -1) {
+        return requestEntries[slot];
+    }
+    if (freeRequestEntryCount > 0) {
+        slot = freeRequestEntries[--freeRequestEntryCount];
+    } else {
+        if (requestEntryCount == requestEntryCapacity) {
+            int newCapacity = requestEntryCapacity * 2;
+            RequestIndexEntry* newEntries = new RequestIndexEntry[newCapacity];
+            for (int i = 0; i < requestEntryCount; i++) {
+                newEntries[i] = requestEntries[i];
+            }
+            delete[] requestEntries;
+            delete[] freeRequestEntries;
+            requestEntries = newEntries;
+            freeRequestEntries = new int[newCapacity];
+            requestEntryCapacity = newCapacity;
+        }
+        slot = requestEntryCount++;
+    }
+    requestEntries[slot] = RequestIndexEntry();
+    requestSlots->insert(requestID, slot);
+    return requestEntries[slot];
+}
+
+// Frees the entry once its request is neither active nor in resident
+// history; its timer, reservation and waitlist place are gone by then
+void ParkingSystem::releaseRequestEntry(int requestID) {
+    int slot = requestSlots->find(requestID);
+    if (slot == -1 || requestEntries[slot].position != -1 || requestEntries[slot].historyNode != nullptr) {
+        return;
+    }
+    requestSlots->remove(requestID);
+    freeRequestEntries[freeRequestEntryCount++] = slot;
+}
+
+ParkingRequest* ParkingSystem::findActiveRequest(int requestID) {
+    const RequestIndexEntry* entry = findRequestEntry(requestID);
+    if (entry == nullptr || entry->position == -1) {
+        return nullptr;
+    }
+    return &activeRequests[entry->position];
+}
+
+// Appends a request (with its state) to the active set
+ParkingRequest* ParkingSystem::restoreActiveRequest(const ParkingRequest& request) {
+    if (activeRequestCount >= activeRequestCapacity) {
+        expandActiveRequests();
+    }
+    int requestID = request.getRequestID();
+    requestEntry(requestID).position = activeRequestCount;
+    activeRequests[activeRequestCount] = request;
+    linkRequestState(requestID, request.getState());
+    return &activeRequests[activeRequestCount++];
+}
+
+// Order of active requests is not significant, so the last entry is moved
+// into the hole instead of shifting the whole array
+void ParkingSystem::removeActiveRequest(int requestID) {
+    RequestIndexEntry* entry = findRequestEntry(requestID);
+    if (entry == nullptr || entry->position == -1) {
+        return;
+    }
+    int position = entry->position;
+    
+    unlinkRequestState(requestID, activeRequests[position].getState());
+    int last = activeRequestCount - 1;
+    if (position != last) {
+        activeRequests[position] = activeRequests[last];
+        findRequestEntry(activeRequests[position].getRequestID())->position = position;
+    }
+    activeRequestCount--;
+    entry->position = -1;
+    releaseRequestEntry(requestID);
+}
+
+// New members go to the front; order within a state is not significant
+void ParkingSystem::linkRequestState(int requestID, RequestState state) {
+    RequestIndexEntry& entry = *findRequestEntry(requestID);
+    entry.prevInState = -1;
+    entry.nextInState = stateHeads[state];
+    if (stateHeads[state] != -1) {
+        findRequestEntry(stateHeads[state])->prevInState = requestID;
+    }
+    stateHeads[state] = requestID;
+    stateCounts[state]++;
+}
+
+void ParkingSystem::unlinkRequestState(int requestID, RequestState state) {
+    RequestIndexEntry& entry = *findRequestEntry(requestID);
+    if (entry.prevInState != -1) {
+        findRequestEntry(entry.prevInState)->nextInState = entry.nextInState;
+    } else {
+        stateHeads[state] = entry.nextInState;
+    }
+    if (entry.nextInState != -1) {
+        findRequestEntry(entry.nextInState)->prevInState = entry.prevInState;
+    }
+    entry.prevInState = -1;
+    entry.nextInState = -1;
+    stateCounts[state]--;
+}
+
+// Sets a state the transition table would not allow; only for undo
+void ParkingSystem::forceRequestState(ParkingRequest* request, RequestState state) {
+    unlinkRequestState(request->getRequestID(), request->getState());
+    *request = withState(*request, state);
+    linkRequestState(request->getRequestID(), state);
+}
+
+bool ParkingSystem::applyRequestEvent(ParkingRequest* request, RequestEvent event) {
+    RequestState from = request->getState();
+    if (!request->apply(event)) {
+        return false;
+    }
+    unlinkRequestState(request->getRequestID(), from);
+    linkRequestState(request->getRequestID(), request->getState());
+    return true;
+}
+
+void ParkingSystem::addToHistory(const ParkingRequest& request, int slotID, int zoneID, bool crossZone,
+                                 int allocatedTime) {
+    HistoryNode* newNode = new HistoryNode(request, slotID, zoneID, crossZone);
+    newNode->allocatedTime = allocatedTime;
+    newNode->next = historyHead;
+    if (historyHead != nullptr) {
+        historyHead->prev = newNode;
+    }
+    historyHead = newNode;
+    historyCount++;
+    residentTotals.add(*newNode, 1);
+    
+    requestEntry(request.getRequestID()).historyNode = newNode;
+}
+
+// Every change to a resident entry goes through here, so the analytics
+// totals follow it
+void ParkingSystem::updateHistoryNode(HistoryNode* node, const ParkingRequest& request, int releaseTime, int charge) {
+    residentTotals.add(*node, -1);
+    node->request = request;
+    node->releaseTime = releaseTime;
+    node->charge = charge;
+    residentTotals.add(*node, 1);
+}
+
+HistoryNode* ParkingSystem::findInHistory(int requestID) {
+    const RequestIndexEntry* entry = findRequestEntry(requestID);
+    return (entry != nullptr) ? entry->historyNode : nullptr;
+}
+
+// Moves a finished entry out of memory into the archive, when one is enabled
+void ParkingSystem::archiveHistoryNode(HistoryNode* node) {
+    if (archive == nullptr || node == nullptr || !archive->append(*node)) {
+        return;
+    }
+    unlinkHistoryNode(node);
+}
+
+void ParkingSystem::unlinkHistoryNode(HistoryNode* node) {
+    if (node->prev != nullptr) {
+        node->prev->next = node->next;
+    } else {
+        historyHead = node->next;
+    }
+    if (node->next != nullptr) {
+        node->next->prev = node->prev;
+    }
+    
+    int requestID = node->request.getRequestID();
+    RequestIndexEntry* entry = findRequestEntry(requestID);
+    if (entry != nullptr && entry->historyNode == node) {
+        entry->historyNode = nullptr;
+        releaseRequestEntry(requestID);
+    }
+    historyCount--;
+    residentTotals.add(*node, -1);
+    delete node;
+}
+
+void ParkingSystem::discardHistoryNode(int requestID) {
+    HistoryNode* node = findInHistory(requestID);
+    if (node != nullptr) {
+        unlinkHistoryNode(node);
+    }
+}
+
+// The request's history entry, taken back into memory if it was archived.
+// Undo runs newest first, so an archived entry is always the last record.
+HistoryNode* ParkingSystem::reclaimHistoryNode(int requestID) {
+    HistoryNode* node = findInHistory(requestID);
+    if (node != nullptr || archive == nullptr) {
+        return node;
+    }
+    
+    HistoryNode last;
+    if (!archive->readRecord(archive->getRecordCount() - 1, last) || last.request.getRequestID() != requestID
+        || !archive->removeLast(last)) {
+        return nullptr;
+    }
+    addToHistory(last.request, last.allocatedSlotID, last.allocatedZoneID, last.isCrossZone, last.allocatedTime);
+    updateHistoryNode(historyHead, last.request, last.releaseTime, last.charge);
+    return historyHead;
+}
+
+// Starts archiving finished history to `path`; entries that are already
+// finished are moved over immediately
+bool ParkingSystem::enableHistoryArchive(const string& path) {
+    delete archive;
+    archive = new HistoryArchive();
+    if (!archive->open(path)) {
+        delete archive;
+        archive = nullptr;
+        return false;
+    }
+    
+    HistoryNode* node = historyHead;
+    while (node != nullptr) {
+        HistoryNode* next = node->next;
+        RequestState state = node->request.getState();
+        ParkingRequest* active = findActiveRequest(node->request.getRequestID());
+        bool rolledBack = (active != nullptr && active->getState() == CANCELLED);
+        if (state == RELEASED || state == CANCELLED || rolledBack) {
+            archiveHistoryNode(node);
+        }
+        node = next;
+    }
+    return true;
+}
+
+// Looks a request up in resident history first, then in the archive
+bool ParkingSystem::getHistoryEntry(int requestID, HistoryNode& entryOut) {
+    HistoryNode* node = findInHistory(requestID);
+    if (node != nullptr) {
+        entryOut = *node;
+        entryOut.prev = nullptr;
+        entryOut.next = nullptr;
+        return true;
+    }
+    if (archive != nullptr) {
+        return archive->find(requestID, entryOut);
+    }
+    return false;
+}
+
+int ParkingSystem::getResidentHistoryCount() const {
+    return historyCount;
+}
+
+int ParkingSystem::findZoneIndex(int zoneID) const {
+    return zoneIndex->find(zoneID);
+}
+
+void ParkingSystem::adjustZoneOccupancy(int zoneIndex, int delta) {
+    if (zoneIndex == -1) {
+        return;
+    }
+    zoneOccupancy[zoneIndex] += delta;
+    busiestZones->update(zoneIndex, zoneOccupancy[zoneIndex]);
+    // Least utilized ranks by occupied share of the zone's slots (taken
+    // plus free); a zone with no slots ranks as full
+    int slots = zoneOccupancy[zoneIndex] + zones[zoneIndex].getTotalAvailableSlots();
+    if (slots > 0) {
+        emptiestZones->update(zoneIndex, zoneOccupancy[zoneIndex], slots);
+    } else {
+        emptiestZones->update(zoneIndex, 1, 1);
+    }
+    capacityTree->update(zoneIndex, zones[zoneIndex].getTotalAvailableSlots());
+}
+
+void ParkingSystem::publishSlotChange(int zoneID, int slotID, SlotOccupancy from, SlotOccupancy to) {
+    if (occupancyListener == nullptr) {
+        return;
+    }
+    OccupancyDelta delta;
+    delta.zoneID = zoneID;
+    delta.areaID = slotID / 1000;
+    delta.slotIndex = slotID % 1000;
+    delta.from = from;
+    delta.to = to;
+    occupancyListener(delta, occupancyContext);
+}
+
+void ParkingSystem::logOperation(LogRecordType type, int a, int b, int c, int d, const string& vehicleID) {
+    if (wal == nullptr || replayingLog || logSuppressDepth > 0) {
+        return;
+    }
+    LogRecord record(type, a, b, c, d);
+    record.vehicleID = vehicleID;
+    wal->append(record);
+}
+
+bool ParkingSystem::enableWriteAheadLog(const string& path, int groupCommitSize) {
+    disableWriteAheadLog();
+    wal = new WriteAheadLog();
+    if (!wal->open(path, groupCommitSize, false, snapshotSequence)) {
+        delete wal;
+        wal = nullptr;
+        return false;
+    }
+    return true;
+}
+
+void ParkingSystem::disableWriteAheadLog() {
+    delete wal;
+    wal = nullptr;
+}
+
+bool ParkingSystem::syncWriteAheadLog() {
+    if (wal == nullptr) {
+        return false;
+    }
+    return wal->sync();
+}
+
+bool ParkingSystem::flushWriteAheadLogIfDue() {
+    return (wal == nullptr) || wal->syncIfDue();
+}
+
+// Rebuilds state by re-running every logged operation through the public
+// API. Operations derived from others (waitlist hand-offs, timer expiry)
+// are not logged and are re-derived the same way during replay. A
+// transaction the log never saw commit is aborted. Records a loaded
+// snapshot already holds are skipped, in case a crash came between
+// saving it and truncating the log.
+// A torn tail is cut off once the good records are applied; otherwise
+// records appended after recovery would sit behind it, unreachable
+long long ParkingSystem::recoverFromLog(const string& path) {
+    replayingLog = true;
+    long long validBytes = 0;
+    long long applied = WriteAheadLog::replay(path, applyLogRecord, this, &validBytes, snapshotSequence);
+    replayingLog = false;
+    if (applied >= 0) {
+        WriteAheadLog::truncateTail(path, validBytes);
+    }
+    if (transactionOpen) {
+        abortTransaction();
+    }
+    return applied;
+}
+
+void ParkingSystem::applyLogRecord(const LogRecord& record, void* context) {
+    ParkingSystem* system = (ParkingSystem*)context;
+    const int* f = record.fields;
+    
+    switch (record.type) {
+        case LOG_SETUP_ZONE:
+            system->setupZone(f[0], f[1]);
+            break;
+        case LOG_SETUP_AREA:
+            system->setupParkingArea(f[0], f[1], f[2], f[3]);
+            break;
+        case LOG_ADJACENCY:
+            system->addZoneAdjacency(f[0], f[1], (f[2] > 0) ? f[2] : 1);
+            break;
+        case LOG_SLOT_ATTRIBUTES:
+            system->setSlotAttributes(f[0], f[1], f[2], f[3] >> 8, f[3] & 0xFF);
+            break;
+        case LOG_CREATE:
+            // Keep request IDs identical to the original run
+            if (system->nextRequestID < f[0]) {
+                system->nextRequestID = f[0];
+            }
+            system->createParkingRequest(record.vehicleID, f[1], f[2], (PriorityClass)f[3]);
+            break;
+        case LOG_RESERVE:
+            system->createReservation(record.vehicleID, f[0], f[1], f[2]);
+            break;
+        case LOG_ALLOCATE:
+            system->allocateParking(f[0]);
+            break;
+        case LOG_OCCUPY:
+            system->occupyParking(f[0]);
+            break;
+        case LOG_RELEASE:
+            system->releaseParking(f[0], f[1]);
+            break;
+        case LOG_CANCEL:
+            system->cancelRequest(f[0]);
+            break;
+        case LOG_ROLLBACK:
+            system->rollbackLastAllocation();
+            break;
+        case LOG_ADVANCE_TIME:
+            system->advanceTime(f[0]);
+            break;
+        case LOG_SET_NO_SHOW:
+            system->setNoShowTimeout(f[0]);
+            break;
+        case LOG_SET_MAX_STAY:
+            system->setMaxStayDuration(f[0]);
+            break;
+        case LOG_CONFIGURE_TIMELINE:
+            system->configureTimeline(f[0], f[1]);
+            break;
+        case LOG_SET_ZONE_RATE:
+            system->setZoneRate(f[0], f[1]);
+            break;
+        case LOG_SET_SURCHARGE:
+            system->setCrossZoneSurcharge(f[0]);
+            break;
+        case LOG_SET_TARIFF_BAND:
+            system->setTariffBand(f[0], f[1], f[2]);
+            break;
+        case LOG_CONFIGURE_TARIFF:
+            system->configureTariff(f[0], f[1]);
+            break;
+        case LOG_SET_AREA_OPEN:
+            system->setAreaOpen(f[0], f[1], f[2] != 0);
+            break;
+        case LOG_ADD_AREA:
+            system->addParkingArea(f[0], f[1], f[2]);
+            break;
+        case LOG_REMOVE_AREA:
+            system->removeParkingArea(f[0], f[1]);
+            break;
+        case LOG_RESIZE_AREA:
+            system->resizeParkingArea(f[0], f[1], f[2]);
+            break;
+        case LOG_REMOVE_ADJACENCY:
+            system->removeZoneAdjacency(f[0], f[1]);
+            break;
+        case LOG_SET_SPILLOVER:
+            system->setSpilloverPolicy((SpilloverPolicy)f[0]);
+            break;
+        case LOG_UNDO:
+            system->undoLastOperation();
+            break;
+        case LOG_REDO:
+            system->redoLastOperation();
+            break;
+        case LOG_BEGIN_TRANSACTION:
+            system->beginTransaction();
+            break;
+        case LOG_SAVEPOINT:
+            system->setSavepoint();
+            break;
+        case LOG_ROLLBACK_TO_SAVEPOINT:
+            system->rollbackToSavepoint(f[0]);
+            break;
+        case LOG_COMMIT_TRANSACTION:
+            system->commitTransaction();
+            break;
+        case LOG_ABORT_TRANSACTION:
+            system->abortTransaction();
+            break;
+    }
+}
+
+// Writes a point-in-time image of the whole system and, once it is safely
+// on disk, truncates the write-ahead log it supersedes. The file is
+// written under a temporary name and renamed, so a crash leaves either
+// the old snapshot or the new one. The header holds the sequence number
+// of the next log record, so a log that outlives a crash before its
+// truncation is not applied twice.
+// Layout: [magic "PKSN"][i32 version][i64 log sequence][i64 payload size]
+//         [u32 checksum][payload]
+bool ParkingSystem::saveSnapshot(const string& path) {
+    if (transactionOpen) {
+        return false;
+    }
+    // The snapshot records the archive's length, so that much must be durable first
+    if (archive != nullptr && !archive->sync()) {
+        return false;
+    }
+    long long sequence = (wal != nullptr) ? wal->getNextSequence() : snapshotSequence;
+    SnapshotWriter payload;
+    writeSnapshotTo(payload, false);
+    
+    SnapshotWriter header;
+    header.writeBytes(SNAPSHOT_MAGIC, 4);
+    header.writeI32(SNAPSHOT_VERSION);
+    header.writeI64(sequence);
+    header.writeI64(payload.getSize());
+    header.writeI32((int)snapshotChecksum(payload.getData(), payload.getSize()));
+    
+    string tempPath = path + ".tmp";
+    FILE* out = fopen(tempPath.c_str(), "wb");
+    if (out == nullptr) {
+        return false;
+    }
+    bool written = fwrite(header.getData(), 1, (size_t)header.getSize(), out) == (size_t)header.getSize()
+                && fwrite(payload.getData(), 1, (size_t)payload.getSize(), out) == (size_t)payload.getSize()
+                && fflush(out) == 0;
+#ifdef _WIN32
+    written = written && _commit(_fileno(out)) == 0;
+#else
+    written = written && fsync(fileno(out)) == 0;
+#endif
+    fclose(out);
+    
+    if (!written) {
+        remove(tempPath.c_str());
+        return false;
+    }
+#ifdef _WIN32
+    remove(path.c_str());
+#endif
+    if (rename(tempPath.c_str(), path.c_str()) != 0) {
+        return false;
+    }
+    snapshotSequence = sequence;
+    
+    if (wal != nullptr) {
+        wal->truncate();
+    }
+    return true;
+}
+
+// Restores a snapshot into a freshly constructed system with the same zone
+// count. Any write-ahead log written after the snapshot can then be
+// replayed on top with recoverFromLog().
+bool ParkingSystem::loadSnapshot(const string& path) {
+    if (engine != nullptr || activeRequestCount > 0 || historyHead != nullptr) {
+        return false;
+    }
+    
+    MappedFile file;
+    if (!file.open(path) || file.getSize() < SNAPSHOT_HEADER_SIZE) {
+        return false;
+    }
+    
+    SnapshotReader header(file.getData(), SNAPSHOT_HEADER_SIZE);
+    const unsigned char* magic = header.readBytes(4);
+    for (int i = 0; i < 4; i++) {
+        if (magic[i] != SNAPSHOT_MAGIC[i]) {
+            return false;
+        }
+    }
+    int version = header.readI32();
+    long long sequence = header.readI64();
+    long long payloadSize = header.readI64();
+    unsigned int expected = (unsigned int)header.readI32();
+    if (version != SNAPSHOT_VERSION || payloadSize != file.getSize() - SNAPSHOT_HEADER_SIZE) {
+        return false;
+    }
+    
+    const unsigned char* payload = file.getData() + SNAPSHOT_HEADER_SIZE;
+    if (snapshotChecksum(payload, payloadSize) != expected) {
+        return false;
+    }
+    
+    SnapshotReader in(payload, payloadSize);
+    logSuppressDepth++;
+    bool loaded = readSnapshotFrom(in, false);
+    logSuppressDepth--;
+    if (loaded) {
+        snapshotSequence = sequence;
+    }
+    return loaded;
+}
+
+// Zones are copied directly (sharing their areas); active requests and
+// their history entries go through the snapshot encoding in memory, and
+// finished history is carried over as totals only
+ParkingSystem* ParkingSystem::fork() const {
+    if (transactionOpen) {
+        return nullptr;
+    }
+    ParkingSystem* copy = new ParkingSystem(zoneCount);
+    for (int i = 0; i < configuredZoneCount; i++) {
+        copy->setupZone(zones[i].getZoneID(), 0);
+        copy->zones[i] = zones[i];
+        copy->adjustZoneOccupancy(i, zoneOccupancy[i]);
+    }
+    delete copy->areaZones;
+    copy->areaZones = areaZones;
+    areaZones->share();
+    
+    SnapshotWriter state;
+    writeSnapshotTo(state, true);
+    SnapshotReader in(state.getData(), state.getSize());
+    copy->logSuppressDepth++;
+    bool loaded = copy->readSnapshotFrom(in, true);
+    copy->logSuppressDepth--;
+    if (!loaded) {
+        delete copy;
+        return nullptr;
+    }
+    return copy;
+}
+
+void ParkingSystem::writeSnapshotTo(SnapshotWriter& out, bool sharedLayout) const {
+    out.writeI32(zoneCount);
+    out.writeI32(nextRequestID);
+    out.writeI32(timerWheel->getCurrentTime());
+    out.writeI32(noShowTimeout);
+    out.writeI32(maxStayDuration);
+    out.writeU8((unsigned char)spilloverPolicy);
+    
+    // Layout and slot occupancy, one bitmap per area
+    unsigned char* bitmap = nullptr;
+    int bitmapCapacity = 0;
+    for (int i = 0; i < zoneCount && !sharedLayout; i++) {
+        const Zone& zone = zones[i];
+        out.writeI32(zone.getZoneID());
+        out.writeI32(zone.getAreaCount());
+        for (int a = 0; a < zone.getAreaCount(); a++) {
+            const ParkingArea* area = zone.getArea(a);
+            out.writeI32(area->getAreaID());
+            out.writeI32(area->getCapacity());
+            int bytes = area->getBitmapSize();
+            if (bytes > bitmapCapacity) {
+                delete[] bitmap;
+                bitmap = new unsigned char[bytes];
+                bitmapCapacity = bytes;
+            }
+            if (bytes > 0) {
+                area->writeOccupancyBitmap(bitmap);
+                out.writeBytes(bitmap, bytes);
+            }
+            
+            // Attributes are rare, so areas without any store only the flag
+            bool hasAttributes = area->hasSlotAttributes();
+            out.writeBool(hasAttributes);
+            for (int s = 0; hasAttributes && s < area->getCapacity(); s++) {
+                out.writeU8((unsigned char)area->getSlot(s)->getAttributes());
+            }
+            out.writeBool(zone.isAreaOpen(a));
+        }
+        out.writeI32(zone.getAdjacentZoneCount());
+        for (int j = 0; j < zone.getAdjacentZoneCount(); j++) {
+            out.writeI32(zone.getAdjacentZone(j));
+            out.writeI32(zone.getAdjacentWeight(j));
+        }
+    }
+    delete[] bitmap;
+    
+    timeline->writeSnapshot(out);
+    tariff->writeSnapshot(out);
+    
+    // Only the position in the archive; its records stay in their own file
+    bool withArchive = archive != nullptr && !sharedLayout;
+    out.writeString(withArchive ? archive->getPath() : "");
+    out.writeI32(withArchive ? archive->getRecordCount() : 0);
+    
+    // Active requests with their timers, reservations and waitlist state
+    out.writeI32(activeRequestCount);
+    for (int i = 0; i < activeRequestCount; i++) {
+        const ParkingRequest& request = activeRequests[i];
+        const RequestIndexEntry& entry = *findRequestEntry(request.getRequestID());
+        out.writeI32(request.getRequestID());
+        out.writeString(request.getVehicleID());
+        out.writeI32(request.getRequestedZone());
+        out.writeI32(request.getRequestTime());
+        out.writeU8((unsigned char)request.getState());
+        out.writeU8((unsigned char)request.getPriority());
+        out.writeBool(entry.overstayed);
+        out.writeBool(entry.waitlisted);
+        out.writeI32(entry.reservedSlotID);
+        out.writeI32(entry.reservedZoneID);
+        out.writeI32(entry.reservationStart);
+        out.writeI32(entry.reservationEnd);
+        out.writeBool(entry.reservedCrossZone);
+        out.writeBool(entry.timer != nullptr);
+        if (entry.timer != nullptr) {
+            out.writeU8((unsigned char)entry.timer->kind);
+            out.writeI32(entry.timer->deadline);
+        }
+    }
+    
+    // History oldest first, so loading can simply prepend. A fork takes only
+    // the entries of active requests and inherits the rest as totals, so
+    // its cost does not grow with finished history
+    HistoryTotals inherited = inheritedTotals;
+    HistoryNode** nodes = new HistoryNode*[historyCount > 0 ? historyCount : 1];
+    int nodeCount = 0;
+    if (sharedLayout) {
+        inherited.add(residentTotals, 1);
+        if (archive != nullptr) {
+            inherited.add(archive->getTotals(), 1);
+        }
+        for (int i = activeRequestCount - 1; i >= 0; i--) {
+            HistoryNode* node = findRequestEntry(activeRequests[i].getRequestID())->historyNode;
+            if (node != nullptr) {
+                nodes[nodeCount++] = node;
+                inherited.add(*node, -1);
+            }
+        }
+    } else {
+        for (HistoryNode* node = historyHead; node != nullptr; node = node->next) {
+            nodes[nodeCount++] = node;
+        }
+    }
+    out.writeI32(inherited.entries);
+    out.writeI32(inherited.completed);
+    out.writeI32(inherited.cancelled);
+    out.writeI32(inherited.crossZone);
+    out.writeI64(inherited.totalDuration);
+    out.writeI32(nodeCount);
+    for (int i = nodeCount - 1; i >= 0; i--) {
+        const HistoryNode* node = nodes[i];
+        out.writeI32(node->request.getRequestID());
+        out.writeString(node->request.getVehicleID());
+        out.writeI32(node->request.getRequestedZone());
+        out.writeI32(node->request.getRequestTime());
+        out.writeU8((unsigned char)node->request.getState());
+        out.writeU8((unsigned char)node->request.getPriority());
+        out.writeI32(node->allocatedSlotID);
+        out.writeI32(node->allocatedZoneID);
+        out.writeI32(node->allocatedTime);
+        out.writeI32(node->releaseTime);
+        out.writeI32(node->charge);
+        out.writeBool(node->isCrossZone);
+    }
+    delete[] nodes;
+    
+    // Rollback stack oldest first, so loading can simply push
+    int stackSize = rollbackManager->getSize();
+    AllocationOperation* operations = new AllocationOperation[stackSize > 0 ? stackSize : 1];
+    int operationCount = rollbackManager->getOperations(operations, stackSize);
+    out.writeI32(operationCount);
+    for (int i = operationCount - 1; i >= 0; i--) {
+        out.writeI32(operations[i].requestID);
+        out.writeString(operations[i].vehicleID);
+        out.writeI32(operations[i].allocatedSlotID);
+        out.writeI32(operations[i].allocatedZoneID);
+        out.writeI32(operations[i].requestTime);
+        out.writeU8((unsigned char)operations[i].previousState);
+        out.writeU8((unsigned char)operations[i].newState);
+    }
+    delete[] operations;
+    
+    // A fork starts its own undo history: most undo records would need
+    // entries it only inherited as totals
+    out.writeI32(undoGroup);
+    if (!sharedLayout) {
+        undoLog->writeSnapshot(out);
+    }
+}
+
+bool ParkingSystem::readSnapshotFrom(SnapshotReader& in, bool sharedLayout) {
+    if (in.readI32() != zoneCount) {
+        return false;
+    }
+    nextRequestID = in.readI32();
+    int currentTime = in.readI32();
+    noShowTimeout = in.readI32();
+    maxStayDuration = in.readI32();
+    int policy = in.readU8();
+    if (policy > SPILLOVER_TWO_CHOICES) {
+        return false;
+    }
+    spilloverPolicy = (SpilloverPolicy)policy;
+    if (engine != nullptr) {
+        engine->setSpilloverPolicy(spilloverPolicy);
+    }
+    
+    delete timerWheel;
+    timerWheel = new TimerWheel(currentTime);
+    
+    for (int i = 0; i < zoneCount && !sharedLayout && !in.hasFailed(); i++) {
+        int zoneID = in.readI32();
+        int areaCount = in.readI32();
+        if (zoneID != -1) {
+            setupZone(zoneID, areaCount);
+        }
+        for (int a = 0; a < areaCount && !in.hasFailed(); a++) {
+            int areaID = in.readI32();
+            int capacity = in.readI32();
+            if (zoneID == -1) {
+                continue;
+            }
+            setupParkingArea(zoneID, a, areaID, capacity);
+            ParkingArea* area = zones[i].getArea(a);
+            const unsigned char* bitmap = in.readBytes((capacity + 7) / 8);
+            if (bitmap != nullptr) {
+                zones[i].loadAreaOccupancy(a, bitmap);
+            }
+            if (in.readBool()) {
+                const unsigned char* attributes = in.readBytes(capacity);
+                for (int s = 0; attributes != nullptr && s < capacity; s++) {
+                    area->getSlot(s)->setAttributes(attributes[s]);
+                }
+            }
+            zones[i].setAreaOpen(a, in.readBool());
+        }
+        int adjacentCount = in.readI32();
+        for (int j = 0; j < adjacentCount && !in.hasFailed(); j++) {
+            int adjacentID = in.readI32();
+            zones[i].addAdjacentZone(adjacentID, in.readI32());
+        }
+        
+        if (zoneID != -1) {
+            adjustZoneOccupancy(i, zones[i].getTotalCapacity() - zones[i].getTotalAvailableSlots());
+        }
+    }
+    
+    if (!timeline->readSnapshot(in) || !tariff->readSnapshot(in)) {
+        return false;
+    }
+    
+    string archivePath = in.readString();
+    int archivedRecords = in.readI32();
+    if (!archivePath.empty()) {
+        delete archive;
+        archive = new HistoryArchive();
+        if (!archive->reopen(archivePath, archivedRecords)) {
+            delete archive;
+            archive = nullptr;
+            return false;
+        }
+    }
+    
+    int requestCount = in.readI32();
+    for (int i = 0; i < requestCount && !in.hasFailed(); i++) {
+        int requestID = in.readI32();
+        string vehicleID = in.readString();
+        int requestedZone = in.readI32();
+        int requestTime = in.readI32();
+        RequestState state = (RequestState)in.readU8();
+        PriorityClass priority = (PriorityClass)in.readU8();
+        
+        ParkingRequest request(requestID, vehicleID, requestedZone, requestTime, priority);
+        request.restoreState(state);
+        restoreActiveRequest(request);
+        RequestIndexEntry& entry = *findRequestEntry(requestID);
+        
+        entry.overstayed = in.readBool();
+        if (entry.overstayed) {
+            overstayedCount++;
+        }
+        bool waitlisted = in.readBool();
+        entry.reservedSlotID = in.readI32();
+        entry.reservedZoneID = in.readI32();
+        entry.reservationStart = in.readI32();
+        entry.reservationEnd = in.readI32();
+        entry.reservedCrossZone = in.readBool();
+        if (entry.reservedSlotID != -1 && !sharedLayout) {
+            int zoneIndex = findZoneIndex(entry.reservedZoneID);
+            if (zoneIndex != -1) {
+                zones[zoneIndex].restoreReservation(entry.reservedSlotID, entry.reservationStart,
+                                                    entry.reservationEnd, requestID);
+            }
+        }
+        if (in.readBool()) {
+            TimerKind kind = (TimerKind)in.readU8();
+            int deadline = in.readI32();
+            scheduleRequestTimer(requestID, deadline, kind);
+        }
+        if (waitlisted) {
+            addToWaitlist(activeRequests[entry.position]);
+        }
+    }
+    
+    inheritedTotals.entries = in.readI32();
+    inheritedTotals.completed = in.readI32();
+    inheritedTotals.cancelled = in.readI32();
+    inheritedTotals.crossZone = in.readI32();
+    inheritedTotals.totalDuration = in.readI64();
+    int nodeCount = in.readI32();
+    for (int i = 0; i < nodeCount && !in.hasFailed(); i++) {
+        int requestID = in.readI32();
+        string vehicleID = in.readString();
+        int requestedZone = in.readI32();
+        int requestTime = in.readI32();
+        RequestState state = (RequestState)in.readU8();
+        PriorityClass priority = (PriorityClass)in.readU8();
+        int slotID = in.readI32();
+        int zoneID = in.readI32();
+        int allocatedTime = in.readI32();
+        int releaseTime = in.readI32();
+        int charge = in.readI32();
+        bool crossZone = in.readBool();
+        
+        ParkingRequest request(requestID, vehicleID, requestedZone, requestTime, priority);
+        request.restoreState(state);
+        addToHistory(request, slotID, zoneID, crossZone, allocatedTime);
+        updateHistoryNode(historyHead, request, releaseTime, charge);
+    }
+    
+    int operationCount = in.readI32();
+    for (int i = 0; i < operationCount && !in.hasFailed(); i++) {
+        AllocationOperation op;
+        op.requestID = in.readI32();
+        op.vehicleID = in.readString();
+        op.allocatedSlotID = in.readI32();
+        op.allocatedZoneID = in.readI32();
+        op.requestTime = in.readI32();
+        op.previousState = (RequestState)in.readU8();
+        op.newState = (RequestState)in.readU8();
+        rollbackManager->pushOperation(op);
+    }
+    
+    undoGroup = in.readI32();
+    if (!sharedLayout && !undoLog->readSnapshot(in)) {
+        return false;
+    }
+    
+    return !in.hasFailed();
+}
+
+Zone* ParkingSystem::getZones() {
+    return zones;
+}
+
+int ParkingSystem::getZoneCount() const {
+    return zoneCount;
+}
+
+// nullptr when the build has PARKING_NO_METRICS
+const ParkingMetrics* ParkingSystem::getMetrics() const {
+#ifdef PARKING_METRICS_ENABLED
+    return metrics;
+#else
+    return nullptr;
+#endif
+}
+
+string ParkingSystem::getMetricsText() const {
+    string text;
+#ifdef PARKING_METRICS_ENABLED
+    metrics->writeText(text, zones, zoneCount);
+#endif
+    return text;
+}
+
+void ParkingSystem::setOccupancyListener(OccupancyListener listener, void* context) {
+    occupancyListener = listener;
+    occupancyContext = context;
+}
+
+ParkingRequest* ParkingSystem::getActiveRequest(int requestID) {
+    return findActiveRequest(requestID);
+}
+
+int ParkingSystem::getRequestCountInState(RequestState state) const {
+    return stateCounts[state];
+}
+
+int ParkingSystem::getFirstRequestInState(RequestState state) const {
+    return stateHeads[state];
+}
+
+int ParkingSystem::getNextRequestInState(int requestID) const {
+    const RequestIndexEntry* entry = findRequestEntry(requestID);
+    return (entry != nullptr) ? entry->nextInState : -1;
+}
+
+int ParkingSystem::getZoneIndex(int zoneID) const {
+    return zoneIndex->find(zoneID);
 }
\ No newline at end of file
@@ -6,24 +6,51 @@
 #include "ParkingRequest.h"
 #include "AllocationEngine.h"
 #include "RollbackManager.h"
+#include "UndoLog.h"
+#include "OccupancyTimeline.h"
+#include "ZoneHeap.h"
+#include "ZoneCapacityTree.h"
+#include "ZoneIndex.h"
+#include "TimerWheel.h"
+#include "WaitlistQueue.h"
+#include "WriteAheadLog.h"
+#include "Snapshot.h"
+#include "HistoryArchive.h"
+#include "ParkingMetrics.h"
+#include "TariffEngine.h"
 #include <string>
 using namespace std;
 
-struct HistoryNode {
-    ParkingRequest request;
-    int allocatedSlotID;
-    int allocatedZoneID;
-    int releaseTime;
-    bool isCrossZone;
-    HistoryNode* next;
-    
-    HistoryNode(const ParkingRequest& req, int slotID, int zoneID, bool crossZone) {
-        request = req;
-        allocatedSlotID = slotID;
-        allocatedZoneID = zoneID;
-        releaseTime = -1;
-        isCrossZone = crossZone;
-        next = nullptr;
+struct RequestIndexEntry {
+    int position;
+    TimerNode* timer;
+    bool overstayed;
+    int reservedSlotID;
+    int reservedZoneID;
+    int reservationStart;
+    int reservationEnd;
+    bool reservedCrossZone;
+    bool waitlisted;
+    int waitlistZoneIndex;
+    HistoryNode* historyNode;
+    // Neighbours (request IDs) in the list of active requests sharing its state
+    int prevInState;
+    int nextInState;
+    
+    RequestIndexEntry() {
+        position = -1;
+        timer = nullptr;
+        overstayed = false;
+        reservedSlotID = -1;
+        reservedZoneID = -1;
+        reservationStart = 0;
+        reservationEnd = 0;
+        reservedCrossZone = false;
+        waitlisted = false;
+        waitlistZoneIndex = -1;
+        historyNode = nullptr;
+        prevInState = -1;
+        nextInState = -1;
     }
 };
 
@@ -34,6 +61,7 @@ struct ParkingAnalytics {
     int completedRequests;
     int cancelledRequests;
     int crossZoneAllocations;
+    long long totalRevenue;
     
     ParkingAnalytics() {
         averageParkingDuration = 0.0;
@@ -42,30 +70,174 @@ struct ParkingAnalytics {
         completedRequests = 0;
         cancelledRequests = 0;
         crossZoneAllocations = 0;
+        totalRevenue = 0;
     }
 };
 
+enum SlotOccupancy {
+    SLOT_FREE,
+    SLOT_ALLOCATED,
+    SLOT_OCCUPIED
+};
+
+// One slot changing state; slots are numbered per area (slot ID % 1000)
+struct OccupancyDelta {
+    int zoneID;
+    int areaID;
+    int slotIndex;
+    SlotOccupancy from;
+    SlotOccupancy to;
+};
+
+typedef void (*OccupancyListener)(const OccupancyDelta& delta, void* context);
+
 class ParkingSystem {
 private:
     Zone* zones;
     int zoneCount;
+    int configuredZoneCount;
+    ZoneIndex* zoneIndex;
+    // Area ID to the index of the zone holding that area; a fork shares it
+    // with its original until either changes the layout (ownAreaZones)
+    ZoneIndex* areaZones;
     AllocationEngine* engine;
     RollbackManager* rollbackManager;
     
+    // Transitions of the most recent operations; all those recorded while
+    // a public operation runs (undoDepth > 0) share its undoGroup
+    UndoLog* undoLog;
+    int undoGroup;
+    int undoDepth;
+    bool redoing;
+    // Time of the release whose freed slot is being handed to the waitlist;
+    // a drained request's stay starts then, not at its request time
+    int handOffTime;
+    
+    // An open transaction holds its undo group open (and pinned) until it
+    // commits; savepoints are undo log positions
+    bool transactionOpen;
+    long long transactionStart;
+    long long* savepoints;
+    int savepointCount;
+    int savepointCapacity;
+    OccupancyTimeline* timeline;
+    TariffEngine* tariff;
+    
+    int* zoneOccupancy;
+    ZoneHeap* busiestZones;
+    ZoneHeap* emptiestZones;
+    ZoneCapacityTree* capacityTree;
+    
+    WaitlistQueue* waitlists;
+    int* waitingCounts;
+    
     ParkingRequest* activeRequests;
     int activeRequestCount;
     int activeRequestCapacity;
     
+    // Entries for active requests and for finished ones still in resident
+    // history, found by request ID through a hash. A freed entry's place is
+    // reused, so memory follows the live requests, not every ID issued
+    ZoneIndex* requestSlots;
+    RequestIndexEntry* requestEntries;
+    int requestEntryCount;
+    int requestEntryCapacity;
+    int* freeRequestEntries;
+    int freeRequestEntryCount;
+    
+    // Intrusive doubly linked list of active requests per RequestState,
+    // threaded through the request entries; every transition goes through
+    // applyRequestEvent, which moves the request between lists in O(1)
+    int stateHeads[REQUEST_STATE_COUNT];
+    int stateCounts[REQUEST_STATE_COUNT];
+    
+    TimerWheel* timerWheel;
+    int noShowTimeout;
+    int maxStayDuration;
+    int overstayedCount;
+    SpilloverPolicy spilloverPolicy;
+    
     HistoryNode* historyHead;
     int historyCount;
+    // Analytics totals of resident entries, kept as entries change, and of
+    // the finished entries a fork inherited from its original
+    HistoryTotals residentTotals;
+    HistoryTotals inheritedTotals;
+    HistoryArchive* archive;
     
     int nextRequestID;
     
+    WriteAheadLog* wal;
+    // Sequence number of the first log record not covered by the last
+    // snapshot saved or loaded; recovery skips the records before it
+    long long snapshotSequence;
+    bool replayingLog;
+    int logSuppressDepth;
+    
+#ifdef PARKING_METRICS_ENABLED
+    ParkingMetrics* metrics;
+#endif
+    
+    OccupancyListener occupancyListener;
+    void* occupancyContext;
+    
     void expandActiveRequests();
+    RequestIndexEntry* findRequestEntry(int requestID) const;
+    RequestIndexEntry& requestEntry(int requestID);
+    void releaseRequestEntry(int requestID);
+    void scheduleRequestTimer(int requestID, int deadline, TimerKind kind);
+    void cancelRequestTimer(int requestID);
+    void armStateTimer(int requestID, RequestState state, int requestTime);
+    void commitAllocation(ParkingRequest* request, const AllocationResult& result);
+    void releaseReservation(int requestID);
+    void addToWaitlist(const ParkingRequest& request);
+    void removeFromWaitlist(int requestID);
+    bool hasWaitingTop(int zoneIndex);
+    static bool isStillWaiting(int requestID, void* context);
+    void drainWaitlist(int zoneIndex);
+    void drainWaitlist(int zoneIndex, int time);
+    int stayStartFor(const ParkingRequest& request) const;
+    
+    int createRequestInternal(string vehicleID, int requestedZone, int requestTime, PriorityClass priority);
+    bool allocateInternal(int requestID);
+    bool occupyInternal(int requestID);
+    bool releaseInternal(int requestID, int releaseTime);
+    bool cancelInternal(int requestID);
+    bool rollbackInternal();
+    void beginUndoGroup();
+    void endUndoGroup();
+    void recordUndo(UndoRecord& record);
+    bool undoRecord(const UndoRecord& record);
+    bool redoRecord(const UndoRecord& record);
+    bool undoToPosition(long long position);
+    bool holdSlot(int zoneID, int slotID, SlotOccupancy state, int stayStart);
+    void dropSlot(int zoneID, int slotID, SlotOccupancy state, int stayEnd);
+    void logOperation(LogRecordType type, int a, int b, int c, int d, const string& vehicleID);
+    static void applyLogRecord(const LogRecord& record, void* context);
+    // sharedLayout leaves out the zones (and the reservations booked in
+    // them) and the archive, for a fork that shares them instead
+    void writeSnapshotTo(SnapshotWriter& out, bool sharedLayout) const;
+    bool readSnapshotFrom(SnapshotReader& in, bool sharedLayout);
     ParkingRequest* findActiveRequest(int requestID);
+    ParkingRequest* restoreActiveRequest(const ParkingRequest& request);
     void removeActiveRequest(int requestID);
-    void addToHistory(const ParkingRequest& request, int slotID, int zoneID, bool crossZone);
+    void forceRequestState(ParkingRequest* request, RequestState state);
+    void linkRequestState(int requestID, RequestState state);
+    void unlinkRequestState(int requestID, RequestState state);
+    bool applyRequestEvent(ParkingRequest* request, RequestEvent event);
+    void addToHistory(const ParkingRequest& request, int slotID, int zoneID, bool crossZone, int allocatedTime);
+    void updateHistoryNode(HistoryNode* node, const ParkingRequest& request, int releaseTime, int charge);
     HistoryNode* findInHistory(int requestID);
+    void unlinkHistoryNode(HistoryNode* node);
+    void archiveHistoryNode(HistoryNode* node);
+    void discardHistoryNode(int requestID);
+    HistoryNode* reclaimHistoryNode(int requestID);
+    int findZoneIndex(int zoneID) const;
+    void adjustZoneOccupancy(int zoneIndex, int delta);
+    void serveWaitlistAfterGrowth(int zoneIndex, int added);
+    void unindexArea(int zoneIndex, int areaID);
+    ZoneIndex* ownAreaZones();
+    void publishSlotChange(int zoneID, int slotID, SlotOccupancy from, SlotOccupancy to);
 
 public:
     ParkingSystem(int zoneCount);
@@ -74,8 +246,29 @@ public:
     void setupZone(int zoneID, int areaCount);
     void setupParkingArea(int zoneID, int areaIndex, int areaID, int slotCapacity);
     void addZoneAdjacency(int zoneID1, int zoneID2);
+    void addZoneAdjacency(int zoneID1, int zoneID2, int weight);
+    bool setSlotAttributes(int zoneID, int areaIndex, int firstSlot, int count, int mask);
+    int countSlotsWithAttributes(int zoneID, int mask) const;
+    // Closing an area stops new allocations there; vehicles already
+    // parked stay until released
+    bool setAreaOpen(int zoneID, int areaIndex, bool open);
+    
+    // Reconfiguration while running: the zone keeps its vehicles, requests
+    // and history, and added slots are offered to the waitlist at once.
+    // Removing or shrinking an area is refused while a slot that would go
+    // is occupied or booked; later areas in the zone move down one index.
+    // Not allowed inside a transaction, and not undoable; a removal or a
+    // shrink also clears the undo log, so earlier operations can no
+    // longer be undone or redone either.
+    int addParkingArea(int zoneID, int areaID, int slotCapacity);
+    bool removeParkingArea(int zoneID, int areaIndex);
+    bool resizeParkingArea(int zoneID, int areaIndex, int slotCapacity);
+    bool removeZoneAdjacency(int zoneID1, int zoneID2);
     
     int createParkingRequest(string vehicleID, int requestedZone, int requestTime);
+    int createParkingRequest(string vehicleID, int requestedZone, int requestTime, PriorityClass priority);
+    int createReservation(string vehicleID, int requestedZone, int startTime, int endTime);
+    bool hasReservation(int requestID) const;
     bool allocateParking(int requestID);
     bool occupyParking(int requestID);
     bool releaseParking(int requestID, int releaseTime);
@@ -84,13 +277,120 @@ public:
     bool rollbackLastAllocation();
     bool rollbackLastKAllocations(int k);
     
+    // Undoes every transition of the most recent operation (allocate,
+    // occupy, release, cancel, rollback or advanceTime, with the waitlist
+    // hand-offs it triggered): slots, request states and history come back
+    // as they were, and a release's charge is taken back. A request put
+    // back into ALLOCATED or OCCUPIED gets a fresh no-show or maximum-stay
+    // timer, counted from now; reservations and overstay flags are not
+    // restored. Any new operation discards what could be redone.
+    bool undoLastOperation();
+    bool redoLastOperation();
+    bool canUndo() const;
+    bool canRedo() const;
+    
+    // All-or-nothing groups of operations. Every transition made while a
+    // transaction is open joins it; abort (or rolling back to a savepoint)
+    // undoes them newest first in O(k), and a committed transaction is a
+    // single undo step. One transaction at a time, no undo/redo or
+    // snapshot while it is open; recovery aborts one left unfinished.
+    bool beginTransaction();
+    // Returns the savepoint's number, -1 outside a transaction
+    int setSavepoint();
+    // Undoes back to the savepoint, which stays set; later ones are dropped
+    bool rollbackToSavepoint(int savepoint);
+    bool commitTransaction();
+    bool abortTransaction();
+    bool inTransaction() const;
+    
     ParkingAnalytics getAnalytics() const;
     void printZoneUtilization() const;
     int getPeakUsageZone() const;
+    int getTopKZones(int k, int* zoneIDsOut) const;
+    // Lowest occupied / capacity first (lower ID on ties)
+    int getLeastUtilizedZones(int k, int* zoneIDsOut) const;
+    // Over zones with fromZoneID <= ID <= toZoneID, in O(log zones);
+    // free slots in closed areas count
+    long long getFreeSlotsBetween(int fromZoneID, int toZoneID) const;
+    // Zone ID with the most free slots (lowest ID on ties), -1 if none
+    int getMostAvailableZone(int fromZoneID, int toZoneID) const;
+    
+    // Starts an empty timeline; refused while any stay is open (allocated
+    // or occupied), since its release would be subtracted from buckets
+    // that never counted it
+    bool configureTimeline(int bucketWidth, int bucketCount);
+    // 0 for unknown zones and ranges outside the timeline
+    double getZoneUtilizationBetween(int zoneID, int fromTime, int toTime) const;
+    int getPeakOccupancyBetween(int zoneID, int fromTime, int toTime) const;
+    
+    void setNoShowTimeout(int timeout);
+    int getNoShowTimeout() const;
+    void setMaxStayDuration(int duration);
+    // Applies to requests allocated from now on; reservations always take
+    // the nearest neighbour
+    void setSpilloverPolicy(SpilloverPolicy policy);
+    SpilloverPolicy getSpilloverPolicy() const;
+    int advanceTime(int now);
+    int getCurrentTime() const;
+    bool isOverstayed(int requestID) const;
+    int getOverstayedCount() const;
+    
+    bool isWaitlisted(int requestID) const;
+    int getWaitlistLength(int zoneID) const;
+    
+    // Charges are computed once, at release, and kept on the history entry
+    bool setZoneRate(int zoneID, int ratePerUnit);
+    void setCrossZoneSurcharge(int amount);
+    bool configureTariff(int dayLength, int revenueInterval);
+    bool setTariffBand(int startTime, int endTime, int percent);
+    long long getZoneRevenue(int zoneID) const;
+    long long getTotalRevenue() const;
+    const TariffEngine* getTariff() const;
+    
+    bool enableWriteAheadLog(const string& path, int groupCommitSize);
+    void disableWriteAheadLog();
+    bool syncWriteAheadLog();
+    // Syncs a partial group once it has waited the log's max sync delay;
+    // call on idle so a quiet period cannot leave records unsynced
+    bool flushWriteAheadLogIfDue();
+    long long recoverFromLog(const string& path);
+    
+    bool saveSnapshot(const string& path);
+    bool loadSnapshot(const string& path);
+    
+    // An independent copy for what-if runs. Each zone's area table, and
+    // the areas and slots in it, are shared copy-on-write, so forking costs
+    // O(zones) plus the active requests; a zone's table is copied on the
+    // first change to that zone, and an area only when one side changes it.
+    // Finished history (resident or archived) is carried over as analytics
+    // totals, not entries: the fork's analytics match this system's, but
+    // those entries cannot be looked up or undone there. The fork starts
+    // with an empty undo log and has no log, archive, listener or metrics
+    // history. nullptr inside a transaction.
+    ParkingSystem* fork() const;
+    
+    bool enableHistoryArchive(const string& path);
+    bool getHistoryEntry(int requestID, HistoryNode& entryOut);
+    int getResidentHistoryCount() const;
+    
+    const ParkingMetrics* getMetrics() const;
+    string getMetricsText() const;
+    
+    // Called on the operation's thread for every slot transition; pass
+    // nullptr to detach. The listener must not call back into the system.
+    void setOccupancyListener(OccupancyListener listener, void* context);
     
     Zone* getZones();
     int getZoneCount() const;
+    int getZoneIndex(int zoneID) const;
     ParkingRequest* getActiveRequest(int requestID);
+    
+    // Active requests by state in O(1); rolled-back requests stay active
+    // (as CANCELLED), released and cancelled ones leave with the request.
+    // Iterate with getFirstRequestInState / getNextRequestInState until -1.
+    int getRequestCountInState(RequestState state) const;
+    int getFirstRequestInState(RequestState state) const;
+    int getNextRequestInState(int requestID) const;
 };
 
 #endif
\ No newline at end of file
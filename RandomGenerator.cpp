@@ -0,0 +1,72 @@
+#include "RandomGenerator.h"
+#include <cmath>
+
+RandomGenerator::RandomGenerator() {
+    seed(1);
+}
+
+RandomGenerator::RandomGenerator(unsigned long long seedValue) {
+    seed(seedValue);
+}
+
+unsigned long long RandomGenerator::rotateLeft(unsigned long long value, int bits) {
+    return (value << bits) | (value >> (64 - bits));
+}
+
+// The state is filled from the seed with splitmix64, which never yields
+// the all-zero state xoshiro cannot leave
+void RandomGenerator::seed(unsigned long long seedValue) {
+    unsigned long long x = seedValue;
+    for (int i = 0; i < 4; i++) {
+        x += 0x9E3779B97F4A7C15ULL;
+        unsigned long long z = x;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        state[i] = z ^ (z >> 31);
+    }
+}
+
+unsigned long long RandomGenerator::next() {
+    unsigned long long result = rotateLeft(state[1] * 5, 7) * 9;
+    unsigned long long t = state[1] << 17;
+    state[2] ^= state[0];
+    state[3] ^= state[1];
+    state[1] ^= state[2];
+    state[0] ^= state[3];
+    state[2] ^= t;
+    state[3] = rotateLeft(state[3], 45);
+    return result;
+}
+
+// Uniform in [0, 1) with 53 bits of precision
+double RandomGenerator::nextDouble() {
+    return (double)(next() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+int RandomGenerator::nextInt(int bound) {
+    if (bound <= 0) {
+        return 0;
+    }
+    return (int)(nextDouble() * bound);
+}
+
+bool RandomGenerator::chance(double probability) {
+    return nextDouble() < probability;
+}
+
+double RandomGenerator::exponential(double rate) {
+    return -log(1.0 - nextDouble()) / rate;
+}
+
+// Box-Muller; the second value of each pair is dropped so every call
+// consumes exactly two draws
+double RandomGenerator::normal(double mean, double stddev) {
+    double u1 = 1.0 - nextDouble();
+    double u2 = nextDouble();
+    double z = sqrt(-2.0 * log(u1)) * cos(6.283185307179586 * u2);
+    return mean + stddev * z;
+}
+
+double RandomGenerator::logNormal(double mu, double sigma) {
+    return exp(normal(mu, sigma));
+}
\ No newline at end of file
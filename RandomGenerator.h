@@ -0,0 +1,29 @@
+#ifndef RANDOMGENERATOR_H
+#define RANDOMGENERATOR_H
+
+// Seeded xoshiro256** generator with the distributions the workload
+// generator needs. The standard library's distributions are not specified
+// bit-for-bit, so they are implemented here to keep a seed producing the
+// same sequence on every compiler and platform.
+class RandomGenerator {
+private:
+    unsigned long long state[4];
+
+    static unsigned long long rotateLeft(unsigned long long value, int bits);
+
+public:
+    RandomGenerator();
+    RandomGenerator(unsigned long long seed);
+
+    void seed(unsigned long long seed);
+    unsigned long long next();
+
+    double nextDouble();
+    int nextInt(int bound);
+    bool chance(double probability);
+    double exponential(double rate);
+    double normal(double mean, double stddev);
+    double logNormal(double mu, double sigma);
+};
+
+#endif
\ No newline at end of file
@@ -1,47 +1,29 @@
 #include "RollbackManager.h"
 
 RollbackManager::RollbackManager() {
-    top = nullptr;
-    size = 0;
     maxSize = 1000;
+    operations = new AllocationOperation[maxSize];
+    bottom = 0;
+    size = 0;
 }
 
 RollbackManager::RollbackManager(int maxSize) {
-    top = nullptr;
+    this->maxSize = (maxSize > 0) ? maxSize : 1;
+    operations = new AllocationOperation[this->maxSize];
+    bottom = 0;
     size = 0;
-    this->maxSize = maxSize;
 }
 
 RollbackManager::~RollbackManager() {
-    clear();
+    delete[] operations;
 }
 
 void RollbackManager::pushOperation(const AllocationOperation& operation) {
-    if (size >= maxSize) {
-        if (top != nullptr) {
-            if (top->next == nullptr) {
-                delete top;
-                top = nullptr;
-                size = 0;
-            } else {
-                StackNode* current = top;
-                StackNode* prev = nullptr;
-                while (current->next != nullptr) {
-                    prev = current;
-                    current = current->next;
-                }
-                delete current;
-                if (prev != nullptr) {
-                    prev->next = nullptr;
-                }
-                size--;
-            }
-        }
+    if (size == maxSize) {
+        bottom = (bottom + 1) % maxSize;
+        size--;
     }
-    
-    StackNode* newNode = new StackNode(operation);
-    newNode->next = top;
-    top = newNode;
+    operations[(bottom + size) % maxSize] = operation;
     size++;
 }
 
@@ -50,11 +32,8 @@ bool RollbackManager::popOperation(AllocationOperation& operation) {
         return false;
     }
     
-    operation = top->operation;
-    StackNode* temp = top;
-    top = top->next;
-    delete temp;
     size--;
+    operation = operations[(bottom + size) % maxSize];
     return true;
 }
 
@@ -63,23 +42,29 @@ bool RollbackManager::peekOperation(AllocationOperation& operation) const {
         return false;
     }
     
-    operation = top->operation;
+    operation = operations[(bottom + size - 1) % maxSize];
     return true;
 }
 
+// Copies up to maxCount operations, most recent first
+int RollbackManager::getOperations(AllocationOperation* out, int maxCount) const {
+    int count = 0;
+    while (count < size && count < maxCount) {
+        out[count] = operations[(bottom + size - 1 - count) % maxSize];
+        count++;
+    }
+    return count;
+}
+
 int RollbackManager::getSize() const {
     return size;
 }
 
 bool RollbackManager::isEmpty() const {
-    return top == nullptr;
+    return size == 0;
 }
 
 void RollbackManager::clear() {
-    while (!isEmpty()) {
-        StackNode* temp = top;
-        top = top->next;
-        delete temp;
-    }
+    bottom = 0;
     size = 0;
 }
\ No newline at end of file
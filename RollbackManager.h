@@ -36,18 +36,17 @@ struct AllocationOperation {
     }
 };
 
-struct StackNode {
-    AllocationOperation operation;
-    StackNode* next;
-    
-    StackNode(const AllocationOperation& op) : operation(op), next(nullptr) {}
-};
-
+// Bounded stack in a ring buffer: once full, a push overwrites the
+// oldest operation, so push and pop are both O(1)
 class RollbackManager {
 private:
-    StackNode* top;
+    AllocationOperation* operations;
+    int bottom;
     int size;
     int maxSize;
+    
+    RollbackManager(const RollbackManager&);
+    RollbackManager& operator=(const RollbackManager&);
 
 public:
     RollbackManager();
@@ -57,6 +56,7 @@ public:
     void pushOperation(const AllocationOperation& operation);
     bool popOperation(AllocationOperation& operation);
     bool peekOperation(AllocationOperation& operation) const;
+    int getOperations(AllocationOperation* out, int maxCount) const;
     
     int getSize() const;
     bool isEmpty() const;
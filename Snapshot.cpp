@@ -0,0 +1,157 @@
+#include "Snapshot.h"
+
+SnapshotWriter::SnapshotWriter() {
+    capacity = 4096;
+    buffer = new unsigned char[capacity];
+    size = 0;
+}
+
+SnapshotWriter::~SnapshotWriter() {
+    delete[] buffer;
+}
+
+void SnapshotWriter::ensureCapacity(long long extra) {
+    if (size + extra <= capacity) {
+        return;
+    }
+    long long newCapacity = capacity * 2;
+    while (newCapacity < size + extra) {
+        newCapacity *= 2;
+    }
+    unsigned char* newBuffer = new unsigned char[newCapacity];
+    for (long long i = 0; i < size; i++) {
+        newBuffer[i] = buffer[i];
+    }
+    delete[] buffer;
+    buffer = newBuffer;
+    capacity = newCapacity;
+}
+
+void SnapshotWriter::writeU8(unsigned char value) {
+    ensureCapacity(1);
+    buffer[size++] = value;
+}
+
+void SnapshotWriter::writeI32(int value) {
+    ensureCapacity(4);
+    unsigned int bits = (unsigned int)value;
+    for (int i = 0; i < 4; i++) {
+        buffer[size++] = (unsigned char)((bits >> (8 * i)) & 0xFF);
+    }
+}
+
+void SnapshotWriter::writeI64(long long value) {
+    ensureCapacity(8);
+    unsigned long long bits = (unsigned long long)value;
+    for (int i = 0; i < 8; i++) {
+        buffer[size++] = (unsigned char)((bits >> (8 * i)) & 0xFF);
+    }
+}
+
+void SnapshotWriter::writeBool(bool value) {
+    writeU8(value ? 1 : 0);
+}
+
+void SnapshotWriter::writeString(const string& value) {
+    writeI32((int)value.length());
+    writeBytes((const unsigned char*)value.data(), (long long)value.length());
+}
+
+void SnapshotWriter::writeBytes(const unsigned char* bytes, long long length) {
+    ensureCapacity(length);
+    for (long long i = 0; i < length; i++) {
+        buffer[size++] = bytes[i];
+    }
+}
+
+const unsigned char* SnapshotWriter::getData() const {
+    return buffer;
+}
+
+long long SnapshotWriter::getSize() const {
+    return size;
+}
+
+SnapshotReader::SnapshotReader(const unsigned char* data, long long size) {
+    this->data = data;
+    this->size = size;
+    offset = 0;
+    failed = false;
+}
+
+bool SnapshotReader::take(long long length) {
+    if (failed || length < 0 || length > size - offset) {
+        failed = true;
+        return false;
+    }
+    return true;
+}
+
+unsigned char SnapshotReader::readU8() {
+    if (!take(1)) {
+        return 0;
+    }
+    return data[offset++];
+}
+
+int SnapshotReader::readI32() {
+    if (!take(4)) {
+        return 0;
+    }
+    unsigned int bits = 0;
+    for (int i = 0; i < 4; i++) {
+        bits |= (unsigned int)data[offset++] << (8 * i);
+    }
+    return (int)bits;
+}
+
+long long SnapshotReader::readI64() {
+    if (!take(8)) {
+        return 0;
+    }
+    unsigned long long bits = 0;
+    for (int i = 0; i < 8; i++) {
+        bits |= (unsigned long long)data[offset++] << (8 * i);
+    }
+    return (long long)bits;
+}
+
+bool SnapshotReader::readBool() {
+    return readU8() != 0;
+}
+
+string SnapshotReader::readString() {
+    int length = readI32();
+    const unsigned char* bytes = readBytes(length);
+    if (bytes == nullptr) {
+        return "";
+    }
+    return string((const char*)bytes, length);
+}
+
+// Returns a pointer into the underlying memory, valid while it is mapped
+const unsigned char* SnapshotReader::readBytes(long long length) {
+    if (!take(length)) {
+        return nullptr;
+    }
+    const unsigned char* bytes = data + offset;
+    offset += length;
+    return bytes;
+}
+
+bool SnapshotReader::hasFailed() const {
+    return failed;
+}
+
+long long SnapshotReader::getRemaining() const {
+    return size - offset;
+}
+
+unsigned int snapshotChecksum(const unsigned char* data, long long length) {
+    unsigned int hash = 2166136261u;
+    for (long long i = 0; i < length; i++) {
+        hash ^= data[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
\ No newline at end of file
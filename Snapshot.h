@@ -0,0 +1,61 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <string>
+using namespace std;
+
+// Encoder for snapshot files. Values are little-endian and fixed width;
+// bitmaps and other bulk data are copied in as raw bytes so loading them
+// back is a straight copy out of the mapped file.
+class SnapshotWriter {
+private:
+    unsigned char* buffer;
+    long long size;
+    long long capacity;
+
+    void ensureCapacity(long long extra);
+
+public:
+    SnapshotWriter();
+    ~SnapshotWriter();
+
+    void writeU8(unsigned char value);
+    void writeI32(int value);
+    void writeI64(long long value);
+    void writeBool(bool value);
+    void writeString(const string& value);
+    void writeBytes(const unsigned char* bytes, long long length);
+
+    const unsigned char* getData() const;
+    long long getSize() const;
+};
+
+// Decoder over a block of memory (normally a MappedFile). Reading past the
+// end returns zeros and marks the reader failed instead of overrunning.
+class SnapshotReader {
+private:
+    const unsigned char* data;
+    long long size;
+    long long offset;
+    bool failed;
+
+    bool take(long long length);
+
+public:
+    SnapshotReader(const unsigned char* data, long long size);
+
+    unsigned char readU8();
+    int readI32();
+    long long readI64();
+    bool readBool();
+    string readString();
+    const unsigned char* readBytes(long long length);
+
+    bool hasFailed() const;
+    long long getRemaining() const;
+};
+
+// FNV-1a over a byte range, used to reject torn or corrupt snapshots
+unsigned int snapshotChecksum(const unsigned char* data, long long length);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,174 @@
+#include "SummaryBitmap.h"
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+SummaryBitmap::SummaryBitmap() {
+    words = nullptr;
+    summary = nullptr;
+    size = 0;
+    wordCount = 0;
+    summaryCount = 0;
+    setCount = 0;
+}
+
+SummaryBitmap::~SummaryBitmap() {
+    delete[] words;
+    delete[] summary;
+}
+
+SummaryBitmap::SummaryBitmap(const SummaryBitmap& other) {
+    words = nullptr;
+    summary = nullptr;
+    copyFrom(other);
+}
+
+SummaryBitmap& SummaryBitmap::operator=(const SummaryBitmap& other) {
+    if (this != &other) {
+        delete[] words;
+        delete[] summary;
+        copyFrom(other);
+    }
+    return *this;
+}
+
+void SummaryBitmap::copyFrom(const SummaryBitmap& other) {
+    size = other.size;
+    wordCount = other.wordCount;
+    summaryCount = other.summaryCount;
+    setCount = other.setCount;
+    words = (wordCount > 0) ? new unsigned long long[wordCount] : nullptr;
+    summary = (summaryCount > 0) ? new unsigned long long[summaryCount] : nullptr;
+    for (int i = 0; i < wordCount; i++) {
+        words[i] = other.words[i];
+    }
+    for (int i = 0; i < summaryCount; i++) {
+        summary[i] = other.summary[i];
+    }
+}
+
+void SummaryBitmap::resize(int size) {
+    delete[] words;
+    delete[] summary;
+    this->size = (size > 0) ? size : 0;
+    wordCount = (this->size + 63) / 64;
+    summaryCount = (wordCount + 63) / 64;
+    setCount = 0;
+    words = (wordCount > 0) ? new unsigned long long[wordCount] : nullptr;
+    summary = (summaryCount > 0) ? new unsigned long long[summaryCount] : nullptr;
+    for (int i = 0; i < wordCount; i++) {
+        words[i] = 0;
+    }
+    for (int i = 0; i < summaryCount; i++) {
+        summary[i] = 0;
+    }
+}
+
+void SummaryBitmap::resizeKeeping(int size) {
+    SummaryBitmap resized;
+    resized.resize(size);
+    for (int w = 0; w < wordCount && w < resized.wordCount; w++) {
+        unsigned long long bits = words[w];
+        if (w == resized.wordCount - 1 && (resized.size & 63) != 0) {
+            bits &= (1ULL << (resized.size & 63)) - 1;
+        }
+        while (bits != 0) {
+            resized.set(w * 64 + lowestBit(bits));
+            bits &= bits - 1;
+        }
+    }
+    *this = resized;
+}
+
+void SummaryBitmap::set(int index) {
+    if (index < 0 || index >= size) {
+        return;
+    }
+    unsigned long long bit = 1ULL << (index & 63);
+    int word = index >> 6;
+    if (words[word] & bit) {
+        return;
+    }
+    words[word] |= bit;
+    summary[word >> 6] |= 1ULL << (word & 63);
+    setCount++;
+}
+
+void SummaryBitmap::clear(int index) {
+    if (index < 0 || index >= size) {
+        return;
+    }
+    unsigned long long bit = 1ULL << (index & 63);
+    int word = index >> 6;
+    if (!(words[word] & bit)) {
+        return;
+    }
+    words[word] &= ~bit;
+    if (words[word] == 0) {
+        summary[word >> 6] &= ~(1ULL << (word & 63));
+    }
+    setCount--;
+}
+
+bool SummaryBitmap::test(int index) const {
+    if (index < 0 || index >= size) {
+        return false;
+    }
+    return (words[index >> 6] >> (index & 63)) & 1ULL;
+}
+
+int SummaryBitmap::findFirst() const {
+    for (int s = 0; s < summaryCount; s++) {
+        if (summary[s] != 0) {
+            int word = s * 64 + lowestBit(summary[s]);
+            return word * 64 + lowestBit(words[word]);
+        }
+    }
+    return -1;
+}
+
+int SummaryBitmap::findNext(int from) const {
+    if (from < 0) {
+        from = 0;
+    }
+    if (from >= size) {
+        return -1;
+    }
+    int word = from >> 6;
+    unsigned long long rest = words[word] & (~0ULL << (from & 63));
+    if (rest != 0) {
+        return word * 64 + lowestBit(rest);
+    }
+    // Later words through the summary, starting in the current summary word
+    word++;
+    for (int s = word >> 6; s < summaryCount; s++) {
+        unsigned long long candidates = summary[s];
+        if (s == (word >> 6)) {
+            candidates &= ((word & 63) == 0) ? ~0ULL : (~0ULL << (word & 63));
+        }
+        if (candidates != 0) {
+            int found = s * 64 + lowestBit(candidates);
+            return found * 64 + lowestBit(words[found]);
+        }
+    }
+    return -1;
+}
+
+int SummaryBitmap::getSize() const {
+    return size;
+}
+
+int SummaryBitmap::getSetCount() const {
+    return setCount;
+}
+
+// Index of the lowest set bit; word must be non-zero
+int SummaryBitmap::lowestBit(unsigned long long word) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward64(&index, word);
+    return (int)index;
+#else
+    return __builtin_ctzll(word);
+#endif
+}
\ No newline at end of file
@@ -0,0 +1,45 @@
+#ifndef SUMMARYBITMAP_H
+#define SUMMARYBITMAP_H
+
+// Bit set, sized up front, with one summary bit per 64-bit word, set while the
+// word is non-zero. findFirst is a find-first-set on the summary and one
+// on the word it points at; a single summary word covers 4096 bits, so
+// for every size used here the search never loops.
+class SummaryBitmap {
+private:
+    unsigned long long* words;
+    unsigned long long* summary;
+    int size;
+    int wordCount;
+    int summaryCount;
+    int setCount;
+
+    void copyFrom(const SummaryBitmap& other);
+
+public:
+    SummaryBitmap();
+    ~SummaryBitmap();
+
+    SummaryBitmap(const SummaryBitmap& other);
+    SummaryBitmap& operator=(const SummaryBitmap& other);
+
+    // Discards the contents; every bit starts clear
+    void resize(int size);
+    // Keeps the bits below the new size; new bits start clear
+    void resizeKeeping(int size);
+
+    void set(int index);
+    void clear(int index);
+    bool test(int index) const;
+    // Lowest set bit, or -1 when none is
+    int findFirst() const;
+    // Lowest set bit at or above from, or -1
+    int findNext(int from) const;
+
+    int getSize() const;
+    int getSetCount() const;
+
+    static int lowestBit(unsigned long long word);
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,264 @@
+#include "TariffEngine.h"
+
+TariffEngine::TariffEngine(int zoneCount) {
+    this->zoneCount = zoneCount;
+    zoneRates = new int[zoneCount];
+    zoneRevenue = new long long[zoneCount];
+    for (int i = 0; i < zoneCount; i++) {
+        zoneRates[i] = DEFAULT_RATE;
+        zoneRevenue[i] = 0;
+    }
+    crossZoneSurcharge = DEFAULT_SURCHARGE;
+    totalRevenue = 0;
+    chargeCount = 0;
+
+    dayLength = 0;
+    bandPercent = nullptr;
+    weightedPrefix = nullptr;
+    intervalWidth = 1;
+    intervalRevenue = nullptr;
+    intervalCapacity = 0;
+    configure(DEFAULT_DAY_LENGTH, DEFAULT_DAY_LENGTH);
+}
+
+TariffEngine::~TariffEngine() {
+    delete[] zoneRates;
+    delete[] zoneRevenue;
+    delete[] bandPercent;
+    delete[] weightedPrefix;
+    delete[] intervalRevenue;
+}
+
+bool TariffEngine::setZoneRate(int zoneIndex, int ratePerUnit) {
+    if (zoneIndex < 0 || zoneIndex >= zoneCount || ratePerUnit < 0) {
+        return false;
+    }
+    zoneRates[zoneIndex] = ratePerUnit;
+    return true;
+}
+
+void TariffEngine::setCrossZoneSurcharge(int amount) {
+    crossZoneSurcharge = (amount > 0) ? amount : 0;
+}
+
+bool TariffEngine::configure(int dayLength, int intervalWidth) {
+    if (dayLength <= 0 || intervalWidth <= 0) {
+        return false;
+    }
+    delete[] bandPercent;
+    delete[] weightedPrefix;
+    this->dayLength = dayLength;
+    bandPercent = new int[dayLength];
+    weightedPrefix = new long long[dayLength + 1];
+    for (int t = 0; t < dayLength; t++) {
+        bandPercent[t] = 100;
+    }
+    rebuildPrefix();
+
+    delete[] intervalRevenue;
+    this->intervalWidth = intervalWidth;
+    intervalCapacity = 16;
+    intervalRevenue = new long long[intervalCapacity];
+    for (int i = 0; i < intervalCapacity; i++) {
+        intervalRevenue[i] = 0;
+    }
+    return true;
+}
+
+bool TariffEngine::setBand(int startTime, int endTime, int percent) {
+    if (startTime < 0 || endTime > dayLength || startTime >= endTime || percent < 0) {
+        return false;
+    }
+    for (int t = startTime; t < endTime; t++) {
+        bandPercent[t] = percent;
+    }
+    rebuildPrefix();
+    return true;
+}
+
+void TariffEngine::rebuildPrefix() {
+    weightedPrefix[0] = 0;
+    for (int t = 0; t < dayLength; t++) {
+        weightedPrefix[t + 1] = weightedPrefix[t] + bandPercent[t];
+    }
+}
+
+// Weighted units (in percent) from time 0 to `time`; whole days come from
+// the last prefix entry, the remainder from the table
+long long TariffEngine::weightedUnitsUntil(int time) const {
+    long long days = time / dayLength;
+    int remainder = time % dayLength;
+    if (remainder < 0) {
+        remainder += dayLength;
+        days--;
+    }
+    return days * weightedPrefix[dayLength] + weightedPrefix[remainder];
+}
+
+int TariffEngine::computeCharge(int zoneIndex, int startTime, int endTime, bool crossZone) const {
+    if (zoneIndex < 0 || zoneIndex >= zoneCount) {
+        return 0;
+    }
+    long long charge = 0;
+    if (endTime > startTime) {
+        long long weighted = weightedUnitsUntil(endTime) - weightedUnitsUntil(startTime);
+        charge = (zoneRates[zoneIndex] * weighted + 50) / 100;
+    }
+    if (crossZone) {
+        charge += crossZoneSurcharge;
+    }
+    return (int)charge;
+}
+
+void TariffEngine::ensureInterval(int interval) {
+    if (interval < intervalCapacity) {
+        return;
+    }
+    int newCapacity = intervalCapacity * 2;
+    while (newCapacity <= interval) {
+        newCapacity *= 2;
+    }
+    long long* newRevenue = new long long[newCapacity];
+    for (int i = 0; i < newCapacity; i++) {
+        newRevenue[i] = (i < intervalCapacity) ? intervalRevenue[i] : 0;
+    }
+    delete[] intervalRevenue;
+    intervalRevenue = newRevenue;
+    intervalCapacity = newCapacity;
+}
+
+void TariffEngine::recordCharge(int zoneIndex, int time, int amount) {
+    if (zoneIndex >= 0 && zoneIndex < zoneCount) {
+        zoneRevenue[zoneIndex] += amount;
+    }
+    int interval = (time > 0) ? time / intervalWidth : 0;
+    ensureInterval(interval);
+    intervalRevenue[interval] += amount;
+    totalRevenue += amount;
+    chargeCount++;
+}
+
+void TariffEngine::reverseCharge(int zoneIndex, int time, int amount) {
+    recordCharge(zoneIndex, time, -amount);
+    chargeCount -= 2;
+}
+
+int TariffEngine::getZoneRate(int zoneIndex) const {
+    return (zoneIndex >= 0 && zoneIndex < zoneCount) ? zoneRates[zoneIndex] : 0;
+}
+
+int TariffEngine::getCrossZoneSurcharge() const {
+    return crossZoneSurcharge;
+}
+
+int TariffEngine::getDayLength() const {
+    return dayLength;
+}
+
+int TariffEngine::getIntervalWidth() const {
+    return intervalWidth;
+}
+
+long long TariffEngine::getZoneRevenue(int zoneIndex) const {
+    return (zoneIndex >= 0 && zoneIndex < zoneCount) ? zoneRevenue[zoneIndex] : 0;
+}
+
+long long TariffEngine::getTotalRevenue() const {
+    return totalRevenue;
+}
+
+long long TariffEngine::getChargeCount() const {
+    return chargeCount;
+}
+
+long long TariffEngine::getIntervalRevenue(int interval) const {
+    return (interval >= 0 && interval < intervalCapacity) ? intervalRevenue[interval] : 0;
+}
+
+// One past the last interval that has any revenue
+int TariffEngine::getIntervalCount() const {
+    int count = intervalCapacity;
+    while (count > 0 && intervalRevenue[count - 1] == 0) {
+        count--;
+    }
+    return count;
+}
+
+void TariffEngine::writeSnapshot(SnapshotWriter& out) const {
+    out.writeI32(zoneCount);
+    for (int i = 0; i < zoneCount; i++) {
+        out.writeI32(zoneRates[i]);
+        out.writeI64(zoneRevenue[i]);
+    }
+    out.writeI32(crossZoneSurcharge);
+    out.writeI64(totalRevenue);
+    out.writeI64(chargeCount);
+
+    // Bands as runs of equal percent, usually only a handful
+    out.writeI32(dayLength);
+    int runs = 0;
+    for (int t = 0; t < dayLength; t++) {
+        if (t == 0 || bandPercent[t] != bandPercent[t - 1]) {
+            runs++;
+        }
+    }
+    out.writeI32(runs);
+    for (int t = 0; t < dayLength; t++) {
+        if (t == 0 || bandPercent[t] != bandPercent[t - 1]) {
+            out.writeI32(t);
+            out.writeI32(bandPercent[t]);
+        }
+    }
+
+    int intervals = getIntervalCount();
+    out.writeI32(intervalWidth);
+    out.writeI32(intervals);
+    for (int i = 0; i < intervals; i++) {
+        out.writeI64(intervalRevenue[i]);
+    }
+}
+
+bool TariffEngine::readSnapshot(SnapshotReader& in) {
+    if (in.readI32() != zoneCount) {
+        return false;
+    }
+    for (int i = 0; i < zoneCount; i++) {
+        zoneRates[i] = in.readI32();
+        zoneRevenue[i] = in.readI64();
+    }
+    crossZoneSurcharge = in.readI32();
+    totalRevenue = in.readI64();
+    chargeCount = in.readI64();
+
+    int savedDayLength = in.readI32();
+    int runs = in.readI32();
+    if (in.hasFailed() || !configure(savedDayLength, 1)) {
+        return false;
+    }
+    int runStart = -1;
+    int runPercent = 100;
+    for (int r = 0; r < runs && !in.hasFailed(); r++) {
+        int start = in.readI32();
+        int percent = in.readI32();
+        if (runStart != -1) {
+            setBand(runStart, start, runPercent);
+        }
+        runStart = start;
+        runPercent = percent;
+    }
+    if (runStart != -1) {
+        setBand(runStart, dayLength, runPercent);
+    }
+
+    int savedWidth = in.readI32();
+    int intervals = in.readI32();
+    if (in.hasFailed() || savedWidth <= 0 || intervals < 0) {
+        return false;
+    }
+    intervalWidth = savedWidth;
+    ensureInterval(intervals);
+    for (int i = 0; i < intervals; i++) {
+        intervalRevenue[i] = in.readI64();
+    }
+    return !in.hasFailed();
+}
\ No newline at end of file
@@ -0,0 +1,73 @@
+#ifndef TARIFFENGINE_H
+#define TARIFFENGINE_H
+
+#include "Snapshot.h"
+
+// Parking charges and the revenue they add up to.
+// A stay costs ratePerUnit of the zone it parked in for every time unit,
+// scaled by the time-of-day band the unit falls in (percent, 100 = the
+// base rate), plus a flat surcharge when it was a cross-zone allocation.
+// Bands repeat every dayLength units and are folded into a prefix table
+// of weighted units, so a charge is two lookups however long the stay.
+// Revenue is added up per zone and per fixed-width interval (by release
+// time) as charges are made, so reports never look at history.
+class TariffEngine {
+private:
+    int zoneCount;
+    int* zoneRates;
+    int crossZoneSurcharge;
+
+    int dayLength;
+    int* bandPercent;
+    // weightedPrefix[t] = sum of bandPercent over [0, t)
+    long long* weightedPrefix;
+
+    long long* zoneRevenue;
+    long long totalRevenue;
+    long long chargeCount;
+    int intervalWidth;
+    long long* intervalRevenue;
+    int intervalCapacity;
+
+    void rebuildPrefix();
+    long long weightedUnitsUntil(int time) const;
+    void ensureInterval(int interval);
+
+    TariffEngine(const TariffEngine&);
+    TariffEngine& operator=(const TariffEngine&);
+
+public:
+    static const int DEFAULT_RATE = 10;
+    static const int DEFAULT_SURCHARGE = 50;
+    static const int DEFAULT_DAY_LENGTH = 1440;
+
+    TariffEngine(int zoneCount);
+    ~TariffEngine();
+
+    bool setZoneRate(int zoneIndex, int ratePerUnit);
+    void setCrossZoneSurcharge(int amount);
+    // Clears every band and the revenue intervals
+    bool configure(int dayLength, int intervalWidth);
+    // Applies percent to [startTime, endTime) of each day
+    bool setBand(int startTime, int endTime, int percent);
+
+    int computeCharge(int zoneIndex, int startTime, int endTime, bool crossZone) const;
+    void recordCharge(int zoneIndex, int time, int amount);
+    // Takes back a charge made by recordCharge with the same arguments
+    void reverseCharge(int zoneIndex, int time, int amount);
+
+    int getZoneRate(int zoneIndex) const;
+    int getCrossZoneSurcharge() const;
+    int getDayLength() const;
+    int getIntervalWidth() const;
+    long long getZoneRevenue(int zoneIndex) const;
+    long long getTotalRevenue() const;
+    long long getChargeCount() const;
+    long long getIntervalRevenue(int interval) const;
+    int getIntervalCount() const;
+
+    void writeSnapshot(SnapshotWriter& out) const;
+    bool readSnapshot(SnapshotReader& in);
+};
+
+#endif
\ No newline at end of file
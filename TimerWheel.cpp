@@ -0,0 +1,261 @@
+#include "TimerWheel.h"
+
+// Level markers for timers that are not in a wheel bucket
+static const int DUE_LEVEL = -2;
+static const int OVERFLOW_LEVEL = -3;
+
+TimerWheel::TimerWheel() {
+    for (int l = 0; l < WHEEL_LEVELS; l++) {
+        levelCounts[l] = 0;
+        for (int s = 0; s < WHEEL_SLOTS; s++) {
+            buckets[l][s] = nullptr;
+        }
+    }
+    due = nullptr;
+    overflow = nullptr;
+    overflowCount = 0;
+    currentTick = 0;
+    size = 0;
+}
+
+TimerWheel::TimerWheel(int startTime) : TimerWheel() {
+    currentTick = (startTime > 0) ? startTime : 0;
+}
+
+TimerWheel::~TimerWheel() {
+    clear();
+}
+
+void TimerWheel::place(TimerNode* node) {
+    TimerNode** head;
+
+    if (node->deadline <= currentTick) {
+        // Already due: the current tick's bucket has been drained, so the
+        // timer waits in a separate list for the next advance()
+        node->level = DUE_LEVEL;
+        node->slot = -1;
+        head = &due;
+    } else {
+        long long delta = (long long)node->deadline - currentTick;
+        int level = -1;
+        for (int l = 0; l < WHEEL_LEVELS; l++) {
+            if (delta < (1LL << (WHEEL_BITS * (l + 1)))) {
+                level = l;
+                break;
+            }
+        }
+
+        if (level == -1) {
+            node->level = OVERFLOW_LEVEL;
+            node->slot = -1;
+            head = &overflow;
+            overflowCount++;
+        } else {
+            int slot = (node->deadline >> (WHEEL_BITS * level)) & (WHEEL_SLOTS - 1);
+            node->level = level;
+            node->slot = slot;
+            head = &buckets[level][slot];
+            levelCounts[level]++;
+        }
+    }
+
+    node->prev = nullptr;
+    node->next = *head;
+    if (*head != nullptr) {
+        (*head)->prev = node;
+    }
+    *head = node;
+}
+
+void TimerWheel::unlink(TimerNode* node) {
+    if (node->level == -1) {
+        return;
+    }
+    TimerNode** head;
+    if (node->level == OVERFLOW_LEVEL) {
+        head = &overflow;
+        overflowCount--;
+    } else if (node->level == DUE_LEVEL) {
+        head = &due;
+    } else {
+        head = &buckets[node->level][node->slot];
+        levelCounts[node->level]--;
+    }
+
+    if (node->prev != nullptr) {
+        node->prev->next = node->next;
+    } else {
+        *head = node->next;
+    }
+    if (node->next != nullptr) {
+        node->next->prev = node->prev;
+    }
+    node->prev = nullptr;
+    node->next = nullptr;
+    node->level = -1;
+    node->slot = -1;
+}
+
+// Re-files every timer of the bucket that the current tick just entered
+// at the given level; each lands in a finer wheel (or level 0 if due now).
+void TimerWheel::cascade(int level) {
+    int slot = (currentTick >> (WHEEL_BITS * level)) & (WHEEL_SLOTS - 1);
+    TimerNode* node = buckets[level][slot];
+    buckets[level][slot] = nullptr;
+
+    while (node != nullptr) {
+        TimerNode* next = node->next;
+        levelCounts[level]--;
+        if (node->deadline == currentTick) {
+            node->level = 0;
+            node->slot = currentTick & (WHEEL_SLOTS - 1);
+            node->prev = nullptr;
+            node->next = buckets[0][node->slot];
+            if (buckets[0][node->slot] != nullptr) {
+                buckets[0][node->slot]->prev = node;
+            }
+            buckets[0][node->slot] = node;
+            levelCounts[0]++;
+        } else {
+            place(node);
+        }
+        node = next;
+    }
+}
+
+void TimerWheel::cascadeOverflow() {
+    TimerNode* node = overflow;
+    overflow = nullptr;
+    overflowCount = 0;
+
+    while (node != nullptr) {
+        TimerNode* next = node->next;
+        place(node);
+        node = next;
+    }
+}
+
+TimerNode* TimerWheel::schedule(int requestID, int deadline, TimerKind kind) {
+    TimerNode* node = new TimerNode(requestID, deadline, kind);
+    place(node);
+    size++;
+    return node;
+}
+
+// A node already handed out by advance() (level -1) belongs to the
+// caller and is left alone
+void TimerWheel::cancel(TimerNode* node) {
+    if (node == nullptr || node->level == -1) {
+        return;
+    }
+    unlink(node);
+    size--;
+    delete node;
+}
+
+// Moves the clock forward to `now` and returns the expired timers as a
+// list chained through `next`. The caller owns (and must delete) them.
+TimerNode* TimerWheel::advance(int now) {
+    TimerNode* expiredHead = due;
+    TimerNode* expiredTail = nullptr;
+
+    while (due != nullptr) {
+        size--;
+        due->prev = nullptr;
+        due->level = -1;
+        expiredTail = due;
+        due = due->next;
+    }
+
+    while (currentTick < now) {
+        // Jump straight to the next boundary that could bring work into
+        // level 0 when every finer wheel is empty
+        int emptyLevels = 0;
+        while (emptyLevels < WHEEL_LEVELS && levelCounts[emptyLevels] == 0) {
+            emptyLevels++;
+        }
+        if (emptyLevels == WHEEL_LEVELS && overflowCount == 0) {
+            currentTick = now;
+            break;
+        }
+        if (emptyLevels > 0) {
+            long long span = 1LL << (WHEEL_BITS * emptyLevels);
+            long long boundary = (((long long)currentTick / span) + 1) * span;
+            if (boundary > now) {
+                currentTick = now;
+                break;
+            }
+            currentTick = (int)(boundary - 1);
+        }
+
+        currentTick++;
+
+        if ((currentTick & ((1 << (WHEEL_BITS * WHEEL_LEVELS)) - 1)) == 0) {
+            cascadeOverflow();
+        }
+        for (int l = WHEEL_LEVELS - 1; l >= 1; l--) {
+            if ((currentTick & ((1 << (WHEEL_BITS * l)) - 1)) == 0) {
+                cascade(l);
+            }
+        }
+
+        int slot = currentTick & (WHEEL_SLOTS - 1);
+        TimerNode* node = buckets[0][slot];
+        buckets[0][slot] = nullptr;
+        while (node != nullptr) {
+            TimerNode* next = node->next;
+            levelCounts[0]--;
+            size--;
+            node->prev = nullptr;
+            node->next = nullptr;
+            node->level = -1;
+            node->slot = -1;
+            if (expiredTail == nullptr) {
+                expiredHead = node;
+            } else {
+                expiredTail->next = node;
+            }
+            expiredTail = node;
+            node = next;
+        }
+    }
+
+    return expiredHead;
+}
+
+int TimerWheel::getCurrentTime() const {
+    return currentTick;
+}
+
+int TimerWheel::getSize() const {
+    return size;
+}
+
+void TimerWheel::clear() {
+    for (int l = 0; l < WHEEL_LEVELS; l++) {
+        for (int s = 0; s < WHEEL_SLOTS; s++) {
+            TimerNode* node = buckets[l][s];
+            while (node != nullptr) {
+                TimerNode* next = node->next;
+                delete node;
+                node = next;
+            }
+            buckets[l][s] = nullptr;
+        }
+        levelCounts[l] = 0;
+    }
+
+    TimerNode* lists[2] = { due, overflow };
+    for (int i = 0; i < 2; i++) {
+        TimerNode* node = lists[i];
+        while (node != nullptr) {
+            TimerNode* next = node->next;
+            delete node;
+            node = next;
+        }
+    }
+    due = nullptr;
+    overflow = nullptr;
+    overflowCount = 0;
+    size = 0;
+}
\ No newline at end of file
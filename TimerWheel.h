@@ -0,0 +1,69 @@
+#ifndef TIMERWHEEL_H
+#define TIMERWHEEL_H
+
+enum TimerKind {
+    NO_SHOW_TIMER,
+    MAX_STAY_TIMER,
+    RESERVATION_START_TIMER
+};
+
+struct TimerNode {
+    int requestID;
+    int deadline;
+    TimerKind kind;
+    TimerNode* prev;
+    TimerNode* next;
+    int level;
+    int slot;
+
+    TimerNode(int reqID, int time, TimerKind timerKind) {
+        requestID = reqID;
+        deadline = time;
+        kind = timerKind;
+        prev = nullptr;
+        next = nullptr;
+        level = -1;
+        slot = -1;
+    }
+};
+
+// Hierarchical timer wheel: WHEEL_LEVELS wheels of WHEEL_SLOTS buckets,
+// each level covering WHEEL_SLOTS times the range of the one below.
+// Buckets are doubly-linked so a timer can be cancelled in O(1), and
+// advance() skips over empty wheels, so its cost is proportional to the
+// number of expired timers (plus one cascade per wheel boundary crossed)
+// rather than to the number of pending timers.
+class TimerWheel {
+private:
+    static const int WHEEL_BITS = 6;
+    static const int WHEEL_SLOTS = 1 << WHEEL_BITS;
+    static const int WHEEL_LEVELS = 4;
+
+    TimerNode* buckets[WHEEL_LEVELS][WHEEL_SLOTS];
+    int levelCounts[WHEEL_LEVELS];
+    TimerNode* due;
+    TimerNode* overflow;
+    int overflowCount;
+    int currentTick;
+    int size;
+
+    void place(TimerNode* node);
+    void unlink(TimerNode* node);
+    void cascade(int level);
+    void cascadeOverflow();
+
+public:
+    TimerWheel();
+    TimerWheel(int startTime);
+    ~TimerWheel();
+
+    TimerNode* schedule(int requestID, int deadline, TimerKind kind);
+    void cancel(TimerNode* node);
+    TimerNode* advance(int now);
+
+    int getCurrentTime() const;
+    int getSize() const;
+    void clear();
+};
+
+#endif
\ No newline at end of file
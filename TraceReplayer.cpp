@@ -0,0 +1,327 @@
+#include "TraceReplayer.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+static const int MAX_LINE_LENGTH = 512;
+static const int GOLDEN_FIELDS = 6;
+static const char* GOLDEN_NAMES[GOLDEN_FIELDS] = {
+    "totalRequests", "completedRequests", "cancelledRequests",
+    "crossZoneAllocations", "averageParkingDuration", "zoneUtilizationRate"
+};
+
+static char* nextToken(char*& cursor) {
+    while (*cursor == ' ' || *cursor == '\t' || *cursor == '\r' || *cursor == '\n') {
+        cursor++;
+    }
+    if (*cursor == '\0' || *cursor == '#') {
+        return nullptr;
+    }
+    char* token = cursor;
+    while (*cursor != '\0' && *cursor != ' ' && *cursor != '\t' && *cursor != '\r' && *cursor != '\n') {
+        cursor++;
+    }
+    if (*cursor != '\0') {
+        *cursor++ = '\0';
+    }
+    return token;
+}
+
+static bool toInt(const char* token, int& value) {
+    if (token == nullptr) {
+        return false;
+    }
+    char* end = nullptr;
+    long parsed = strtol(token, &end, 10);
+    if (end == token || *end != '\0') {
+        return false;
+    }
+    value = (int)parsed;
+    return true;
+}
+
+static void goldenValues(const ParkingAnalytics& analytics, double* values) {
+    values[0] = analytics.totalRequests;
+    values[1] = analytics.completedRequests;
+    values[2] = analytics.cancelledRequests;
+    values[3] = analytics.crossZoneAllocations;
+    values[4] = analytics.averageParkingDuration;
+    values[5] = analytics.zoneUtilizationRate;
+}
+
+TraceReplayer::TraceReplayer(ParkingSystem* system) {
+    this->system = system;
+    keyCapacity = 1024;
+    requestByKey = new int[keyCapacity];
+    for (int i = 0; i < keyCapacity; i++) {
+        requestByKey[i] = -1;
+    }
+    for (int i = 0; i < TRACE_OPERATION_COUNT; i++) {
+        failures[i] = 0;
+    }
+    eventCount = 0;
+    wallSeconds = 0.0;
+}
+
+TraceReplayer::~TraceReplayer() {
+    delete[] requestByKey;
+}
+
+void TraceReplayer::mapKey(int key, int requestID) {
+    if (key >= keyCapacity) {
+        int newCapacity = keyCapacity;
+        while (newCapacity <= key) {
+            newCapacity *= 2;
+        }
+        int* newMap = new int[newCapacity];
+        for (int i = 0; i < newCapacity; i++) {
+            newMap[i] = (i < keyCapacity) ? requestByKey[i] : -1;
+        }
+        delete[] requestByKey;
+        requestByKey = newMap;
+        keyCapacity = newCapacity;
+    }
+    requestByKey[key] = requestID;
+}
+
+int TraceReplayer::lookupKey(int key) const {
+    if (key < 0 || key >= keyCapacity) {
+        return -1;
+    }
+    return requestByKey[key];
+}
+
+bool TraceReplayer::replay(const string& path, string& errorOut) {
+    FILE* in = fopen(path.c_str(), "r");
+    if (in == nullptr) {
+        errorOut = "cannot open " + path;
+        return false;
+    }
+
+    char line[MAX_LINE_LENGTH];
+    int lineNumber = 0;
+    string error = "";
+    chrono::steady_clock::time_point replayStart = chrono::steady_clock::now();
+
+    while (error.empty() && fgets(line, MAX_LINE_LENGTH, in) != nullptr) {
+        lineNumber++;
+        char* cursor = line;
+        char* timeToken = nextToken(cursor);
+        if (timeToken == nullptr) {
+            continue;
+        }
+
+        int time = 0;
+        int key = 0;
+        char* name = nextToken(cursor);
+        if (!toInt(timeToken, time) || name == nullptr) {
+            error = "expected '<time> <operation> ...'";
+            break;
+        }
+
+        TraceOperation operation = TRACE_OPERATION_COUNT;
+        for (int i = 0; i < TRACE_OPERATION_COUNT; i++) {
+            if (strcmp(name, getOperationName((TraceOperation)i)) == 0) {
+                operation = (TraceOperation)i;
+            }
+        }
+        if (operation == TRACE_OPERATION_COUNT) {
+            error = string("unknown operation '") + name + "'";
+            break;
+        }
+        if (operation != TRACE_ADVANCE && (!toInt(nextToken(cursor), key) || key < 0)) {
+            error = "expected a non-negative request key";
+            break;
+        }
+
+        // Arguments are parsed before the clock starts so only the
+        // ParkingSystem call itself is timed
+        string vehicleID;
+        int zoneID = 0;
+        PriorityClass priority = PRIORITY_STANDARD;
+        int requestID = lookupKey(key);
+        if (operation == TRACE_CREATE) {
+            char* vehicle = nextToken(cursor);
+            if (vehicle == nullptr || !toInt(nextToken(cursor), zoneID)) {
+                error = "expected 'create <key> <vehicleID> <zoneID> [priority]'";
+                break;
+            }
+            vehicleID = vehicle;
+            char* priorityName = nextToken(cursor);
+            if (priorityName != nullptr) {
+                if (strcmp(priorityName, "permit") == 0) {
+                    priority = PRIORITY_PERMIT_HOLDER;
+                } else if (strcmp(priorityName, "accessible") == 0) {
+                    priority = PRIORITY_ACCESSIBLE;
+                } else if (strcmp(priorityName, "standard") != 0) {
+                    error = string("unknown priority '") + priorityName + "'";
+                    break;
+                }
+            }
+        } else if (operation != TRACE_ADVANCE && requestID == -1) {
+            error = "request key " + to_string(key) + " was never created";
+            break;
+        }
+
+        bool succeeded = true;
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        switch (operation) {
+            case TRACE_CREATE:
+                requestID = system->createParkingRequest(vehicleID, zoneID, time, priority);
+                break;
+            case TRACE_ALLOCATE:
+                succeeded = system->allocateParking(requestID);
+                break;
+            case TRACE_OCCUPY:
+                succeeded = system->occupyParking(requestID);
+                break;
+            case TRACE_RELEASE:
+                succeeded = system->releaseParking(requestID, time);
+                break;
+            case TRACE_CANCEL:
+                succeeded = system->cancelRequest(requestID);
+                break;
+            case TRACE_ADVANCE:
+                system->advanceTime(time);
+                break;
+            default:
+                break;
+        }
+        chrono::steady_clock::time_point end = chrono::steady_clock::now();
+
+        latencies[operation].record(chrono::duration_cast<chrono::nanoseconds>(end - start).count());
+        if (operation == TRACE_CREATE) {
+            mapKey(key, requestID);
+        }
+        if (!succeeded) {
+            failures[operation]++;
+        }
+        eventCount++;
+    }
+
+    wallSeconds = chrono::duration<double>(chrono::steady_clock::now() - replayStart).count();
+    fclose(in);
+
+    if (!error.empty()) {
+        errorOut = "line " + to_string(lineNumber) + ": " + error;
+        return false;
+    }
+    return true;
+}
+
+long long TraceReplayer::getEventCount() const {
+    return eventCount;
+}
+
+long long TraceReplayer::getFailureCount(TraceOperation operation) const {
+    return failures[operation];
+}
+
+const LatencyHistogram& TraceReplayer::getLatency(TraceOperation operation) const {
+    return latencies[operation];
+}
+
+double TraceReplayer::getWallSeconds() const {
+    return wallSeconds;
+}
+
+void TraceReplayer::printReport() const {
+    double throughput = (wallSeconds > 0.0) ? eventCount / wallSeconds : 0.0;
+    cout << "Events: " << eventCount << " in " << wallSeconds << " s ("
+         << (long long)throughput << " events/s including parsing)" << endl;
+
+    char row[160];
+    snprintf(row, sizeof(row), "%-10s %10s %8s %10s %10s %10s %10s %10s",
+             "operation", "count", "failed", "mean ns", "p50 ns", "p99 ns", "p99.9 ns", "max ns");
+    cout << row << endl;
+
+    LatencyHistogram overall;
+    for (int i = 0; i < TRACE_OPERATION_COUNT; i++) {
+        const LatencyHistogram& h = latencies[i];
+        overall.merge(h);
+        if (h.getCount() == 0) {
+            continue;
+        }
+        snprintf(row, sizeof(row), "%-10s %10lld %8lld %10.0f %10lld %10lld %10lld %10lld",
+                 getOperationName((TraceOperation)i), h.getCount(), failures[i], h.getMean(),
+                 h.getPercentile(50), h.getPercentile(99), h.getPercentile(99.9), h.getMax());
+        cout << row << endl;
+    }
+    snprintf(row, sizeof(row), "%-10s %10lld %8s %10.0f %10lld %10lld %10lld %10lld",
+             "all", overall.getCount(), "", overall.getMean(),
+             overall.getPercentile(50), overall.getPercentile(99), overall.getPercentile(99.9), overall.getMax());
+    cout << row << endl;
+}
+
+const char* TraceReplayer::getOperationName(TraceOperation operation) {
+    switch (operation) {
+        case TRACE_CREATE: return "create";
+        case TRACE_ALLOCATE: return "allocate";
+        case TRACE_OCCUPY: return "occupy";
+        case TRACE_RELEASE: return "release";
+        case TRACE_CANCEL: return "cancel";
+        case TRACE_ADVANCE: return "advance";
+        default: return "unknown";
+    }
+}
+
+bool TraceReplayer::writeGolden(const ParkingAnalytics& analytics, const string& path) {
+    FILE* out = fopen(path.c_str(), "w");
+    if (out == nullptr) {
+        return false;
+    }
+    double values[GOLDEN_FIELDS];
+    goldenValues(analytics, values);
+    for (int i = 0; i < GOLDEN_FIELDS; i++) {
+        fprintf(out, "%s %.6f\n", GOLDEN_NAMES[i], values[i]);
+    }
+    return fclose(out) == 0;
+}
+
+// Values are compared to 1e-6 relative, the precision they are written with
+bool TraceReplayer::compareGolden(const ParkingAnalytics& analytics, const string& path, string& differencesOut) {
+    FILE* in = fopen(path.c_str(), "r");
+    if (in == nullptr) {
+        differencesOut = "cannot open " + path;
+        return false;
+    }
+
+    double actual[GOLDEN_FIELDS];
+    goldenValues(analytics, actual);
+    bool seen[GOLDEN_FIELDS] = { false, false, false, false, false, false };
+    differencesOut = "";
+
+    char line[MAX_LINE_LENGTH];
+    while (fgets(line, MAX_LINE_LENGTH, in) != nullptr) {
+        char* cursor = line;
+        char* name = nextToken(cursor);
+        char* value = nextToken(cursor);
+        if (name == nullptr || value == nullptr) {
+            continue;
+        }
+        for (int i = 0; i < GOLDEN_FIELDS; i++) {
+            if (strcmp(name, GOLDEN_NAMES[i]) != 0) {
+                continue;
+            }
+            seen[i] = true;
+            double expected = atof(value);
+            double tolerance = 1e-6 * (fabs(expected) > 1.0 ? fabs(expected) : 1.0);
+            if (fabs(expected - actual[i]) > tolerance) {
+                char message[160];
+                snprintf(message, sizeof(message), "%s: expected %.6f, got %.6f\n", GOLDEN_NAMES[i], expected, actual[i]);
+                differencesOut += message;
+            }
+        }
+    }
+    fclose(in);
+
+    for (int i = 0; i < GOLDEN_FIELDS; i++) {
+        if (!seen[i]) {
+            differencesOut += string(GOLDEN_NAMES[i]) + ": missing from golden file\n";
+        }
+    }
+    return differencesOut.empty();
+}
\ No newline at end of file
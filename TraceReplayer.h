@@ -0,0 +1,65 @@
+#ifndef TRACEREPLAYER_H
+#define TRACEREPLAYER_H
+
+#include "ParkingSystem.h"
+#include "LatencyHistogram.h"
+#include <string>
+using namespace std;
+
+enum TraceOperation {
+    TRACE_CREATE,
+    TRACE_ALLOCATE,
+    TRACE_OCCUPY,
+    TRACE_RELEASE,
+    TRACE_CANCEL,
+    TRACE_ADVANCE,
+    TRACE_OPERATION_COUNT
+};
+
+// Streams a trace of timestamped events through a ParkingSystem as fast
+// as possible, timing every call. One event per line, '#' starts a comment:
+//
+//   <time> create <key> <vehicleID> <zoneID> [standard|permit|accessible]
+//   <time> allocate <key>
+//   <time> occupy <key>
+//   <time> release <key>          (release time = event time)
+//   <time> cancel <key>
+//   <time> advance                (fires timers due by <time>)
+//
+// <key> is the trace's own request number; it is mapped to the request ID
+// the system hands out on create, so traces do not depend on ID order.
+class TraceReplayer {
+private:
+    ParkingSystem* system;
+    int* requestByKey;
+    int keyCapacity;
+
+    LatencyHistogram latencies[TRACE_OPERATION_COUNT];
+    long long failures[TRACE_OPERATION_COUNT];
+    long long eventCount;
+    double wallSeconds;
+
+    void mapKey(int key, int requestID);
+    int lookupKey(int key) const;
+
+public:
+    TraceReplayer(ParkingSystem* system);
+    ~TraceReplayer();
+
+    // Stops at the first malformed line, reporting it in errorOut
+    bool replay(const string& path, string& errorOut);
+
+    long long getEventCount() const;
+    long long getFailureCount(TraceOperation operation) const;
+    const LatencyHistogram& getLatency(TraceOperation operation) const;
+    double getWallSeconds() const;
+    void printReport() const;
+
+    static const char* getOperationName(TraceOperation operation);
+
+    // Golden files hold the final analytics as "<name> <value>" lines
+    static bool writeGolden(const ParkingAnalytics& analytics, const string& path);
+    static bool compareGolden(const ParkingAnalytics& analytics, const string& path, string& differencesOut);
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,150 @@
+#include "UndoLog.h"
+
+UndoLog::UndoLog(int capacity) {
+    this->capacity = (capacity > 0) ? capacity : 1;
+    records = new UndoRecord[this->capacity];
+    start = 0;
+    undoCount = 0;
+    redoCount = 0;
+    firstSequence = 0;
+    pinnedGroup = -1;
+}
+
+UndoLog::~UndoLog() {
+    delete[] records;
+}
+
+UndoRecord& UndoLog::at(int offset) const {
+    return records[(start + offset) % capacity];
+}
+
+void UndoLog::grow(int newCapacity) {
+    UndoRecord* newRecords = new UndoRecord[newCapacity];
+    for (int i = 0; i < undoCount + redoCount; i++) {
+        newRecords[i] = at(i);
+    }
+    delete[] records;
+    records = newRecords;
+    capacity = newCapacity;
+    start = 0;
+}
+
+void UndoLog::record(const UndoRecord& record) {
+    redoCount = 0;
+    if (undoCount == capacity && at(0).group == pinnedGroup) {
+        grow(capacity * 2);
+    }
+    if (undoCount == capacity) {
+        int evicted = at(0).group;
+        while (undoCount > 0 && at(0).group == evicted) {
+            start = (start + 1) % capacity;
+            undoCount--;
+            firstSequence++;
+        }
+    }
+    at(undoCount) = record;
+    undoCount++;
+}
+
+bool UndoLog::peekUndo(UndoRecord& out) const {
+    if (undoCount == 0) {
+        return false;
+    }
+    out = at(undoCount - 1);
+    return true;
+}
+
+bool UndoLog::peekRedo(UndoRecord& out) const {
+    if (redoCount == 0) {
+        return false;
+    }
+    out = at(undoCount);
+    return true;
+}
+
+void UndoLog::commitUndo() {
+    if (undoCount > 0) {
+        undoCount--;
+        redoCount++;
+    }
+}
+
+void UndoLog::commitRedo() {
+    if (redoCount > 0) {
+        undoCount++;
+        redoCount--;
+    }
+}
+
+void UndoLog::discardRedo() {
+    redoCount = 0;
+}
+
+long long UndoLog::getPosition() const {
+    return firstSequence + undoCount;
+}
+
+void UndoLog::setPinnedGroup(int group) {
+    pinnedGroup = group;
+}
+
+int UndoLog::getUndoCount() const {
+    return undoCount;
+}
+
+int UndoLog::getRedoCount() const {
+    return redoCount;
+}
+
+void UndoLog::clear() {
+    start = 0;
+    undoCount = 0;
+    redoCount = 0;
+    firstSequence = 0;
+}
+
+void UndoLog::writeSnapshot(SnapshotWriter& out) const {
+    out.writeI32(undoCount);
+    out.writeI32(redoCount);
+    for (int i = 0; i < undoCount + redoCount; i++) {
+        const UndoRecord& record = at(i);
+        out.writeI32(record.group);
+        out.writeU8((unsigned char)record.event);
+        out.writeU8((unsigned char)record.fromState);
+        out.writeI32(record.requestID);
+        out.writeI32(record.slotID);
+        out.writeI32(record.zoneID);
+        out.writeI32(record.time);
+        out.writeI32(record.charge);
+        out.writeBool(record.crossZone);
+        out.writeBool(record.wasWaitlisted);
+    }
+}
+
+bool UndoLog::readSnapshot(SnapshotReader& in) {
+    clear();
+    int undone = in.readI32();
+    int redone = in.readI32();
+    if (in.hasFailed() || undone < 0 || redone < 0) {
+        return false;
+    }
+    if (undone + redone > capacity) {
+        grow(undone + redone);
+    }
+    for (int i = 0; i < undone + redone && !in.hasFailed(); i++) {
+        UndoRecord& record = records[i];
+        record.group = in.readI32();
+        record.event = in.readU8();
+        record.fromState = (RequestState)in.readU8();
+        record.requestID = in.readI32();
+        record.slotID = in.readI32();
+        record.zoneID = in.readI32();
+        record.time = in.readI32();
+        record.charge = in.readI32();
+        record.crossZone = in.readBool();
+        record.wasWaitlisted = in.readBool();
+    }
+    undoCount = undone;
+    redoCount = redone;
+    return !in.hasFailed();
+}
\ No newline at end of file
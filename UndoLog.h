@@ -0,0 +1,103 @@
+#ifndef UNDOLOG_H
+#define UNDOLOG_H
+
+#include "ParkingRequest.h"
+#include "Snapshot.h"
+
+// Recorded alongside the RequestEvents: a rollbackLastAllocation, and a
+// failed allocation joining the waitlist
+const int UNDO_ROLLBACK = REQUEST_EVENT_COUNT;
+const int UNDO_WAITLIST = REQUEST_EVENT_COUNT + 1;
+
+// One request transition, with what it takes to invert it. `time` is the
+// time the stay was started or ended at in the occupancy timeline.
+struct UndoRecord {
+    int group;
+    int event;                // RequestEvent or UNDO_ROLLBACK / UNDO_WAITLIST
+    RequestState fromState;
+    int requestID;
+    int slotID;
+    int zoneID;
+    int time;
+    int charge;
+    bool crossZone;
+    bool wasWaitlisted;
+
+    UndoRecord() {
+        group = 0;
+        event = REQUEST_ALLOCATE;
+        fromState = REQUESTED;
+        requestID = -1;
+        slotID = -1;
+        zoneID = -1;
+        time = 0;
+        charge = 0;
+        crossZone = false;
+        wasWaitlisted = false;
+    }
+
+    UndoRecord(int event, RequestState fromState, int requestID, int slotID, int zoneID, int time) {
+        group = 0;
+        this->event = event;
+        this->fromState = fromState;
+        this->requestID = requestID;
+        this->slotID = slotID;
+        this->zoneID = zoneID;
+        this->time = time;
+        charge = 0;
+        crossZone = false;
+        wasWaitlisted = false;
+    }
+};
+
+// Ring buffer of the most recent transitions, in groups (one per public
+// operation, so a release and the waitlist allocation it triggered undo
+// together). Records below the cursor can be undone, those above it
+// redone; recording anything new discards the redo side. When full the
+// oldest group is dropped whole, so every record is O(1) amortized.
+// A pinned group (an open transaction) is never dropped; the buffer grows
+// instead.
+class UndoLog {
+private:
+    UndoRecord* records;
+    int capacity;
+    int start;
+    int undoCount;
+    int redoCount;
+    long long firstSequence;
+    int pinnedGroup;
+
+    UndoRecord& at(int offset) const;
+    void grow(int newCapacity);
+
+    UndoLog(const UndoLog&);
+    UndoLog& operator=(const UndoLog&);
+
+public:
+    UndoLog(int capacity);
+    ~UndoLog();
+
+    void record(const UndoRecord& record);
+
+    // Newest undoable record / oldest redoable one; false when none
+    bool peekUndo(UndoRecord& out) const;
+    bool peekRedo(UndoRecord& out) const;
+    // Moves one record across the cursor
+    void commitUndo();
+    void commitRedo();
+    void discardRedo();
+
+    // Sequence number the next record will get; counts every record ever
+    // kept, so it stays valid as old groups are dropped
+    long long getPosition() const;
+    void setPinnedGroup(int group);
+
+    int getUndoCount() const;
+    int getRedoCount() const;
+    void clear();
+
+    void writeSnapshot(SnapshotWriter& out) const;
+    bool readSnapshot(SnapshotReader& in);
+};
+
+#endif
\ No newline at end of file
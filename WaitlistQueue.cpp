@@ -0,0 +1,139 @@
+#include "WaitlistQueue.h"
+
+WaitlistQueue::WaitlistQueue() {
+    heap = nullptr;
+    size = 0;
+    capacity = 0;
+}
+
+WaitlistQueue::~WaitlistQueue() {
+    delete[] heap;
+}
+
+WaitlistQueue::WaitlistQueue(const WaitlistQueue& other) {
+    size = other.size;
+    capacity = other.capacity;
+    heap = (capacity > 0) ? new WaitlistEntry[capacity] : nullptr;
+    for (int i = 0; i < size; i++) {
+        heap[i] = other.heap[i];
+    }
+}
+
+WaitlistQueue& WaitlistQueue::operator=(const WaitlistQueue& other) {
+    if (this != &other) {
+        delete[] heap;
+        size = other.size;
+        capacity = other.capacity;
+        heap = (capacity > 0) ? new WaitlistEntry[capacity] : nullptr;
+        for (int i = 0; i < size; i++) {
+            heap[i] = other.heap[i];
+        }
+    }
+    return *this;
+}
+
+bool WaitlistQueue::servedBefore(const WaitlistEntry& a, const WaitlistEntry& b) {
+    if (a.priority != b.priority) {
+        return a.priority > b.priority;
+    }
+    if (a.requestTime != b.requestTime) {
+        return a.requestTime < b.requestTime;
+    }
+    return a.requestID < b.requestID;
+}
+
+void WaitlistQueue::grow() {
+    int newCapacity = (capacity == 0) ? 8 : capacity * 2;
+    WaitlistEntry* newHeap = new WaitlistEntry[newCapacity];
+    for (int i = 0; i < size; i++) {
+        newHeap[i] = heap[i];
+    }
+    delete[] heap;
+    heap = newHeap;
+    capacity = newCapacity;
+}
+
+void WaitlistQueue::siftUp(int i) {
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (!servedBefore(heap[i], heap[parent])) {
+            break;
+        }
+        WaitlistEntry temp = heap[i];
+        heap[i] = heap[parent];
+        heap[parent] = temp;
+        i = parent;
+    }
+}
+
+void WaitlistQueue::siftDown(int i) {
+    while (true) {
+        int best = i;
+        int left = 2 * i + 1;
+        int right = 2 * i + 2;
+        if (left < size && servedBefore(heap[left], heap[best])) {
+            best = left;
+        }
+        if (right < size && servedBefore(heap[right], heap[best])) {
+            best = right;
+        }
+        if (best == i) {
+            return;
+        }
+        WaitlistEntry temp = heap[i];
+        heap[i] = heap[best];
+        heap[best] = temp;
+        i = best;
+    }
+}
+
+void WaitlistQueue::push(const WaitlistEntry& entry) {
+    if (size >= capacity) {
+        grow();
+    }
+    heap[size++] = entry;
+    siftUp(size - 1);
+}
+
+bool WaitlistQueue::pop(WaitlistEntry& entry) {
+    if (size == 0) {
+        return false;
+    }
+    entry = heap[0];
+    heap[0] = heap[--size];
+    siftDown(0);
+    return true;
+}
+
+bool WaitlistQueue::peek(WaitlistEntry& entry) const {
+    if (size == 0) {
+        return false;
+    }
+    entry = heap[0];
+    return true;
+}
+
+void WaitlistQueue::heapify() {
+    for (int i = size / 2 - 1; i >= 0; i--) {
+        siftDown(i);
+    }
+}
+
+void WaitlistQueue::retain(bool (*keep)(int requestID, void* context), void* context) {
+    int kept = 0;
+    for (int i = 0; i < size; i++) {
+        if (keep(heap[i].requestID, context)) {
+            heap[kept++] = heap[i];
+        }
+    }
+    size = kept;
+    heapify();
+}
+
+int WaitlistQueue::getSize() const {
+    return size;
+}
+
+bool WaitlistQueue::isEmpty() const {
+    return size == 0;
+}
\ No newline at end of file
@@ -0,0 +1,56 @@
+#ifndef WAITLISTQUEUE_H
+#define WAITLISTQUEUE_H
+
+#include "ParkingRequest.h"
+
+struct WaitlistEntry {
+    int requestID;
+    PriorityClass priority;
+    int requestTime;
+
+    WaitlistEntry() {
+        requestID = -1;
+        priority = PRIORITY_STANDARD;
+        requestTime = 0;
+    }
+
+    WaitlistEntry(int reqID, PriorityClass priorityClass, int time) {
+        requestID = reqID;
+        priority = priorityClass;
+        requestTime = time;
+    }
+};
+
+// Binary heap of waiting requests for one zone. Higher priority class is
+// served first, then the earliest request time, then the lower request ID.
+class WaitlistQueue {
+private:
+    WaitlistEntry* heap;
+    int size;
+    int capacity;
+
+    void grow();
+    void heapify();
+    void siftUp(int i);
+    void siftDown(int i);
+
+public:
+    WaitlistQueue();
+    ~WaitlistQueue();
+
+    WaitlistQueue(const WaitlistQueue& other);
+    WaitlistQueue& operator=(const WaitlistQueue& other);
+
+    static bool servedBefore(const WaitlistEntry& a, const WaitlistEntry& b);
+
+    void push(const WaitlistEntry& entry);
+    bool pop(WaitlistEntry& entry);
+    bool peek(WaitlistEntry& entry) const;
+    // Drops every entry keep() rejects and rebuilds the heap in O(n)
+    void retain(bool (*keep)(int requestID, void* context), void* context);
+
+    int getSize() const;
+    bool isEmpty() const;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,367 @@
+#include "WriteAheadLog.h"
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+static const unsigned char LOG_MAGIC[4] = { 'P', 'K', 'W', 'L' };
+static const unsigned int LOG_VERSION = 2;
+static const int LOG_HEADER_SIZE = 16;
+static const int RECORD_HEADER_SIZE = 6;
+static const int MAX_PAYLOAD_SIZE = 1 + 4 * 4 + 1 + 255;
+
+static unsigned int checksum(const unsigned char* data, int length) {
+    // FNV-1a
+    unsigned int hash = 2166136261u;
+    for (int i = 0; i < length; i++) {
+        hash ^= data[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static void putU32(unsigned char* out, unsigned int value) {
+    out[0] = (unsigned char)(value & 0xFF);
+    out[1] = (unsigned char)((value >> 8) & 0xFF);
+    out[2] = (unsigned char)((value >> 16) & 0xFF);
+    out[3] = (unsigned char)((value >> 24) & 0xFF);
+}
+
+static unsigned int getU32(const unsigned char* in) {
+    return (unsigned int)in[0] | ((unsigned int)in[1] << 8)
+         | ((unsigned int)in[2] << 16) | ((unsigned int)in[3] << 24);
+}
+
+static long long getI64(const unsigned char* in) {
+    return (long long)((unsigned long long)getU32(in) | ((unsigned long long)getU32(in + 4) << 32));
+}
+
+static void countRecord(const LogRecord&, void* context) {
+    (*(long long*)context)++;
+}
+
+static bool syncFile(FILE* file) {
+    if (fflush(file) != 0) {
+        return false;
+    }
+#ifdef _WIN32
+    return _commit(_fileno(file)) == 0;
+#else
+    return fsync(fileno(file)) == 0;
+#endif
+}
+
+WriteAheadLog::WriteAheadLog() {
+    file = nullptr;
+    path = "";
+    bufferCapacity = 4096;
+    buffer = new unsigned char[bufferCapacity];
+    bufferSize = 0;
+    pendingRecords = 0;
+    groupCommitSize = 1;
+    maxSyncDelayMs = DEFAULT_MAX_SYNC_DELAY_MS;
+    nextSequence = 0;
+    recordsWritten = 0;
+    syncCount = 0;
+}
+
+WriteAheadLog::~WriteAheadLog() {
+    close();
+    delete[] buffer;
+}
+
+bool WriteAheadLog::open(const string& path, int groupCommitSize, bool truncate, long long firstSequence) {
+    close();
+
+    this->path = path;
+    this->groupCommitSize = (groupCommitSize > 0) ? groupCommitSize : 1;
+    nextSequence = firstSequence;
+
+    // An existing log is appended to only if it has a complete header; a
+    // torn header holds no records and is rewritten, a foreign file refused.
+    // Appending continues the numbering after the records already there
+    bool writeHeader = truncate;
+    if (!truncate) {
+        FILE* existing = fopen(path.c_str(), "rb");
+        if (existing == nullptr) {
+            writeHeader = true;
+        } else {
+            unsigned char header[LOG_HEADER_SIZE];
+            int headerBytes = (int)fread(header, 1, LOG_HEADER_SIZE, existing);
+            fclose(existing);
+            if (headerBytes < LOG_HEADER_SIZE) {
+                writeHeader = true;
+            } else if (header[0] != LOG_MAGIC[0] || header[1] != LOG_MAGIC[1] || header[2] != LOG_MAGIC[2]
+                       || header[3] != LOG_MAGIC[3] || getU32(header + 4) != LOG_VERSION) {
+                return false;
+            } else {
+                long long existingRecords = 0;
+                replay(path, countRecord, &existingRecords);
+                nextSequence = getI64(header + 8) + existingRecords;
+            }
+        }
+    }
+
+    file = fopen(path.c_str(), writeHeader ? "wb" : "ab");
+    if (file == nullptr) {
+        return false;
+    }
+
+    if (writeHeader) {
+        unsigned char header[LOG_HEADER_SIZE];
+        for (int i = 0; i < 4; i++) {
+            header[i] = LOG_MAGIC[i];
+        }
+        putU32(header + 4, LOG_VERSION);
+        putU32(header + 8, (unsigned int)(nextSequence & 0xFFFFFFFF));
+        putU32(header + 12, (unsigned int)((unsigned long long)nextSequence >> 32));
+        if (fwrite(header, 1, LOG_HEADER_SIZE, file) != LOG_HEADER_SIZE || !syncFile(file)) {
+            close();
+            return false;
+        }
+    }
+    return true;
+}
+
+void WriteAheadLog::close() {
+    if (file != nullptr) {
+        writeBuffer(true);
+        fclose(file);
+        file = nullptr;
+    }
+    bufferSize = 0;
+    pendingRecords = 0;
+}
+
+bool WriteAheadLog::isOpen() const {
+    return file != nullptr;
+}
+
+void WriteAheadLog::ensureBuffer(int extra) {
+    if (bufferSize + extra <= bufferCapacity) {
+        return;
+    }
+    int newCapacity = bufferCapacity * 2;
+    while (newCapacity < bufferSize + extra) {
+        newCapacity *= 2;
+    }
+    unsigned char* newBuffer = new unsigned char[newCapacity];
+    for (int i = 0; i < bufferSize; i++) {
+        newBuffer[i] = buffer[i];
+    }
+    delete[] buffer;
+    buffer = newBuffer;
+    bufferCapacity = newCapacity;
+}
+
+bool WriteAheadLog::writeBuffer(bool forceSync) {
+    if (file == nullptr) {
+        return false;
+    }
+    if (bufferSize > 0) {
+        if ((int)fwrite(buffer, 1, bufferSize, file) != bufferSize) {
+            return false;
+        }
+        bufferSize = 0;
+    }
+    if (pendingRecords > 0 || forceSync) {
+        if (!syncFile(file)) {
+            return false;
+        }
+        syncCount++;
+        pendingRecords = 0;
+    }
+    return true;
+}
+
+bool WriteAheadLog::append(const LogRecord& record) {
+    if (file == nullptr) {
+        return false;
+    }
+
+    int idLength = (int)record.vehicleID.length();
+    if (idLength > 255) {
+        idLength = 255;
+    }
+    int payloadLength = 1 + 4 * 4 + 1 + idLength;
+    ensureBuffer(RECORD_HEADER_SIZE + payloadLength);
+
+    unsigned char* header = buffer + bufferSize;
+    unsigned char* payload = header + RECORD_HEADER_SIZE;
+    payload[0] = (unsigned char)record.type;
+    for (int i = 0; i < 4; i++) {
+        putU32(payload + 1 + 4 * i, (unsigned int)record.fields[i]);
+    }
+    payload[17] = (unsigned char)idLength;
+    for (int i = 0; i < idLength; i++) {
+        payload[18 + i] = (unsigned char)record.vehicleID[i];
+    }
+
+    header[0] = (unsigned char)(payloadLength & 0xFF);
+    header[1] = (unsigned char)((payloadLength >> 8) & 0xFF);
+    putU32(header + 2, checksum(payload, payloadLength));
+
+    bufferSize += RECORD_HEADER_SIZE + payloadLength;
+    if (pendingRecords == 0) {
+        oldestPending = chrono::steady_clock::now();
+    }
+    pendingRecords++;
+    nextSequence++;
+    recordsWritten++;
+
+    if (pendingRecords >= groupCommitSize) {
+        return writeBuffer(true);
+    }
+    return syncIfDue();
+}
+
+bool WriteAheadLog::sync() {
+    return writeBuffer(true);
+}
+
+bool WriteAheadLog::syncIfDue() {
+    if (file == nullptr || pendingRecords == 0) {
+        return true;
+    }
+    long long waited = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - oldestPending).count();
+    return (waited >= maxSyncDelayMs) ? writeBuffer(true) : true;
+}
+
+void WriteAheadLog::setMaxSyncDelay(int milliseconds) {
+    maxSyncDelayMs = (milliseconds > 0) ? milliseconds : 0;
+}
+
+// Drops every record (used once a snapshot has captured the state); the
+// numbering carries on from where it was
+bool WriteAheadLog::truncate() {
+    if (file == nullptr) {
+        return false;
+    }
+    return open(path, groupCommitSize, true, nextSequence);
+}
+
+long long WriteAheadLog::getNextSequence() const {
+    return nextSequence;
+}
+
+long long WriteAheadLog::getRecordsWritten() const {
+    return recordsWritten;
+}
+
+long long WriteAheadLog::getSyncCount() const {
+    return syncCount;
+}
+
+const string& WriteAheadLog::getPath() const {
+    return path;
+}
+
+long long WriteAheadLog::replay(const string& path, void (*apply)(const LogRecord&, void*), void* context,
+                                long long* validBytesOut, long long skipBefore) {
+    long long validBytes = 0;
+    if (validBytesOut != nullptr) {
+        *validBytesOut = 0;
+    }
+    FILE* in = fopen(path.c_str(), "rb");
+    if (in == nullptr) {
+        return -1;
+    }
+
+    unsigned char header[LOG_HEADER_SIZE];
+    if (fread(header, 1, LOG_HEADER_SIZE, in) != LOG_HEADER_SIZE) {
+        fclose(in);
+        return 0;
+    }
+    if (header[0] != LOG_MAGIC[0] || header[1] != LOG_MAGIC[1] || header[2] != LOG_MAGIC[2]
+        || header[3] != LOG_MAGIC[3] || getU32(header + 4) != LOG_VERSION) {
+        if (validBytesOut != nullptr) {
+            *validBytesOut = -1;
+        }
+        fclose(in);
+        return 0;
+    }
+    validBytes = LOG_HEADER_SIZE;
+    long long sequence = getI64(header + 8);
+
+    // Streamed through a fixed window so the log never has to fit in memory
+    const int windowSize = 1 << 16;
+    unsigned char* window = new unsigned char[windowSize];
+    int windowStart = 0;
+    int windowEnd = 0;
+    long long applied = 0;
+    LogRecord record;
+
+    while (true) {
+        if (windowEnd - windowStart < RECORD_HEADER_SIZE + MAX_PAYLOAD_SIZE) {
+            int remaining = windowEnd - windowStart;
+            for (int i = 0; i < remaining; i++) {
+                window[i] = window[windowStart + i];
+            }
+            windowStart = 0;
+            windowEnd = remaining + (int)fread(window + remaining, 1, windowSize - remaining, in);
+        }
+
+        int available = windowEnd - windowStart;
+        if (available < RECORD_HEADER_SIZE) {
+            break;
+        }
+
+        unsigned char* recordStart = window + windowStart;
+        int payloadLength = recordStart[0] | (recordStart[1] << 8);
+        if (payloadLength < 18 || payloadLength > MAX_PAYLOAD_SIZE
+            || available < RECORD_HEADER_SIZE + payloadLength) {
+            break;
+        }
+
+        unsigned char* payload = recordStart + RECORD_HEADER_SIZE;
+        int idLength = payload[17];
+        if (18 + idLength != payloadLength || checksum(payload, payloadLength) != getU32(recordStart + 2)) {
+            break;
+        }
+
+        record.type = (LogRecordType)payload[0];
+        for (int i = 0; i < 4; i++) {
+            record.fields[i] = (int)getU32(payload + 1 + 4 * i);
+        }
+        record.vehicleID.assign((const char*)(payload + 18), idLength);
+
+        if (sequence >= skipBefore) {
+            apply(record, context);
+            applied++;
+        }
+        sequence++;
+        windowStart += RECORD_HEADER_SIZE + payloadLength;
+        validBytes += RECORD_HEADER_SIZE + payloadLength;
+    }
+
+    delete[] window;
+    fclose(in);
+    if (validBytesOut != nullptr) {
+        *validBytesOut = validBytes;
+    }
+    return applied;
+}
+
+bool WriteAheadLog::truncateTail(const string& path, long long validBytes) {
+    if (validBytes < 0) {
+        return false;
+    }
+    FILE* file = fopen(path.c_str(), "r+b");
+    if (file == nullptr) {
+        return false;
+    }
+    fseek(file, 0, SEEK_END);
+    bool done = true;
+    if (ftell(file) > validBytes) {
+#ifdef _WIN32
+        done = _chsize_s(_fileno(file), validBytes) == 0;
+#else
+        done = ftruncate(fileno(file), (off_t)validBytes) == 0;
+#endif
+        done = done && syncFile(file);
+    }
+    fclose(file);
+    return done;
+}
\ No newline at end of file
@@ -0,0 +1,136 @@
+#ifndef WRITEAHEADLOG_H
+#define WRITEAHEADLOG_H
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+using namespace std;
+
+enum LogRecordType {
+    LOG_SETUP_ZONE = 1,
+    LOG_SETUP_AREA,
+    LOG_ADJACENCY,
+    LOG_CREATE,
+    LOG_RESERVE,
+    LOG_ALLOCATE,
+    LOG_OCCUPY,
+    LOG_RELEASE,
+    LOG_CANCEL,
+    LOG_ROLLBACK,
+    LOG_ADVANCE_TIME,
+    LOG_SET_NO_SHOW,
+    LOG_SET_MAX_STAY,
+    LOG_CONFIGURE_TIMELINE,
+    LOG_SLOT_ATTRIBUTES,
+    LOG_SET_ZONE_RATE,
+    LOG_SET_SURCHARGE,
+    LOG_SET_TARIFF_BAND,
+    LOG_CONFIGURE_TARIFF,
+    LOG_SET_AREA_OPEN,
+    LOG_UNDO,
+    LOG_REDO,
+    LOG_BEGIN_TRANSACTION,
+    LOG_SAVEPOINT,
+    LOG_ROLLBACK_TO_SAVEPOINT,
+    LOG_COMMIT_TRANSACTION,
+    LOG_ABORT_TRANSACTION,
+    LOG_ADD_AREA,
+    LOG_REMOVE_AREA,
+    LOG_RESIZE_AREA,
+    LOG_REMOVE_ADJACENCY,
+    LOG_SET_SPILLOVER
+};
+
+// One logged operation. The meaning of the integer fields depends on the
+// type (e.g. CREATE: requestID, zone, time, priority); unused fields are 0.
+// SLOT_ATTRIBUTES packs its slot count and mask as (count << 8) | mask.
+struct LogRecord {
+    LogRecordType type;
+    int fields[4];
+    string vehicleID;
+
+    LogRecord() {
+        type = LOG_CREATE;
+        for (int i = 0; i < 4; i++) {
+            fields[i] = 0;
+        }
+        vehicleID = "";
+    }
+
+    LogRecord(LogRecordType recordType, int a, int b, int c, int d) {
+        type = recordType;
+        fields[0] = a;
+        fields[1] = b;
+        fields[2] = c;
+        fields[3] = d;
+        vehicleID = "";
+    }
+};
+
+// Binary append-only log of ParkingSystem operations.
+// Header: [magic "PKWL"][u32 version][i64 sequence number of the first
+// record]; records are numbered consecutively from there, across
+// truncations, so a snapshot can say which of them it already holds.
+// Record layout: [u16 payload length][u32 checksum][payload], where the
+// payload is [u8 type][4 x i32 fields][u8 id length][id bytes]. Records
+// are staged in memory and written + fsync'ed once per group of
+// groupCommitSize records, so the sync cost is shared by the whole group.
+// A group is also synced once its oldest record has waited maxSyncDelayMs;
+// that is checked on append and by syncIfDue(), which a caller that can
+// go idle must call periodically (ParkingApi does on its tick), so an
+// acknowledged record is durable after at most the delay plus one tick.
+// A torn or corrupt tail (crash mid-write) is detected by the checksum
+// and ends replay at the last complete record; truncateTail cuts it off
+// so records appended after recovery are not stranded behind it.
+class WriteAheadLog {
+private:
+    FILE* file;
+    string path;
+    unsigned char* buffer;
+    int bufferSize;
+    int bufferCapacity;
+    int pendingRecords;
+    int groupCommitSize;
+    int maxSyncDelayMs;
+    chrono::steady_clock::time_point oldestPending;
+    long long nextSequence;
+    long long recordsWritten;
+    long long syncCount;
+
+    void ensureBuffer(int extra);
+    bool writeBuffer(bool forceSync);
+
+public:
+    WriteAheadLog();
+    ~WriteAheadLog();
+
+    // A new header numbers the log from firstSequence
+    bool open(const string& path, int groupCommitSize, bool truncate, long long firstSequence = 0);
+    void close();
+    bool isOpen() const;
+
+    bool append(const LogRecord& record);
+    bool sync();
+    bool syncIfDue();
+    void setMaxSyncDelay(int milliseconds);
+    bool truncate();
+
+    long long getNextSequence() const;
+    long long getRecordsWritten() const;
+    long long getSyncCount() const;
+    const string& getPath() const;
+
+    static const int DEFAULT_MAX_SYNC_DELAY_MS = 10;
+
+    // Reads every complete record from `path`, calling `apply` for each
+    // numbered skipBefore or later; returns the number of records applied,
+    // or -1 if the file is missing.
+    // validBytesOut gets the offset just past the last complete record (0
+    // for a missing or torn header, -1 when the file is not a log at all)
+    static long long replay(const string& path, void (*apply)(const LogRecord&, void*), void* context,
+                            long long* validBytesOut = nullptr, long long skipBefore = 0);
+    // Shortens the file to validBytes if it is longer
+    static bool truncateTail(const string& path, long long validBytes);
+};
+
+#endif
\ No newline at end of file
@@ -1,83 +1,150 @@
 #include "Zone.h"
 
+static AreaTable* createAreaTable(int capacity) {
+    AreaTable* table = new AreaTable();
+    table->areas = (capacity > 0) ? new ParkingArea*[capacity] : nullptr;
+    table->open = (capacity > 0) ? new bool[capacity] : nullptr;
+    table->count = 0;
+    table->capacity = capacity;
+    table->withSpace.resize(capacity);
+    table->shareCount = 1;
+    return table;
+}
+
 Zone::Zone() {
     zoneID = -1;
-    areaCount = 0;
-    areas = nullptr;
+    table = createAreaTable(0);
+    availableSlots = 0;
     adjacentZones = nullptr;
+    adjacentWeights = nullptr;
     adjacentCount = 0;
     adjacentCapacity = 0;
 }
 
 Zone::Zone(int zoneID, int areaCount) {
     this->zoneID = zoneID;
-    this->areaCount = areaCount;
-    this->areas = new ParkingArea[areaCount];
+    table = createAreaTable(areaCount);
+    for (int i = 0; i < areaCount; i++) {
+        table->areas[i] = new ParkingArea();
+        table->open[i] = true;
+    }
+    table->count = areaCount;
+    availableSlots = 0;
     
     adjacentCapacity = 5;
     adjacentZones = new int[adjacentCapacity];
+    adjacentWeights = new int[adjacentCapacity];
     adjacentCount = 0;
 }
 
 Zone::~Zone() {
-    delete[] areas;
+    releaseTable();
     delete[] adjacentZones;
+    delete[] adjacentWeights;
 }
 
 Zone::Zone(const Zone& other) {
     zoneID = other.zoneID;
-    areaCount = other.areaCount;
+    table = other.table;
+    table->shareCount++;
+    availableSlots = other.availableSlots;
+    copyAdjacency(other);
+}
+
+Zone& Zone::operator=(const Zone& other) {
+    if (this != &other) {
+        other.table->shareCount++;
+        releaseTable();
+        delete[] adjacentZones;
+        delete[] adjacentWeights;
+        
+        zoneID = other.zoneID;
+        table = other.table;
+        availableSlots = other.availableSlots;
+        copyAdjacency(other);
+    }
+    return *this;
+}
+
+void Zone::copyAdjacency(const Zone& other) {
     adjacentCount = other.adjacentCount;
     adjacentCapacity = other.adjacentCapacity;
-    
-    if (other.areas != nullptr) {
-        areas = new ParkingArea[areaCount];
-        for (int i = 0; i < areaCount; i++) {
-            areas[i] = other.areas[i];
-        }
-    } else {
-        areas = nullptr;
-    }
-    
     if (other.adjacentZones != nullptr) {
         adjacentZones = new int[adjacentCapacity];
+        adjacentWeights = new int[adjacentCapacity];
         for (int i = 0; i < adjacentCount; i++) {
             adjacentZones[i] = other.adjacentZones[i];
+            adjacentWeights[i] = other.adjacentWeights[i];
         }
     } else {
         adjacentZones = nullptr;
+        adjacentWeights = nullptr;
     }
 }
 
-Zone& Zone::operator=(const Zone& other) {
-    if (this != &other) {
-        delete[] areas;
-        delete[] adjacentZones;
-        
-        zoneID = other.zoneID;
-        areaCount = other.areaCount;
-        adjacentCount = other.adjacentCount;
-        adjacentCapacity = other.adjacentCapacity;
-        
-        if (other.areas != nullptr) {
-            areas = new ParkingArea[areaCount];
-            for (int i = 0; i < areaCount; i++) {
-                areas[i] = other.areas[i];
-            }
-        } else {
-            areas = nullptr;
-        }
-        
-        if (other.adjacentZones != nullptr) {
-            adjacentZones = new int[adjacentCapacity];
-            for (int i = 0; i < adjacentCount; i++) {
-                adjacentZones[i] = other.adjacentZones[i];
-            }
-        } else {
-            adjacentZones = nullptr;
+void Zone::releaseTable() {
+    if (--table->shareCount > 0) {
+        return;
+    }
+    for (int i = 0; i < table->count; i++) {
+        releaseArea(table->areas[i]);
+    }
+    delete[] table->areas;
+    delete[] table->open;
+    delete table;
+}
+
+void Zone::releaseArea(ParkingArea* area) {
+    if (area->unshare()) {
+        delete area;
+    }
+}
+
+// Copy-on-write of the table: a zone still sharing it with a copy takes
+// its own before changing anything. The new table points at the same
+// areas, so this is O(areas) once, not a copy of every slot
+AreaTable* Zone::ownTable() {
+    if (table->shareCount > 1) {
+        AreaTable* copy = createAreaTable(table->capacity);
+        for (int i = 0; i < table->count; i++) {
+            copy->areas[i] = table->areas[i];
+            copy->areas[i]->share();
+            copy->open[i] = table->open[i];
         }
+        copy->count = table->count;
+        copy->withSpace = table->withSpace;
+        table->shareCount--;
+        table = copy;
     }
-    return *this;
+    return table;
+}
+
+// Copy-on-write: an area still shared with another zone is copied before
+// this zone changes it, so the other zone never sees the change
+ParkingArea* Zone::ownArea(int areaIndex) {
+    ParkingArea* area = ownTable()->areas[areaIndex];
+    if (area->isShared()) {
+        table->areas[areaIndex] = new ParkingArea(*area);
+        releaseArea(area);
+    }
+    return table->areas[areaIndex];
+}
+
+// The table must already be owned
+void Zone::growAreas() {
+    int capacity = (table->capacity > 0) ? table->capacity * 2 : 4;
+    ParkingArea** newAreas = new ParkingArea*[capacity];
+    bool* newOpen = new bool[capacity];
+    for (int i = 0; i < table->count; i++) {
+        newAreas[i] = table->areas[i];
+        newOpen[i] = table->open[i];
+    }
+    delete[] table->areas;
+    delete[] table->open;
+    table->areas = newAreas;
+    table->open = newOpen;
+    table->capacity = capacity;
+    table->withSpace.resizeKeeping(capacity);
 }
 
 int Zone::getZoneID() const {
@@ -85,49 +152,220 @@ int Zone::getZoneID() const {
 }
 
 int Zone::getAreaCount() const {
-    return areaCount;
+    return table->count;
 }
 
 void Zone::initializeArea(int areaIndex, int areaID, int slotCapacity) {
-    if (areaIndex >= 0 && areaIndex < areaCount) {
-        areas[areaIndex] = ParkingArea(areaID, zoneID, slotCapacity);
+    if (areaIndex >= 0 && areaIndex < table->count) {
+        availableSlots -= table->areas[areaIndex]->getAvailableCount();
+        ownArea(areaIndex)->configure(areaID, zoneID, slotCapacity);
+        availableSlots += table->areas[areaIndex]->getAvailableCount();
+        refreshArea(areaIndex);
     }
 }
 
+int Zone::addArea(int areaID, int slotCapacity) {
+    ownTable();
+    if (table->count == table->capacity) {
+        growAreas();
+    }
+    int areaIndex = table->count++;
+    table->areas[areaIndex] = new ParkingArea(areaID, zoneID, slotCapacity);
+    table->open[areaIndex] = true;
+    availableSlots += slotCapacity;
+    refreshArea(areaIndex);
+    return areaIndex;
+}
+
+// The last area takes the removed one's place, so only that one index
+// changes and only its summary bit is rewritten
+bool Zone::removeArea(int areaIndex) {
+    if (areaIndex < 0 || areaIndex >= table->count) {
+        return false;
+    }
+    const ParkingArea* area = table->areas[areaIndex];
+    if (area->getOccupiedCount() > 0 || area->hasBookingsFrom(0)) {
+        return false;
+    }
+    availableSlots -= area->getAvailableCount();
+    releaseArea(ownTable()->areas[areaIndex]);
+    int last = table->count - 1;
+    table->areas[areaIndex] = table->areas[last];
+    table->open[areaIndex] = table->open[last];
+    table->withSpace.clear(last);
+    table->count--;
+    if (areaIndex < table->count) {
+        refreshArea(areaIndex);
+    }
+    return true;
+}
+
+bool Zone::resizeArea(int areaIndex, int slotCapacity) {
+    if (areaIndex < 0 || areaIndex >= table->count) {
+        return false;
+    }
+    int before = table->areas[areaIndex]->getAvailableCount();
+    if (!ownArea(areaIndex)->resize(slotCapacity)) {
+        return false;
+    }
+    availableSlots += table->areas[areaIndex]->getAvailableCount() - before;
+    refreshArea(areaIndex);
+    return true;
+}
+
+void Zone::refreshArea(int areaIndex) {
+    ownTable();
+    if (table->open[areaIndex] && table->areas[areaIndex]->getAvailableCount() > 0) {
+        table->withSpace.set(areaIndex);
+    } else {
+        table->withSpace.clear(areaIndex);
+    }
+}
+
+// Slot IDs encode their area, so this only compares against each area
+int Zone::findAreaIndex(int slotID) const {
+    for (int i = 0; i < table->count; i++) {
+        if (table->areas[i]->getSlotIndex(slotID) != -1) {
+            return i;
+        }
+    }
+    return -1;
+}
+
 ParkingArea* Zone::getArea(int index) {
-    if (index >= 0 && index < areaCount) {
-        return &areas[index];
+    if (index >= 0 && index < table->count) {
+        return ownArea(index);
+    }
+    return nullptr;
+}
+
+const ParkingArea* Zone::getArea(int index) const {
+    if (index >= 0 && index < table->count) {
+        return table->areas[index];
     }
     return nullptr;
 }
 
 ParkingSlot* Zone::findAvailableSlot() {
-    for (int i = 0; i < areaCount; i++) {
-        ParkingSlot* slot = areas[i].findAvailableSlot();
-        if (slot != nullptr) {
-            return slot;
+    int areaIndex = table->withSpace.findFirst();
+    return (areaIndex != -1) ? table->areas[areaIndex]->findAvailableSlot() : nullptr;
+}
+
+ParkingSlot* Zone::claimAvailableSlot(int stayStart, int stayEnd) {
+    // Usually the first area with space has an unbooked slot; the rest are
+    // only visited when its free slots are all booked
+    for (int areaIndex = table->withSpace.findFirst(); areaIndex != -1;
+         areaIndex = table->withSpace.findNext(areaIndex + 1)) {
+        int slotIndex = table->areas[areaIndex]->findSlotForStay(stayStart, stayEnd);
+        if (slotIndex == -1) {
+            continue;
         }
+        ParkingArea* area = ownArea(areaIndex);
+        area->occupySlot(slotIndex);
+        availableSlots--;
+        refreshArea(areaIndex);
+        return area->getSlot(slotIndex);
     }
     return nullptr;
 }
 
-int Zone::getTotalAvailableSlots() const {
-    int total = 0;
-    for (int i = 0; i < areaCount; i++) {
-        total += areas[i].getAvailableCount();
+bool Zone::occupySlot(int slotID) {
+    int areaIndex = findAreaIndex(slotID);
+    if (areaIndex == -1 || !ownArea(areaIndex)->occupySlot(table->areas[areaIndex]->getSlotIndex(slotID))) {
+        return false;
     }
-    return total;
+    availableSlots--;
+    refreshArea(areaIndex);
+    return true;
+}
+
+bool Zone::freeSlot(int slotID) {
+    int areaIndex = findAreaIndex(slotID);
+    if (areaIndex == -1 || !ownArea(areaIndex)->freeSlot(table->areas[areaIndex]->getSlotIndex(slotID))) {
+        return false;
+    }
+    availableSlots++;
+    refreshArea(areaIndex);
+    return true;
+}
+
+void Zone::loadAreaOccupancy(int areaIndex, const unsigned char* bitmap) {
+    if (areaIndex >= 0 && areaIndex < table->count) {
+        availableSlots -= table->areas[areaIndex]->getAvailableCount();
+        ownArea(areaIndex)->loadOccupancyBitmap(bitmap);
+        availableSlots += table->areas[areaIndex]->getAvailableCount();
+        refreshArea(areaIndex);
+    }
+}
+
+bool Zone::setAreaOpen(int areaIndex, bool open) {
+    if (areaIndex < 0 || areaIndex >= table->count) {
+        return false;
+    }
+    ownTable()->open[areaIndex] = open;
+    refreshArea(areaIndex);
+    return true;
+}
+
+bool Zone::isAreaOpen(int areaIndex) const {
+    return areaIndex >= 0 && areaIndex < table->count && table->open[areaIndex];
+}
+
+bool Zone::reserveSlotDuring(int startTime, int endTime, int requestID, int& slotIDOut) {
+    for (int i = 0; i < table->count; i++) {
+        if (!table->open[i]) {
+            continue;
+        }
+        int index = table->areas[i]->findSlotFreeDuring(startTime, endTime);
+        if (index != -1 && ownArea(i)->bookSlot(index, startTime, endTime, requestID)) {
+            slotIDOut = table->areas[i]->getSlot(index)->getSlotID();
+            return true;
+        }
+    }
+    return false;
+}
+
+bool Zone::cancelReservation(int slotID, int startTime, int requestID) {
+    for (int i = 0; i < table->count; i++) {
+        int index = table->areas[i]->getSlotIndex(slotID);
+        if (index != -1) {
+            return ownArea(i)->unbookSlot(index, startTime, requestID);
+        }
+    }
+    return false;
+}
+
+// Re-books a known slot, used when loading a snapshot
+bool Zone::restoreReservation(int slotID, int startTime, int endTime, int requestID) {
+    for (int i = 0; i < table->count; i++) {
+        int index = table->areas[i]->getSlotIndex(slotID);
+        if (index != -1) {
+            return ownArea(i)->bookSlot(index, startTime, endTime, requestID);
+        }
+    }
+    return false;
+}
+
+// Kept as slots change, closed areas included
+int Zone::getTotalAvailableSlots() const {
+    return availableSlots;
 }
 
 int Zone::getTotalCapacity() const {
     int total = 0;
-    for (int i = 0; i < areaCount; i++) {
-        total += areas[i].getCapacity();
+    for (int i = 0; i < table->count; i++) {
+        total += table->areas[i]->getCapacity();
     }
     return total;
 }
 
 void Zone::addAdjacentZone(int zoneID) {
+    addAdjacentZone(zoneID, 1);
+}
+
+// Inserted after any neighbour of equal weight, so unweighted adjacency
+// keeps the order in which it was declared
+void Zone::addAdjacentZone(int zoneID, int weight) {
     for (int i = 0; i < adjacentCount; i++) {
         if (adjacentZones[i] == zoneID) {
             return;
@@ -135,16 +373,42 @@ void Zone::addAdjacentZone(int zoneID) {
     }
     
     if (adjacentCount >= adjacentCapacity) {
-        adjacentCapacity *= 2;
-        int* newArray = new int[adjacentCapacity];
+        adjacentCapacity = (adjacentCapacity > 0) ? adjacentCapacity * 2 : 4;
+        int* newZones = new int[adjacentCapacity];
+        int* newWeights = new int[adjacentCapacity];
         for (int i = 0; i < adjacentCount; i++) {
-            newArray[i] = adjacentZones[i];
+            newZones[i] = adjacentZones[i];
+            newWeights[i] = adjacentWeights[i];
         }
         delete[] adjacentZones;
-        adjacentZones = newArray;
+        delete[] adjacentWeights;
+        adjacentZones = newZones;
+        adjacentWeights = newWeights;
     }
     
-    adjacentZones[adjacentCount++] = zoneID;
+    int position = adjacentCount;
+    while (position > 0 && adjacentWeights[position - 1] > weight) {
+        adjacentZones[position] = adjacentZones[position - 1];
+        adjacentWeights[position] = adjacentWeights[position - 1];
+        position--;
+    }
+    adjacentZones[position] = zoneID;
+    adjacentWeights[position] = weight;
+    adjacentCount++;
+}
+
+bool Zone::removeAdjacentZone(int zoneID) {
+    for (int i = 0; i < adjacentCount; i++) {
+        if (adjacentZones[i] == zoneID) {
+            for (int j = i; j < adjacentCount - 1; j++) {
+                adjacentZones[j] = adjacentZones[j + 1];
+                adjacentWeights[j] = adjacentWeights[j + 1];
+            }
+            adjacentCount--;
+            return true;
+        }
+    }
+    return false;
 }
 
 bool Zone::isAdjacentTo(int zoneID) const {
@@ -165,4 +429,11 @@ int Zone::getAdjacentZone(int index) const {
         return adjacentZones[index];
     }
     return -1;
+}
+
+int Zone::getAdjacentWeight(int index) const {
+    if (index >= 0 && index < adjacentCount) {
+        return adjacentWeights[index];
+    }
+    return -1;
 }
\ No newline at end of file
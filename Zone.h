@@ -3,15 +3,44 @@
 
 #include "ParkingArea.h"
 
+// A zone's areas. Areas are held by pointer so adding one never moves the
+// others. A copied zone shares the whole table with the original (one
+// count, so copying is O(1)) until either changes it; the one changing it
+// then takes its own table, whose areas stay shared one by one until each
+// is changed too (see Zone::ownTable and Zone::ownArea)
+struct AreaTable {
+    ParkingArea** areas;
+    bool* open;
+    int count;
+    int capacity;
+    // Bit set per area that is open and has a free slot, on top of each
+    // area's own free-slot bitmap, so finding a free slot is two
+    // find-first-set lookups however many areas are full or closed
+    SummaryBitmap withSpace;
+    int shareCount;
+};
+
 class Zone {
 private:
     int zoneID;
-    ParkingArea* areas;
-    int areaCount;
+    AreaTable* table;
+    int availableSlots;
     
+    // Neighbours kept sorted by ascending weight (walking distance), so
+    // cross-zone searches try the closest zone first
     int* adjacentZones;
+    int* adjacentWeights;
     int adjacentCount;
     int adjacentCapacity;
+    
+    void refreshArea(int areaIndex);
+    int findAreaIndex(int slotID) const;
+    void copyAdjacency(const Zone& other);
+    void releaseTable();
+    void releaseArea(ParkingArea* area);
+    AreaTable* ownTable();
+    ParkingArea* ownArea(int areaIndex);
+    void growAreas();
 
 public:
     Zone();
@@ -25,16 +54,48 @@ public:
     int getAreaCount() const;
     
     void initializeArea(int areaIndex, int areaID, int slotCapacity);
+    // Runtime reconfiguration. addArea returns the new index; the caller
+    // keeps area IDs unique. Removing moves the last area into the freed
+    // index. Removing or shrinking is refused while any slot that would go
+    // is occupied or booked
+    int addArea(int areaID, int slotCapacity);
+    bool removeArea(int areaIndex);
+    bool resizeArea(int areaIndex, int slotCapacity);
+    // Occupancy changes must go through the zone (not the area or slot)
+    // to keep the summary right. The non-const getArea takes the zone's
+    // own copy of a shared area, so read through the const one where
+    // possible
     ParkingArea* getArea(int index);
+    const ParkingArea* getArea(int index) const;
+    // For reading only; the slot may belong to an area shared with a copy
     ParkingSlot* findAvailableSlot();
+    // Finds and occupies, in one step, a free slot that no booking needs
+    // during [stayStart, stayEnd); pass INT_MAX as stayEnd for a stay of
+    // unknown length
+    ParkingSlot* claimAvailableSlot(int stayStart, int stayEnd);
+    bool occupySlot(int slotID);
+    bool freeSlot(int slotID);
+    void loadAreaOccupancy(int areaIndex, const unsigned char* bitmap);
+    
+    // A closed (draining) area keeps its parked vehicles but is skipped
+    // by allocation and reservations until reopened
+    bool setAreaOpen(int areaIndex, bool open);
+    bool isAreaOpen(int areaIndex) const;
+    
+    bool reserveSlotDuring(int startTime, int endTime, int requestID, int& slotIDOut);
+    bool cancelReservation(int slotID, int startTime, int requestID);
+    bool restoreReservation(int slotID, int startTime, int endTime, int requestID);
     
     int getTotalAvailableSlots() const;
     int getTotalCapacity() const;
     
     void addAdjacentZone(int zoneID);
+    void addAdjacentZone(int zoneID, int weight);
+    bool removeAdjacentZone(int zoneID);
     bool isAdjacentTo(int zoneID) const;
     int getAdjacentZoneCount() const;
     int getAdjacentZone(int index) const;
+    int getAdjacentWeight(int index) const;
 };
 
 #endif
\ No newline at end of file
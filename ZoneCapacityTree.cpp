@@ -0,0 +1,188 @@
+#include "ZoneCapacityTree.h"
+
+ZoneCapacityTree::ZoneCapacityTree(int maxZones) {
+    this->maxZones = (maxZones > 0) ? maxZones : 1;
+    zoneCount = 0;
+    sortedIDs = new int[this->maxZones];
+    zoneAtLeaf = new int[this->maxZones];
+    leafOfZone = new int[this->maxZones];
+    for (int i = 0; i < this->maxZones; i++) {
+        leafOfZone[i] = -1;
+    }
+
+    leafCount = 1;
+    while (leafCount < this->maxZones) {
+        leafCount *= 2;
+    }
+    sums = new long long[2 * leafCount];
+    maxValues = new int[2 * leafCount];
+    maxLeaves = new int[2 * leafCount];
+    // Unused leaves hold -1 so they never win an argmax
+    for (int leaf = 0; leaf < leafCount; leaf++) {
+        sums[leafCount + leaf] = 0;
+        maxValues[leafCount + leaf] = -1;
+        maxLeaves[leafCount + leaf] = leaf;
+    }
+    for (int node = leafCount - 1; node >= 1; node--) {
+        pull(node);
+    }
+}
+
+ZoneCapacityTree::~ZoneCapacityTree() {
+    delete[] sortedIDs;
+    delete[] zoneAtLeaf;
+    delete[] leafOfZone;
+    delete[] sums;
+    delete[] maxValues;
+    delete[] maxLeaves;
+}
+
+void ZoneCapacityTree::pull(int node) {
+    int left = 2 * node;
+    int right = left + 1;
+    sums[node] = sums[left] + sums[right];
+    bool leftWins = maxValues[left] >= maxValues[right];
+    maxValues[node] = leftWins ? maxValues[left] : maxValues[right];
+    maxLeaves[node] = leftWins ? maxLeaves[left] : maxLeaves[right];
+}
+
+void ZoneCapacityTree::rebuild() {
+    for (int node = leafCount - 1; node >= 1; node--) {
+        pull(node);
+    }
+}
+
+bool ZoneCapacityTree::addZone(int zoneID, int zoneIndex) {
+    if (zoneCount >= maxZones || zoneIndex < 0 || zoneIndex >= maxZones || leafOfZone[zoneIndex] != -1) {
+        return false;
+    }
+    int position = firstLeafAtLeast(zoneID);
+    if (position < zoneCount && sortedIDs[position] == zoneID) {
+        return false;
+    }
+
+    if (position == zoneCount) {
+        sortedIDs[position] = zoneID;
+        zoneAtLeaf[position] = zoneIndex;
+        leafOfZone[zoneIndex] = position;
+        zoneCount++;
+        update(zoneIndex, 0);
+        return true;
+    }
+
+    for (int leaf = zoneCount; leaf > position; leaf--) {
+        sortedIDs[leaf] = sortedIDs[leaf - 1];
+        zoneAtLeaf[leaf] = zoneAtLeaf[leaf - 1];
+        leafOfZone[zoneAtLeaf[leaf]] = leaf;
+        sums[leafCount + leaf] = sums[leafCount + leaf - 1];
+        maxValues[leafCount + leaf] = maxValues[leafCount + leaf - 1];
+    }
+    sortedIDs[position] = zoneID;
+    zoneAtLeaf[position] = zoneIndex;
+    leafOfZone[zoneIndex] = position;
+    sums[leafCount + position] = 0;
+    maxValues[leafCount + position] = 0;
+    zoneCount++;
+    rebuild();
+    return true;
+}
+
+void ZoneCapacityTree::update(int zoneIndex, int freeSlots) {
+    if (zoneIndex < 0 || zoneIndex >= maxZones || leafOfZone[zoneIndex] == -1) {
+        return;
+    }
+    int node = leafCount + leafOfZone[zoneIndex];
+    sums[node] = freeSlots;
+    maxValues[node] = freeSlots;
+    for (node /= 2; node >= 1; node /= 2) {
+        pull(node);
+    }
+}
+
+// Binary searches over the sorted IDs
+int ZoneCapacityTree::firstLeafAtLeast(int zoneID) const {
+    int low = 0;
+    int high = zoneCount;
+    while (low < high) {
+        int middle = (low + high) / 2;
+        if (sortedIDs[middle] < zoneID) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+int ZoneCapacityTree::firstLeafAbove(int zoneID) const {
+    int low = 0;
+    int high = zoneCount;
+    while (low < high) {
+        int middle = (low + high) / 2;
+        if (sortedIDs[middle] <= zoneID) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+long long ZoneCapacityTree::rangeSum(int fromZoneID, int toZoneID) const {
+    if (fromZoneID > toZoneID) {
+        return 0;
+    }
+    // Half-open [left, right) over leaves, walked bottom-up
+    int left = firstLeafAtLeast(fromZoneID) + leafCount;
+    int right = firstLeafAbove(toZoneID) + leafCount;
+    long long total = 0;
+    while (left < right) {
+        if (left & 1) {
+            total += sums[left++];
+        }
+        if (right & 1) {
+            total += sums[--right];
+        }
+        left /= 2;
+        right /= 2;
+    }
+    return total;
+}
+
+int ZoneCapacityTree::rangeArgMax(int fromZoneID, int toZoneID) const {
+    if (fromZoneID > toZoneID) {
+        return -1;
+    }
+    int left = firstLeafAtLeast(fromZoneID) + leafCount;
+    int right = firstLeafAbove(toZoneID) + leafCount;
+    int bestValue = 0;
+    int bestLeaf = -1;
+    // Nodes are met out of leaf order, so ties compare leaf positions
+    while (left < right) {
+        int nodes[2] = { -1, -1 };
+        if (left & 1) {
+            nodes[0] = left++;
+        }
+        if (right & 1) {
+            nodes[1] = --right;
+        }
+        for (int n = 0; n < 2; n++) {
+            int node = nodes[n];
+            if (node == -1) {
+                continue;
+            }
+            if (maxValues[node] > bestValue
+                || (maxValues[node] == bestValue && bestLeaf != -1 && maxLeaves[node] < bestLeaf)) {
+                bestValue = maxValues[node];
+                bestLeaf = maxLeaves[node];
+            }
+        }
+        left /= 2;
+        right /= 2;
+    }
+    return (bestLeaf != -1) ? zoneAtLeaf[bestLeaf] : -1;
+}
+
+int ZoneCapacityTree::getZoneCount() const {
+    return zoneCount;
+}
\ No newline at end of file
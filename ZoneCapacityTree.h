@@ -0,0 +1,47 @@
+#ifndef ZONECAPACITYTREE_H
+#define ZONECAPACITYTREE_H
+
+// Segment tree of free slots per zone, with the leaves in ascending zone
+// ID order so a range of IDs ("zones 100-180") is a contiguous range of
+// leaves. Every node holds the sum of its leaves and the leaf with the
+// most free slots (the lower zone ID on ties), so updates and range
+// queries are O(log z). Zones added in ascending ID order take O(log z);
+// an out-of-order ID shifts the leaves and rebuilds in O(z).
+class ZoneCapacityTree {
+private:
+    int maxZones;
+    int zoneCount;
+    int* sortedIDs;      // zone ID per leaf
+    int* zoneAtLeaf;     // zones array index per leaf
+    int* leafOfZone;     // leaf per zones array index, -1 if not added
+
+    int leafCount;       // power of two >= maxZones
+    long long* sums;
+    int* maxValues;
+    int* maxLeaves;
+
+    void pull(int node);
+    void rebuild();
+    int firstLeafAtLeast(int zoneID) const;
+    int firstLeafAbove(int zoneID) const;
+
+    ZoneCapacityTree(const ZoneCapacityTree&);
+    ZoneCapacityTree& operator=(const ZoneCapacityTree&);
+
+public:
+    ZoneCapacityTree(int maxZones);
+    ~ZoneCapacityTree();
+
+    // Adds a zone with no free slots; false when full or already added
+    bool addZone(int zoneID, int zoneIndex);
+    void update(int zoneIndex, int freeSlots);
+
+    // Over zones with fromZoneID <= ID <= toZoneID
+    long long rangeSum(int fromZoneID, int toZoneID) const;
+    // Zones array index with the most free slots, -1 if none has any
+    int rangeArgMax(int fromZoneID, int toZoneID) const;
+
+    int getZoneCount() const;
+};
+
+#endif
\ No newline at end of file
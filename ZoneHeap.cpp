@@ -0,0 +1,228 @@
+#include "ZoneHeap.h"
+
+ZoneHeap::ZoneHeap() {
+    heap = nullptr;
+    positions = nullptr;
+    keys = nullptr;
+    weights = nullptr;
+    size = 0;
+    capacity = 0;
+    isMaxHeap = true;
+}
+
+ZoneHeap::ZoneHeap(int capacity, bool isMaxHeap) {
+    this->capacity = capacity;
+    this->isMaxHeap = isMaxHeap;
+    size = 0;
+
+    heap = new int[capacity];
+    positions = new int[capacity];
+    keys = new int[capacity];
+    weights = new int[capacity];
+    for (int i = 0; i < capacity; i++) {
+        positions[i] = -1;
+        keys[i] = 0;
+        weights[i] = 1;
+    }
+}
+
+ZoneHeap::~ZoneHeap() {
+    delete[] heap;
+    delete[] positions;
+    delete[] keys;
+    delete[] weights;
+}
+
+ZoneHeap::ZoneHeap(const ZoneHeap& other) {
+    capacity = other.capacity;
+    isMaxHeap = other.isMaxHeap;
+    size = other.size;
+
+    heap = new int[capacity];
+    positions = new int[capacity];
+    keys = new int[capacity];
+    weights = new int[capacity];
+    for (int i = 0; i < capacity; i++) {
+        heap[i] = other.heap[i];
+        positions[i] = other.positions[i];
+        keys[i] = other.keys[i];
+        weights[i] = other.weights[i];
+    }
+}
+
+ZoneHeap& ZoneHeap::operator=(const ZoneHeap& other) {
+    if (this != &other) {
+        delete[] heap;
+        delete[] positions;
+        delete[] keys;
+        delete[] weights;
+
+        capacity = other.capacity;
+        isMaxHeap = other.isMaxHeap;
+        size = other.size;
+
+        heap = new int[capacity];
+        positions = new int[capacity];
+        keys = new int[capacity];
+        weights = new int[capacity];
+        for (int i = 0; i < capacity; i++) {
+            heap[i] = other.heap[i];
+            positions[i] = other.positions[i];
+            keys[i] = other.keys[i];
+            weights[i] = other.weights[i];
+        }
+    }
+    return *this;
+}
+
+bool ZoneHeap::comesBefore(int zoneA, int zoneB) const {
+    long long a = (long long)keys[zoneA] * weights[zoneB];
+    long long b = (long long)keys[zoneB] * weights[zoneA];
+    if (a != b) {
+        return isMaxHeap ? (a > b) : (a < b);
+    }
+    return zoneA < zoneB;
+}
+
+void ZoneHeap::swapNodes(int i, int j) {
+    int temp = heap[i];
+    heap[i] = heap[j];
+    heap[j] = temp;
+    positions[heap[i]] = i;
+    positions[heap[j]] = j;
+}
+
+void ZoneHeap::siftUp(int i) {
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (!comesBefore(heap[i], heap[parent])) {
+            break;
+        }
+        swapNodes(i, parent);
+        i = parent;
+    }
+}
+
+void ZoneHeap::siftDown(int i) {
+    while (true) {
+        int best = i;
+        int left = 2 * i + 1;
+        int right = 2 * i + 2;
+        if (left < size && comesBefore(heap[left], heap[best])) {
+            best = left;
+        }
+        if (right < size && comesBefore(heap[right], heap[best])) {
+            best = right;
+        }
+        if (best == i) {
+            return;
+        }
+        swapNodes(i, best);
+        i = best;
+    }
+}
+
+void ZoneHeap::insert(int zoneIndex, int key, int weight) {
+    if (zoneIndex < 0 || zoneIndex >= capacity || weight <= 0) {
+        return;
+    }
+    if (contains(zoneIndex)) {
+        update(zoneIndex, key, weight);
+        return;
+    }
+
+    keys[zoneIndex] = key;
+    weights[zoneIndex] = weight;
+    heap[size] = zoneIndex;
+    positions[zoneIndex] = size;
+    size++;
+    siftUp(size - 1);
+}
+
+void ZoneHeap::update(int zoneIndex, int key, int weight) {
+    if (!contains(zoneIndex) || weight <= 0) {
+        return;
+    }
+
+    keys[zoneIndex] = key;
+    weights[zoneIndex] = weight;
+    siftUp(positions[zoneIndex]);
+    siftDown(positions[zoneIndex]);
+}
+
+bool ZoneHeap::contains(int zoneIndex) const {
+    return zoneIndex >= 0 && zoneIndex < capacity && positions[zoneIndex] != -1;
+}
+
+int ZoneHeap::top() const {
+    if (size == 0) {
+        return -1;
+    }
+    return heap[0];
+}
+
+// Best-first walk of the heap: a small candidate heap holds the frontier
+// (children of everything already emitted), so only O(k) nodes are touched
+// and the cost is O(k log k) independent of the number of zones.
+int ZoneHeap::getTopK(int k, int* zoneIndexesOut) const {
+    if (k <= 0 || size == 0) {
+        return 0;
+    }
+
+    int* candidates = new int[k + 1];
+    int candidateCount = 0;
+    int found = 0;
+
+    candidates[candidateCount++] = 0;
+
+    while (found < k && candidateCount > 0) {
+        int position = candidates[0];
+        zoneIndexesOut[found++] = heap[position];
+
+        candidates[0] = candidates[--candidateCount];
+        int i = 0;
+        while (true) {
+            int best = i;
+            int left = 2 * i + 1;
+            int right = 2 * i + 2;
+            if (left < candidateCount && comesBefore(heap[candidates[left]], heap[candidates[best]])) {
+                best = left;
+            }
+            if (right < candidateCount && comesBefore(heap[candidates[right]], heap[candidates[best]])) {
+                best = right;
+            }
+            if (best == i) {
+                break;
+            }
+            int temp = candidates[i];
+            candidates[i] = candidates[best];
+            candidates[best] = temp;
+            i = best;
+        }
+
+        for (int child = 2 * position + 1; child <= 2 * position + 2; child++) {
+            if (child >= size || candidateCount > k) {
+                continue;
+            }
+            int j = candidateCount++;
+            candidates[j] = child;
+            while (j > 0) {
+                int parent = (j - 1) / 2;
+                if (!comesBefore(heap[candidates[j]], heap[candidates[parent]])) {
+                    break;
+                }
+                int temp = candidates[j];
+                candidates[j] = candidates[parent];
+                candidates[parent] = temp;
+                j = parent;
+            }
+        }
+    }
+
+    delete[] candidates;
+    return found;
+}
+
+int ZoneHeap::getSize() const {
+    return size;
+}
\ No newline at end of file
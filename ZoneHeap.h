@@ -0,0 +1,43 @@
+#ifndef ZONEHEAP_H
+#define ZONEHEAP_H
+
+// Indexed binary heap of zone indexes keyed by occupancy.
+// positions[] maps a zone index to its place in the heap so a key can be
+// changed in O(log z) when a slot in that zone is taken or freed.
+// A key may carry a positive weight, in which case zones are ordered by
+// key / weight (compared exactly by cross-multiplying), e.g. occupied
+// slots over capacity.
+// Ties are broken by the lower zone index to keep results deterministic.
+class ZoneHeap {
+private:
+    int* heap;
+    int* positions;
+    int* keys;
+    int* weights;
+    int size;
+    int capacity;
+    bool isMaxHeap;
+
+    bool comesBefore(int zoneA, int zoneB) const;
+    void swapNodes(int i, int j);
+    void siftUp(int i);
+    void siftDown(int i);
+
+public:
+    ZoneHeap();
+    ZoneHeap(int capacity, bool isMaxHeap);
+    ~ZoneHeap();
+
+    ZoneHeap(const ZoneHeap& other);
+    ZoneHeap& operator=(const ZoneHeap& other);
+
+    void insert(int zoneIndex, int key, int weight = 1);
+    void update(int zoneIndex, int key, int weight = 1);
+    bool contains(int zoneIndex) const;
+
+    int top() const;
+    int getTopK(int k, int* zoneIndexesOut) const;
+    int getSize() const;
+};
+
+#endif
\ No newline at end of file
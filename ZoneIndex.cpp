@@ -0,0 +1,188 @@
+#include "ZoneIndex.h"
+
+ZoneIndex::ZoneIndex() {
+    keys = nullptr;
+    values = nullptr;
+    capacity = 0;
+    size = 0;
+    shareCount = 1;
+}
+
+ZoneIndex::ZoneIndex(int maxZones) {
+    capacity = 2;
+    while (capacity < 2 * maxZones) {
+        capacity *= 2;
+    }
+    size = 0;
+    shareCount = 1;
+
+    keys = new int[capacity];
+    values = new int[capacity];
+    for (int i = 0; i < capacity; i++) {
+        keys[i] = 0;
+        values[i] = -1;
+    }
+}
+
+ZoneIndex::~ZoneIndex() {
+    delete[] keys;
+    delete[] values;
+}
+
+ZoneIndex::ZoneIndex(const ZoneIndex& other) {
+    capacity = other.capacity;
+    size = other.size;
+    shareCount = 1;
+    keys = nullptr;
+    values = nullptr;
+
+    if (capacity > 0) {
+        keys = new int[capacity];
+        values = new int[capacity];
+        for (int i = 0; i < capacity; i++) {
+            keys[i] = other.keys[i];
+            values[i] = other.values[i];
+        }
+    }
+}
+
+ZoneIndex& ZoneIndex::operator=(const ZoneIndex& other) {
+    if (this != &other) {
+        delete[] keys;
+        delete[] values;
+
+        capacity = other.capacity;
+        size = other.size;
+        keys = nullptr;
+        values = nullptr;
+
+        if (capacity > 0) {
+            keys = new int[capacity];
+            values = new int[capacity];
+            for (int i = 0; i < capacity; i++) {
+                keys[i] = other.keys[i];
+                values[i] = other.values[i];
+            }
+        }
+    }
+    return *this;
+}
+
+int ZoneIndex::probeStart(int zoneID) const {
+    // Multiplicative hash; capacity is a power of two
+    unsigned int hash = (unsigned int)zoneID * 2654435761u;
+    return (int)(hash & (unsigned int)(capacity - 1));
+}
+
+// An empty bucket is marked by a value of -1
+bool ZoneIndex::insert(int zoneID, int zoneIndex) {
+    if (capacity == 0 || zoneIndex < 0) {
+        return false;
+    }
+
+    int i = probeStart(zoneID);
+    while (values[i] != -1) {
+        if (keys[i] == zoneID) {
+            values[i] = zoneIndex;
+            return true;
+        }
+        i = (i + 1) & (capacity - 1);
+    }
+
+    if (2 * (size + 1) > capacity) {
+        grow();
+        return insert(zoneID, zoneIndex);
+    }
+    keys[i] = zoneID;
+    values[i] = zoneIndex;
+    size++;
+    return true;
+}
+
+// Later entries of the probe run are shifted back into the gap, so
+// lookups never need tombstones
+bool ZoneIndex::remove(int zoneID) {
+    if (capacity == 0) {
+        return false;
+    }
+
+    int i = probeStart(zoneID);
+    while (values[i] != -1 && keys[i] != zoneID) {
+        i = (i + 1) & (capacity - 1);
+    }
+    if (values[i] == -1) {
+        return false;
+    }
+    values[i] = -1;
+    size--;
+
+    int j = i;
+    while (true) {
+        j = (j + 1) & (capacity - 1);
+        if (values[j] == -1) {
+            return true;
+        }
+        // An entry may fill the gap only if its home bucket is not in (i, j]
+        int home = probeStart(keys[j]);
+        bool reachable = (i <= j) ? (i < home && home <= j) : (i < home || home <= j);
+        if (!reachable) {
+            keys[i] = keys[j];
+            values[i] = values[j];
+            values[j] = -1;
+            i = j;
+        }
+    }
+}
+
+void ZoneIndex::grow() {
+    int oldCapacity = capacity;
+    int* oldKeys = keys;
+    int* oldValues = values;
+
+    capacity = 2 * oldCapacity;
+    size = 0;
+    keys = new int[capacity];
+    values = new int[capacity];
+    for (int i = 0; i < capacity; i++) {
+        keys[i] = 0;
+        values[i] = -1;
+    }
+    for (int i = 0; i < oldCapacity; i++) {
+        if (oldValues[i] != -1) {
+            insert(oldKeys[i], oldValues[i]);
+        }
+    }
+    delete[] oldKeys;
+    delete[] oldValues;
+}
+
+int ZoneIndex::find(int zoneID) const {
+    if (capacity == 0) {
+        return -1;
+    }
+
+    int i = probeStart(zoneID);
+    while (values[i] != -1) {
+        if (keys[i] == zoneID) {
+            return values[i];
+        }
+        i = (i + 1) & (capacity - 1);
+    }
+    return -1;
+}
+
+int ZoneIndex::getSize() const {
+    return size;
+}
+
+void ZoneIndex::share() {
+    shareCount++;
+}
+
+bool ZoneIndex::unshare() {
+    return --shareCount == 0;
+}
+
+bool ZoneIndex::isShared() const {
+    return shareCount > 1;
+}
\ No newline at end of file
@@ -0,0 +1,41 @@
+#ifndef ZONEINDEX_H
+#define ZONEINDEX_H
+
+// Hash map from zone ID to the zone's position in the zones array (also
+// used from area ID to the zone holding it). Open addressing with linear
+// probing; the table is sized for the expected number of keys (at most
+// half full) and doubles only if more are inserted, so the zone table,
+// sized for the maximum number of zones, never rehashes.
+class ZoneIndex {
+private:
+    int* keys;
+    int* values;
+    int capacity;
+    int size;
+    // Holders sharing this index (see ParkingSystem::fork); a copy
+    // starts unshared
+    int shareCount;
+
+    int probeStart(int zoneID) const;
+    void grow();
+
+public:
+    ZoneIndex();
+    ZoneIndex(int maxZones);
+    ~ZoneIndex();
+
+    ZoneIndex(const ZoneIndex& other);
+    ZoneIndex& operator=(const ZoneIndex& other);
+
+    bool insert(int zoneID, int zoneIndex);
+    bool remove(int zoneID);
+    int find(int zoneID) const;
+    int getSize() const;
+
+    void share();
+    // True once nothing holds the index any more
+    bool unshare();
+    bool isShared() const;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,279 @@
+// Core data structure and allocation path microbenchmarks.
+//
+// Every benchmark runs against each facility size at each occupancy level.
+// Occupied slots are the first ones of every area, so a linear scan for a
+// free slot pays the full occupied prefix. Prints one CSV line per
+// measurement, suitable for diffing between versions:
+//   benchmark,zones,slots,occupancy,operations,ns_per_op
+//
+// Usage: core_benchmark [maxSlots]   (default 1000000; smaller sizes only below it)
+#include "../ParkingSystem.h"
+#include "../RandomGenerator.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+using namespace std;
+
+struct FacilitySize {
+    int zones;
+    int areasPerZone;
+    int slotsPerArea;
+};
+
+static const FacilitySize SIZES[] = {
+    { 10, 4, 50 },
+    { 100, 8, 250 },
+    { 1000, 10, 100 }
+};
+static const int SIZE_COUNT = 3;
+static const double OCCUPANCY[] = { 0.0, 0.5, 0.9, 0.99 };
+static const int OCCUPANCY_COUNT = 4;
+static const int OPERATIONS = 100000;
+
+// Keeps results alive so the compiler cannot drop the measured calls
+static volatile long long sink = 0;
+
+static double now() {
+    return chrono::duration<double>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static void report(const string& name, const FacilitySize& size, double occupancy, long long operations, double seconds) {
+    double nsPerOp = (operations > 0) ? seconds * 1e9 / operations : 0.0;
+    cout << name << "," << size.zones << "," << (long long)size.zones * size.areasPerZone * size.slotsPerArea
+         << "," << occupancy << "," << operations << "," << nsPerOp << endl;
+}
+
+// Zone z (1-based) is adjacent to z + 1; area IDs are unique per facility
+static ParkingSystem* buildSystem(const FacilitySize& size) {
+    ParkingSystem* system = new ParkingSystem(size.zones);
+    for (int z = 1; z <= size.zones; z++) {
+        system->setupZone(z, size.areasPerZone);
+        for (int a = 0; a < size.areasPerZone; a++) {
+            system->setupParkingArea(z, a, (z - 1) * size.areasPerZone + a + 1, size.slotsPerArea);
+        }
+    }
+    for (int z = 1; z < size.zones; z++) {
+        system->addZoneAdjacency(z, z + 1);
+    }
+    return system;
+}
+
+static void occupyPrefix(Zone* zone, double occupancy) {
+    for (int a = 0; a < zone->getAreaCount(); a++) {
+        ParkingArea* area = zone->getArea(a);
+        int occupied = (int)(area->getCapacity() * occupancy);
+        for (int s = 0; s < occupied; s++) {
+            zone->occupySlot(area->getSlot(s)->getSlotID());
+        }
+    }
+}
+
+static void benchmarkSlotSearch(const FacilitySize& size, double occupancy) {
+    ParkingSystem* system = buildSystem(size);
+    Zone* zones = system->getZones();
+    for (int z = 0; z < size.zones; z++) {
+        occupyPrefix(&zones[z], occupancy);
+    }
+    AllocationEngine engine(zones, size.zones);
+    RandomGenerator random(7);
+
+    ParkingArea* area = zones[0].getArea(0);
+    double start = now();
+    for (int i = 0; i < OPERATIONS; i++) {
+        sink += (long long)area->findAvailableSlot();
+    }
+    report("area_find_available_slot", size, occupancy, OPERATIONS, now() - start);
+
+    start = now();
+    for (int i = 0; i < OPERATIONS; i++) {
+        sink += (long long)zones[i % size.zones].findAvailableSlot();
+    }
+    report("zone_find_available_slot", size, occupancy, OPERATIONS, now() - start);
+
+    // Each allocation is undone straight away so the occupancy level holds
+    ParkingRequest sameZone(1, "BENCH", 1, 0);
+    start = now();
+    for (int i = 0; i < OPERATIONS; i++) {
+        AllocationResult result = engine.allocateSlot(sameZone);
+        engine.freeSlot(result.allocatedSlotID, result.allocatedZoneID);
+    }
+    report("allocate_free_same_zone", size, occupancy, OPERATIONS, now() - start);
+
+    // Zone 1 full, so every allocation falls through to zone 2
+    occupyPrefix(&zones[0], 1.0);
+    start = now();
+    for (int i = 0; i < OPERATIONS; i++) {
+        AllocationResult result = engine.allocateSlot(sameZone);
+        engine.freeSlot(result.allocatedSlotID, result.allocatedZoneID);
+    }
+    report("allocate_free_cross_zone", size, occupancy, OPERATIONS, now() - start);
+
+    int* slotIDs = new int[OPERATIONS];
+    int* zoneIDs = new int[OPERATIONS];
+    for (int i = 0; i < OPERATIONS; i++) {
+        int z = random.nextInt(size.zones);
+        ParkingArea* target = zones[z].getArea(random.nextInt(size.areasPerZone));
+        slotIDs[i] = target->getSlot(random.nextInt(size.slotsPerArea))->getSlotID();
+        zoneIDs[i] = z + 1;
+    }
+    start = now();
+    for (int i = 0; i < OPERATIONS; i++) {
+        sink += (long long)engine.findSlotByID(slotIDs[i], zoneIDs[i]);
+    }
+    report("find_slot_by_id", size, occupancy, OPERATIONS, now() - start);
+
+    delete[] slotIDs;
+    delete[] zoneIDs;
+    delete system;
+}
+
+// Requests go through the public API: a first wave completes (filling the
+// history), a second wave is left allocated (the active set)
+static void benchmarkRequests(const FacilitySize& size, double occupancy) {
+    ParkingSystem* system = buildSystem(size);
+    int slots = size.zones * size.areasPerZone * size.slotsPerArea;
+    int count = (int)(slots * occupancy);
+    if (count == 0) {
+        delete system;
+        return;
+    }
+
+    int* finished = new int[count];
+    for (int i = 0; i < count; i++) {
+        finished[i] = system->createParkingRequest("DONE", (i % size.zones) + 1, i);
+        system->allocateParking(finished[i]);
+        system->occupyParking(finished[i]);
+        system->releaseParking(finished[i], i + 60);
+    }
+    int* active = new int[count];
+    for (int i = 0; i < count; i++) {
+        active[i] = system->createParkingRequest("LIVE", (i % size.zones) + 1, i);
+        system->allocateParking(active[i]);
+    }
+
+    RandomGenerator random(11);
+    int* probes = new int[OPERATIONS];
+    for (int i = 0; i < OPERATIONS; i++) {
+        probes[i] = random.nextInt(count);
+    }
+
+    double start = now();
+    for (int i = 0; i < OPERATIONS; i++) {
+        sink += (long long)system->getActiveRequest(active[probes[i]]);
+    }
+    report("find_active_request", size, occupancy, OPERATIONS, now() - start);
+
+    HistoryNode entry;
+    start = now();
+    for (int i = 0; i < OPERATIONS; i++) {
+        sink += system->getHistoryEntry(finished[probes[i]], entry) ? 1 : 0;
+    }
+    report("find_in_history", size, occupancy, OPERATIONS, now() - start);
+
+    int analyticsCalls = 100;
+    start = now();
+    for (int i = 0; i < analyticsCalls; i++) {
+        sink += system->getAnalytics().totalRequests;
+    }
+    report("get_analytics", size, occupancy, analyticsCalls, now() - start);
+
+    // Ranges cover a random 80% of the zone IDs
+    int span = size.zones * 8 / 10;
+    start = now();
+    for (int i = 0; i < OPERATIONS; i++) {
+        int from = 1 + probes[i] % (size.zones - span + 1);
+        sink += system->getFreeSlotsBetween(from, from + span - 1);
+    }
+    report("range_free_slots", size, occupancy, OPERATIONS, now() - start);
+
+    start = now();
+    for (int i = 0; i < OPERATIONS; i++) {
+        int from = 1 + probes[i] % (size.zones - span + 1);
+        sink += system->getMostAvailableZone(from, from + span - 1);
+    }
+    report("range_most_available_zone", size, occupancy, OPERATIONS, now() - start);
+
+    // Cancelling removes the request from the active set (and frees its slot)
+    int removals = (count < OPERATIONS) ? count : OPERATIONS;
+    start = now();
+    for (int i = 0; i < removals; i++) {
+        sink += system->cancelRequest(active[i]) ? 1 : 0;
+    }
+    report("remove_active_request", size, occupancy, removals, now() - start);
+
+    delete[] finished;
+    delete[] active;
+    delete[] probes;
+    delete system;
+}
+
+// The stack depth is the facility's slot count times the occupancy level
+static void benchmarkRollbackPush(const FacilitySize& size, double occupancy) {
+    int capacity = (int)(size.zones * size.areasPerZone * size.slotsPerArea * occupancy);
+    if (capacity == 0) {
+        return;
+    }
+    RollbackManager manager(capacity);
+    AllocationOperation operation(1, "BENCH", 1001, 1, 0, REQUESTED, ALLOCATED);
+    for (int i = 0; i < capacity; i++) {
+        manager.pushOperation(operation);
+    }
+    // Pushing onto a full stack evicts the oldest entry
+    int pushes = 1000;
+    double start = now();
+    for (int i = 0; i < pushes; i++) {
+        manager.pushOperation(operation);
+    }
+    report("rollback_push_at_capacity", size, occupancy, pushes, now() - start);
+}
+
+// Forks share every area, so the first change in a fork copies one area
+static void benchmarkFork(const FacilitySize& size, double occupancy) {
+    ParkingSystem* system = buildSystem(size);
+    Zone* zones = system->getZones();
+    for (int z = 0; z < size.zones; z++) {
+        occupyPrefix(&zones[z], occupancy);
+    }
+
+    int forks = 100;
+    ParkingSystem** copies = new ParkingSystem*[forks];
+    double start = now();
+    for (int i = 0; i < forks; i++) {
+        copies[i] = system->fork();
+    }
+    report("fork", size, occupancy, forks, now() - start);
+
+    start = now();
+    for (int i = 0; i < forks; i++) {
+        int requestID = copies[i]->createParkingRequest("FORK", (i % size.zones) + 1, 0);
+        sink += copies[i]->allocateParking(requestID) ? 1 : 0;
+    }
+    report("fork_first_allocation", size, occupancy, forks, now() - start);
+
+    for (int i = 0; i < forks; i++) {
+        delete copies[i];
+    }
+    delete[] copies;
+    delete system;
+}
+
+int main(int argc, char* argv[]) {
+    long long maxSlots = (argc > 1) ? atoll(argv[1]) : 1000000;
+
+    cout << "benchmark,zones,slots,occupancy,operations,ns_per_op" << endl;
+    for (int s = 0; s < SIZE_COUNT; s++) {
+        const FacilitySize& size = SIZES[s];
+        if ((long long)size.zones * size.areasPerZone * size.slotsPerArea > maxSlots) {
+            continue;
+        }
+        for (int o = 0; o < OCCUPANCY_COUNT; o++) {
+            benchmarkSlotSearch(size, OCCUPANCY[o]);
+            benchmarkRequests(size, OCCUPANCY[o]);
+            benchmarkRollbackPush(size, OCCUPANCY[o]);
+            benchmarkFork(size, OCCUPANCY[o]);
+        }
+    }
+    return sink == 42 ? 1 : 0;
+}
\ No newline at end of file
@@ -0,0 +1,153 @@
+// Requests per second through HttpServer + ParkingApi on localhost.
+//
+// The server loop runs on its own thread; client threads each hold one
+// keep-alive connection and send batches of `pipeline` requests per write,
+// then read all the responses. Prints CSV lines:
+//   benchmark,connections,pipeline,requests,seconds,requests_per_second
+//
+// Usage: http_benchmark [requestsPerConnection]   (default 20000; POSIX only)
+#include "../ParkingApi.h"
+#include <arpa/inet.h>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <string>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+
+using namespace std;
+
+static double now() {
+    return chrono::duration<double>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static int connectTo(int port) {
+    int socketHandle = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons((unsigned short)port);
+    if (connect(socketHandle, (sockaddr*)&address, sizeof(address)) != 0) {
+        close(socketHandle);
+        return -1;
+    }
+    int noDelay = 1;
+    setsockopt(socketHandle, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+    return socketHandle;
+}
+
+// Reads until `expected` complete responses have arrived; false on error
+static bool readResponses(int socketHandle, int expected, string& buffer) {
+    int complete = 0;
+    size_t cursor = 0;
+    char chunk[65536];
+    while (complete < expected) {
+        size_t headerEnd = buffer.find("\r\n\r\n", cursor);
+        if (headerEnd != string::npos) {
+            size_t lengthAt = buffer.find("Content-Length: ", cursor);
+            size_t length = strtoul(buffer.c_str() + lengthAt + 16, nullptr, 10);
+            if (buffer.length() >= headerEnd + 4 + length) {
+                cursor = headerEnd + 4 + length;
+                complete++;
+                continue;
+            }
+        }
+        ssize_t received = recv(socketHandle, chunk, sizeof(chunk), 0);
+        if (received <= 0) {
+            return false;
+        }
+        buffer.append(chunk, received);
+    }
+    buffer.erase(0, cursor);
+    return true;
+}
+
+static void runClient(int port, const string& request, int pipeline, int total, bool* ok) {
+    int socketHandle = connectTo(port);
+    if (socketHandle < 0) {
+        *ok = false;
+        return;
+    }
+    string batch;
+    for (int i = 0; i < pipeline; i++) {
+        batch += request;
+    }
+    string buffer;
+    for (int sent = 0; sent < total; sent += pipeline) {
+        if (send(socketHandle, batch.data(), batch.length(), 0) != (ssize_t)batch.length()
+            || !readResponses(socketHandle, pipeline, buffer)) {
+            *ok = false;
+            break;
+        }
+    }
+    close(socketHandle);
+}
+
+int main(int argc, char* argv[]) {
+    int perConnection = (argc > 1) ? atoi(argv[1]) : 20000;
+
+    ParkingSystem system(3);
+    for (int z = 1; z <= 3; z++) {
+        system.setupZone(z, 2);
+        system.setupParkingArea(z, 0, z * 10, 100);
+        system.setupParkingArea(z, 1, z * 10 + 1, 100);
+    }
+    int requestID = system.createParkingRequest("BENCH", 1, 0);
+    system.allocateParking(requestID);
+
+    ParkingApi api(&system, "");
+    HttpServer server(ParkingApi::dispatch, &api);
+    if (!server.listen(0)) {
+        cerr << "cannot listen" << endl;
+        return 1;
+    }
+    thread loop(&HttpServer::run, &server);
+
+    const string host = "Host: localhost:" + to_string(server.getPort()) + "\r\n\r\n";
+    const string lookup = "GET /api/requests/1 HTTP/1.1\r\n" + host;
+    const string analytics = "GET /api/analytics HTTP/1.1\r\n" + host;
+    const int connectionCounts[] = { 1, 4, 16 };
+    const int pipelines[] = { 1, 16 };
+
+    cout << "benchmark,connections,pipeline,requests,seconds,requests_per_second" << endl;
+    for (int r = 0; r < 2; r++) {
+        const string& request = (r == 0) ? lookup : analytics;
+        for (int c = 0; c < 3; c++) {
+            for (int p = 0; p < 2; p++) {
+                int connections = connectionCounts[c];
+                int pipeline = pipelines[p];
+                int total = (perConnection / pipeline) * pipeline;
+                bool* ok = new bool[connections];
+                thread* clients = new thread[connections];
+                double start = now();
+                for (int i = 0; i < connections; i++) {
+                    ok[i] = true;
+                    clients[i] = thread(runClient, server.getPort(), request, pipeline, total, &ok[i]);
+                }
+                for (int i = 0; i < connections; i++) {
+                    clients[i].join();
+                }
+                double seconds = now() - start;
+                long long requests = (long long)connections * total;
+                for (int i = 0; i < connections; i++) {
+                    if (!ok[i]) {
+                        requests = 0;
+                    }
+                }
+                cout << ((r == 0) ? "get_request" : "get_analytics") << "," << connections << "," << pipeline
+                     << "," << requests << "," << seconds << "," << (long long)(requests / seconds) << endl;
+                delete[] ok;
+                delete[] clients;
+            }
+        }
+    }
+
+    server.stop();
+    loop.join();
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,73 @@
+// Layout loading at city scale.
+//
+// Generates a layout of 10,000 zones x 10 areas (100k areas, 2M slots)
+// with a weighted ring-plus-chord adjacency graph and attributes on part
+// of the slots, then times LayoutLoader::load() on it. Prints CSV lines:
+//   benchmark,zones,areas,seconds
+//
+// Usage: layout_benchmark [zones]   (default 10000)
+#include "../LayoutLoader.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+using namespace std;
+
+static const int AREAS_PER_ZONE = 10;
+static const int SLOTS_PER_AREA = 20;
+
+static double now() {
+    return chrono::duration<double>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static bool generateLayout(const string& path, int zones) {
+    FILE* out = fopen(path.c_str(), "w");
+    if (out == nullptr) {
+        return false;
+    }
+    fprintf(out, "# generated: %d zones x %d areas\nzones %d\n", zones, AREAS_PER_ZONE, zones);
+    for (int z = 1; z <= zones; z++) {
+        fprintf(out, "zone %d %d\n", z, AREAS_PER_ZONE);
+        for (int a = 0; a < AREAS_PER_ZONE; a++) {
+            fprintf(out, "area %d %d %d %d\n", z, a, z * AREAS_PER_ZONE + a, SLOTS_PER_AREA);
+        }
+        fprintf(out, "attributes %d 0 0 2 ev covered\n", z);
+    }
+    for (int z = 1; z <= zones; z++) {
+        fprintf(out, "adjacent %d %d %d\n", z, (z % zones) + 1, 1 + z % 7);
+        fprintf(out, "adjacent %d %d %d\n", z, ((z + zones / 2) % zones) + 1, 10);
+    }
+    fclose(out);
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    int zones = (argc > 1) ? atoi(argv[1]) : 10000;
+    const string layoutPath = "layout_benchmark.layout";
+
+    cout << "benchmark,zones,areas,seconds" << endl;
+
+    double start = now();
+    if (!generateLayout(layoutPath, zones)) {
+        cerr << "cannot write " << layoutPath << endl;
+        return 1;
+    }
+    cout << "layout_generate," << zones << "," << zones * AREAS_PER_ZONE << "," << (now() - start) << endl;
+
+    string error;
+    start = now();
+    ParkingSystem* system = LayoutLoader::load(layoutPath, error);
+    double seconds = now() - start;
+    if (system == nullptr) {
+        cerr << error << endl;
+        remove(layoutPath.c_str());
+        return 1;
+    }
+    cout << "layout_load," << zones << "," << zones * AREAS_PER_ZONE << "," << seconds << endl;
+
+    delete system;
+    remove(layoutPath.c_str());
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,75 @@
+// Snapshot save and restore time for a large facility.
+//
+// Builds 100 zones x 100 areas x 1000 slots (10M slots), occupies part of
+// them through the normal request path, then times saveSnapshot() and
+// loadSnapshot() into a fresh system and, for comparison, rebuilding the
+// same state by replaying the write-ahead log. Prints CSV lines:
+//   benchmark,slots,seconds
+//
+// Usage: snapshot_benchmark [areasPerZone]   (default 100)
+#include "../ParkingSystem.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+using namespace std;
+
+static const int ZONES = 100;
+static const int SLOTS_PER_AREA = 1000;
+static const int OCCUPIED_REQUESTS = 200000;
+
+static double now() {
+    return chrono::duration<double>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static void buildLayout(ParkingSystem* system, int areasPerZone) {
+    for (int z = 0; z < ZONES; z++) {
+        system->setupZone(z + 1, areasPerZone);
+        for (int a = 0; a < areasPerZone; a++) {
+            system->setupParkingArea(z + 1, a, (z + 1) * 100 + a, SLOTS_PER_AREA);
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+    int areasPerZone = (argc > 1) ? atoi(argv[1]) : 100;
+    long long slots = (long long)ZONES * areasPerZone * SLOTS_PER_AREA;
+    const string snapshotPath = "snapshot_benchmark.snap";
+    const string logPath = "snapshot_benchmark.log";
+
+    cout << "benchmark,slots,seconds" << endl;
+
+    remove(logPath.c_str());
+    ParkingSystem* system = new ParkingSystem(ZONES);
+    system->enableWriteAheadLog(logPath, 4096);
+    buildLayout(system, areasPerZone);
+    for (int i = 0; i < OCCUPIED_REQUESTS; i++) {
+        int requestID = system->createParkingRequest("BENCH", (i % ZONES) + 1, i);
+        system->allocateParking(requestID);
+        system->occupyParking(requestID);
+    }
+    system->syncWriteAheadLog();
+
+    ParkingSystem* replayed = new ParkingSystem(ZONES);
+    double start = now();
+    replayed->recoverFromLog(logPath);
+    cout << "wal_replay," << slots << "," << (now() - start) << endl;
+    delete replayed;
+
+    start = now();
+    system->saveSnapshot(snapshotPath);
+    cout << "snapshot_save," << slots << "," << (now() - start) << endl;
+    delete system;
+
+    ParkingSystem* restored = new ParkingSystem(ZONES);
+    start = now();
+    bool loaded = restored->loadSnapshot(snapshotPath);
+    cout << "snapshot_load," << slots << "," << (now() - start) << endl;
+    delete restored;
+
+    remove(snapshotPath.c_str());
+    remove(logPath.c_str());
+    return loaded ? 0 : 1;
+}
\ No newline at end of file
@@ -0,0 +1,187 @@
+// Cost of the occupancy stream on the allocation path.
+//
+// Runs cycles that park a vehicle and release the one parked PARKED
+// cycles earlier (so the lot stays partly full) with no listener, with an
+// OccupancyFeed attached, and with the feed published every `burst`
+// cycles to 1, 100 and 1000 localhost /api/stream subscribers (drained by
+// a reader thread). Prints CSV lines:
+//   benchmark,subscribers,cycles,frames,bytes_per_subscriber,ns_per_cycle
+//
+// Usage: stream_benchmark [cycles] [burst]   (default 200000, 500; POSIX only)
+#include "../ParkingApi.h"
+#include <arpa/inet.h>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <netinet/in.h>
+#include <poll.h>
+#include <string>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+
+using namespace std;
+
+static const int ZONES = 10;
+static const int AREAS_PER_ZONE = 4;
+static const int SLOTS_PER_AREA = 250;
+static const int PARKED = 2000;
+
+static double now() {
+    return chrono::duration<double>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static ParkingSystem* buildSystem() {
+    ParkingSystem* system = new ParkingSystem(ZONES);
+    for (int z = 0; z < ZONES; z++) {
+        system->setupZone(z + 1, AREAS_PER_ZONE);
+        for (int a = 0; a < AREAS_PER_ZONE; a++) {
+            system->setupParkingArea(z + 1, a, (z + 1) * 100 + a, SLOTS_PER_AREA);
+        }
+    }
+    return system;
+}
+
+static int subscribe(int port) {
+    int socketHandle = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons((unsigned short)port);
+    if (connect(socketHandle, (sockaddr*)&address, sizeof(address)) != 0) {
+        close(socketHandle);
+        return -1;
+    }
+    char request[80];
+    int length = snprintf(request, sizeof(request), "GET /api/stream HTTP/1.1\r\nHost: localhost:%d\r\n\r\n", port);
+    send(socketHandle, request, length, 0);
+    return socketHandle;
+}
+
+// Reads and discards everything the subscribers receive until told to stop
+static void drainSubscribers(int* sockets, int count, atomic<bool>* stop, long long* bytesOut) {
+    pollfd* descriptors = new pollfd[count];
+    for (int i = 0; i < count; i++) {
+        descriptors[i].fd = sockets[i];
+        descriptors[i].events = POLLIN;
+    }
+    char chunk[65536];
+    long long bytes = 0;
+    while (!*stop) {
+        if (::poll(descriptors, count, 10) <= 0) {
+            continue;
+        }
+        for (int i = 0; i < count; i++) {
+            if (descriptors[i].revents & POLLIN) {
+                ssize_t received = recv(descriptors[i].fd, chunk, sizeof(chunk), MSG_DONTWAIT);
+                if (received > 0) {
+                    bytes += received;
+                }
+            }
+        }
+    }
+    delete[] descriptors;
+    *bytesOut = bytes;
+}
+
+// Publishes every `burst` cycles (to the server's subscribers, or just
+// builds the frame without one); the publish time counts toward the cycles
+static double runCycles(ParkingSystem* system, int cycles, int burst, OccupancyFeed* feed, ParkingApi* api,
+                        HttpServer* server) {
+    int* parked = new int[PARKED];
+    string frame;
+    double start = now();
+    for (int i = 0; i < cycles; i++) {
+        int requestID = system->createParkingRequest("BENCH", (i % ZONES) + 1, i);
+        system->allocateParking(requestID);
+        system->occupyParking(requestID);
+        if (i >= PARKED) {
+            system->releaseParking(parked[i % PARKED], i);
+        }
+        parked[i % PARKED] = requestID;
+        if (feed != nullptr && (i + 1) % burst == 0) {
+            if (server != nullptr) {
+                ParkingApi::publish(*server, api);
+                server->poll(0);
+            } else {
+                feed->takeFrame(frame);
+            }
+        }
+    }
+    double seconds = now() - start;
+    delete[] parked;
+    return seconds;
+}
+
+static void report(const string& name, int subscribers, int cycles, long long frames, long long bytes,
+                   double seconds) {
+    cout << name << "," << subscribers << "," << cycles << "," << frames << ","
+         << (subscribers > 0 ? bytes / subscribers : 0) << "," << seconds * 1e9 / cycles << endl;
+}
+
+int main(int argc, char* argv[]) {
+    int cycles = (argc > 1) ? atoi(argv[1]) : 200000;
+    int burst = (argc > 2) ? atoi(argv[2]) : 500;
+
+    cout << "benchmark,subscribers,cycles,frames,bytes_per_subscriber,ns_per_cycle" << endl;
+
+    ParkingSystem* baseline = buildSystem();
+    report("no_listener", 0, cycles, 0, 0, runCycles(baseline, cycles, burst, nullptr, nullptr, nullptr));
+    delete baseline;
+
+    ParkingSystem* recorded = buildSystem();
+    OccupancyFeed recordedFeed;
+    recorded->setOccupancyListener(OccupancyFeed::onDelta, &recordedFeed);
+    double seconds = runCycles(recorded, cycles, burst, &recordedFeed, nullptr, nullptr);
+    report("feed_only", 0, cycles, recordedFeed.getFrameNumber(), 0, seconds);
+    delete recorded;
+
+    int subscriberCounts[] = { 1, 100, 1000 };
+    for (int s = 0; s < 3; s++) {
+        int subscribers = subscriberCounts[s];
+        ParkingSystem* system = buildSystem();
+        OccupancyFeed feed;
+        system->setOccupancyListener(OccupancyFeed::onDelta, &feed);
+        ParkingApi api(system, "");
+        api.setOccupancyFeed(&feed);
+        HttpServer server(ParkingApi::dispatch, &api);
+        server.setTickHandler(ParkingApi::publish, &api, 100);
+        if (!server.listen(0)) {
+            cerr << "listen failed" << endl;
+            return 1;
+        }
+
+        int* sockets = new int[subscribers];
+        for (int i = 0; i < subscribers; i++) {
+            sockets[i] = subscribe(server.getPort());
+            server.poll(0);
+        }
+        while (server.getSubscriberCount() < subscribers) {
+            server.poll(10);
+        }
+
+        atomic<bool> stop(false);
+        long long bytes = 0;
+        thread reader(drainSubscribers, sockets, subscribers, &stop, &bytes);
+        seconds = runCycles(system, cycles, burst, &feed, &api, &server);
+        for (int i = 0; i < 20; i++) {
+            server.poll(10);
+        }
+        stop = true;
+        reader.join();
+
+        report("published", server.getSubscriberCount(), cycles, feed.getFrameNumber(), bytes, seconds);
+
+        for (int i = 0; i < subscribers; i++) {
+            close(sockets[i]);
+        }
+        delete[] sockets;
+        server.close();
+        delete system;
+    }
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,87 @@
+// Write-ahead log overhead and replay speed.
+//
+// Drives create/allocate/occupy/release cycles through ParkingSystem with
+// the log disabled and with several group-commit sizes, then replays the
+// largest log into a fresh system. Prints one CSV line per measurement:
+//   benchmark,records,seconds,ns_per_record
+//
+// Usage: wal_benchmark [cycles]   (default 250000 cycles = 1M records)
+#include "../ParkingSystem.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+using namespace std;
+
+static const int ZONES = 10;
+static const int AREAS_PER_ZONE = 4;
+static const int SLOTS_PER_AREA = 250;
+
+// The log is enabled before setup so the layout is part of it
+static ParkingSystem* buildSystem(const string& logPath, int groupCommitSize) {
+    ParkingSystem* system = new ParkingSystem(ZONES);
+    if (groupCommitSize > 0) {
+        system->enableWriteAheadLog(logPath, groupCommitSize);
+    }
+    for (int z = 0; z < ZONES; z++) {
+        system->setupZone(z + 1, AREAS_PER_ZONE);
+        for (int a = 0; a < AREAS_PER_ZONE; a++) {
+            system->setupParkingArea(z + 1, a, (z + 1) * 100 + a, SLOTS_PER_AREA);
+        }
+    }
+    return system;
+}
+
+static double now() {
+    return chrono::duration<double>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Four logged records per cycle: create, allocate, occupy, release
+static double runCycles(ParkingSystem* system, int cycles) {
+    double start = now();
+    for (int i = 0; i < cycles; i++) {
+        int requestID = system->createParkingRequest("BENCH", (i % ZONES) + 1, i);
+        system->allocateParking(requestID);
+        system->occupyParking(requestID);
+        system->releaseParking(requestID, i + 10);
+    }
+    return now() - start;
+}
+
+static void report(const string& name, long long records, double seconds) {
+    double nsPerRecord = (records > 0) ? seconds * 1e9 / records : 0.0;
+    cout << name << "," << records << "," << seconds << "," << nsPerRecord << endl;
+}
+
+int main(int argc, char* argv[]) {
+    int cycles = (argc > 1) ? atoi(argv[1]) : 250000;
+    const string logPath = "wal_benchmark.log";
+
+    cout << "benchmark,records,seconds,ns_per_record" << endl;
+
+    ParkingSystem* baseline = buildSystem(logPath, 0);
+    report("no_log", 4LL * cycles, runCycles(baseline, cycles));
+    delete baseline;
+
+    // fsync per record is orders of magnitude slower, so it gets fewer cycles
+    int groupSizes[] = { 1, 64, 1024 };
+    for (int g = 0; g < 3; g++) {
+        int groupCycles = (groupSizes[g] == 1) ? (cycles < 2000 ? cycles : 2000) : cycles;
+        remove(logPath.c_str());
+        ParkingSystem* logged = buildSystem(logPath, groupSizes[g]);
+        double seconds = runCycles(logged, groupCycles);
+        logged->syncWriteAheadLog();
+        delete logged;
+        report("wal_group_" + to_string(groupSizes[g]), 4LL * groupCycles, seconds);
+    }
+
+    ParkingSystem recovered(ZONES);
+    double start = now();
+    long long applied = recovered.recoverFromLog(logPath);
+    report("wal_replay", applied, now() - start);
+
+    remove(logPath.c_str());
+    return 0;
+}
\ No newline at end of file
@@ -1,7 +1,13 @@
 #include <iostream>
 #include <windows.h>
 #include <string>
+#include <cstdio>
+#include <cstdlib>
 #include "ParkingSystem.h"
+#include "LayoutLoader.h"
+#include "TraceReplayer.h"
+#include "LoadGenerator.h"
+#include "ParkingApi.h"
 
 using namespace std;
 
@@ -274,6 +280,1423 @@ bool test12_PeakUsageZone() {
     return correct;
 }
 
+bool test13_OccupancyTimeline() {
+    printTestHeader("Occupancy Timeline - Range Utilization and Peak");
+    ParkingSystem system(2);
+    system.setupZone(1, 1);
+    system.setupParkingArea(1, 0, 101, 10);
+    system.configureTimeline(10, 100);
+    int req1 = system.createParkingRequest("V1001", 1, 100);
+    system.allocateParking(req1);
+    system.occupyParking(req1);
+    system.releaseParking(req1, 200);
+    int req2 = system.createParkingRequest("V1002", 1, 150);
+    system.allocateParking(req2);
+    system.occupyParking(req2);
+    system.releaseParking(req2, 300);
+    double utilization = system.getZoneUtilizationBetween(1, 100, 199);
+    int peakBoth = system.getPeakOccupancyBetween(1, 100, 299);
+    int peakLate = system.getPeakOccupancyBetween(1, 200, 299);
+    int peakAfter = system.getPeakOccupancyBetween(1, 300, 500);
+    cout << "Utilization [100,199]: " << utilization << "%, Peak: " << peakBoth << endl;
+    bool correct = (utilization == 15.0) && (peakBoth == 2) && (peakLate == 1) && (peakAfter == 0);
+    
+    // The timeline ends at 1000: a stay running past it counts to the end,
+    // queries beyond it are refused, and it cannot be rebuilt mid-stay
+    int req3 = system.createParkingRequest("V1003", 1, 900);
+    system.allocateParking(req3);
+    bool bounded = (system.getPeakOccupancyBetween(1, 900, 999) == 1)
+                   && (system.getPeakOccupancyBetween(1, 900, 1500) == 0)
+                   && (system.getZoneUtilizationBetween(1, 0, 1000) == 0.0)
+                   && !system.configureTimeline(10, 200);
+    system.occupyParking(req3);
+    system.releaseParking(req3, 1200);
+    bounded = bounded && (system.getPeakOccupancyBetween(1, 990, 999) == 1) && system.configureTimeline(10, 200)
+              && (system.getPeakOccupancyBetween(1, 100, 1999) == 0);
+    correct = correct && bounded;
+    printTestResult(correct);
+    return correct;
+}
+
+bool test14_TopKZones() {
+    printTestHeader("Top-K Busiest and Least Utilized Zones");
+    ParkingSystem system(3);
+    system.setupZone(1, 1);
+    system.setupParkingArea(1, 0, 101, 10);
+    system.setupZone(2, 1);
+    system.setupParkingArea(2, 0, 201, 10);
+    system.setupZone(3, 1);
+    system.setupParkingArea(3, 0, 301, 10);
+    int zone2Requests[7];
+    for (int i = 0; i < 7; i++) {
+        string vehID = "V" + to_string(2001 + i);
+        zone2Requests[i] = system.createParkingRequest(vehID, 2, 200 + i);
+        system.allocateParking(zone2Requests[i]);
+    }
+    for (int i = 0; i < 3; i++) {
+        string vehID = "V" + to_string(1001 + i);
+        int reqID = system.createParkingRequest(vehID, 1, 100 + i);
+        system.allocateParking(reqID);
+    }
+    int busiest[3];
+    int least[2];
+    int busiestFound = system.getTopKZones(3, busiest);
+    int leastFound = system.getLeastUtilizedZones(2, least);
+    bool orderCorrect = (busiestFound == 3 && busiest[0] == 2 && busiest[1] == 1 && busiest[2] == 3)
+                        && (leastFound == 2 && least[0] == 3 && least[1] == 1);
+    for (int i = 0; i < 5; i++) {
+        system.cancelRequest(zone2Requests[i]);
+    }
+    bool peakMoved = (system.getPeakUsageZone() == 1);
+    cout << "Peak Usage Zone after cancellations: " << system.getPeakUsageZone() << endl;
+    
+    // Least utilized compares shares: 5 of 100 slots is emptier than 3 of 10
+    ParkingSystem mixed(2);
+    mixed.setupZone(1, 1);
+    mixed.setupParkingArea(1, 0, 101, 10);
+    mixed.setupZone(2, 1);
+    mixed.setupParkingArea(2, 0, 201, 100);
+    for (int i = 0; i < 8; i++) {
+        int reqID = mixed.createParkingRequest("M" + to_string(i), (i < 3) ? 1 : 2, i);
+        mixed.allocateParking(reqID);
+    }
+    int byShare[2];
+    bool shareOrder = (mixed.getLeastUtilizedZones(2, byShare) == 2) && byShare[0] == 2 && byShare[1] == 1
+                      && mixed.getPeakUsageZone() == 2;
+    
+    bool passed = orderCorrect && peakMoved && shareOrder;
+    printTestResult(passed);
+    return passed;
+}
+
+bool test15_NoShowExpiry() {
+    printTestHeader("No-Show Reclamation and Max-Stay Flagging");
+    ParkingSystem system(2);
+    system.setupZone(1, 1);
+    system.setupParkingArea(1, 0, 101, 5);
+    system.setNoShowTimeout(50);
+    system.setMaxStayDuration(100);
+    int reqA = system.createParkingRequest("V1001", 1, 100);
+    int reqB = system.createParkingRequest("V1002", 1, 100);
+    int reqC = system.createParkingRequest("V1003", 1, 120);
+    system.allocateParking(reqA);
+    system.allocateParking(reqB);
+    system.allocateParking(reqC);
+    system.occupyParking(reqB);
+    system.occupyParking(reqC);
+    int noShows = system.advanceTime(160);
+    bool reclaimed = (noShows == 1) && (system.getActiveRequest(reqA) == nullptr)
+                     && (system.getZones()[0].getTotalAvailableSlots() == 3);
+    int overstays = system.advanceTime(250);
+    bool flagged = (overstays == 2) && system.isOverstayed(reqB) && system.isOverstayed(reqC);
+    system.releaseParking(reqB, 260);
+    bool cleared = (system.getOverstayedCount() == 1);
+    system.setNoShowTimeout(100000);
+    int reqD = system.createParkingRequest("V1004", 1, 300);
+    system.allocateParking(reqD);
+    bool notEarly = (system.advanceTime(100299) == 0);
+    bool onTime = (system.advanceTime(100300) == 1);
+    cout << "No-shows: " << noShows << ", Overstays: " << overstays << endl;
+    bool passed = reclaimed && flagged && cleared && notEarly && onTime;
+    printTestResult(passed);
+    return passed;
+}
+
+bool test16_AdvanceReservations() {
+    printTestHeader("Advance Reservations for Future Time Windows");
+    ParkingSystem system(2);
+    system.setupZone(1, 1);
+    system.setupParkingArea(1, 0, 101, 2);
+    system.setupZone(2, 1);
+    system.setupParkingArea(2, 0, 201, 1);
+    system.addZoneAdjacency(1, 2);
+    int reqA = system.createReservation("V1001", 1, 200, 300);
+    int reqB = system.createReservation("V1002", 1, 250, 350);
+    int reqC = system.createReservation("V1003", 1, 260, 280);
+    int reqD = system.createReservation("V1004", 1, 300, 400);
+    int reqE = system.createReservation("V1005", 1, 270, 290);
+    bool booked = (reqA != -1 && reqB != -1 && reqC != -1 && reqD != -1) && (reqE == -1);
+    ParkingRequest* reqAPtr = system.getActiveRequest(reqA);
+    bool waiting = (reqAPtr != nullptr && reqAPtr->getState() == REQUESTED)
+                   && (system.getZones()[0].getTotalAvailableSlots() == 2);
+    int activated = system.advanceTime(200);
+    reqAPtr = system.getActiveRequest(reqA);
+    bool allocated = (activated == 1 && reqAPtr != nullptr && reqAPtr->getState() == ALLOCATED)
+                     && (system.getZones()[0].getTotalAvailableSlots() == 1);
+    system.cancelRequest(reqD);
+    int reqF = system.createReservation("V1006", 1, 300, 400);
+    bool rebooked = (reqF != -1) && !system.hasReservation(reqD) && system.hasReservation(reqF);
+    cout << "Activated at t=200: " << activated << endl;
+    
+    // A walk-in never takes a slot booked later on, unless the maximum stay
+    // ends before the booking starts
+    ParkingSystem single(1);
+    single.setupZone(1, 1);
+    single.setupParkingArea(1, 0, 101, 1);
+    int held = single.createReservation("R1", 1, 10, 20);
+    int walkIn = single.createParkingRequest("W1", 1, 0);
+    bool guarded = !single.allocateParking(walkIn) && single.isWaitlisted(walkIn)
+                   && (single.advanceTime(10) == 1) && (single.getActiveRequest(held)->getState() == ALLOCATED);
+    single.occupyParking(held);
+    single.releaseParking(held, 20);
+    single.cancelRequest(walkIn);
+    int later = single.createReservation("R2", 1, 100, 120);
+    single.setMaxStayDuration(50);
+    int brief = single.createParkingRequest("W2", 1, 30);
+    int tooLong = single.createParkingRequest("W3", 1, 60);
+    guarded = guarded && (later != -1) && single.allocateParking(brief);
+    single.occupyParking(brief);
+    single.releaseParking(brief, 40);
+    guarded = guarded && !single.allocateParking(tooLong);
+    
+    bool passed = booked && waiting && allocated && rebooked && guarded;
+    printTestResult(passed);
+    return passed;
+}
+
+bool test17_PriorityWaitlist() {
+    printTestHeader("Priority Waitlist Drained on Slot Release");
+    ParkingSystem system(2);
+    system.setupZone(1, 1);
+    system.setupParkingArea(1, 0, 101, 1);
+    int reqA = system.createParkingRequest("V1001", 1, 100);
+    int reqB = system.createParkingRequest("V1002", 1, 110);
+    int reqC = system.createParkingRequest("V1003", 1, 120, PRIORITY_ACCESSIBLE);
+    int reqD = system.createParkingRequest("V1004", 1, 105);
+    system.allocateParking(reqA);
+    system.occupyParking(reqA);
+    bool queued = !system.allocateParking(reqB) && !system.allocateParking(reqC)
+                  && !system.allocateParking(reqD) && (system.getWaitlistLength(1) == 3);
+    system.releaseParking(reqA, 200);
+    ParkingRequest* reqCPtr = system.getActiveRequest(reqC);
+    bool priorityServed = (reqCPtr != nullptr && reqCPtr->getState() == ALLOCATED)
+                          && (system.getWaitlistLength(1) == 2);
+    system.cancelRequest(reqB);
+    system.cancelRequest(reqC);
+    ParkingRequest* reqDPtr = system.getActiveRequest(reqD);
+    bool fifoServed = (reqDPtr != nullptr && reqDPtr->getState() == ALLOCATED)
+                      && (system.getWaitlistLength(1) == 0) && !system.isWaitlisted(reqD);
+    
+    // Cancelled waiters leave stale heap entries; once they outnumber the
+    // live ones they are swept, and the order of the rest is kept
+    int kept[2] = { -1, -1 };
+    for (int i = 0; i < 40; i++) {
+        int reqID = system.createParkingRequest("C" + to_string(i), 1, 300 + i,
+                                                (i == 25) ? PRIORITY_ACCESSIBLE : PRIORITY_STANDARD);
+        system.allocateParking(reqID);
+        if (i == 10 || i == 25) {
+            kept[i == 25] = reqID;
+        } else {
+            system.cancelRequest(reqID);
+        }
+    }
+    int late = system.createParkingRequest("C40", 1, 400);
+    system.allocateParking(late);
+    system.occupyParking(reqD);
+    system.releaseParking(reqD, 500);
+    bool swept = (system.getActiveRequest(kept[1])->getState() == ALLOCATED) && (system.getWaitlistLength(1) == 2)
+                 && system.isWaitlisted(kept[0]) && system.isWaitlisted(late);
+    system.cancelRequest(kept[1]);
+    swept = swept && (system.getActiveRequest(kept[0])->getState() == ALLOCATED) && system.isWaitlisted(late);
+    
+    
+    // A no-show hands its slot to a waiting booking whose start timer
+    // expired in the same batch
+    ParkingSystem timed(1);
+    timed.setupZone(1, 1);
+    timed.setupParkingArea(1, 0, 101, 1);
+    timed.setNoShowTimeout(50);
+    timed.setMaxStayDuration(40);
+    int booking = timed.createReservation("R1", 1, 50, 100);
+    int walkIn = timed.createParkingRequest("W1", 1, 0);
+    timed.allocateParking(walkIn);
+    timed.advanceTime(10);
+    timed.allocateParking(booking);
+    bool bookingWaits = timed.isWaitlisted(booking);
+    timed.advanceTime(50);
+    ParkingRequest* handedOver = timed.getActiveRequest(booking);
+    bool sameBatch = bookingWaits && (timed.getActiveRequest(walkIn) == nullptr)
+                     && (handedOver != nullptr) && (handedOver->getState() == ALLOCATED);
+    timed.advanceTime(99);
+    sameBatch = sameBatch && (timed.getActiveRequest(booking) != nullptr);
+    timed.advanceTime(100);
+    sameBatch = sameBatch && (timed.getActiveRequest(booking) == nullptr);
+    
+    // A drained request's stay starts when it gets the slot, not when it asked
+    ParkingSystem drained(1);
+    drained.setupZone(1, 1);
+    drained.setupParkingArea(1, 0, 101, 1);
+    drained.configureTimeline(10, 100);
+    drained.setNoShowTimeout(50);
+    int holder = drained.createParkingRequest("H1", 1, 0);
+    drained.allocateParking(holder);
+    drained.occupyParking(holder);
+    int waiter = drained.createParkingRequest("H2", 1, 100);
+    drained.allocateParking(waiter);
+    drained.releaseParking(holder, 500);
+    drained.advanceTime(520);
+    bool stillHeld = (drained.getActiveRequest(waiter) != nullptr);
+    drained.occupyParking(waiter);
+    drained.releaseParking(waiter, 600);
+    HistoryNode waiterEntry;
+    bool stayFromDrain = stillHeld && (drained.getPeakOccupancyBetween(1, 100, 499) == 1)
+                         && drained.getHistoryEntry(waiter, waiterEntry) && (waiterEntry.allocatedTime == 500)
+                         && (drained.getAnalytics().averageParkingDuration == 300.0);
+    
+    bool passed = queued && priorityServed && fifoServed && swept && sameBatch && stayFromDrain;
+    printTestResult(passed);
+    return passed;
+}
+
+bool test18_WriteAheadLogRecovery() {
+    printTestHeader("Write-Ahead Log Crash Recovery");
+    const string logPath = "parking_test_wal.log";
+    remove(logPath.c_str());
+    ParkingSystem* original = new ParkingSystem(2);
+    original->enableWriteAheadLog(logPath, 1);
+    original->setupZone(1, 1);
+    original->setupParkingArea(1, 0, 101, 2);
+    original->setupZone(2, 1);
+    original->setupParkingArea(2, 0, 201, 2);
+    original->addZoneAdjacency(1, 2);
+    int req1 = original->createParkingRequest("V1001", 1, 100);
+    int req2 = original->createParkingRequest("V1002", 1, 110);
+    int req3 = original->createParkingRequest("V1003", 1, 120);
+    int req4 = original->createParkingRequest("V1004", 1, 130);
+    original->allocateParking(req1);
+    original->allocateParking(req2);
+    original->allocateParking(req3);
+    original->occupyParking(req1);
+    original->releaseParking(req1, 200);
+    original->cancelRequest(req4);
+    original->rollbackLastAllocation();
+    ParkingAnalytics before = original->getAnalytics();
+    int availableBefore = original->getZones()[0].getTotalAvailableSlots() + original->getZones()[1].getTotalAvailableSlots();
+    delete original;
+    
+    ParkingSystem recovered(2);
+    long long applied = recovered.recoverFromLog(logPath);
+    ParkingAnalytics after = recovered.getAnalytics();
+    int availableAfter = recovered.getZones()[0].getTotalAvailableSlots() + recovered.getZones()[1].getTotalAvailableSlots();
+    ParkingRequest* req2Ptr = recovered.getActiveRequest(req2);
+    bool stateMatches = (req2Ptr != nullptr && req2Ptr->getState() == ALLOCATED)
+                        && (recovered.getActiveRequest(req1) == nullptr);
+    bool analyticsMatch = (after.totalRequests == before.totalRequests)
+                          && (after.completedRequests == before.completedRequests)
+                          && (after.cancelledRequests == before.cancelledRequests)
+                          && (after.averageParkingDuration == before.averageParkingDuration);
+    bool idsContinue = (recovered.createParkingRequest("V1005", 2, 300) == req4 + 1);
+    
+    // A crash mid-write leaves a torn record; recovery cuts it off so
+    // records logged after the restart are replayed next time
+    FILE* torn = fopen(logPath.c_str(), "ab");
+    fwrite("\x40\x00torn", 1, 6, torn);
+    fclose(torn);
+    ParkingSystem* resumed = new ParkingSystem(2);
+    resumed->recoverFromLog(logPath);
+    resumed->enableWriteAheadLog(logPath, 1);
+    int req6 = resumed->createParkingRequest("V1006", 2, 310);
+    delete resumed;
+    ParkingSystem reopened(2);
+    reopened.recoverFromLog(logPath);
+    bool tailTruncated = (req6 != -1) && (reopened.getActiveRequest(req6) != nullptr);
+    remove(logPath.c_str());
+    cout << "Records replayed: " << applied << endl;
+    bool passed = (applied > 0) && stateMatches && analyticsMatch && (availableAfter == availableBefore) && idsContinue
+                  && tailTruncated;
+    printTestResult(passed);
+    return passed;
+}
+
+bool test19_SnapshotRestore() {
+    printTestHeader("Snapshot Save and Fast Restore");
+    const string snapshotPath = "parking_test.snap";
+    const string logPath = "parking_test_snap_wal.log";
+    remove(logPath.c_str());
+    ParkingSystem* original = new ParkingSystem(2);
+    original->enableWriteAheadLog(logPath, 1);
+    original->setupZone(1, 1);
+    original->setupParkingArea(1, 0, 101, 2);
+    original->setupZone(2, 1);
+    original->setupParkingArea(2, 0, 201, 1);
+    original->setNoShowTimeout(50);
+    int req1 = original->createParkingRequest("V1001", 1, 100);
+    int req2 = original->createParkingRequest("V1002", 1, 110);
+    int req3 = original->createParkingRequest("V1003", 1, 120, PRIORITY_ACCESSIBLE);
+    int reserved = original->createReservation("V1004", 2, 500, 600);
+    original->allocateParking(req1);
+    original->occupyParking(req1);
+    original->allocateParking(req2);
+    original->allocateParking(req3);
+    unsigned char preSnapshotLog[4096];
+    FILE* logFile = fopen(logPath.c_str(), "rb");
+    size_t preSnapshotBytes = fread(preSnapshotLog, 1, sizeof(preSnapshotLog), logFile);
+    fclose(logFile);
+    bool saved = original->saveSnapshot(snapshotPath);
+    ParkingAnalytics atSnapshot = original->getAnalytics();
+    
+    // Logged after the snapshot, so only this part is replayed
+    original->releaseParking(req1, 200);
+    ParkingAnalytics before = original->getAnalytics();
+    delete original;
+    
+    ParkingSystem restored(2);
+    bool loaded = restored.loadSnapshot(snapshotPath);
+    long long applied = restored.recoverFromLog(logPath);
+    ParkingAnalytics after = restored.getAnalytics();
+    ParkingRequest* req3Ptr = restored.getActiveRequest(req3);
+    bool handedOver = (req3Ptr != nullptr && req3Ptr->getState() == ALLOCATED) && !restored.isWaitlisted(req3);
+    bool analyticsMatch = (after.totalRequests == before.totalRequests)
+                          && (after.completedRequests == before.completedRequests)
+                          && (after.averageParkingDuration == before.averageParkingDuration);
+    
+    // Timers survive the restart: req2 never arrives and is reclaimed
+    restored.advanceTime(170);
+    bool timersRestored = (restored.getActiveRequest(req2) == nullptr);
+    bool reservationRestored = restored.hasReservation(reserved)
+                               && (restored.createReservation("V1005", 2, 550, 580) == -1);
+    
+    // A crash between writing the snapshot and truncating the log leaves
+    // records the snapshot already holds; they are not applied again
+    logFile = fopen(logPath.c_str(), "wb");
+    fwrite(preSnapshotLog, 1, preSnapshotBytes, logFile);
+    fclose(logFile);
+    ParkingSystem crashed(2);
+    bool crashLoaded = crashed.loadSnapshot(snapshotPath);
+    long long reapplied = crashed.recoverFromLog(logPath);
+    bool notReapplied = crashLoaded && (reapplied == 0) && (crashed.getAnalytics().totalRequests == atSnapshot.totalRequests)
+                        && (crashed.createParkingRequest("V1006", 1, 300) == reserved + 1);
+    remove(snapshotPath.c_str());
+    remove(logPath.c_str());
+    cout << "Records replayed after snapshot: " << applied << endl;
+    bool passed = saved && loaded && (applied == 1) && handedOver && analyticsMatch
+                  && timersRestored && reservationRestored && notReapplied;
+    printTestResult(passed);
+    return passed;
+}
+
+bool test20_HistoryArchive() {
+    printTestHeader("Completed History Archived to Disk");
+    const string archivePath = "parking_test_history.arc";
+    ParkingSystem archived(1);
+    ParkingSystem inMemory(1);
+    ParkingSystem* systems[2] = { &archived, &inMemory };
+    archived.enableHistoryArchive(archivePath);
+    for (int s = 0; s < 2; s++) {
+        systems[s]->setupZone(1, 1);
+        systems[s]->setupParkingArea(1, 0, 101, 3);
+        for (int i = 0; i < 5; i++) {
+            int req = systems[s]->createParkingRequest("V200" + to_string(i), 1, 100 + i);
+            systems[s]->allocateParking(req);
+            systems[s]->occupyParking(req);
+            systems[s]->releaseParking(req, 150 + 10 * i);
+        }
+        int cancelled = systems[s]->createParkingRequest("V2005", 1, 200);
+        systems[s]->cancelRequest(cancelled);
+        int live = systems[s]->createParkingRequest("V2006", 1, 210);
+        systems[s]->allocateParking(live);
+    }
+    ParkingAnalytics fromArchive = archived.getAnalytics();
+    ParkingAnalytics fromMemory = inMemory.getAnalytics();
+    bool analyticsMatch = (fromArchive.totalRequests == fromMemory.totalRequests)
+                          && (fromArchive.completedRequests == fromMemory.completedRequests)
+                          && (fromArchive.cancelledRequests == fromMemory.cancelledRequests)
+                          && (fromArchive.averageParkingDuration == fromMemory.averageParkingDuration);
+    
+    // Only the live allocation stays resident; finished entries read back from disk
+    HistoryNode entry;
+    bool lookedUp = archived.getHistoryEntry(3, entry)
+                    && (entry.request.getState() == RELEASED) && (entry.releaseTime == 170)
+                    && (entry.request.getVehicleID() == "V2002");
+    bool liveResident = archived.getHistoryEntry(7, entry) && (entry.request.getState() == ALLOCATED);
+    cout << "Resident history entries: " << archived.getResidentHistoryCount()
+         << " (in-memory system: " << inMemory.getResidentHistoryCount() << ")" << endl;
+    
+    // A snapshot re-attaches the archive; one cut short since is refused
+    const string snapshotPath = "parking_test_history.snap";
+    bool saved = archived.saveSnapshot(snapshotPath);
+    ParkingSystem restored(1);
+    bool reattached = restored.loadSnapshot(snapshotPath)
+                      && (restored.getAnalytics().completedRequests == fromArchive.completedRequests);
+    // The reopened archive rebuilds its on-disk ID index, so old IDs still resolve
+    HistoryNode reread;
+    bool rereadAfterReopen = restored.getHistoryEntry(3, reread) && (reread.releaseTime == 170)
+                             && !restored.getHistoryEntry(999, reread);
+    unsigned char header[8] = { 0 };
+    FILE* shortened = fopen(archivePath.c_str(), "rb");
+    size_t headerBytes = fread(header, 1, sizeof(header), shortened);
+    fclose(shortened);
+    shortened = fopen(archivePath.c_str(), "wb");
+    fwrite(header, 1, headerBytes, shortened);
+    fclose(shortened);
+    ParkingSystem tooShort(1);
+    bool shortRefused = !tooShort.loadSnapshot(snapshotPath);
+    remove(snapshotPath.c_str());
+    bool passed = analyticsMatch && lookedUp && liveResident && saved && reattached && rereadAfterReopen
+                  && shortRefused
+                  && (archived.getResidentHistoryCount() == 1) && (inMemory.getResidentHistoryCount() == 7);
+    remove(archivePath.c_str());
+    printTestResult(passed);
+    return passed;
+}
+
+bool test21_LayoutLoader() {
+    printTestHeader("Layout File Loading");
+    const string layoutPath = "parking_test.layout";
+    FILE* out = fopen(layoutPath.c_str(), "w");
+    fputs("# test layout\n"
+          "zones 3\n"
+          "zone 10 1\n"
+          "area 10 0 110 1\n"
+          "zone 20 1\n"
+          "area 20 0 120 2   # far neighbour\n"
+          "zone 30 2\n"
+          "area 30 0 130 1\n"
+          "area 30 1 131 3\n"
+          "adjacent 10 20 5\n"
+          "adjacent 10 30 2\n"
+          "attributes 30 1 0 2 ev covered\n", out);
+    fclose(out);
+    
+    string error;
+    ParkingSystem* system = LayoutLoader::load(layoutPath, error);
+    bool loaded = (system != nullptr);
+    bool layoutMatches = false;
+    bool nearestFirst = false;
+    if (loaded) {
+        layoutMatches = (system->getZones()[2].getTotalCapacity() == 4)
+                        && (system->countSlotsWithAttributes(30, SLOT_EV_CHARGER | SLOT_COVERED) == 2)
+                        && (system->countSlotsWithAttributes(20, SLOT_EV_CHARGER) == 0);
+        
+        // Zone 10 is full after one car; the overflow goes to zone 30 (weight 2), not zone 20
+        int req1 = system->createParkingRequest("L1", 10, 100);
+        int req2 = system->createParkingRequest("L2", 10, 101);
+        system->allocateParking(req1);
+        system->allocateParking(req2);
+        nearestFirst = (system->getZones()[2].getTotalAvailableSlots() == 3)
+                       && (system->getZones()[1].getTotalAvailableSlots() == 2);
+        delete system;
+    }
+    
+    out = fopen(layoutPath.c_str(), "w");
+    fputs("zones 1\nzone 1 1\narea 2 0 201 5\n", out);
+    fclose(out);
+    string badError;
+    bool rejected = (LayoutLoader::load(layoutPath, badError) == nullptr) && (badError.find("line 3") == 0);
+    cout << "Rejected bad layout with: " << badError << endl;
+    remove(layoutPath.c_str());
+    
+    bool passed = loaded && layoutMatches && nearestFirst && rejected;
+    printTestResult(passed);
+    return passed;
+}
+
+bool test22_TraceReplay() {
+    printTestHeader("Trace Replay with Golden Analytics");
+    const string tracePath = "parking_test.trace";
+    const string goldenPath = "parking_test.golden";
+    FILE* out = fopen(tracePath.c_str(), "w");
+    fputs("# time op key args\n"
+          "100 create 7 T1 1\n"
+          "101 create 9 T2 1 accessible\n"
+          "102 allocate 7\n"
+          "103 allocate 9\n"
+          "110 occupy 7\n"
+          "150 release 7\n"
+          "160 cancel 9\n"
+          "170 release 9   # already cancelled, counted as a failure\n", out);
+    fclose(out);
+    
+    ParkingSystem system(1);
+    system.setupZone(1, 1);
+    system.setupParkingArea(1, 0, 101, 2);
+    TraceReplayer replayer(&system);
+    string error;
+    bool replayed = replayer.replay(tracePath, error);
+    ParkingAnalytics analytics = system.getAnalytics();
+    bool counted = (replayer.getEventCount() == 8) && (replayer.getFailureCount(TRACE_RELEASE) == 1)
+                   && (replayer.getLatency(TRACE_CREATE).getCount() == 2);
+    bool applied = (analytics.completedRequests == 1) && (analytics.cancelledRequests == 1)
+                   && (analytics.averageParkingDuration == 50.0);
+    
+    bool goldenMatches = TraceReplayer::writeGolden(analytics, goldenPath);
+    string differences;
+    goldenMatches = goldenMatches && TraceReplayer::compareGolden(analytics, goldenPath, differences);
+    analytics.completedRequests++;
+    bool mismatchDetected = !TraceReplayer::compareGolden(analytics, goldenPath, differences)
+                            && (differences.find("completedRequests") == 0);
+    
+    out = fopen(tracePath.c_str(), "w");
+    fputs("5 allocate 42\n", out);
+    fclose(out);
+    TraceReplayer badReplayer(&system);
+    bool badRejected = !badReplayer.replay(tracePath, error) && (error.find("line 1") == 0);
+    
+    remove(tracePath.c_str());
+    remove(goldenPath.c_str());
+    bool passed = replayed && counted && applied && goldenMatches && mismatchDetected && badRejected;
+    printTestResult(passed);
+    return passed;
+}
+
+bool test23_LoadGenerator() {
+    printTestHeader("Seeded Load Generator");
+    const string firstPath = "parking_test_a.trace";
+    const string secondPath = "parking_test_b.trace";
+    WorkloadConfig config;
+    config.seed = 42;
+    config.duration = 600;
+    config.arrivalRate = 1.5;
+    config.cancellationRate = 0.2;
+    
+    ParkingSystem* systems[3];
+    for (int i = 0; i < 3; i++) {
+        systems[i] = new ParkingSystem(3);
+        for (int z = 1; z <= 3; z++) {
+            systems[i]->setupZone(z, 1);
+            systems[i]->setupParkingArea(z, 0, z * 100, 20);
+        }
+        systems[i]->addZoneAdjacency(1, 2);
+    }
+    
+    LoadGenerator first(systems[0], config);
+    LoadGenerator second(systems[1], config);
+    bool ran = first.run(firstPath) && second.run(secondPath);
+    const WorkloadStats& stats = first.getStats();
+    
+    // Same seed, same trace
+    bool identical = true;
+    FILE* a = fopen(firstPath.c_str(), "r");
+    FILE* b = fopen(secondPath.c_str(), "r");
+    if (a == nullptr || b == nullptr) {
+        identical = false;
+    } else {
+        int ca, cb;
+        do {
+            ca = fgetc(a);
+            cb = fgetc(b);
+            if (ca != cb) {
+                identical = false;
+            }
+        } while (identical && ca != EOF);
+    }
+    if (a != nullptr) fclose(a);
+    if (b != nullptr) fclose(b);
+    
+    bool consistent = (stats.arrivals > 100) && (stats.cancelled > 0)
+                      && (stats.released == stats.occupied)
+                      && (stats.allocated + stats.waitlisted == stats.arrivals);
+    
+    TraceReplayer replayer(systems[2]);
+    string error;
+    bool replayed = replayer.replay(firstPath, error);
+    ParkingAnalytics generated = systems[0]->getAnalytics();
+    ParkingAnalytics replayedAnalytics = systems[2]->getAnalytics();
+    bool sameOutcome = replayed && (generated.totalRequests == replayedAnalytics.totalRequests)
+                       && (generated.completedRequests == replayedAnalytics.completedRequests)
+                       && (generated.cancelledRequests == replayedAnalytics.cancelledRequests)
+                       && (generated.averageParkingDuration == replayedAnalytics.averageParkingDuration);
+    
+    for (int i = 0; i < 3; i++) {
+        delete systems[i];
+    }
+    remove(firstPath.c_str());
+    remove(secondPath.c_str());
+    bool passed = ran && identical && consistent && sameOutcome;
+    printTestResult(passed);
+    return passed;
+}
+
+bool test24_Metrics() {
+    printTestHeader("Operation Metrics and Exposition");
+    ParkingSystem system(2);
+    system.setupZone(1, 1);
+    system.setupParkingArea(1, 0, 101, 1);
+    system.setupZone(2, 1);
+    system.setupParkingArea(2, 0, 201, 1);
+    system.addZoneAdjacency(1, 2);
+    
+    int first = system.createParkingRequest("M1", 1, 10);
+    int second = system.createParkingRequest("M2", 1, 11);
+    int third = system.createParkingRequest("M3", 1, 12);
+    system.allocateParking(first);
+    system.allocateParking(second);      // spills into zone 2
+    system.allocateParking(third);       // waitlisted
+    system.occupyParking(first);
+    system.releaseParking(first, 40);    // hands zone 1's slot to the waitlist
+    system.releaseParking(first, 41);    // already released
+    
+    const ParkingMetrics* metrics = system.getMetrics();
+#ifdef PARKING_METRICS_ENABLED
+    bool passed = (metrics != nullptr);
+    if (passed) {
+        const ZoneMetrics* zone1 = metrics->getZoneMetrics(0);
+        const ZoneMetrics* zone2 = metrics->getZoneMetrics(1);
+        bool counted = (metrics->getCallCount(METRIC_CREATE) == 3)
+                       && (metrics->getCallCount(METRIC_ALLOCATE) == 4)
+                       && (metrics->getFailureCount(METRIC_ALLOCATE) == 1)
+                       && (metrics->getCallCount(METRIC_RELEASE) == 2)
+                       && (metrics->getFailureCount(METRIC_RELEASE) == 1)
+                       && (metrics->getLatency(METRIC_ALLOCATE).getCount() == 4);
+        bool zones = (zone1->allocations == 2) && (zone1->spilledOut == 1) && (zone1->failures == 1)
+                     && (zone1->releases == 1) && (zone2->spilledIn == 1)
+                     && (metrics->getAllocationCount() == 3);
+        bool search = (metrics->getSearchLength().getMax() == 2) && (metrics->getCrossZoneRate() > 0.33)
+                      && (metrics->getCrossZoneRate() < 0.34);
+        string text = system.getMetricsText();
+        bool exposed = (text.find("parking_operation_failures_total{op=\"allocate\"} 1\n") != string::npos)
+                       && (text.find("parking_zone_spilled_in_total{zone=\"2\"} 1\n") != string::npos);
+        passed = counted && zones && search && exposed;
+    }
+#else
+    bool passed = (metrics == nullptr) && system.getMetricsText().empty();
+#endif
+    printTestResult(passed);
+    return passed;
+}
+
+bool test25_HttpApi() {
+    printTestHeader("JSON API Routing");
+    ParkingSystem system(2);
+    system.setupZone(1, 1);
+    system.setupParkingArea(1, 0, 101, 1);
+    system.setupZone(2, 1);
+    system.setupParkingArea(2, 0, 201, 1);
+    system.addZoneAdjacency(1, 2);
+    ParkingApi api(&system, "");
+    
+    HttpRequest request;
+    HttpResponse response;
+    request.method = "POST";
+    request.path = "/api/requests";
+    request.contentType = "application/x-www-form-urlencoded";
+    request.body = "vehicle=LEB%2D1&zone=1&time=100";
+    api.handle(request, response);
+    bool created = (response.status == 200) && (response.body.find("\"requestID\":1,\"vehicleID\":\"LEB-1\"") != string::npos);
+    
+    request = HttpRequest();
+    request.method = "POST";
+    request.path = "/api/requests/1/allocate";
+    response = HttpResponse();
+    api.handle(request, response);
+    bool allocated = (response.status == 200) && (response.body.find("\"state\":\"ALLOCATED\",\"allocatedZone\":1") != string::npos);
+    
+    response = HttpResponse();
+    api.handle(request, response);
+    bool rejected = (response.status == 409) && (response.body.find("{\"ok\":false") == 0);
+    
+    request.path = "/api/requests/1/occupy";
+    response = HttpResponse();
+    api.handle(request, response);
+    request.path = "/api/requests/1/release";
+    request.query = "time=160";
+    response = HttpResponse();
+    api.handle(request, response);
+    bool released = (response.status == 200) && (response.body.find("\"duration\":60") != string::npos);
+    
+    request = HttpRequest();
+    request.method = "GET";
+    request.path = "/api/zones";
+    response = HttpResponse();
+    api.handle(request, response);
+    bool zones = (response.body == "{\"zones\":[{\"id\":1,\"capacity\":1,\"occupied\":0,\"waiting\":0},"
+                                    "{\"id\":2,\"capacity\":1,\"occupied\":0,\"waiting\":0}]}");
+    
+    request.path = "/api/analytics";
+    response = HttpResponse();
+    api.handle(request, response);
+    bool analytics = (response.body.find("\"completedRequests\":1") != string::npos);
+    
+    request.path = "/api/requests/x";
+    response = HttpResponse();
+    api.handle(request, response);
+    bool badID = (response.status == 400);
+    request.path = "/index.html";
+    response = HttpResponse();
+    api.handle(request, response);
+    bool noStatic = (response.status == 404);
+    
+    // A form posted from another site is refused; the dashboard's own is not
+    request = HttpRequest();
+    request.method = "POST";
+    request.path = "/api/requests";
+    request.contentType = "application/x-www-form-urlencoded";
+    request.body = "vehicle=LEB-2&zone=1&time=200";
+    request.host = "127.0.0.1:8080";
+    request.origin = "http://evil.example";
+    response = HttpResponse();
+    api.handle(request, response);
+    bool crossRefused = (response.status == 403) && (system.getActiveRequest(2) == nullptr);
+    request.origin = "http://127.0.0.1:8080";
+    response = HttpResponse();
+    api.handle(request, response);
+    bool sameAccepted = (response.status == 200);
+    
+    // A page on a rebound name is same-origin with itself but names its own host
+    request = HttpRequest();
+    request.method = "GET";
+    request.path = "/api/zones";
+    request.localPort = 8080;
+    request.host = "rebound.example:8080";
+    response = HttpResponse();
+    api.handle(request, response);
+    bool reboundRefused = (response.status == 403);
+    request.host = "localhost:8080";
+    response = HttpResponse();
+    api.handle(request, response);
+    bool localAccepted = (response.status == 200);
+    
+    bool passed = created && allocated && rejected && released && zones && analytics && badID && noStatic
+                  && crossRefused && sameAccepted && reboundRefused && localAccepted;
+    printTestResult(passed);
+    return passed;
+}
+
+bool test26_OccupancyFeed() {
+    printTestHeader("Coalesced Occupancy Stream");
+    ParkingSystem system(1);
+    system.setupZone(1, 1);
+    system.setupParkingArea(1, 0, 101, 2);
+    OccupancyFeed feed;
+    system.setOccupancyListener(OccupancyFeed::onDelta, &feed);
+    
+    int first = system.createParkingRequest("S1", 1, 10);
+    int second = system.createParkingRequest("S2", 1, 11);
+    system.allocateParking(first);
+    system.occupyParking(first);         // merges into one FREE -> OCCUPIED delta
+    system.allocateParking(second);
+    system.cancelRequest(second);        // back to FREE, so it is dropped
+    
+    string frame;
+    bool coalesced = feed.takeFrame(frame)
+                     && (frame == "id: 1\nevent: occupancy\ndata: [[1,101,0,0,2]]\n\n")
+                     && (feed.getRecordedCount() == 4) && (feed.getPublishedCount() == 1);
+    bool drained = !feed.takeFrame(frame) && frame.empty();
+    
+    system.releaseParking(first, 50);
+    bool released = feed.takeFrame(frame) && (frame == "id: 2\nevent: occupancy\ndata: [[1,101,0,2,0]]\n\n");
+    
+    ParkingApi api(&system, "");
+    HttpRequest request;
+    HttpResponse response;
+    request.method = "GET";
+    request.path = "/api/stream";
+    api.handle(request, response);
+    bool disabled = (response.status == 404) && !response.streaming;
+    api.setOccupancyFeed(&feed);
+    response = HttpResponse();
+    api.handle(request, response);
+    bool snapshot = response.streaming && (response.body.find("retry: 1000\nevent: zones\ndata: {\"zones\":[{\"id\":1,") == 0);
+    
+    bool passed = coalesced && drained && released && disabled && snapshot;
+    printTestResult(passed);
+    return passed;
+}
+
+bool test27_TariffRevenue() {
+    printTestHeader("Tariff Charges and Revenue Totals");
+    const string snapshotPath = "parking_test_tariff.snap";
+    ParkingSystem* system = new ParkingSystem(2);
+    system->setupZone(1, 1);
+    system->setupParkingArea(1, 0, 101, 1);
+    system->setupZone(2, 1);
+    system->setupParkingArea(2, 0, 201, 1);
+    system->addZoneAdjacency(1, 2);
+    system->setZoneRate(2, 20);
+    system->configureTariff(100, 50);
+    system->setTariffBand(0, 10, 200);   // peak: double rate
+    
+    // 5 peak units + 15 normal at 10 per unit
+    int first = system->createParkingRequest("T1", 1, 5);
+    system->allocateParking(first);
+    system->occupyParking(first);
+    system->releaseParking(first, 25);
+    
+    // Spills into zone 2 and stays past the day boundary:
+    // 70 normal + 10 peak + 20 normal at 20 per unit, plus the surcharge
+    int holder = system->createParkingRequest("T2", 1, 30);
+    int spilled = system->createParkingRequest("T3", 1, 30);
+    system->allocateParking(holder);
+    system->allocateParking(spilled);
+    system->occupyParking(holder);
+    system->occupyParking(spilled);
+    system->releaseParking(spilled, 130);
+    
+    HistoryNode entry;
+    bool charged = system->getHistoryEntry(first, entry) && (entry.charge == 250)
+                   && system->getHistoryEntry(spilled, entry) && (entry.charge == 2250);
+    const TariffEngine* tariff = system->getTariff();
+    bool totals = (system->getZoneRevenue(1) == 250) && (system->getZoneRevenue(2) == 2250)
+                  && (system->getAnalytics().totalRevenue == 2500) && (tariff->getIntervalCount() == 3)
+                  && (tariff->getIntervalRevenue(0) == 250) && (tariff->getIntervalRevenue(2) == 2250);
+    
+    // Rates, bands and totals survive a snapshot: 70 normal + 5 peak units
+    bool saved = system->saveSnapshot(snapshotPath);
+    delete system;
+    ParkingSystem restored(2);
+    bool loaded = saved && restored.loadSnapshot(snapshotPath);
+    restored.releaseParking(holder, 105);
+    bool restoredTotals = loaded && restored.getHistoryEntry(holder, entry) && (entry.charge == 800)
+                          && (restored.getTotalRevenue() == 3300) && (restored.getZoneRevenue(2) == 2250);
+    remove(snapshotPath.c_str());
+    
+    bool passed = charged && totals && restoredTotals;
+    printTestResult(passed);
+    return passed;
+}
+
+bool test28_AreaSummary() {
+    printTestHeader("Free-Area Summary and Closed Areas");
+    const string snapshotPath = "parking_test_areas.snap";
+    ParkingSystem* system = new ParkingSystem(1);
+    system->setupZone(1, 3);
+    system->setupParkingArea(1, 0, 11, 2);
+    system->setupParkingArea(1, 1, 12, 2);
+    system->setupParkingArea(1, 2, 13, 2);
+    
+    HistoryNode entry;
+    int areaOf[5];
+    int ids[5];
+    for (int i = 0; i < 3; i++) {
+        ids[i] = system->createParkingRequest("A" + to_string(i), 1, i);
+        system->allocateParking(ids[i]);
+        system->getHistoryEntry(ids[i], entry);
+        areaOf[i] = entry.allocatedSlotID / 1000;
+    }
+    bool filledInOrder = (areaOf[0] == 11) && (areaOf[1] == 11) && (areaOf[2] == 12);
+    
+    // Area 12 still has a free slot but is draining, so 13 is next
+    system->setAreaOpen(1, 1, false);
+    ids[3] = system->createParkingRequest("A3", 1, 3);
+    system->allocateParking(ids[3]);
+    system->getHistoryEntry(ids[3], entry);
+    areaOf[3] = entry.allocatedSlotID / 1000;
+    Zone* zone = system->getZones();
+    bool skipsClosed = (areaOf[3] == 13) && !zone->isAreaOpen(1) && (zone->getTotalAvailableSlots() == 2);
+    
+    // A freed slot in area 11 becomes the first choice again
+    system->cancelRequest(ids[0]);
+    ParkingSlot* next = zone->findAvailableSlot();
+    bool reuses = (next != nullptr) && (next->getSlotID() == 11000);
+    
+    // The closed flag survives a snapshot; reopening makes area 12 usable
+    bool saved = system->saveSnapshot(snapshotPath);
+    delete system;
+    ParkingSystem restored(1);
+    bool loaded = saved && restored.loadSnapshot(snapshotPath);
+    Zone* restoredZone = restored.getZones();
+    bool stillClosed = loaded && !restoredZone->isAreaOpen(1);
+    restored.setAreaOpen(1, 0, false);
+    restored.setAreaOpen(1, 2, false);
+    bool blocked = (restoredZone->findAvailableSlot() == nullptr);
+    restored.setAreaOpen(1, 1, true);
+    ids[4] = restored.createParkingRequest("A4", 1, 4);
+    bool reopened = restored.allocateParking(ids[4]) && restored.getHistoryEntry(ids[4], entry)
+                    && (entry.allocatedSlotID == 12001);
+    remove(snapshotPath.c_str());
+    
+    bool passed = filledInOrder && skipsClosed && reuses && stillClosed && blocked && reopened;
+    printTestResult(passed);
+    return passed;
+}
+
+bool test29_CapacityRanges() {
+    printTestHeader("Zone Range Capacity Queries");
+    // Declared out of ID order; capacity is ID / 10 slots
+    int ids[] = { 150, 100, 180, 200, 120, 90 };
+    ParkingSystem system(6);
+    for (int i = 0; i < 6; i++) {
+        system.setupZone(ids[i], 1);
+        system.setupParkingArea(ids[i], 0, ids[i], ids[i] / 10);
+    }
+    
+    // Zones 100, 120, 150 and 180: 10 + 12 + 15 + 18
+    bool sums = (system.getFreeSlotsBetween(100, 180) == 55) && (system.getFreeSlotsBetween(0, 1000) == 84)
+                && (system.getFreeSlotsBetween(121, 149) == 0) && (system.getMostAvailableZone(100, 180) == 180)
+                && (system.getMostAvailableZone(121, 149) == -1);
+    
+    // Four cars leave 180 at 14, still the most; three leave 150 tied with 120 at 12
+    for (int i = 0; i < 7; i++) {
+        int requestID = system.createParkingRequest("R" + to_string(i), (i < 4) ? 180 : 150, i);
+        system.allocateParking(requestID);
+    }
+    bool afterAllocation = (system.getFreeSlotsBetween(100, 180) == 48) && (system.getMostAvailableZone(100, 180) == 180)
+                           && (system.getMostAvailableZone(100, 150) == 120);
+    system.cancelRequest(1);
+    system.cancelRequest(2);
+    bool afterRelease = (system.getFreeSlotsBetween(180, 180) == 16) && (system.getMostAvailableZone(0, 199) == 180);
+    
+    ParkingApi api(&system, "");
+    HttpRequest request;
+    HttpResponse response;
+    request.method = "GET";
+    request.path = "/api/capacity";
+    request.query = "from=90&to=120";
+    api.handle(request, response);
+    bool served = (response.status == 200) && (response.body == "{\"freeSlots\":31,\"mostAvailableZone\":120}");
+    
+    bool passed = sums && afterAllocation && afterRelease && served;
+    printTestResult(passed);
+    return passed;
+}
+
+bool test30_RequestStateSets() {
+    printTestHeader("Table-Driven Transitions and State Sets");
+    const string snapshotPath = "parking_test_states.snap";
+    bool table = ParkingRequest::isLegal(REQUESTED, REQUEST_ALLOCATE) && ParkingRequest::isLegal(ALLOCATED, REQUEST_CANCEL)
+                 && !ParkingRequest::isLegal(OCCUPIED, REQUEST_CANCEL) && !ParkingRequest::isLegal(RELEASED, REQUEST_RELEASE);
+    
+    ParkingSystem* system = new ParkingSystem(1);
+    system->setupZone(1, 1);
+    system->setupParkingArea(1, 0, 101, 10);
+    int ids[5];
+    for (int i = 0; i < 5; i++) {
+        ids[i] = system->createParkingRequest("S" + to_string(i), 1, i);
+    }
+    for (int i = 0; i < 3; i++) {
+        system->allocateParking(ids[i]);
+    }
+    system->occupyParking(ids[1]);
+    bool illegalRejected = !system->occupyParking(ids[3]) && (system->getRequestCountInState(REQUESTED) == 2);
+    system->cancelRequest(ids[4]);
+    system->releaseParking(ids[1], 20);
+    system->rollbackLastAllocation();
+    
+    bool counts = (system->getRequestCountInState(REQUESTED) == 1) && (system->getRequestCountInState(ALLOCATED) == 1)
+                  && (system->getRequestCountInState(OCCUPIED) == 0) && (system->getRequestCountInState(CANCELLED) == 1)
+                  && (system->getRequestCountInState(RELEASED) == 0);
+    int visited = 0;
+    bool membersOnly = true;
+    for (int id = system->getFirstRequestInState(ALLOCATED); id != -1; id = system->getNextRequestInState(id)) {
+        membersOnly = membersOnly && (id == ids[0]) && (system->getActiveRequest(id)->getState() == ALLOCATED);
+        visited++;
+    }
+    
+    bool saved = system->saveSnapshot(snapshotPath);
+    delete system;
+    ParkingSystem restored(1);
+    bool loaded = saved && restored.loadSnapshot(snapshotPath);
+    bool restoredCounts = loaded && (restored.getRequestCountInState(REQUESTED) == 1)
+                          && (restored.getRequestCountInState(ALLOCATED) == 1)
+                          && (restored.getRequestCountInState(CANCELLED) == 1)
+                          && (restored.getFirstRequestInState(REQUESTED) == ids[3]);
+    remove(snapshotPath.c_str());
+    
+    bool passed = table && illegalRejected && counts && (visited == 1) && membersOnly && restoredCounts;
+    printTestResult(passed);
+    return passed;
+}
+
+bool test31_UndoRedo() {
+    printTestHeader("Undo and Redo of Any Transition");
+    const string archivePath = "parking_test_undo.archive";
+    const string logPath = "parking_test_undo.wal";
+    remove(logPath.c_str());
+    
+    ParkingSystem* system = new ParkingSystem(1);
+    system->enableWriteAheadLog(logPath, 1);
+    system->setupZone(1, 1);
+    system->setupParkingArea(1, 0, 101, 2);
+    system->enableHistoryArchive(archivePath);
+    int r1 = system->createParkingRequest("U1", 1, 0);
+    int r2 = system->createParkingRequest("U2", 1, 5);
+    int r3 = system->createParkingRequest("U3", 1, 10);
+    system->allocateParking(r1);
+    system->allocateParking(r2);
+    system->allocateParking(r3);
+    system->occupyParking(r1);
+    // Frees r1's slot, which goes straight to the waitlisted r3
+    system->releaseParking(r1, 50);
+    long long revenue = system->getTotalRevenue();
+    
+    // Undoing the release takes back the hand-off, the charge and the archive record too
+    bool undone = system->undoLastOperation();
+    ParkingRequest* req1 = system->getActiveRequest(r1);
+    ParkingRequest* req3 = system->getActiveRequest(r3);
+    bool releaseUndone = undone && req1 != nullptr && req1->getState() == OCCUPIED && req3->getState() == REQUESTED
+                         && system->isWaitlisted(r3) && system->getTotalRevenue() == 0
+                         && system->getAnalytics().totalRequests == 2
+                         && system->getZones()[0].getTotalAvailableSlots() == 0;
+    bool occupyUndone = system->undoLastOperation() && system->getActiveRequest(r1)->getState() == ALLOCATED;
+    
+    bool redone = system->redoLastOperation() && system->redoLastOperation() && !system->canRedo()
+                  && system->getActiveRequest(r1) == nullptr
+                  && system->getActiveRequest(r3)->getState() == ALLOCATED && system->getTotalRevenue() == revenue
+                  && system->getAnalytics().completedRequests == 1;
+    
+    // A mistaken cancel, then a rollback (of r3, the newest allocation)
+    system->cancelRequest(r2);
+    bool cancelUndone = system->undoLastOperation() && system->getActiveRequest(r2)->getState() == ALLOCATED
+                        && system->getZones()[0].getTotalAvailableSlots() == 0;
+    system->rollbackLastAllocation();
+    bool rollbackUndone = system->undoLastOperation() && system->getActiveRequest(r3)->getState() == ALLOCATED
+                          && system->rollbackLastAllocation()
+                          && system->getActiveRequest(r3)->getState() == CANCELLED;
+    
+    // A new operation discards the redo side
+    system->undoLastOperation();
+    system->cancelRequest(r3);
+    bool redoCleared = !system->canRedo() && !system->redoLastOperation();
+    
+    // Rollback skips r1, long released, instead of freeing its old slot
+    bool staleSkipped = system->rollbackLastAllocation() && system->getActiveRequest(r2)->getState() == CANCELLED
+                        && !system->rollbackLastAllocation() && system->getZones()[0].getTotalAvailableSlots() == 2;
+    
+    ParkingAnalytics before = system->getAnalytics();
+    delete system;
+    ParkingSystem recovered(1);
+    recovered.recoverFromLog(logPath);
+    ParkingAnalytics after = recovered.getAnalytics();
+    bool replayed = (after.completedRequests == before.completedRequests)
+                    && (after.cancelledRequests == before.cancelledRequests)
+                    && (recovered.getTotalRevenue() == revenue)
+                    && (recovered.getZones()[0].getTotalAvailableSlots() == 2);
+    remove(logPath.c_str());
+    remove(archivePath.c_str());
+    
+    // Undoing a no-show expiry re-arms the timer, so the request can expire again
+    ParkingSystem timed(1);
+    timed.setupZone(1, 1);
+    timed.setupParkingArea(1, 0, 101, 1);
+    timed.setNoShowTimeout(5);
+    int a = timed.createParkingRequest("U4", 1, 0);
+    int b = timed.createParkingRequest("U5", 1, 0);
+    timed.allocateParking(a);
+    timed.allocateParking(b);
+    timed.advanceTime(10);
+    bool expiryUndone = timed.undoLastOperation() && timed.getActiveRequest(a) != nullptr
+                        && timed.getActiveRequest(a)->getState() == ALLOCATED && timed.isWaitlisted(b);
+    timed.advanceTime(20);
+    bool timerRearmed = expiryUndone && timed.getActiveRequest(a) == nullptr
+                        && timed.getActiveRequest(b)->getState() == ALLOCATED;
+    
+    bool passed = releaseUndone && occupyUndone && redone && cancelUndone && rollbackUndone && redoCleared
+                  && staleSkipped && replayed && timerRearmed;
+    printTestResult(passed);
+    return passed;
+}
+
+bool test32_Transactions() {
+    printTestHeader("Transactions and Savepoints");
+    const string logPath = "parking_test_txn.wal";
+    remove(logPath.c_str());
+    
+    ParkingSystem* system = new ParkingSystem(2);
+    system->enableWriteAheadLog(logPath, 1);
+    system->setupZone(1, 1);
+    system->setupParkingArea(1, 0, 101, 3);
+    system->setupZone(2, 1);
+    system->setupParkingArea(2, 0, 201, 3);
+    system->addZoneAdjacency(1, 2);
+    int a = system->createParkingRequest("T1", 1, 0);
+    int b = system->createParkingRequest("T2", 1, 0);
+    
+    bool begun = system->beginTransaction() && !system->beginTransaction();
+    system->allocateParking(a);
+    int savepoint = system->setSavepoint();
+    system->allocateParking(b);
+    system->occupyParking(a);
+    bool toSavepoint = system->rollbackToSavepoint(savepoint) && system->getActiveRequest(a)->getState() == ALLOCATED
+                       && system->getActiveRequest(b)->getState() == REQUESTED && !system->undoLastOperation();
+    bool aborted = system->abortTransaction() && !system->inTransaction() && !system->canRedo()
+                   && system->getActiveRequest(a)->getState() == REQUESTED
+                   && system->getZones()[0].getTotalAvailableSlots() == 3;
+    
+    // A committed transaction is undone as one step
+    system->beginTransaction();
+    system->allocateParking(a);
+    system->allocateParking(b);
+    system->commitTransaction();
+    bool committed = system->getZones()[0].getTotalAvailableSlots() == 1 && system->undoLastOperation()
+                     && system->getZones()[0].getTotalAvailableSlots() == 3;
+    
+    // Four slots do not fit in zone 1, so none are booked and nothing is left waiting
+    ParkingApi api(system, "");
+    HttpRequest request;
+    HttpResponse response;
+    request.method = "POST";
+    request.path = "/api/bookings";
+    request.query = "vehicle=TOUR&zone=1&time=10&count=4";
+    api.handle(request, response);
+    bool allOrNothing = response.status == 409 && system->getZones()[0].getTotalAvailableSlots() == 3
+                        && system->getZones()[1].getTotalAvailableSlots() == 3
+                        && system->getRequestCountInState(REQUESTED) == 2 && system->getWaitlistLength(1) == 0;
+    request.query = "vehicle=TOUR&zone=1&time=10&count=3";
+    response = HttpResponse();
+    api.handle(request, response);
+    bool booked = response.status == 200 && response.body.find("\"vehicleID\":\"TOUR-3\"") != string::npos
+                  && system->getZones()[0].getTotalAvailableSlots() == 0;
+    
+    // A transaction the log never saw commit is aborted on recovery
+    system->beginTransaction();
+    system->allocateParking(a);
+    delete system;
+    ParkingSystem recovered(2);
+    recovered.recoverFromLog(logPath);
+    bool recoveredAborted = !recovered.inTransaction() && recovered.getActiveRequest(a)->getState() == REQUESTED
+                            && recovered.getZones()[1].getTotalAvailableSlots() == 3
+                            && recovered.getZones()[0].getTotalAvailableSlots() == 0;
+    remove(logPath.c_str());
+    
+    bool passed = begun && (savepoint == 0) && toSavepoint && aborted && committed && allOrNothing && booked
+                  && recoveredAborted;
+    printTestResult(passed);
+    return passed;
+}
+
+bool test33_RuntimeReconfiguration() {
+    printTestHeader("Runtime Reconfiguration");
+    const string logPath = "parking_test_reconfig.wal";
+    remove(logPath.c_str());
+    
+    ParkingSystem* system = new ParkingSystem(2);
+    system->enableWriteAheadLog(logPath, 1);
+    system->setupZone(1, 1);
+    system->setupParkingArea(1, 0, 101, 1);
+    system->setupZone(2, 1);
+    system->setupParkingArea(2, 0, 201, 1);
+    int a = system->createParkingRequest("R1", 1, 0);
+    int b = system->createParkingRequest("R2", 1, 0);
+    system->allocateParking(a);
+    system->occupyParking(a);
+    system->allocateParking(b);
+    
+    // The new area goes straight to the request waiting for zone 1
+    int added = system->addParkingArea(1, 102, 2);
+    bool grown = added == 1 && system->getActiveRequest(b)->getState() == ALLOCATED
+                 && system->getZones()[0].getTotalAvailableSlots() == 1 && system->getWaitlistLength(1) == 0
+                 && system->addParkingArea(2, 102, 5) == -1;
+    
+    bool refused = !system->resizeParkingArea(1, 0, 0) && !system->removeParkingArea(1, 1);
+    bool shrunk = system->resizeParkingArea(1, 1, 1) && system->getZones()[0].getTotalCapacity() == 2
+                  && system->getZones()[0].getTotalAvailableSlots() == 0;
+    system->cancelRequest(b);
+    bool removed = system->removeParkingArea(1, 1) && system->getZones()[0].getAreaCount() == 1
+                   && system->getZones()[0].getTotalAvailableSlots() == 0;
+    bool resized = system->resizeParkingArea(1, 0, 4) && system->getZones()[0].getTotalAvailableSlots() == 3
+                   && system->getZones()[0].getArea(0)->getSlot(3)->getSlotID() == 101003;
+    // A removed area's ID is free again; one still in use is not
+    bool idsTracked = system->addParkingArea(2, 101, 1) == -1 && system->addParkingArea(2, 102, 1) != -1;
+    // Removing an area moves the zone's last one into its index
+    system->addParkingArea(2, 103, 2);
+    const Zone& zone2 = system->getZones()[1];
+    bool lastMoved = system->removeParkingArea(2, 0) && zone2.getAreaCount() == 2
+                     && zone2.getArea(0)->getAreaID() == 103 && zone2.getArea(1)->getAreaID() == 102
+                     && zone2.getTotalAvailableSlots() == 3 && system->addParkingArea(2, 201, 1) != -1;
+    for (int k = 0; k < 3; k++) {
+        int parked = system->createParkingRequest("M" + to_string(k), 2, 10);
+        lastMoved = lastMoved && system->allocateParking(parked);
+    }
+    
+    system->addZoneAdjacency(1, 2);
+    bool unlinked = system->removeZoneAdjacency(2, 1) && !system->getZones()[0].isAdjacentTo(2)
+                    && !system->getZones()[1].isAdjacentTo(1) && !system->removeZoneAdjacency(1, 2);
+    
+    delete system;
+    ParkingSystem recovered(2);
+    recovered.recoverFromLog(logPath);
+    bool replayed = recovered.getZones()[0].getAreaCount() == 1 && recovered.getZones()[0].getTotalCapacity() == 4
+                    && recovered.getZones()[0].getTotalAvailableSlots() == 3
+                    && recovered.getActiveRequest(a)->getState() == OCCUPIED;
+    remove(logPath.c_str());
+    
+    bool passed = grown && refused && shrunk && removed && resized && idsTracked && lastMoved && unlinked
+                  && replayed;
+    printTestResult(passed);
+    return passed;
+}
+
+bool test34_ForkCopyOnWrite() {
+    printTestHeader("Copy-on-Write Fork");
+    ParkingSystem system(2);
+    system.setupZone(1, 2);
+    system.setupParkingArea(1, 0, 101, 3);
+    system.setupParkingArea(1, 1, 102, 3);
+    system.setupZone(2, 1);
+    system.setupParkingArea(2, 0, 201, 3);
+    system.addZoneAdjacency(1, 2);
+    int a = system.createParkingRequest("F1", 1, 0);
+    system.allocateParking(a);
+    system.occupyParking(a);
+    
+    const Zone* live = system.getZones();
+    ParkingSystem* what = system.fork();
+    const Zone* forked = what->getZones();
+    bool shared = forked[0].getArea(0) == live[0].getArea(0) && forked[0].getArea(1) == live[0].getArea(1)
+                  && forked[1].getArea(0) == live[1].getArea(0)
+                  && what->getActiveRequest(a)->getState() == OCCUPIED;
+    
+    // Closing zone 1 in the fork spills the next request into zone 2,
+    // which is the only area the fork copies
+    what->setAreaOpen(1, 0, false);
+    what->setAreaOpen(1, 1, false);
+    int b = what->createParkingRequest("F2", 1, 5);
+    what->allocateParking(b);
+    bool spilled = forked[1].getTotalAvailableSlots() == 2 && live[1].getTotalAvailableSlots() == 3
+                   && forked[1].getArea(0) != live[1].getArea(0) && forked[0].getArea(0) == live[0].getArea(0)
+                   && live[0].isAreaOpen(0);
+    
+    what->releaseParking(a, 10);
+    bool independent = forked[0].getTotalAvailableSlots() == 6 && live[0].getTotalAvailableSlots() == 5
+                       && forked[0].getArea(0) != live[0].getArea(0)
+                       && system.getActiveRequest(a)->getState() == OCCUPIED;
+    
+    // Layout changes stay on their side: a zone's area table and the
+    // area-ID index are copied before either system changes them
+    bool layoutApart = what->addParkingArea(2, 202, 2) == 1 && forked[1].getAreaCount() == 2
+                       && live[1].getAreaCount() == 1 && system.addParkingArea(2, 202, 1) == 1
+                       && what->removeParkingArea(1, 1) && live[0].getAreaCount() == 2
+                       && live[0].getArea(1)->getAreaID() == 102;
+    delete what;
+    
+    int c = system.createParkingRequest("F3", 1, 20);
+    bool unaffected = system.allocateParking(c) && system.getZones()[0].getTotalAvailableSlots() == 4
+                      && system.releaseParking(a, 30);
+    
+    // Finished history, archived or resident, carries over as totals
+    const string archivePath = "parking_test_fork.arc";
+    ParkingSystem archived(1);
+    archived.setupZone(1, 1);
+    archived.setupParkingArea(1, 0, 101, 2);
+    archived.setZoneRate(1, 100);
+    archived.enableHistoryArchive(archivePath);
+    for (int i = 0; i < 5; i++) {
+        int req = archived.createParkingRequest("H" + to_string(i), 1, 10 * i);
+        archived.allocateParking(req);
+        archived.occupyParking(req);
+        archived.releaseParking(req, 10 * i + 5);
+    }
+    int open = archived.createParkingRequest("H5", 1, 60);
+    archived.allocateParking(open);
+    ParkingSystem* branch = archived.fork();
+    ParkingAnalytics original = archived.getAnalytics();
+    ParkingAnalytics branched = branch->getAnalytics();
+    bool totalsCarried = (branched.totalRequests == 6) && (original.totalRequests == 6)
+                         && (branched.completedRequests == 5) && (original.completedRequests == 5)
+                         && (branched.averageParkingDuration == original.averageParkingDuration)
+                         && (branched.totalRevenue == original.totalRevenue)
+                         && (branch->getResidentHistoryCount() == 1) && !branch->canUndo();
+    bool forkCounts = branch->occupyParking(open) && branch->releaseParking(open, 70)
+                      && (branch->getAnalytics().completedRequests == 6)
+                      && (archived.getAnalytics().completedRequests == 5);
+    delete branch;
+    remove(archivePath.c_str());
+    
+    bool passed = shared && spilled && independent && layoutApart && unaffected && totalsCarried && forkCounts;
+    printTestResult(passed);
+    return passed;
+}
+
+bool test35_CapacitySimulation() {
+    printTestHeader("Capacity Simulation");
+    ParkingSystem system(3);
+    for (int z = 1; z <= 3; z++) {
+        system.setupZone(z, 1);
+        system.setupParkingArea(z, 0, z * 100, 10);
+    }
+    system.addZoneAdjacency(1, 2);
+    system.setNoShowTimeout(15);
+    
+    WorkloadConfig config;
+    config.seed = 7;
+    config.duration = 1440;
+    config.arrivalRate = 1.0;
+    config.zoneSkew = 2.0;
+    config.noShowRate = 0.2;
+    config.sampleInterval = 60;
+    LoadGenerator simulator(&system, config);
+    bool ran = simulator.run("");
+    const WorkloadStats& stats = simulator.getStats();
+    
+    bool sampled = simulator.getSampleCount() == 25 && simulator.getSampleTime(24) == 1440.0
+                   && simulator.getPeakUtilization(0) >= simulator.getMeanUtilization(0)
+                   && simulator.getPeakUtilization(0) <= 1.0 && simulator.getUtilization(0, 0) == 0.0;
+    // Zone 1 takes most arrivals and overflows into zone 2 only
+    bool rates = simulator.getZoneArrivals(0) > simulator.getZoneArrivals(2) && stats.crossZone > 0
+                 && simulator.getZoneCrossZoneRate(0) > 0.0 && simulator.getZoneCrossZoneRate(2) == 0.0
+                 && simulator.getZoneRejectionRate(0) >= simulator.getZoneRejectionRate(1)
+                 && stats.abandoned > 0;
+    // Every no-show's slot came back through the timeout
+    bool drained = stats.noShows > 0 && system.getZones()[0].getTotalAvailableSlots() == 10
+                   && system.getZones()[1].getTotalAvailableSlots() == 10
+                   && system.getRequestCountInState(ALLOCATED) == 0;
+    
+    bool passed = ran && sampled && rates && drained;
+    printTestResult(passed);
+    return passed;
+}
+
+bool test36_BalancedSpillover() {
+    printTestHeader("Balanced Spillover");
+    const string logPath = "parking_test_spill.wal";
+    remove(logPath.c_str());
+    
+    // Zone 1 (2 slots) overflows into zones 2, 3 and 4, linked in that order
+    ParkingSystem nearest(4);
+    ParkingSystem* balanced = new ParkingSystem(4);
+    balanced->enableWriteAheadLog(logPath, 1);
+    ParkingSystem* systems[2] = { &nearest, balanced };
+    for (int s = 0; s < 2; s++) {
+        systems[s]->setupZone(1, 1);
+        systems[s]->setupParkingArea(1, 0, 100, 2);
+        for (int z = 2; z <= 4; z++) {
+            systems[s]->setupZone(z, 1);
+            systems[s]->setupParkingArea(z, 0, z * 100, 10);
+            systems[s]->addZoneAdjacency(1, z);
+        }
+    }
+    balanced->setSpilloverPolicy(SPILLOVER_TWO_CHOICES);
+    for (int s = 0; s < 2; s++) {
+        for (int i = 0; i < 14; i++) {
+            int requestID = systems[s]->createParkingRequest("S" + to_string(i), 1, i);
+            systems[s]->allocateParking(requestID);
+        }
+    }
+    
+    const Zone* first = nearest.getZones();
+    bool skewed = first[1].getTotalAvailableSlots() == 0 && first[2].getTotalAvailableSlots() == 8
+                  && first[3].getTotalAvailableSlots() == 10;
+    // Twelve overflows over three neighbours: none takes more than five
+    int available[4];
+    for (int z = 0; z < 4; z++) {
+        available[z] = balanced->getZones()[z].getTotalAvailableSlots();
+    }
+    bool even = balanced->getSpilloverPolicy() == SPILLOVER_TWO_CHOICES && available[0] == 0;
+    int placed = 0;
+    for (int z = 1; z <= 3; z++) {
+        int taken = 10 - available[z];
+        even = even && taken >= 3 && taken <= 5;
+        placed += taken;
+    }
+    even = even && placed == 12;
+    
+    // Sampling is a hash of the request ID, so forks and replays choose alike
+    ParkingSystem* what = balanced->fork();
+    int extra = what->createParkingRequest("S14", 1, 20);
+    bool forked = what->getSpilloverPolicy() == SPILLOVER_TWO_CHOICES && what->allocateParking(extra);
+    delete what;
+    delete balanced;
+    ParkingSystem recovered(4);
+    recovered.recoverFromLog(logPath);
+    bool replayed = recovered.getSpilloverPolicy() == SPILLOVER_TWO_CHOICES;
+    for (int z = 0; z < 4; z++) {
+        replayed = replayed && recovered.getZones()[z].getTotalAvailableSlots() == available[z];
+    }
+    remove(logPath.c_str());
+    
+#ifdef PARKING_METRICS_ENABLED
+    bool measured = nearest.getMetrics()->getMaxSpilloverShare() > 0.8
+                    && recovered.getMetrics()->getMaxSpilloverShare() < 0.5
+                    && recovered.getMetricsText().find("parking_spillover_max_share_permille") != string::npos;
+#else
+    bool measured = true;
+#endif
+    
+    bool passed = skewed && even && forked && replayed && measured;
+    printTestResult(passed);
+    return passed;
+}
+
 void runAllTests() {
     clearScreen();
     setColor(11);
@@ -284,7 +1707,7 @@ void runAllTests() {
     setColor(7);
     
     int passed = 0;
-    int total = 12;
+    int total = 36;
     
     if (test1_BasicAllocation()) passed++;
     if (test2_CrossZoneAllocation()) passed++;
@@ -298,6 +1721,30 @@ void runAllTests() {
     if (test10_AnalyticsAfterRollback()) passed++;
     if (test11_ZoneUtilization()) passed++;
     if (test12_PeakUsageZone()) passed++;
+    if (test13_OccupancyTimeline()) passed++;
+    if (test14_TopKZones()) passed++;
+    if (test15_NoShowExpiry()) passed++;
+    if (test16_AdvanceReservations()) passed++;
+    if (test17_PriorityWaitlist()) passed++;
+    if (test18_WriteAheadLogRecovery()) passed++;
+    if (test19_SnapshotRestore()) passed++;
+    if (test20_HistoryArchive()) passed++;
+    if (test21_LayoutLoader()) passed++;
+    if (test22_TraceReplay()) passed++;
+    if (test23_LoadGenerator()) passed++;
+    if (test24_Metrics()) passed++;
+    if (test25_HttpApi()) passed++;
+    if (test26_OccupancyFeed()) passed++;
+    if (test27_TariffRevenue()) passed++;
+    if (test28_AreaSummary()) passed++;
+    if (test29_CapacityRanges()) passed++;
+    if (test30_RequestStateSets()) passed++;
+    if (test31_UndoRedo()) passed++;
+    if (test32_Transactions()) passed++;
+    if (test33_RuntimeReconfiguration()) passed++;
+    if (test34_ForkCopyOnWrite()) passed++;
+    if (test35_CapacitySimulation()) passed++;
+    if (test36_BalancedSpillover()) passed++;
     
     cout << "\n==========================================\n";
     if (passed == total) {
@@ -319,8 +1766,29 @@ void initializeSystem() {
     setColor(14);
     cout << "\n  [INITIALIZING SYSTEM]\n";
     setColor(7);
+    
+    string layoutError;
+    ParkingSystem* loaded = LayoutLoader::load("parking.layout", layoutError);
+    if (loaded != nullptr) {
+        delete parkingSystem;
+        parkingSystem = loaded;
+        cout << "  Loaded layout from parking.layout\n\n";
+        for (int i = 0; i < parkingSystem->getZoneCount(); i++) {
+            Zone& zone = parkingSystem->getZones()[i];
+            if (zone.getZoneID() != -1) {
+                cout << "  + Zone " << zone.getZoneID() << ": " << zone.getTotalCapacity()
+                     << " slots (" << zone.getAreaCount() << " areas) - READY\n";
+            }
+        }
+        printSuccess("System initialized successfully!");
+        pauseScreen();
+        return;
+    }
+    
+    cout << "  No usable layout file (" << layoutError << ")\n";
     cout << "  Setting up 3 zones with parking areas...\n\n";
     
+    delete parkingSystem;
     parkingSystem = new ParkingSystem(3);
     
     parkingSystem->setupZone(1, 2);
@@ -461,10 +1929,15 @@ void handleAllocateParking() {
     if (success) {
         printSuccess("Parking allocated successfully!");
     } else {
-        printError("Failed to allocate. Possible reasons:");
-        cout << "  - Invalid Request ID\n";
-        cout << "  - Request already allocated\n";
-        cout << "  - No slots available\n";
+        if (parkingSystem->isWaitlisted(requestID)) {
+            printInfo("No slots available - request added to the waitlist.");
+            cout << "  It will be allocated automatically when a slot frees up.\n";
+        } else {
+            printError("Failed to allocate. Possible reasons:");
+            cout << "  - Invalid Request ID\n";
+            cout << "  - Request already allocated\n";
+            cout << "  - No slots available\n";
+        }
     }
     
     pauseScreen();
@@ -699,7 +2172,326 @@ void handleViewPeakZone() {
     pauseScreen();
 }
 
-int main() {
+// Non-interactive trace replay:
+//   parking_system --replay <trace> [--layout <file>] [--golden <file>] [--write-golden <file>]
+//                  [--metrics <file>]
+// Exits with 0 on success, 1 on a golden mismatch and 2 on bad input.
+int runTraceReplay(int argc, char* argv[]) {
+    string tracePath;
+    string layoutPath = "parking.layout";
+    string goldenPath;
+    string writeGoldenPath;
+    string metricsPath;
+    
+    for (int i = 1; i < argc; i++) {
+        string option = argv[i];
+        if (i + 1 >= argc) {
+            cerr << "Missing value for " << option << endl;
+            return 2;
+        }
+        if (option == "--replay") {
+            tracePath = argv[++i];
+        } else if (option == "--layout") {
+            layoutPath = argv[++i];
+        } else if (option == "--golden") {
+            goldenPath = argv[++i];
+        } else if (option == "--write-golden") {
+            writeGoldenPath = argv[++i];
+        } else if (option == "--metrics") {
+            metricsPath = argv[++i];
+        } else {
+            cerr << "Unknown option " << option << endl;
+            return 2;
+        }
+    }
+    if (tracePath.empty()) {
+        cerr << "Usage: " << argv[0] << " --replay <trace> [--layout <file>] [--golden <file>] [--write-golden <file>] [--metrics <file>]" << endl;
+        return 2;
+    }
+    
+    string error;
+    ParkingSystem* system = LayoutLoader::load(layoutPath, error);
+    if (system == nullptr) {
+        cerr << "Layout: " << error << endl;
+        return 2;
+    }
+    
+    TraceReplayer replayer(system);
+    bool replayed = replayer.replay(tracePath, error);
+    replayer.printReport();
+    if (!replayed) {
+        cerr << "Trace: " << error << endl;
+        delete system;
+        return 2;
+    }
+    
+    int exitCode = 0;
+    if (!metricsPath.empty()) {
+        FILE* out = fopen(metricsPath.c_str(), "w");
+        if (out != nullptr) {
+            fputs(system->getMetricsText().c_str(), out);
+            fclose(out);
+            cout << "Metrics written to " << metricsPath << endl;
+        } else {
+            cerr << "Cannot write " << metricsPath << endl;
+            exitCode = 2;
+        }
+    }
+    
+    ParkingAnalytics analytics = system->getAnalytics();
+    if (!writeGoldenPath.empty()) {
+        if (TraceReplayer::writeGolden(analytics, writeGoldenPath)) {
+            cout << "Golden analytics written to " << writeGoldenPath << endl;
+        } else {
+            cerr << "Cannot write " << writeGoldenPath << endl;
+            exitCode = 2;
+        }
+    }
+    if (!goldenPath.empty()) {
+        string differences;
+        if (TraceReplayer::compareGolden(analytics, goldenPath, differences)) {
+            cout << "Analytics match " << goldenPath << endl;
+        } else {
+            cout << "Analytics differ from " << goldenPath << ":\n" << differences;
+            exitCode = 1;
+        }
+    }
+    
+    delete system;
+    return exitCode;
+}
+
+// Non-interactive workload generation:
+//   parking_system --generate <trace> [--layout <file>] [--seed <n>] [--rate <per minute>]
+//                  [--duration <minutes>] [--cancel <share>] [--skew <exponent>]
+// Runs the workload against the layout in-process and writes its trace.
+int runLoadGenerator(int argc, char* argv[]) {
+    string tracePath;
+    string layoutPath = "parking.layout";
+    WorkloadConfig config;
+    
+    for (int i = 1; i < argc; i++) {
+        string option = argv[i];
+        if (i + 1 >= argc) {
+            cerr << "Missing value for " << option << endl;
+            return 2;
+        }
+        string value = argv[++i];
+        if (option == "--generate") {
+            tracePath = value;
+        } else if (option == "--layout") {
+            layoutPath = value;
+        } else if (option == "--seed") {
+            config.seed = strtoull(value.c_str(), nullptr, 10);
+        } else if (option == "--rate") {
+            config.arrivalRate = atof(value.c_str());
+        } else if (option == "--duration") {
+            config.duration = atof(value.c_str());
+        } else if (option == "--cancel") {
+            config.cancellationRate = atof(value.c_str());
+        } else if (option == "--skew") {
+            config.zoneSkew = atof(value.c_str());
+        } else {
+            cerr << "Unknown option " << option << endl;
+            return 2;
+        }
+    }
+    
+    string error;
+    ParkingSystem* system = LayoutLoader::load(layoutPath, error);
+    if (system == nullptr) {
+        cerr << "Layout: " << error << endl;
+        return 2;
+    }
+    
+    LoadGenerator generator(system, config);
+    bool generated = generator.run(tracePath);
+    const WorkloadStats& stats = generator.getStats();
+    cout << "Arrivals:    " << stats.arrivals << " (" << stats.allocated << " allocated, "
+         << stats.waitlisted << " waitlisted)\n";
+    cout << "Cancelled:   " << stats.cancelled << " (+" << stats.abandoned << " abandoned on the waitlist)\n";
+    cout << "Completed:   " << stats.released << "\n";
+    cout << "Trace:       " << stats.traceEvents << " events in " << stats.wallSeconds << " s";
+    if (stats.wallSeconds > 0.0) {
+        cout << " (" << (long long)(stats.traceEvents / stats.wallSeconds) << " events/s)";
+    }
+    cout << endl;
+    
+    delete system;
+    if (!generated) {
+        cerr << "Cannot write " << tracePath << endl;
+        return 2;
+    }
+    return 0;
+}
+
+// Capacity planning run, no trace:
+//   parking_system --simulate <days> [--layout <file>] [--seed <n>] [--rate <per minute>]
+//                  [--cancel <share>] [--no-show <share>] [--no-show-timeout <minutes>]
+//                  [--skew <exponent>] [--sample <minutes>] [--curves <csv>]
+//                  [--spillover nearest|balanced]
+// Prints per-zone utilization, rejection and cross-zone rates, and how
+// much overflow each zone absorbed from its neighbours.
+int runSimulation(int argc, char* argv[]) {
+    string layoutPath = "parking.layout";
+    string curvesPath;
+    int noShowTimeout = 0;
+    string spillover;
+    WorkloadConfig config;
+    config.sampleInterval = 60.0;
+    
+    for (int i = 1; i < argc; i++) {
+        string option = argv[i];
+        if (i + 1 >= argc) {
+            cerr << "Missing value for " << option << endl;
+            return 2;
+        }
+        string value = argv[++i];
+        if (option == "--simulate") {
+            config.duration = atof(value.c_str()) * 1440.0;
+        } else if (option == "--layout") {
+            layoutPath = value;
+        } else if (option == "--seed") {
+            config.seed = strtoull(value.c_str(), nullptr, 10);
+        } else if (option == "--rate") {
+            config.arrivalRate = atof(value.c_str());
+        } else if (option == "--cancel") {
+            config.cancellationRate = atof(value.c_str());
+        } else if (option == "--no-show") {
+            config.noShowRate = atof(value.c_str());
+        } else if (option == "--no-show-timeout") {
+            noShowTimeout = atoi(value.c_str());
+        } else if (option == "--skew") {
+            config.zoneSkew = atof(value.c_str());
+        } else if (option == "--sample") {
+            config.sampleInterval = atof(value.c_str());
+        } else if (option == "--curves") {
+            curvesPath = value;
+        } else if (option == "--spillover") {
+            if (value != "nearest" && value != "balanced") {
+                cerr << "--spillover must be nearest or balanced" << endl;
+                return 2;
+            }
+            spillover = value;
+        } else {
+            cerr << "Unknown option " << option << endl;
+            return 2;
+        }
+    }
+    
+    string error;
+    ParkingSystem* system = LayoutLoader::load(layoutPath, error);
+    if (system == nullptr) {
+        cerr << "Layout: " << error << endl;
+        return 2;
+    }
+    if (noShowTimeout > 0) {
+        system->setNoShowTimeout(noShowTimeout);
+    }
+    if (!spillover.empty()) {
+        system->setSpilloverPolicy((spillover == "balanced") ? SPILLOVER_TWO_CHOICES : SPILLOVER_NEAREST);
+    }
+    
+    LoadGenerator simulator(system, config);
+    simulator.run("");
+    const WorkloadStats& stats = simulator.getStats();
+    
+    printf("zone,capacity,arrivals,mean_utilization,peak_utilization,rejection_rate,cross_zone_rate,spilled_in\n");
+    Zone* zones = system->getZones();
+    for (int i = 0; i < system->getZoneCount(); i++) {
+        if (zones[i].getZoneID() == -1) {
+            continue;
+        }
+        printf("%d,%d,%lld,%.4f,%.4f,%.4f,%.4f,%lld\n", zones[i].getZoneID(), zones[i].getTotalCapacity(),
+               simulator.getZoneArrivals(i), simulator.getMeanUtilization(i), simulator.getPeakUtilization(i),
+               simulator.getZoneRejectionRate(i), simulator.getZoneCrossZoneRate(i), simulator.getZoneSpilledIn(i));
+    }
+    double rejection = (stats.arrivals > 0) ? (double)stats.abandoned / stats.arrivals : 0.0;
+    double crossZone = (stats.occupied > 0) ? (double)stats.crossZone / stats.occupied : 0.0;
+    cout << "Arrivals:    " << stats.arrivals << " (" << stats.abandoned << " rejected, " << stats.noShows
+         << " no-shows, " << stats.cancelled << " cancelled)\n";
+    cout << "Rates:       rejection " << rejection << ", cross-zone " << crossZone << "\n";
+    cout << "Simulated:   " << config.duration / 1440.0 << " days in " << stats.wallSeconds << " s";
+    if (stats.wallSeconds > 0.0) {
+        cout << " (" << (long long)(stats.arrivals / stats.wallSeconds) << " vehicles/s)";
+    }
+    cout << endl;
+    
+    bool written = curvesPath.empty() || simulator.writeCurves(curvesPath);
+    delete system;
+    if (!written) {
+        cerr << "Cannot write " << curvesPath << endl;
+        return 2;
+    }
+    return 0;
+}
+
+// Serves the JSON API and the dashboard on the loopback interface:
+//   parking_system --serve <port> [--layout <file>] [--web-root <dir>]
+int runServer(int argc, char* argv[]) {
+    int port = 0;
+    string layoutPath = "parking.layout";
+    string webRoot = "web-ui";
+    
+    for (int i = 1; i < argc; i++) {
+        string option = argv[i];
+        if (i + 1 >= argc) {
+            cerr << "Missing value for " << option << endl;
+            return 2;
+        }
+        string value = argv[++i];
+        if (option == "--serve") {
+            port = atoi(value.c_str());
+        } else if (option == "--layout") {
+            layoutPath = value;
+        } else if (option == "--web-root") {
+            webRoot = value;
+        } else {
+            cerr << "Unknown option " << option << endl;
+            return 2;
+        }
+    }
+    
+    string error;
+    ParkingSystem* system = LayoutLoader::load(layoutPath, error);
+    if (system == nullptr) {
+        cerr << "Layout: " << error << endl;
+        return 2;
+    }
+    
+    OccupancyFeed feed;
+    system->setOccupancyListener(OccupancyFeed::onDelta, &feed);
+    ParkingApi api(system, webRoot);
+    api.setOccupancyFeed(&feed);
+    HttpServer server(ParkingApi::dispatch, &api);
+    // Bursts within one interval reach subscribers as a single frame
+    server.setTickHandler(ParkingApi::publish, &api, 100);
+    if (!server.listen(port)) {
+        cerr << "Cannot listen on port " << port << endl;
+        delete system;
+        return 2;
+    }
+    cout << "Serving on http://127.0.0.1:" << server.getPort() << "/" << endl;
+    server.run();
+    
+    delete system;
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1) {
+        if (string(argv[1]) == "--generate") {
+            return runLoadGenerator(argc, argv);
+        }
+        if (string(argv[1]) == "--simulate") {
+            return runSimulation(argc, argv);
+        }
+        if (string(argv[1]) == "--serve") {
+            return runServer(argc, argv);
+        }
+        return runTraceReplay(argc, argv);
+    }
+    
     int choice;
     bool systemInitialized = false;
     
@@ -1,31 +1,30 @@
-// Simulated Backend Data
+// Backend: the C++ engine's HTTP API (parking_system --serve <port>).
+// The engine serves this page and only accepts same-origin changes, so
+// open it from the server rather than straight from disk.
+const API_BASE = '';
+
+// Dashboard state, refreshed from the server after every change
 let parkingData = {
-    zones: [
-        { id: 1, name: "Zone 1", total: 10, occupied: 0 },
-        { id: 2, name: "Zone 2", total: 8, occupied: 0 },
-        { id: 3, name: "Zone 3", total: 6, occupied: 0 }
-    ],
-    requests: [],
-    nextRequestID: 1,
+    zones: [],
     analytics: {
         total: 0,
         completed: 0,
         cancelled: 0,
         avgDuration: 0,
         crossZone: 0,
-        totalRevenue: 0  // NEW: Total revenue tracking
-    },
-    pricing: {
-        perUnitRate: 10,        // 10 PKR per time unit
-        crossZonePenalty: 50    // 50 PKR extra for cross-zone
+        peakZone: -1,
+        totalRevenue: 0  // Kept by the engine's tariff (see /api/revenue)
     }
 };
 
 // Initialize
-document.addEventListener('DOMContentLoaded', () => {
-    updateAllStats();
-    updateZoneDisplay();
-    addLog('System initialized - All zones operational', 'success');
+document.addEventListener('DOMContentLoaded', async () => {
+    if (await refreshState()) {
+        addLog('Connected to parking engine - All zones operational', 'success');
+        subscribeToOccupancy();
+    } else {
+        addLog('Parking engine unreachable - start parking_system --serve 8080', 'error');
+    }
 });
 
 // Utility Functions
@@ -61,11 +60,100 @@ function showResult(elementId, message, isSuccess) {
     }, 5000);
 }
 
-// NEW: Calculate Parking Cost
-function calculateCost(duration, isCrossZone) {
-    const baseCost = duration * parkingData.pricing.perUnitRate;
-    const crossZoneFee = isCrossZone ? parkingData.pricing.crossZonePenalty : 0;
-    return baseCost + crossZoneFee;
+// Calls the engine; resolves to { ok, status, data } and never throws
+async function callApi(method, path, params = null) {
+    const options = { method: method };
+    if (params) {
+        options.headers = { 'Content-Type': 'application/x-www-form-urlencoded' };
+        options.body = new URLSearchParams(params).toString();
+    }
+    try {
+        const response = await fetch(API_BASE + path, options);
+        const data = await response.json();
+        return { ok: response.ok && data.ok !== false, status: response.status, data: data };
+    } catch (error) {
+        return { ok: false, status: 0, data: { error: 'Cannot reach the parking engine' } };
+    }
+}
+
+async function refreshState() {
+    const [zones, analytics] = await Promise.all([
+        callApi('GET', '/api/zones'),
+        callApi('GET', '/api/analytics')
+    ]);
+    if (zones.status !== 200 || analytics.status !== 200) {
+        return false;
+    }
+    
+    if (occupancyStreamOpen) {
+        // Occupancy comes from the stream; applying it here as well would
+        // count a change twice once its delta arrives
+        zones.data.zones.forEach(zone => {
+            const known = parkingData.zones.find(z => z.id === zone.id);
+            if (known) {
+                known.waiting = zone.waiting;
+            }
+        });
+    } else {
+        applyZones(zones.data.zones);
+    }
+    parkingData.analytics.total = analytics.data.totalRequests;
+    parkingData.analytics.completed = analytics.data.completedRequests;
+    parkingData.analytics.cancelled = analytics.data.cancelledRequests;
+    parkingData.analytics.avgDuration = analytics.data.averageParkingDuration;
+    parkingData.analytics.crossZone = analytics.data.crossZoneAllocations;
+    parkingData.analytics.peakZone = analytics.data.peakZone;
+    parkingData.analytics.totalRevenue = analytics.data.totalRevenue;
+    
+    updateAllStats();
+    updateZoneDisplay();
+    return true;
+}
+
+function applyZones(zones) {
+    parkingData.zones = zones.map(zone => ({
+        id: zone.id,
+        name: `Zone ${zone.id}`,
+        total: zone.capacity,
+        occupied: zone.occupied,
+        waiting: zone.waiting
+    }));
+}
+
+// Live occupancy from /api/stream: a snapshot on (re)connect, then
+// batches of [zone, area, slot, from, to] with 0 = free, so changes made
+// by other clients show up without polling
+let occupancyStreamOpen = false;
+
+function subscribeToOccupancy() {
+    if (!window.EventSource) {
+        return;
+    }
+    const stream = new EventSource(API_BASE + '/api/stream');
+    stream.addEventListener('error', () => {
+        occupancyStreamOpen = false;
+    });
+    stream.addEventListener('zones', event => {
+        occupancyStreamOpen = true;
+        applyZones(JSON.parse(event.data).zones);
+        updateAllStats();
+        updateZoneDisplay();
+    });
+    stream.addEventListener('occupancy', event => {
+        JSON.parse(event.data).forEach(([zoneID, areaID, slot, from, to]) => {
+            const zone = parkingData.zones.find(z => z.id === zoneID);
+            if (!zone) {
+                return;
+            }
+            if (from === 0 && to !== 0) {
+                zone.occupied++;
+            } else if (from !== 0 && to === 0) {
+                zone.occupied--;
+            }
+        });
+        updateAllStats();
+        updateZoneDisplay();
+    });
 }
 
 // Update Statistics
@@ -90,24 +178,10 @@ function updateAllStats() {
     // NEW: Update revenue
     document.getElementById('totalRevenue').textContent = parkingData.analytics.totalRevenue.toFixed(0);
     
-    const peakZone = getPeakZone();
+    const peakZone = parkingData.analytics.peakZone;
     document.getElementById('peakZone').textContent = peakZone > 0 ? `Zone ${peakZone}` : '-';
 }
 
-function getPeakZone() {
-    let maxOccupied = -1;
-    let peakZone = -1;
-    
-    parkingData.zones.forEach(zone => {
-        if (zone.occupied > maxOccupied) {
-            maxOccupied = zone.occupied;
-            peakZone = zone.id;
-        }
-    });
-    
-    return peakZone;
-}
-
 function updateZoneDisplay() {
     parkingData.zones.forEach(zone => {
         const zoneCard = document.querySelector(`[data-zone="${zone.id}"]`);
@@ -118,7 +192,7 @@ function updateZoneDisplay() {
         statusSpan.textContent = `${available}/${zone.total}`;
         
         // Update status color
-        const percentage = (zone.occupied / zone.total) * 100;
+        const percentage = zone.total > 0 ? (zone.occupied / zone.total) * 100 : 100;
         if (percentage >= 80) {
             statusSpan.className = 'zone-status full';
         } else if (percentage >= 50) {
@@ -140,7 +214,7 @@ function updateZoneDisplay() {
 }
 
 // Main Functions
-function createRequest() {
+async function createRequest() {
     const vehicleID = document.getElementById('vehicleID').value.trim();
     const zone = parseInt(document.getElementById('zone').value);
     const requestTime = parseInt(document.getElementById('requestTime').value);
@@ -150,36 +224,28 @@ function createRequest() {
         return;
     }
     
-    if (!zone || zone < 1 || zone > 3) {
-        showResult('requestResult', 'Please enter valid Zone (1-3)', false);
+    if (!parkingData.zones.some(z => z.id === zone)) {
+        const ids = parkingData.zones.map(z => z.id).join(', ');
+        showResult('requestResult', `Please enter a valid Zone (${ids})`, false);
         return;
     }
     
-    if (!requestTime || requestTime < 0) {
+    if (isNaN(requestTime) || requestTime < 0) {
         showResult('requestResult', 'Please enter valid Request Time', false);
         return;
     }
     
-    const requestID = parkingData.nextRequestID++;
-    const request = {
-        id: requestID,
-        vehicleID: vehicleID,
-        zone: zone,
-        requestTime: requestTime,
-        state: 'REQUESTED',
-        allocatedZone: null,
-        allocatedSlot: null,
-        isCrossZone: false,  // NEW: Track if cross-zone
-        cost: 0              // NEW: Track parking cost
-    };
-    
-    parkingData.requests.push(request);
-    parkingData.analytics.total++;
+    const result = await callApi('POST', '/api/requests', { vehicle: vehicleID, zone: zone, time: requestTime });
+    if (!result.ok) {
+        showResult('requestResult', `❌ ${result.data.error}`, false);
+        return;
+    }
     
+    const requestID = result.data.requestID;
     showResult('requestResult', `✅ Request created! ID: ${requestID}`, true);
     addLog(`Request #${requestID} created for ${vehicleID} (Zone ${zone})`, 'success');
     
-    updateAllStats();
+    await refreshState();
     
     // Clear inputs
     document.getElementById('vehicleID').value = '';
@@ -187,7 +253,7 @@ function createRequest() {
     document.getElementById('requestTime').value = '';
 }
 
-function allocateParking() {
+async function allocateParking() {
     const requestID = parseInt(document.getElementById('allocateID').value);
     
     if (!requestID) {
@@ -195,55 +261,40 @@ function allocateParking() {
         return;
     }
     
-    const request = parkingData.requests.find(r => r.id === requestID);
+    const result = await callApi('POST', `/api/requests/${requestID}/allocate`, {});
+    const request = result.data;
     
-    if (!request) {
+    if (result.status === 404) {
         showResult('allocateResult', 'Request not found', false);
         return;
     }
     
-    if (request.state !== 'REQUESTED') {
-        showResult('allocateResult', 'Request already processed', false);
+    if (!result.ok) {
+        if (request.waitlisted) {
+            showResult('allocateResult', '⏳ No slots available - request queued on the waitlist', false);
+            addLog(`Request #${requestID} waitlisted - No slots available`, 'error');
+        } else if (request.state) {
+            showResult('allocateResult', 'Request already processed', false);
+        } else {
+            showResult('allocateResult', `❌ ${request.error}`, false);
+        }
+        await refreshState();
         return;
     }
     
-    // Find available zone
-    const requestedZone = parkingData.zones.find(z => z.id === request.zone);
-    
-    if (requestedZone && requestedZone.occupied < requestedZone.total) {
-        // Allocate in requested zone
-        request.state = 'ALLOCATED';
-        request.allocatedZone = requestedZone.id;
-        request.allocatedSlot = requestedZone.occupied + 1;
-        request.isCrossZone = false;  // NEW: Same zone
-        
-        showResult('allocateResult', `✅ Allocated in Zone ${requestedZone.id}, Slot ${request.allocatedSlot}`, true);
-        addLog(`Request #${requestID} allocated in Zone ${requestedZone.id}`, 'success');
+    if (request.crossZone) {
+        showResult('allocateResult', `✅ Cross-zone allocation: Zone ${request.allocatedZone}, Slot ${request.allocatedSlot} (+₨50 penalty)`, true);
+        addLog(`Request #${requestID} cross-allocated to Zone ${request.allocatedZone} (₨50 penalty)`, 'info');
     } else {
-        // Try adjacent zones (cross-zone allocation)
-        const availableZone = parkingData.zones.find(z => z.occupied < z.total);
-        
-        if (availableZone) {
-            request.state = 'ALLOCATED';
-            request.allocatedZone = availableZone.id;
-            request.allocatedSlot = availableZone.occupied + 1;
-            request.isCrossZone = true;  // NEW: Cross zone
-            parkingData.analytics.crossZone++;
-            
-            showResult('allocateResult', `✅ Cross-zone allocation: Zone ${availableZone.id}, Slot ${request.allocatedSlot} (+₨50 penalty)`, true);
-            addLog(`Request #${requestID} cross-allocated to Zone ${availableZone.id} (₨50 penalty)`, 'info');
-        } else {
-            showResult('allocateResult', '❌ No slots available in any zone', false);
-            addLog(`Request #${requestID} failed - No slots available`, 'error');
-            return;
-        }
+        showResult('allocateResult', `✅ Allocated in Zone ${request.allocatedZone}, Slot ${request.allocatedSlot}`, true);
+        addLog(`Request #${requestID} allocated in Zone ${request.allocatedZone}`, 'success');
     }
     
-    updateAllStats();
+    await refreshState();
     document.getElementById('allocateID').value = '';
 }
 
-function occupySlot() {
+async function occupySlot() {
     const requestID = parseInt(document.getElementById('occupyID').value);
     
     if (!requestID) {
@@ -251,37 +302,27 @@ function occupySlot() {
         return;
     }
     
-    const request = parkingData.requests.find(r => r.id === requestID);
+    const result = await callApi('POST', `/api/requests/${requestID}/occupy`, {});
     
-    if (!request) {
+    if (result.status === 404) {
         showResult('occupyResult', 'Request not found', false);
         return;
     }
     
-    if (request.state !== 'ALLOCATED') {
-        showResult('occupyResult', 'Request must be allocated first', false);
+    if (!result.ok) {
+        showResult('occupyResult', result.data.state ? 'Request must be allocated first' : `❌ ${result.data.error}`, false);
         return;
     }
     
-    request.state = 'OCCUPIED';
-    request.occupyTime = Date.now();
-    
-    // Update zone occupancy
-    const zone = parkingData.zones.find(z => z.id === request.allocatedZone);
-    if (zone) {
-        zone.occupied++;
-    }
+    showResult('occupyResult', `✅ Slot occupied in Zone ${result.data.allocatedZone}`, true);
+    addLog(`Request #${requestID} occupied (${result.data.vehicleID})`, 'success');
     
-    showResult('occupyResult', `✅ Slot occupied in Zone ${request.allocatedZone}`, true);
-    addLog(`Request #${requestID} occupied (${request.vehicleID})`, 'success');
-    
-    updateAllStats();
-    updateZoneDisplay();
+    await refreshState();
     document.getElementById('occupyID').value = '';
 }
 
 // Cancel Request Function
-function cancelRequest() {
+async function cancelRequest() {
     const requestID = parseInt(document.getElementById('cancelID').value);
     
     if (!requestID) {
@@ -289,49 +330,37 @@ function cancelRequest() {
         return;
     }
     
-    const requestIndex = parkingData.requests.findIndex(r => r.id === requestID);
+    const result = await callApi('POST', `/api/requests/${requestID}/cancel`, {});
+    const request = result.data;
     
-    if (requestIndex === -1) {
+    if (result.status === 404) {
         showResult('cancelResult', 'Request not found', false);
         return;
     }
     
-    const request = parkingData.requests[requestIndex];
-    
-    // Check if request can be cancelled - Only REQUESTED or ALLOCATED
-    if (request.state === 'OCCUPIED') {
-        showResult('cancelResult', '❌ Cannot cancel - vehicle is already parked!', false);
-        return;
-    }
-    
-    if (request.state === 'RELEASED') {
-        showResult('cancelResult', '❌ Cannot cancel a released request', false);
-        return;
-    }
-    
-    if (request.state === 'CANCELLED') {
-        showResult('cancelResult', '❌ Request already cancelled', false);
+    // Only REQUESTED or ALLOCATED requests can be cancelled
+    if (!result.ok) {
+        if (request.state === 'OCCUPIED') {
+            showResult('cancelResult', '❌ Cannot cancel - vehicle is already parked!', false);
+        } else if (request.state === 'RELEASED') {
+            showResult('cancelResult', '❌ Cannot cancel a released request', false);
+        } else if (request.state === 'CANCELLED') {
+            showResult('cancelResult', '❌ Request already cancelled', false);
+        } else {
+            showResult('cancelResult', `❌ ${request.error}`, false);
+        }
         return;
     }
     
-    const previousState = request.state;
-    
-    // Update request state
-    request.state = 'CANCELLED';
-    
-    // Update analytics
-    parkingData.analytics.cancelled++;
-    
     showResult('cancelResult', `✅ Request #${requestID} cancelled successfully`, true);
-    addLog(`Request #${requestID} cancelled (was ${previousState}) - ${request.vehicleID}`, 'error');
+    addLog(`Request #${requestID} cancelled - ${request.vehicleID}`, 'error');
     
-    updateAllStats();
-    updateZoneDisplay();
+    await refreshState();
     document.getElementById('cancelID').value = '';
 }
 
 // NEW: Release Slot with Pricing Calculation
-function releaseSlot() {
+async function releaseSlot() {
     const requestID = parseInt(document.getElementById('releaseID').value);
     const releaseTime = parseInt(document.getElementById('releaseTime').value);
     
@@ -345,55 +374,31 @@ function releaseSlot() {
         return;
     }
     
-    const request = parkingData.requests.find(r => r.id === requestID);
+    const result = await callApi('POST', `/api/requests/${requestID}/release`, { time: releaseTime });
+    const request = result.data;
     
-    if (!request) {
+    if (result.status === 404) {
         showResult('releaseResult', 'Request not found', false);
         return;
     }
     
-    if (request.state !== 'OCCUPIED') {
-        showResult('releaseResult', 'Slot must be occupied first', false);
+    if (!result.ok) {
+        showResult('releaseResult', request.state ? 'Slot must be occupied first' : `❌ ${request.error}`, false);
         return;
     }
     
-    request.state = 'RELEASED';
-    request.releaseTime = releaseTime;
-    
-    // Calculate duration and cost
-    const duration = releaseTime - request.requestTime;
-    const cost = calculateCost(duration, request.isCrossZone);
-    request.cost = cost;
-    
-    // Update zone occupancy
-    const zone = parkingData.zones.find(z => z.id === request.allocatedZone);
-    if (zone && zone.occupied > 0) {
-        zone.occupied--;
-    }
-    
-    // Update analytics
-    parkingData.analytics.completed++;
-    parkingData.analytics.totalRevenue += cost;  // NEW: Add to revenue
-    
-    // Recalculate average duration
-    const completedRequests = parkingData.requests.filter(r => r.state === 'RELEASED');
-    if (completedRequests.length > 0) {
-        const totalDuration = completedRequests.reduce((sum, r) => {
-            return sum + (r.releaseTime - r.requestTime);
-        }, 0);
-        parkingData.analytics.avgDuration = totalDuration / completedRequests.length;
-    }
-    
-    // NEW: Show cost breakdown
-    const costBreakdown = request.isCrossZone 
-        ? `Duration: ${duration} units | Base: ₨${duration * 10} + Cross-zone: ₨50`
+    // The engine charges at release (zone rate, time-of-day bands and
+    // the cross-zone surcharge); revenue arrives with the next refresh
+    const duration = request.duration;
+    const cost = request.charge;
+    const costBreakdown = request.crossZone
+        ? `Duration: ${duration} units | Includes cross-zone surcharge`
         : `Duration: ${duration} units`;
     
     showResult('releaseResult', `✅ Slot released! ${costBreakdown} | Total: ₨${cost}`, true);
     addLog(`Request #${requestID} released from Zone ${request.allocatedZone} | Cost: ₨${cost}`, 'success');
     
-    updateAllStats();
-    updateZoneDisplay();
+    await refreshState();
     document.getElementById('releaseID').value = '';
     document.getElementById('releaseTime').value = '';
 }